@@ -4,15 +4,96 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 C_SRCS += \
+../src/GTKsmithArchive.c \
+../src/GTKsmithAverage.c \
+../src/GTKsmithCache.c \
 ../src/GTKsmithChart.c \
+../src/GTKsmithCiti.c \
+../src/GTKsmithContour.c \
+../src/GTKsmithDelaunay.c \
+../src/GTKsmithEnvelope.c \
+../src/GTKsmithFit.c \
+../src/GTKsmithGain.c \
+../src/GTKsmithHistory.c \
+../src/GTKsmithIndex.c \
+../src/GTKsmithLot.c \
+../src/GTKsmithMarker.c \
+../src/GTKsmithMatch.c \
+../src/GTKsmithMdif.c \
+../src/GTKsmithNetwork.c \
+../src/GTKsmithNoise.c \
+../src/GTKsmithParallel.c \
+../src/GTKsmithParse.c \
+../src/GTKsmithPath.c \
+../src/GTKsmithRing.c \
+../src/GTKsmithStability.c \
+../src/GTKsmithStream.c \
+../src/GTKsmithStub.c \
+../src/GTKsmithSynthesis.c \
+../src/GTKsmithTouchstone.c \
+../src/GTKsmithTrace.c \
 ../src/exampleSmith.c 
 
 C_DEPS += \
+./src/GTKsmithArchive.d \
+./src/GTKsmithAverage.d \
+./src/GTKsmithCache.d \
 ./src/GTKsmithChart.d \
+./src/GTKsmithCiti.d \
+./src/GTKsmithContour.d \
+./src/GTKsmithDelaunay.d \
+./src/GTKsmithEnvelope.d \
+./src/GTKsmithFit.d \
+./src/GTKsmithGain.d \
+./src/GTKsmithHistory.d \
+./src/GTKsmithIndex.d \
+./src/GTKsmithLot.d \
+./src/GTKsmithMarker.d \
+./src/GTKsmithMatch.d \
+./src/GTKsmithMdif.d \
+./src/GTKsmithNetwork.d \
+./src/GTKsmithNoise.d \
+./src/GTKsmithParallel.d \
+./src/GTKsmithParse.d \
+./src/GTKsmithPath.d \
+./src/GTKsmithRing.d \
+./src/GTKsmithStability.d \
+./src/GTKsmithStream.d \
+./src/GTKsmithStub.d \
+./src/GTKsmithSynthesis.d \
+./src/GTKsmithTouchstone.d \
+./src/GTKsmithTrace.d \
 ./src/exampleSmith.d 
 
 OBJS += \
+./src/GTKsmithArchive.o \
+./src/GTKsmithAverage.o \
+./src/GTKsmithCache.o \
 ./src/GTKsmithChart.o \
+./src/GTKsmithCiti.o \
+./src/GTKsmithContour.o \
+./src/GTKsmithDelaunay.o \
+./src/GTKsmithEnvelope.o \
+./src/GTKsmithFit.o \
+./src/GTKsmithGain.o \
+./src/GTKsmithHistory.o \
+./src/GTKsmithIndex.o \
+./src/GTKsmithLot.o \
+./src/GTKsmithMarker.o \
+./src/GTKsmithMatch.o \
+./src/GTKsmithMdif.o \
+./src/GTKsmithNetwork.o \
+./src/GTKsmithNoise.o \
+./src/GTKsmithParallel.o \
+./src/GTKsmithParse.o \
+./src/GTKsmithPath.o \
+./src/GTKsmithRing.o \
+./src/GTKsmithStability.o \
+./src/GTKsmithStream.o \
+./src/GTKsmithStub.o \
+./src/GTKsmithSynthesis.o \
+./src/GTKsmithTouchstone.o \
+./src/GTKsmithTrace.o \
 ./src/exampleSmith.o 
 
 
@@ -28,7 +109,7 @@ src/%.o: ../src/%.c src/subdir.mk
 clean: clean-src
 
 clean-src:
-	-$(RM) ./src/GTKsmithChart.d ./src/GTKsmithChart.o ./src/exampleSmith.d ./src/exampleSmith.o
+	-$(RM) ./src/GTKsmithArchive.d ./src/GTKsmithArchive.o ./src/GTKsmithAverage.d ./src/GTKsmithAverage.o ./src/GTKsmithCache.d ./src/GTKsmithCache.o ./src/GTKsmithChart.d ./src/GTKsmithChart.o ./src/GTKsmithCiti.d ./src/GTKsmithCiti.o ./src/GTKsmithContour.d ./src/GTKsmithContour.o ./src/GTKsmithDelaunay.d ./src/GTKsmithDelaunay.o ./src/GTKsmithEnvelope.d ./src/GTKsmithEnvelope.o ./src/GTKsmithFit.d ./src/GTKsmithFit.o ./src/GTKsmithGain.d ./src/GTKsmithGain.o ./src/GTKsmithHistory.d ./src/GTKsmithHistory.o ./src/GTKsmithIndex.d ./src/GTKsmithIndex.o ./src/GTKsmithLot.d ./src/GTKsmithLot.o ./src/GTKsmithMarker.d ./src/GTKsmithMarker.o ./src/GTKsmithMatch.d ./src/GTKsmithMatch.o ./src/GTKsmithMdif.d ./src/GTKsmithMdif.o ./src/GTKsmithNetwork.d ./src/GTKsmithNetwork.o ./src/GTKsmithNoise.d ./src/GTKsmithNoise.o ./src/GTKsmithParallel.d ./src/GTKsmithParallel.o ./src/GTKsmithParse.d ./src/GTKsmithParse.o ./src/GTKsmithPath.d ./src/GTKsmithPath.o ./src/GTKsmithRing.d ./src/GTKsmithRing.o ./src/GTKsmithStability.d ./src/GTKsmithStability.o ./src/GTKsmithStream.d ./src/GTKsmithStream.o ./src/GTKsmithStub.d ./src/GTKsmithStub.o ./src/GTKsmithSynthesis.d ./src/GTKsmithSynthesis.o ./src/GTKsmithTouchstone.d ./src/GTKsmithTouchstone.o ./src/GTKsmithTrace.d ./src/GTKsmithTrace.o ./src/exampleSmith.d ./src/exampleSmith.o
 
 .PHONY: clean-src
 
@@ -0,0 +1,826 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithArchive.c
+ * @brief Compressed archive of sweeps
+ *
+ * @author Michael G. Katzmann
+ *
+ * Successive sweeps of a device differ very little. Gamma is quantized to a
+ * chosen resolution and each point is coded as its difference from the same
+ * point of the previous sweep (or, in a key sweep, from the previous point of
+ * the same sweep). The differences are small integers, coded with an adaptive
+ * Rice code: each block of ARCHIVE_BLOCK values gives the number of low bits k
+ * sent as they are, the rest of each value being sent in unary. A value too
+ * large for that is sent in full after an escape.
+ *
+ * The file is a 64 byte header, the frequency axis (if given) and the sweeps.
+ * A sweep is a frame header, the byte length of each chunk of up to
+ * ARCHIVE_CHUNK_POINTS points and the chunks, each holding the real and then
+ * the imaginary values of its points. Chunks are independent, so they are
+ * coded and decoded in parallel. A key sweep every ARCHIVE_KEY_INTERVAL
+ * sweeps (and whenever the number of points changes) bounds the chain of
+ * sweeps that depend on one another.
+ *
+ * Sweeps are decoded one at a time as the file is read, into a trace that
+ * can be drawn or averaged like a live sweep.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <glib/gstdio.h>
+#include "GTKsmithArchive.h"
+#include "GTKsmithTrace.h"
+#include "GTKsmithParse.h"
+#include "GTKsmithParallel.h"
+
+#define ARCHIVE_MAGIC       "SMITHAR1"
+#define ARCHIVE_VERSION     1
+#define ARCHIVE_BYTE_ORDER  0x01020304
+#define FRAME_MAGIC         0x41505753      // "SWPA"
+#define FRAME_KEY           0x1
+
+// Values sharing a Rice parameter
+#define ARCHIVE_BLOCK       32
+// Quotients this large are escaped
+#define RICE_ESCAPE         32
+// Quantized values are limited to less than this magnitude, so that differences fit in 32 bits
+// (ARCHIVE_MIN_RESOLUTION keeps gamma up to 2 within it)
+#define QUANTUM_LIMIT       (1 << 30)
+
+typedef struct {
+    gchar   magic[8];
+    guint32 version;
+    guint32 byteOrder;
+    gdouble resolution;
+    guint32 nFreq;
+    guint32 keyInterval;
+    guint8  reserved[32];
+} tArchiveHeader;
+
+G_STATIC_ASSERT( sizeof( tArchiveHeader ) == 64 );
+
+typedef struct {
+    guint32 magic;
+    guint32 nPoints;
+    gint64  timestamp;
+    guint32 flags;
+    guint32 nChunks;
+} tFrameHeader;
+
+typedef struct {
+    guint8  *pData;
+    gsize    length, allocated;
+    guint64  bits;
+    gint     nBits;
+} tBitWriter;
+
+typedef struct {
+    const guint8 *p, *pEnd;
+    guint64       bits;
+    gint          nBits;
+    gint          nPadding;     // bytes read beyond the end
+} tBitReader;
+
+struct sArchiveWriter {
+    FILE       *pFile;
+    gchar      *sPath;
+    gdouble     resolution;
+    guint64     nSweeps;
+    gint        nPrevious, nAllocated;
+    gint32     *pU, *pV;            // the sweep being coded (quantized)
+    gint32     *pPreviousU, *pPreviousV;
+    tBitWriter *pChunks;
+    gint        nChunks;
+};
+
+struct sArchiveReader {
+    FILE        *pFile;
+    gchar       *sPath;
+    gdouble      resolution;
+    gint         nFreq;
+    gdouble     *pFreq;             // frequency axis, extended with point numbers as needed
+    gint         nFreqAllocated;
+    gint         nPrevious, nAllocated;
+    gint32      *pU, *pV;
+    gint32      *pPreviousU, *pPreviousV;
+    guint32     *pChunkBytes;
+    gint         nChunkBytes;
+    guint8      *pData;
+    gsize        dataAllocated;
+    tSmithTrace *pTrace;
+};
+
+typedef struct {
+    gint          nPoints;
+    gboolean      bKey;
+    const gint32 *pU, *pV, *pPreviousU, *pPreviousV;
+    gint32       *pDecodedU, *pDecodedV;
+    tBitWriter   *pWriters;
+    const guint8 *pData;
+    const gsize  *pOffsets;         // of each chunk in pData (nChunks + 1)
+    gdouble       resolution;
+    tSmithTrace  *pTrace;
+    gint          bDamaged;         // (atomic)
+} tArchiveJob;
+
+/*!     \brief  Zigzag code a difference
+ *
+ * Map a signed difference to an unsigned value (0, -1, 1, -2 ... to 0, 1, 2, 3 ...)
+ *
+ * \ingroup archive
+ */
+static inline guint32
+zigzag( gint32 value ) {
+    return ((guint32)value << 1) ^ (guint32)(value >> 31);
+}
+
+/*!     \brief  Undo the zigzag code
+ *
+ * Map an unsigned value back to the signed difference
+ *
+ * \ingroup archive
+ */
+static inline gint32
+unzigzag( guint32 value ) {
+    return (gint32)(value >> 1) ^ -(gint32)(value & 1);
+}
+
+/*!     \brief  Append bits
+ *
+ * Append up to 32 bits (least significant first) to a bit stream.
+ * The buffer must have room (see writerReserve()).
+ *
+ * \ingroup archive
+ *
+ * \param pWriter   pointer to the bit writer
+ * \param value     bits
+ * \param nBits     number of bits (0 to 32)
+ */
+static inline void
+putBits( tBitWriter *pWriter, guint32 value, gint nBits ) {
+    pWriter->bits |= (guint64)value << pWriter->nBits;
+    pWriter->nBits += nBits;
+    if( pWriter->nBits >= 32 ) {
+        guint32 word = GUINT32_TO_LE( (guint32)pWriter->bits );
+
+        memcpy( pWriter->pData + pWriter->length, &word, sizeof( word ) );
+        pWriter->length += sizeof( word );
+        pWriter->bits >>= 32;
+        pWriter->nBits -= 32;
+    }
+}
+
+/*!     \brief  Make room in a bit stream
+ *
+ * Empty a bit stream and make room for the worst case coding of a number of values
+ *
+ * \ingroup archive
+ *
+ * \param pWriter   pointer to the bit writer
+ * \param nValues   number of values to be coded
+ */
+static void
+writerReset( tBitWriter *pWriter, gint nValues ) {
+    // an escaped value takes 64 bits, and each block 5 bits more
+    gsize worst = (gsize)nValues * 8 + nValues / ARCHIVE_BLOCK + 16;
+
+    if( pWriter->allocated < worst ) {
+        pWriter->pData = g_realloc( pWriter->pData, worst );
+        pWriter->allocated = worst;
+    }
+    pWriter->length = 0;
+    pWriter->bits = 0;
+    pWriter->nBits = 0;
+}
+
+/*!     \brief  Finish a bit stream
+ *
+ * Write the remaining bits of a bit stream (padded to a byte)
+ *
+ * \ingroup archive
+ *
+ * \param pWriter   pointer to the bit writer
+ */
+static void
+writerFlush( tBitWriter *pWriter ) {
+    for( ; pWriter->nBits > 0; pWriter->nBits -= 8, pWriter->bits >>= 8 )
+        pWriter->pData[ pWriter->length++ ] = (guint8)pWriter->bits;
+    pWriter->nBits = 0;
+}
+
+/*!     \brief  Read bits
+ *
+ * Read up to 32 bits from a bit stream
+ *
+ * \ingroup archive
+ *
+ * \param pReader   pointer to the bit reader
+ * \param nBits     number of bits (0 to 32)
+ * \return          the bits
+ */
+static inline guint32
+getBits( tBitReader *pReader, gint nBits ) {
+    guint32 value;
+
+    while( pReader->nBits <= 56 ) {
+        guint64 byte = 0;
+
+        if( pReader->p < pReader->pEnd )
+            byte = *pReader->p++;
+        else
+            pReader->nPadding++;
+        pReader->bits |= byte << pReader->nBits;
+        pReader->nBits += 8;
+    }
+
+    value = (guint32)(pReader->bits & (((guint64)1 << nBits) - 1));
+    pReader->bits >>= nBits;
+    pReader->nBits -= nBits;
+    return value;
+}
+
+/*!     \brief  Code values
+ *
+ * Rice code the differences of quantized values from their predictions:
+ * the reference sweep, or the previous value if there is no reference
+ *
+ * \ingroup archive
+ *
+ * \param pWriter   pointer to the bit writer
+ * \param pValues   quantized values
+ * \param pRef      quantized values of the previous sweep (or NULL)
+ * \param n         number of values
+ */
+static void
+encodeValues( tBitWriter *pWriter, const gint32 *pValues, const gint32 *pRef, gint n ) {
+    guint32 z[ ARCHIVE_BLOCK ];
+
+    for( gint start = 0; start < n; start += ARCHIVE_BLOCK ) {
+        gint count = MIN( ARCHIVE_BLOCK, n - start ), k = 0;
+        guint64 sum = 0;
+
+        for( gint j = 0; j < count; j++ ) {
+            gint i = start + j;
+            gint32 prediction = pRef ? pRef[i] : ( i > 0 ? pValues[ i - 1 ] : 0 );
+
+            // (wrapping like the decoder, should a reference not be a quantized value)
+            z[j] = zigzag( (gint32)((guint32)pValues[i] - (guint32)prediction) );
+            sum += z[j];
+        }
+
+        // about the best parameter for a geometric distribution of this mean
+        if( sum >= (guint64)count )
+            k = 63 - __builtin_clzll( sum / count );
+        putBits( pWriter, k, 5 );
+
+        for( gint j = 0; j < count; j++ ) {
+            guint32 quotient = z[j] >> k;
+
+            if( quotient < RICE_ESCAPE ) {
+                // quotient ones and a zero, then the low bits
+                putBits( pWriter, (guint32)(((guint64)1 << quotient) - 1), quotient + 1 );
+                putBits( pWriter, z[j] & (((guint32)1 << k) - 1), k );
+            } else {
+                putBits( pWriter, G_MAXUINT32, RICE_ESCAPE );
+                putBits( pWriter, z[j], 32 );
+            }
+        }
+    }
+}
+
+/*!     \brief  Decode values
+ *
+ * Decode values coded by encodeValues()
+ *
+ * \ingroup archive
+ *
+ * \param pReader   pointer to the bit reader
+ * \param pValues   where the quantized values are written
+ * \param pRef      quantized values of the previous sweep (or NULL)
+ * \param n         number of values
+ */
+static void
+decodeValues( tBitReader *pReader, gint32 *pValues, const gint32 *pRef, gint n ) {
+    for( gint start = 0; start < n; start += ARCHIVE_BLOCK ) {
+        gint count = MIN( ARCHIVE_BLOCK, n - start ), k = getBits( pReader, 5 );
+
+        for( gint j = 0; j < count; j++ ) {
+            gint i = start + j, ones;
+            gint32 prediction = pRef ? pRef[i] : ( i > 0 ? pValues[ i - 1 ] : 0 );
+            guint32 z;
+
+            getBits( pReader, 0 );      // refill
+            ones = __builtin_ctzll( ~pReader->bits );
+            if( ones < RICE_ESCAPE ) {
+                getBits( pReader, ones + 1 );
+                z = ((guint32)ones << k) | getBits( pReader, k );
+            } else {
+                getBits( pReader, RICE_ESCAPE );
+                z = getBits( pReader, 32 );
+            }
+            // (wrapping, so that damaged data cannot overflow)
+            pValues[i] = (gint32)((guint32)prediction + (guint32)unzigzag( z ));
+        }
+    }
+}
+
+/*!     \brief  Quantize a value
+ *
+ * Quantize a component of gamma (non finite values become 0)
+ *
+ * \ingroup archive
+ *
+ * \param value         the value
+ * \param resolution    quantization
+ * \param pQuantum      where the quantized value is written
+ * \return              FALSE if the value is too large to be coded at the resolution
+ */
+static inline gboolean
+quantize( gdouble value, gdouble resolution, gint32 *pQuantum ) {
+    gdouble q = rint( value / resolution );
+
+    if( !isfinite( q ) ) {
+        *pQuantum = 0;
+        return TRUE;
+    }
+    if( fabs( q ) >= QUANTUM_LIMIT )
+        return FALSE;
+    *pQuantum = (gint32)q;
+    return TRUE;
+}
+
+/*!     \brief  Grow the arrays of quantized values
+ *
+ * Grow the arrays of quantized values of the current and previous sweeps
+ *
+ * \ingroup archive
+ */
+static void
+growQuanta( gint32 **ppU, gint32 **ppV, gint32 **ppPreviousU, gint32 **ppPreviousV, gint *pnAllocated, gint n ) {
+    if( n <= *pnAllocated )
+        return;
+
+    *ppU = g_renew( gint32, *ppU, n );
+    *ppV = g_renew( gint32, *ppV, n );
+    *ppPreviousU = g_renew( gint32, *ppPreviousU, n );
+    *ppPreviousV = g_renew( gint32, *ppPreviousV, n );
+    *pnAllocated = n;
+}
+
+/*!     \brief  Code chunks of a sweep
+ *
+ * Code a range of the chunks of a sweep (a parallel loop function)
+ *
+ * \ingroup archive
+ *
+ * \param from      first chunk
+ * \param to        last chunk (exclusive)
+ * \param userData  pointer to the tArchiveJob
+ */
+static void
+encodeChunks( gint from, gint to, gpointer userData ) {
+    tArchiveJob *pJob = userData;
+
+    for( gint c = from; c < to; c++ ) {
+        gint first = c * ARCHIVE_CHUNK_POINTS, n = MIN( ARCHIVE_CHUNK_POINTS, pJob->nPoints - first );
+        tBitWriter *pWriter = &pJob->pWriters[c];
+
+        writerReset( pWriter, 2 * n );
+        encodeValues( pWriter, pJob->pU + first, pJob->bKey ? NULL : pJob->pPreviousU + first, n );
+        encodeValues( pWriter, pJob->pV + first, pJob->bKey ? NULL : pJob->pPreviousV + first, n );
+        writerFlush( pWriter );
+    }
+}
+
+/*!     \brief  Decode chunks of a sweep
+ *
+ * Decode a range of the chunks of a sweep into the trace (a parallel loop function)
+ *
+ * \ingroup archive
+ *
+ * \param from      first chunk
+ * \param to        last chunk (exclusive)
+ * \param userData  pointer to the tArchiveJob
+ */
+static void
+decodeChunks( gint from, gint to, gpointer userData ) {
+    tArchiveJob *pJob = userData;
+
+    for( gint c = from; c < to; c++ ) {
+        gint first = c * ARCHIVE_CHUNK_POINTS, n = MIN( ARCHIVE_CHUNK_POINTS, pJob->nPoints - first );
+        tBitReader reader = { pJob->pData + pJob->pOffsets[c], pJob->pData + pJob->pOffsets[ c + 1 ], 0, 0, 0 };
+        gint32 *pU = pJob->pDecodedU + first, *pV = pJob->pDecodedV + first;
+
+        decodeValues( &reader, pU, pJob->bKey ? NULL : pJob->pPreviousU + first, n );
+        decodeValues( &reader, pV, pJob->bKey ? NULL : pJob->pPreviousV + first, n );
+        // more than the padding of the last word was needed
+        if( reader.nPadding * 8 > reader.nBits )
+            g_atomic_int_set( &pJob->bDamaged, TRUE );
+
+        for( gint i = 0; i < n; i++ ) {
+            pJob->pTrace->pU[ first + i ] = pU[i] * pJob->resolution;
+            pJob->pTrace->pV[ first + i ] = pV[i] * pJob->resolution;
+        }
+    }
+}
+
+/*!     \brief  Create a sweep archive
+ *
+ * Create (or replace) an archive file to append sweeps to
+ *
+ * \ingroup archive
+ *
+ * \param sPath         path of the archive
+ * \param resolution    quantization of gamma (0 for ARCHIVE_RESOLUTION, at least ARCHIVE_MIN_RESOLUTION)
+ * \param pFreq         frequency axis of the sweeps (or NULL)
+ * \param nFreq         number of frequencies
+ * \param ppError       where an error is reported (or NULL)
+ * \return              pointer to the writer (finish with sweepArchiveClose), or NULL on error
+ */
+tArchiveWriter *
+sweepArchiveCreate( const gchar *sPath, gdouble resolution, const gdouble *pFreq, gint nFreq, GError **ppError ) {
+    tArchiveHeader header = { ARCHIVE_MAGIC, ARCHIVE_VERSION, ARCHIVE_BYTE_ORDER };
+    tArchiveWriter *pWriter;
+    FILE *pFile;
+
+    if( resolution <= 0.0 )
+        resolution = ARCHIVE_RESOLUTION;
+    if( pFreq == NULL )
+        nFreq = 0;
+    if( !(resolution >= ARCHIVE_MIN_RESOLUTION) ) {
+        g_set_error( ppError, G_FILE_ERROR, G_FILE_ERROR_INVAL, "%s: a resolution of %g is finer than the %g allowed",
+                     sPath, resolution, ARCHIVE_MIN_RESOLUTION );
+        return NULL;
+    }
+
+    if( (pFile = g_fopen( sPath, "wb" )) == NULL ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ), "%s: %s", sPath, g_strerror( errno ) );
+        return NULL;
+    }
+
+    header.resolution = resolution;
+    header.nFreq = nFreq;
+    header.keyInterval = ARCHIVE_KEY_INTERVAL;
+    if( fwrite( &header, sizeof( header ), 1, pFile ) != 1
+            || (nFreq > 0 && fwrite( pFreq, sizeof( gdouble ), nFreq, pFile ) != (gsize)nFreq) ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ), "%s: %s", sPath, g_strerror( errno ) );
+        fclose( pFile );
+        return NULL;
+    }
+
+    pWriter = g_new0( tArchiveWriter, 1 );
+    pWriter->pFile = pFile;
+    pWriter->sPath = g_strdup( sPath );
+    pWriter->resolution = resolution;
+
+    return pWriter;
+}
+
+/*!     \brief  Append a sweep to an archive
+ *
+ * Quantize, code and write a sweep. A sweep with a value too large to be
+ * coded at the resolution of the archive is not written.
+ *
+ * \ingroup archive
+ *
+ * \param pWriter   pointer to the writer
+ * \param pTrace    the sweep
+ * \param timestamp time of the sweep (e.g. g_get_real_time())
+ * \param ppError   where an error is reported (or NULL)
+ * \return          FALSE on error
+ */
+gboolean
+sweepArchiveAppend( tArchiveWriter *pWriter, const tSmithTrace *pTrace, gint64 timestamp, GError **ppError ) {
+    gint n = pTrace->nPoints, nChunks = (n + ARCHIVE_CHUNK_POINTS - 1) / ARCHIVE_CHUNK_POINTS;
+    tArchiveJob job = { .nPoints = n };
+    tFrameHeader frame = { FRAME_MAGIC, n, timestamp, 0, nChunks };
+    gboolean bOK;
+    gint32 *pSwap;
+
+    growQuanta( &pWriter->pU, &pWriter->pV, &pWriter->pPreviousU, &pWriter->pPreviousV, &pWriter->nAllocated, n );
+    for( gint i = 0; i < n; i++ ) {
+        if( !quantize( pTrace->pU[i], pWriter->resolution, &pWriter->pU[i] )
+                || !quantize( pTrace->pV[i], pWriter->resolution, &pWriter->pV[i] ) ) {
+            g_set_error( ppError, G_FILE_ERROR, G_FILE_ERROR_INVAL,
+                         "%s: gamma %g%+gj of point %d is too large for the resolution %g",
+                         pWriter->sPath, pTrace->pU[i], pTrace->pV[i], i, pWriter->resolution );
+            return FALSE;
+        }
+    }
+
+    if( nChunks > pWriter->nChunks ) {
+        pWriter->pChunks = g_renew( tBitWriter, pWriter->pChunks, nChunks );
+        memset( pWriter->pChunks + pWriter->nChunks, 0, (nChunks - pWriter->nChunks) * sizeof( tBitWriter ) );
+        pWriter->nChunks = nChunks;
+    }
+
+    job.bKey = pWriter->nSweeps % ARCHIVE_KEY_INTERVAL == 0 || n != pWriter->nPrevious;
+    job.pU = pWriter->pU;
+    job.pV = pWriter->pV;
+    job.pPreviousU = pWriter->pPreviousU;
+    job.pPreviousV = pWriter->pPreviousV;
+    job.pWriters = pWriter->pChunks;
+    smithParallelFor( nChunks, 1, encodeChunks, &job );
+
+    frame.flags = job.bKey ? FRAME_KEY : 0;
+    bOK = fwrite( &frame, sizeof( frame ), 1, pWriter->pFile ) == 1;
+    for( gint c = 0; c < nChunks && bOK; c++ ) {
+        guint32 length = pWriter->pChunks[c].length;
+
+        bOK = fwrite( &length, sizeof( length ), 1, pWriter->pFile ) == 1;
+    }
+    for( gint c = 0; c < nChunks && bOK; c++ )
+        bOK = fwrite( pWriter->pChunks[c].pData, 1, pWriter->pChunks[c].length, pWriter->pFile )
+                == pWriter->pChunks[c].length;
+    if( !bOK ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ),
+                     "%s: %s", pWriter->sPath, g_strerror( errno ) );
+        return FALSE;
+    }
+
+    // this sweep is the reference for the next
+    pSwap = pWriter->pPreviousU; pWriter->pPreviousU = pWriter->pU; pWriter->pU = pSwap;
+    pSwap = pWriter->pPreviousV; pWriter->pPreviousV = pWriter->pV; pWriter->pV = pSwap;
+    pWriter->nPrevious = n;
+    pWriter->nSweeps++;
+
+    return TRUE;
+}
+
+/*!     \brief  Close an archive
+ *
+ * Finish writing an archive and free the writer
+ *
+ * \ingroup archive
+ *
+ * \param pWriter   pointer to the writer
+ * \param ppError   where an error is reported (or NULL)
+ * \return          FALSE if the archive could not be completed
+ */
+gboolean
+sweepArchiveClose( tArchiveWriter *pWriter, GError **ppError ) {
+    gboolean bOK;
+
+    if( pWriter == NULL )
+        return TRUE;
+
+    bOK = fclose( pWriter->pFile ) == 0;
+    if( !bOK )
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ),
+                     "%s: %s", pWriter->sPath, g_strerror( errno ) );
+
+    for( gint c = 0; c < pWriter->nChunks; c++ )
+        g_free( pWriter->pChunks[c].pData );
+    g_free( pWriter->pChunks );
+    g_free( pWriter->pU );
+    g_free( pWriter->pV );
+    g_free( pWriter->pPreviousU );
+    g_free( pWriter->pPreviousV );
+    g_free( pWriter->sPath );
+    g_free( pWriter );
+
+    return bOK;
+}
+
+/*!     \brief  Bytes left in a file
+ *
+ * Number of bytes from the position of a file to its end, to bound what a
+ * (possibly damaged) archive asks to be read
+ *
+ * \ingroup archive
+ *
+ * \param pFile     the file
+ * \return          bytes left (0 if the file cannot be examined)
+ */
+static guint64
+bytesLeft( FILE *pFile ) {
+    struct stat status;
+    off_t position = ftello( pFile );
+
+    if( position < 0 || fstat( fileno( pFile ), &status ) != 0 || status.st_size < position )
+        return 0;
+    return status.st_size - position;
+}
+
+/*!     \brief  Open a sweep archive
+ *
+ * Open an archive to read its sweeps in order with sweepArchiveNext()
+ *
+ * \ingroup archive
+ *
+ * \param sPath     path of the archive
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the reader (free with sweepArchiveReaderFree), or NULL on error
+ */
+tArchiveReader *
+sweepArchiveOpen( const gchar *sPath, GError **ppError ) {
+    tArchiveReader *pReader;
+    tArchiveHeader header;
+    FILE *pFile;
+
+    if( (pFile = g_fopen( sPath, "rb" )) == NULL ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ), "%s: %s", sPath, g_strerror( errno ) );
+        return NULL;
+    }
+    if( fread( &header, sizeof( header ), 1, pFile ) != 1
+            || memcmp( header.magic, ARCHIVE_MAGIC, sizeof( header.magic ) ) != 0
+            || header.version != ARCHIVE_VERSION || header.byteOrder != ARCHIVE_BYTE_ORDER
+            || !(header.resolution > 0.0) ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorFormat, "%s: not a sweep archive", sPath );
+        fclose( pFile );
+        return NULL;
+    }
+    if( header.nFreq > G_MAXINT / 2 || (guint64)header.nFreq * sizeof( gdouble ) > bytesLeft( pFile ) ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "%s: the frequency axis is incomplete", sPath );
+        fclose( pFile );
+        return NULL;
+    }
+
+    pReader = g_new0( tArchiveReader, 1 );
+    pReader->pFile = pFile;
+    pReader->sPath = g_strdup( sPath );
+    pReader->resolution = header.resolution;
+    pReader->nFreq = header.nFreq;
+    pReader->nFreqAllocated = header.nFreq;
+    pReader->pFreq = g_aligned_alloc( MAX( header.nFreq, 1 ), sizeof( gdouble ), TRACE_ALIGNMENT );
+    if( fread( pReader->pFreq, sizeof( gdouble ), header.nFreq, pFile ) != header.nFreq ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "%s: the frequency axis is incomplete", sPath );
+        sweepArchiveReaderFree( pReader );
+        return NULL;
+    }
+
+    // the arrays are the reader's; the frequency axis is lent to the trace
+    pReader->pTrace = g_new0( tSmithTrace, 1 );
+    pReader->pTrace->flags.bSharedFreq = TRUE;
+
+    return pReader;
+}
+
+/*!     \brief  Read the next sweep of an archive
+ *
+ * Read and decode the next sweep of an archive. The frequency is that of the
+ * archive, or the point number beyond its axis.
+ *
+ * \ingroup archive
+ *
+ * \param pReader       pointer to the reader
+ * \param pTimestamp    where the time of the sweep is written (or NULL)
+ * \param ppError       where an error is reported (or NULL)
+ * \return              the sweep (owned by the reader, valid until the next call), or NULL at the end or on error
+ */
+const tSmithTrace *
+sweepArchiveNext( tArchiveReader *pReader, gint64 *pTimestamp, GError **ppError ) {
+    tFrameHeader frame;
+    tArchiveJob job = { 0 };
+    tSmithTrace *pTrace = pReader->pTrace;
+    gsize *pOffsets, total = 0;
+    gint32 *pSwap;
+    gint n;
+
+    if( fread( &frame, sizeof( frame ), 1, pReader->pFile ) != 1 )
+        return NULL;        // the end
+    n = frame.nPoints;
+    if( frame.magic != FRAME_MAGIC || n > G_MAXINT / 2
+            || frame.nChunks != (frame.nPoints + ARCHIVE_CHUNK_POINTS - 1) / ARCHIVE_CHUNK_POINTS
+            || (!(frame.flags & FRAME_KEY) && n != pReader->nPrevious) ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "%s: the archive is damaged", pReader->sPath );
+        return NULL;
+    }
+    // the sizes in the file are checked against it before anything is allocated (every value takes a bit at least)
+    if( (guint64)frame.nChunks * sizeof( guint32 ) + ((guint64)n + 3) / 4 > bytesLeft( pReader->pFile ) ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "%s: the last sweep is incomplete", pReader->sPath );
+        return NULL;
+    }
+
+    if( (gint)frame.nChunks > pReader->nChunkBytes ) {
+        pReader->pChunkBytes = g_renew( guint32, pReader->pChunkBytes, frame.nChunks );
+        pReader->nChunkBytes = frame.nChunks;
+    }
+    if( fread( pReader->pChunkBytes, sizeof( guint32 ), frame.nChunks, pReader->pFile ) != frame.nChunks ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "%s: the last sweep is incomplete", pReader->sPath );
+        return NULL;
+    }
+    pOffsets = g_new( gsize, frame.nChunks + 1 );
+    for( guint c = 0; c < frame.nChunks; c++ ) {
+        pOffsets[c] = total;
+        total += pReader->pChunkBytes[c];
+    }
+    pOffsets[ frame.nChunks ] = total;
+
+    if( total > bytesLeft( pReader->pFile ) ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "%s: the last sweep is incomplete", pReader->sPath );
+        g_free( pOffsets );
+        return NULL;
+    }
+    if( total > pReader->dataAllocated ) {
+        pReader->pData = g_realloc( pReader->pData, total );
+        pReader->dataAllocated = total;
+    }
+    if( fread( pReader->pData, 1, total, pReader->pFile ) != total ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "%s: the last sweep is incomplete", pReader->sPath );
+        g_free( pOffsets );
+        return NULL;
+    }
+
+    // the trace arrays, with the frequency axis (extended with point numbers) lent to it
+    growQuanta( &pReader->pU, &pReader->pV, &pReader->pPreviousU, &pReader->pPreviousV, &pReader->nAllocated, n );
+    if( n > pReader->nFreqAllocated ) {
+        gdouble *pFreq = g_aligned_alloc( n, sizeof( gdouble ), TRACE_ALIGNMENT );
+
+        memcpy( pFreq, pReader->pFreq, pReader->nFreq * sizeof( gdouble ) );
+        for( gint i = pReader->nFreq; i < n; i++ )
+            pFreq[i] = i;
+        g_aligned_free( pReader->pFreq );
+        pReader->pFreq = pFreq;
+        pReader->nFreqAllocated = n;
+    }
+    pTrace->pFreq = NULL;
+    smithTraceReserve( pTrace, n );
+    pTrace->pFreq = pReader->pFreq;
+    pTrace->nPoints = n;
+
+    job.nPoints = n;
+    job.bKey = (frame.flags & FRAME_KEY) != 0;
+    job.pPreviousU = pReader->pPreviousU;
+    job.pPreviousV = pReader->pPreviousV;
+    job.pDecodedU = pReader->pU;
+    job.pDecodedV = pReader->pV;
+    job.pData = pReader->pData;
+    job.pOffsets = pOffsets;
+    job.resolution = pReader->resolution;
+    job.pTrace = pTrace;
+    smithParallelFor( frame.nChunks, 1, decodeChunks, &job );
+    g_free( pOffsets );
+
+    if( job.bDamaged ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "%s: the archive is damaged", pReader->sPath );
+        pReader->nPrevious = -1;
+        return NULL;
+    }
+
+    pSwap = pReader->pPreviousU; pReader->pPreviousU = pReader->pU; pReader->pU = pSwap;
+    pSwap = pReader->pPreviousV; pReader->pPreviousV = pReader->pV; pReader->pV = pSwap;
+    pReader->nPrevious = n;
+
+    if( pTimestamp )
+        *pTimestamp = frame.timestamp;
+    return pTrace;
+}
+
+/*!     \brief  Resolution of an archive
+ *
+ * Quantization of gamma in an archive (the error of each value is at most half of it)
+ *
+ * \ingroup archive
+ *
+ * \param pReader   pointer to the reader
+ * \return          resolution
+ */
+gdouble
+sweepArchiveResolution( tArchiveReader *pReader ) {
+    return pReader->resolution;
+}
+
+/*!     \brief  Close an archive being read
+ *
+ * Close an archive and free the reader (and its trace)
+ *
+ * \ingroup archive
+ *
+ * \param pReader   pointer to the reader
+ */
+void
+sweepArchiveReaderFree( tArchiveReader *pReader ) {
+    if( pReader == NULL )
+        return;
+
+    fclose( pReader->pFile );
+    smithTraceFree( pReader->pTrace );
+    g_aligned_free( pReader->pFreq );
+    g_free( pReader->pU );
+    g_free( pReader->pV );
+    g_free( pReader->pPreviousU );
+    g_free( pReader->pPreviousV );
+    g_free( pReader->pChunkBytes );
+    g_free( pReader->pData );
+    g_free( pReader->sPath );
+    g_free( pReader );
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHARCHIVE_H_
+#define GTKSMITHARCHIVE_H_
+
+#include "GTKsmithChart.h"
+
+typedef struct sArchiveWriter tArchiveWriter;
+typedef struct sArchiveReader tArchiveReader;
+
+// Quantization of gamma unless another is given
+#define ARCHIVE_RESOLUTION      1.0e-6
+// Finest quantization allowed, so that gamma up to 2 in magnitude (an active device) can be coded
+#define ARCHIVE_MIN_RESOLUTION  (2.0 / ((1 << 30) - 1))
+// A sweep coded without reference to the previous one every so many sweeps
+#define ARCHIVE_KEY_INTERVAL    256
+// Points in each part of a sweep coded (and decoded in parallel) separately
+#define ARCHIVE_CHUNK_POINTS    4096
+
+tArchiveWriter *sweepArchiveCreate( const gchar *, gdouble, const gdouble *, gint, GError ** );
+gboolean sweepArchiveAppend( tArchiveWriter *, const tSmithTrace *, gint64, GError ** );
+gboolean sweepArchiveClose( tArchiveWriter *, GError ** );
+tArchiveReader *sweepArchiveOpen( const gchar *, GError ** );
+const tSmithTrace *sweepArchiveNext( tArchiveReader *, gint64 *, GError ** );
+gdouble sweepArchiveResolution( tArchiveReader * );
+void sweepArchiveReaderFree( tArchiveReader * );
+
+#endif /* GTKSMITHARCHIVE_H_ */
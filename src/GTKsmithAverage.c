@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithAverage.c
+ * @brief Averaging and hold of sweeps
+ *
+ * @author Michael G. Katzmann
+ *
+ * Each sweep is combined point by point with the result of the previous
+ * sweeps, which is kept in a trace that can be drawn directly.
+ * All buffers are allocated when the averager is created; adding a sweep
+ * only runs a loop over the aligned U and V arrays that the compiler vectorizes.
+ *
+ * The moving average keeps the last N sweeps in a ring and a running sum.
+ * The sum is recalculated from the ring each time the ring wraps so that
+ * rounding errors do not accumulate.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GTKsmithAverage.h"
+#include "GTKsmithTrace.h"
+
+struct sSweepAverage {
+    tAverageMode mode;
+    gint         nPoints;
+    gint         nSweeps;       // N
+    gint         count;         // sweeps added since reset
+    tSmithTrace *pResult;
+
+    gdouble     *pSumU, *pSumV; // moving average
+    gdouble     *pRingU, *pRingV;
+    gint         ringNext;
+    gdouble     *pMagSqu;       // hold: |gamma|^2 of the held points
+};
+
+/*!     \brief  Allocate an aligned array
+ *
+ * Allocate an aligned array
+ *
+ * \ingroup average
+ *
+ * \param n         number of values
+ * \return          the array
+ */
+static gdouble *
+alignedArray( gsize n ) {
+    return g_aligned_alloc0( n, sizeof( gdouble ), TRACE_ALIGNMENT );
+}
+
+/*!     \brief  Create an averager
+ *
+ * Create an averager for sweeps of a fixed number of points
+ *
+ * \ingroup average
+ *
+ * \param mode      averaging or hold mode
+ * \param nPoints   number of points in each sweep
+ * \param nSweeps   number of sweeps averaged (ignored by the hold modes)
+ * \return          pointer to the averager (free with sweepAverageFree)
+ */
+tSweepAverage *
+sweepAverageNew( tAverageMode mode, gint nPoints, gint nSweeps ) {
+    tSweepAverage *pAverage = g_new0( tSweepAverage, 1 );
+
+    pAverage->mode = mode;
+    pAverage->nPoints = MAX( nPoints, 1 );
+    pAverage->nSweeps = MAX( nSweeps, 1 );
+    pAverage->pResult = smithTraceNew( pAverage->nPoints, TRUE );
+
+    switch( mode ) {
+    case eAverageMoving:
+        pAverage->pSumU = alignedArray( pAverage->nPoints );
+        pAverage->pSumV = alignedArray( pAverage->nPoints );
+        pAverage->pRingU = alignedArray( (gsize)pAverage->nPoints * pAverage->nSweeps );
+        pAverage->pRingV = alignedArray( (gsize)pAverage->nPoints * pAverage->nSweeps );
+        break;
+    case eHoldMinGamma:
+    case eHoldMaxGamma:
+        pAverage->pMagSqu = alignedArray( pAverage->nPoints );
+        break;
+    default:
+        break;
+    }
+
+    return pAverage;
+}
+
+/*!     \brief  Free an averager
+ *
+ * Free an averager (and its result trace)
+ *
+ * \ingroup average
+ *
+ * \param pAverage  pointer to the averager
+ */
+void
+sweepAverageFree( tSweepAverage *pAverage ) {
+    if( pAverage == NULL )
+        return;
+
+    smithTraceFree( pAverage->pResult );
+    g_aligned_free( pAverage->pSumU );
+    g_aligned_free( pAverage->pSumV );
+    g_aligned_free( pAverage->pRingU );
+    g_aligned_free( pAverage->pRingV );
+    g_aligned_free( pAverage->pMagSqu );
+    g_free( pAverage );
+}
+
+/*!     \brief  Restart the average
+ *
+ * Discard the sweeps added so far
+ *
+ * \ingroup average
+ *
+ * \param pAverage  pointer to the averager
+ */
+void
+sweepAverageReset( tSweepAverage *pAverage ) {
+    pAverage->count = 0;
+    pAverage->ringNext = 0;
+    pAverage->pResult->nPoints = 0;
+}
+
+/*!     \brief  Exponential average kernel
+ *
+ * avg += weight * (new - avg)
+ *
+ * \ingroup average
+ *
+ * \param pAvgU     average U (updated in place)
+ * \param pAvgV     average V (updated in place)
+ * \param pU        new sweep U
+ * \param pV        new sweep V
+ * \param n         number of points
+ * \param weight    weight of the new sweep
+ */
+static void
+exponentialKernel( gdouble *restrict pAvgU, gdouble *restrict pAvgV,
+        const gdouble *restrict pU, const gdouble *restrict pV, gint n, gdouble weight ) {
+    for( gint i = 0; i < n; i++ ) {
+        pAvgU[i] += weight * (pU[i] - pAvgU[i]);
+        pAvgV[i] += weight * (pV[i] - pAvgV[i]);
+    }
+}
+
+/*!     \brief  Moving average kernel
+ *
+ * Replace the oldest sweep in the running sum and ring by the new sweep
+ * and write the mean
+ *
+ * \ingroup average
+ *
+ * \param pSum      running sum (updated in place)
+ * \param pOldest   oldest sweep in the ring (replaced by the new sweep)
+ * \param pNew      new sweep
+ * \param pMean     mean (written)
+ * \param n         number of points
+ * \param scale     1 / number of sweeps in the sum
+ */
+static void
+movingKernel( gdouble *restrict pSum, gdouble *restrict pOldest, const gdouble *restrict pNew,
+        gdouble *restrict pMean, gint n, gdouble scale ) {
+    for( gint i = 0; i < n; i++ ) {
+        pSum[i] += pNew[i] - pOldest[i];
+        pOldest[i] = pNew[i];
+        pMean[i] = pSum[i] * scale;
+    }
+}
+
+/*!     \brief  Accumulate kernel
+ *
+ * sum += values
+ *
+ * \ingroup average
+ *
+ * \param pSum      sum (updated in place)
+ * \param pValues   values to add
+ * \param n         number of points
+ */
+static void
+accumulateKernel( gdouble *restrict pSum, const gdouble *restrict pValues, gint n ) {
+    for( gint i = 0; i < n; i++ )
+        pSum[i] += pValues[i];
+}
+
+/*!     \brief  Hold kernel
+ *
+ * Keep the point with the smaller (or larger) |gamma|
+ *
+ * \ingroup average
+ *
+ * \param pHoldU    held U (updated in place)
+ * \param pHoldV    held V (updated in place)
+ * \param pMagSqu   |gamma|^2 of the held points (updated in place)
+ * \param pU        new sweep U
+ * \param pV        new sweep V
+ * \param n         number of points
+ * \param sign      +1 to hold the minimum, -1 to hold the maximum
+ */
+static void
+holdKernel( gdouble *restrict pHoldU, gdouble *restrict pHoldV, gdouble *restrict pMagSqu,
+        const gdouble *restrict pU, const gdouble *restrict pV, gint n, gdouble sign ) {
+    for( gint i = 0; i < n; i++ ) {
+        gdouble magSqu = pU[i] * pU[i] + pV[i] * pV[i];
+        gboolean bReplace = sign * magSqu < sign * pMagSqu[i];
+
+        // selects rather than branches so that the loop vectorizes
+        pHoldU[i] = bReplace ? pU[i] : pHoldU[i];
+        pHoldV[i] = bReplace ? pV[i] : pHoldV[i];
+        pMagSqu[i] = bReplace ? magSqu : pMagSqu[i];
+    }
+}
+
+/*!     \brief  Add a sweep
+ *
+ * Combine a sweep with the previous sweeps. The result trace is
+ * updated in place.
+ *
+ * \ingroup average
+ *
+ * \param pAverage  pointer to the averager
+ * \param pSweep    pointer to the new sweep
+ * \return          FALSE if the sweep does not have the number of points of the averager
+ */
+gboolean
+sweepAverageAdd( tSweepAverage *pAverage, const tSmithTrace *pSweep ) {
+    tSmithTrace *pResult = pAverage->pResult;
+    gint n = pAverage->nPoints;
+
+    if( pSweep->nPoints != n )
+        return FALSE;
+
+    if( pSweep->pFreq )
+        memcpy( pResult->pFreq, pSweep->pFreq, n * sizeof( gdouble ) );
+    else if( pAverage->count == 0 )
+        memset( pResult->pFreq, 0, n * sizeof( gdouble ) );
+
+    if( pAverage->count == 0 ) {
+        memcpy( pResult->pU, pSweep->pU, n * sizeof( gdouble ) );
+        memcpy( pResult->pV, pSweep->pV, n * sizeof( gdouble ) );
+        pResult->nPoints = n;
+    }
+
+    switch( pAverage->mode ) {
+    case eAverageExponential:
+        // the first sweeps are weighted equally until there are N of them
+        if( pAverage->count > 0 )
+            exponentialKernel( pResult->pU, pResult->pV, pSweep->pU, pSweep->pV, n,
+                    1.0 / MIN( pAverage->count + 1, pAverage->nSweeps ) );
+        break;
+
+    case eAverageMoving: {
+        gdouble *pOldestU = pAverage->pRingU + (gsize)pAverage->ringNext * n;
+        gdouble *pOldestV = pAverage->pRingV + (gsize)pAverage->ringNext * n;
+        gint nInSum = MIN( pAverage->count + 1, pAverage->nSweeps );
+
+        // an unused ring slot contributes nothing to the sum
+        if( pAverage->count < pAverage->nSweeps ) {
+            memset( pOldestU, 0, n * sizeof( gdouble ) );
+            memset( pOldestV, 0, n * sizeof( gdouble ) );
+        }
+        if( pAverage->count == 0 ) {
+            memset( pAverage->pSumU, 0, n * sizeof( gdouble ) );
+            memset( pAverage->pSumV, 0, n * sizeof( gdouble ) );
+        }
+        movingKernel( pAverage->pSumU, pOldestU, pSweep->pU, pResult->pU, n, 1.0 / nInSum );
+        movingKernel( pAverage->pSumV, pOldestV, pSweep->pV, pResult->pV, n, 1.0 / nInSum );
+
+        if( ++pAverage->ringNext == pAverage->nSweeps ) {
+            pAverage->ringNext = 0;
+            // resynchronize the running sum with the ring
+            memcpy( pAverage->pSumU, pAverage->pRingU, n * sizeof( gdouble ) );
+            memcpy( pAverage->pSumV, pAverage->pRingV, n * sizeof( gdouble ) );
+            for( gint sweep = 1; sweep < pAverage->nSweeps; sweep++ ) {
+                accumulateKernel( pAverage->pSumU, pAverage->pRingU + (gsize)sweep * n, n );
+                accumulateKernel( pAverage->pSumV, pAverage->pRingV + (gsize)sweep * n, n );
+            }
+        }
+        break;
+    }
+
+    case eHoldMinGamma:
+    case eHoldMaxGamma:
+        if( pAverage->count == 0 ) {
+            for( gint i = 0; i < n; i++ )
+                pAverage->pMagSqu[i] = pSweep->pU[i] * pSweep->pU[i] + pSweep->pV[i] * pSweep->pV[i];
+        } else {
+            holdKernel( pResult->pU, pResult->pV, pAverage->pMagSqu, pSweep->pU, pSweep->pV, n,
+                    pAverage->mode == eHoldMinGamma ? 1.0 : -1.0 );
+        }
+        break;
+    }
+
+    pAverage->count++;
+    return TRUE;
+}
+
+/*!     \brief  The result of the average
+ *
+ * The trace holding the average (or held points). It is owned by the averager
+ * and is updated by each sweepAverageAdd(); draw it with drawTraceOnSmithChart().
+ *
+ * \ingroup average
+ *
+ * \param pAverage  pointer to the averager
+ * \return          pointer to the result trace (no points before the first sweep)
+ */
+const tSmithTrace *
+sweepAverageTrace( tSweepAverage *pAverage ) {
+    return pAverage->pResult;
+}
+
+/*!     \brief  Number of sweeps added
+ *
+ * Number of sweeps added since the averager was created or reset
+ *
+ * \ingroup average
+ *
+ * \param pAverage  pointer to the averager
+ * \return          number of sweeps
+ */
+gint
+sweepAverageCount( tSweepAverage *pAverage ) {
+    return pAverage->count;
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHAVERAGE_H_
+#define GTKSMITHAVERAGE_H_
+
+#include "GTKsmithChart.h"
+
+typedef enum {
+    eAverageExponential,    // exponential average (weight 1/N once N sweeps are in)
+    eAverageMoving,         // mean of the last N sweeps
+    eHoldMinGamma,          // point with the smallest |gamma| seen
+    eHoldMaxGamma           // point with the largest |gamma| seen
+} tAverageMode;
+
+typedef struct sSweepAverage tSweepAverage;
+
+tSweepAverage *sweepAverageNew( tAverageMode, gint, gint );
+void sweepAverageFree( tSweepAverage * );
+void sweepAverageReset( tSweepAverage * );
+gboolean sweepAverageAdd( tSweepAverage *, const tSmithTrace * );
+const tSmithTrace *sweepAverageTrace( tSweepAverage * );
+gint sweepAverageCount( tSweepAverage * );
+
+#endif /* GTKSMITHAVERAGE_H_ */
@@ -0,0 +1,428 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithCache.c
+ * @brief Binary cache files of networks
+ *
+ * @author Michael G. Katzmann
+ *
+ * A network is saved in a binary file that can be memory mapped and used
+ * without any conversion: a 128 byte header followed by the frequency axis,
+ * the real and imaginary arrays of each parameter (row major) and the noise
+ * parameters, each array starting on a 64 byte boundary (TRACE_ALIGNMENT).
+ * Values are in the byte order of the machine that wrote the file; a file
+ * from a machine of the other byte order is treated as invalid.
+ *
+ * The header records the modification time (to the nanosecond) and size of
+ * the source file, so that a cache older than its source is detected, even
+ * if the source was rewritten within the same second, and a checksum of the data.
+ * The checksum is of 1 MiB blocks (verified in parallel) combined in order.
+ *
+ * A cache is written to a temporary file of a unique name beside it that is
+ * renamed when complete, so a reader never sees a partial cache and writers
+ * of the same cache do not write into each other's temporary file.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <glib/gstdio.h>
+#include "GTKsmithCache.h"
+#include "GTKsmithTrace.h"
+#include "GTKsmithTouchstone.h"
+#include "GTKsmithParse.h"
+#include "GTKsmithParallel.h"
+
+#define CACHE_MAGIC         "SMITHNC1"
+#define CACHE_VERSION       2
+#define CACHE_BYTE_ORDER    0x01020304
+#define CACHE_BLOCK         (1 << 20)
+#define CACHE_PRIME         0x9E3779B97F4A7C15ULL
+
+typedef struct {
+    gchar   magic[8];
+    guint32 version;
+    guint32 byteOrder;
+    guint32 nPorts;
+    guint32 type;
+    gdouble Z0;
+    guint64 nPoints;
+    guint64 nNoise;
+    gint64  sourceMtime;        // seconds
+    gint64  sourceMtimeNsec;    // and nanoseconds
+    guint64 sourceSize;
+    guint64 dataOffset;
+    guint64 dataLength;
+    guint64 checksum;
+    guint8  reserved[32];
+} tCacheHeader;
+
+G_STATIC_ASSERT( sizeof( tCacheHeader ) == 128 );
+
+typedef struct {
+    FILE    *pFile;
+    guint8  *pBuffer;           // one checksum block
+    gsize    fill;
+    guint64  checksum;
+    gboolean bError;
+} tCacheWriter;
+
+/*!     \brief  Bytes of an array in the cache
+ *
+ * Bytes of an array in the cache (rounded up to the alignment)
+ *
+ * \ingroup cache
+ *
+ * \param bytes     bytes of data
+ * \return          bytes occupied
+ */
+static inline guint64
+alignedBytes( guint64 bytes ) {
+    return (bytes + TRACE_ALIGNMENT - 1) / TRACE_ALIGNMENT * TRACE_ALIGNMENT;
+}
+
+/*!     \brief  Checksum of a block
+ *
+ * Checksum of a block of 64 bit words (four independent lanes, combined)
+ *
+ * \ingroup cache
+ *
+ * \param pWords    the words
+ * \param nWords    number of words
+ * \return          checksum of the block
+ */
+static guint64
+blockChecksum( const guint64 *pWords, gsize nWords ) {
+    guint64 lane[4] = { CACHE_PRIME, CACHE_PRIME * 3, CACHE_PRIME * 5, CACHE_PRIME * 7 };
+    guint64 sum = nWords;
+    gsize i;
+
+    for( i = 0; i + 4 <= nWords; i += 4 ) {
+        for( gint k = 0; k < 4; k++ ) {
+            lane[k] = (lane[k] ^ pWords[ i + k ]) * CACHE_PRIME;
+            lane[k] ^= lane[k] >> 32;
+        }
+    }
+    for( ; i < nWords; i++ ) {
+        lane[0] = (lane[0] ^ pWords[i]) * CACHE_PRIME;
+        lane[0] ^= lane[0] >> 32;
+    }
+    for( gint k = 0; k < 4; k++ ) {
+        sum = (sum ^ lane[k]) * CACHE_PRIME;
+        sum ^= sum >> 29;
+    }
+    return sum;
+}
+
+/*!     \brief  Combine the checksum of a block
+ *
+ * Combine the checksum of the next block into the checksum of the data
+ *
+ * \ingroup cache
+ *
+ * \param checksum  checksum of the blocks so far
+ * \param block     checksum of the next block
+ * \return          the combined checksum
+ */
+static inline guint64
+combineChecksum( guint64 checksum, guint64 block ) {
+    checksum = (checksum ^ block) * CACHE_PRIME;
+    return checksum ^ (checksum >> 31);
+}
+
+/*!     \brief  Write the buffered block
+ *
+ * Write the buffered data to the file and add it to the checksum
+ *
+ * \ingroup cache
+ *
+ * \param pWriter   pointer to the writer
+ */
+static void
+writerFlush( tCacheWriter *pWriter ) {
+    if( pWriter->fill == 0 )
+        return;
+
+    pWriter->checksum = combineChecksum( pWriter->checksum,
+            blockChecksum( (const guint64 *)pWriter->pBuffer, pWriter->fill / sizeof( guint64 ) ) );
+    if( fwrite( pWriter->pBuffer, 1, pWriter->fill, pWriter->pFile ) != pWriter->fill )
+        pWriter->bError = TRUE;
+    pWriter->fill = 0;
+}
+
+/*!     \brief  Write an array
+ *
+ * Write an array to the data of the cache, padded to the alignment
+ *
+ * \ingroup cache
+ *
+ * \param pWriter   pointer to the writer
+ * \param pData     the array
+ * \param bytes     bytes of the array
+ */
+static void
+writerArray( tCacheWriter *pWriter, gconstpointer pData, guint64 bytes ) {
+    const guint8 *p = pData;
+    guint64 padded = alignedBytes( bytes );
+
+    for( guint64 written = 0; written < padded; ) {
+        gsize n = MIN( CACHE_BLOCK - pWriter->fill, padded - written );
+
+        if( written < bytes ) {
+            n = MIN( n, bytes - written );
+            memcpy( pWriter->pBuffer + pWriter->fill, p + written, n );
+        } else {
+            memset( pWriter->pBuffer + pWriter->fill, 0, n );
+        }
+        pWriter->fill += n;
+        written += n;
+        if( pWriter->fill == CACHE_BLOCK )
+            writerFlush( pWriter );
+    }
+}
+
+/*!     \brief  Write a network to a cache file
+ *
+ * Write a network to a cache file. Parameters not yet decoded are decoded first;
+ * if one cannot be, nothing is written.
+ *
+ * \ingroup cache
+ *
+ * \param pNetwork      pointer to the network
+ * \param sCachePath    path of the cache file
+ * \param pSource       status of the file the network was loaded from, taken before it
+ *                      was read, so that a change while it was read is detected (or NULL)
+ * \param ppError       where an error is reported (or NULL)
+ * \return              TRUE if the cache was written
+ */
+gboolean
+sweepCacheWrite( const tSmithNetwork *pNetwork, const gchar *sCachePath, const GStatBuf *pSource,
+        GError **ppError ) {
+    tCacheHeader header = { CACHE_MAGIC, CACHE_VERSION, CACHE_BYTE_ORDER,
+                            pNetwork->nPorts, pNetwork->type, pNetwork->Z0,
+                            pNetwork->nPoints, pNetwork->nNoise };
+    gint nParameters = pNetwork->nPorts * pNetwork->nPorts;
+    tCacheWriter writer = { NULL };
+    tSmithTrace **pParameters;
+    gchar *sTemporary;
+    gboolean bOK;
+    gint fd;
+
+    // (a parameter not decoded when the network was loaded is decoded now)
+    pParameters = g_new( tSmithTrace *, nParameters );
+    for( gint i = 0; i < nParameters; i++ ) {
+        gint row = i / pNetwork->nPorts + 1, column = i % pNetwork->nPorts + 1;
+
+        if( (pParameters[i] = smithNetworkParameter( pNetwork, row, column )) == NULL ) {
+            g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData,
+                         "%s: parameter (%d, %d) cannot be decoded", sCachePath, row, column );
+            g_free( pParameters );
+            return FALSE;
+        }
+    }
+
+    if( pSource ) {
+        header.sourceMtime = pSource->st_mtim.tv_sec;
+        header.sourceMtimeNsec = pSource->st_mtim.tv_nsec;
+        header.sourceSize = pSource->st_size;
+    }
+    header.dataOffset = sizeof( tCacheHeader );
+
+    // (in the same directory, so that it can be renamed over the cache)
+    sTemporary = g_strconcat( sCachePath, ".XXXXXX", NULL );
+    if( (fd = g_mkstemp_full( sTemporary, O_RDWR, 0666 )) < 0 || (writer.pFile = fdopen( fd, "wb" )) == NULL ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ),
+                     "%s: %s", sTemporary, g_strerror( errno ) );
+        if( fd >= 0 ) {
+            g_close( fd, NULL );
+            g_unlink( sTemporary );
+        }
+        g_free( sTemporary );
+        g_free( pParameters );
+        return FALSE;
+    }
+    writer.pBuffer = g_malloc( CACHE_BLOCK );
+
+    // the header is written again, complete, at the end
+    writer.bError = fwrite( &header, sizeof( header ), 1, writer.pFile ) != 1;
+    writerArray( &writer, pNetwork->pFreq, pNetwork->nPoints * sizeof( gdouble ) );
+    for( gint i = 0; i < nParameters; i++ ) {
+        writerArray( &writer, pParameters[i]->pU, pNetwork->nPoints * sizeof( gdouble ) );
+        writerArray( &writer, pParameters[i]->pV, pNetwork->nPoints * sizeof( gdouble ) );
+    }
+    writerArray( &writer, pNetwork->pNoise, pNetwork->nNoise * sizeof( tNoiseParameters ) );
+    writerFlush( &writer );
+
+    header.dataLength = (guint64)ftell( writer.pFile ) - header.dataOffset;
+    header.checksum = writer.checksum;
+    if( fseek( writer.pFile, 0, SEEK_SET ) != 0 || fwrite( &header, sizeof( header ), 1, writer.pFile ) != 1 )
+        writer.bError = TRUE;
+    if( fclose( writer.pFile ) != 0 )
+        writer.bError = TRUE;
+
+    bOK = !writer.bError && g_rename( sTemporary, sCachePath ) == 0;
+    if( !bOK ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ),
+                     "%s: %s", sCachePath, g_strerror( errno ) );
+        g_unlink( sTemporary );
+    }
+
+    g_free( writer.pBuffer );
+    g_free( sTemporary );
+    g_free( pParameters );
+    return bOK;
+}
+
+typedef struct {
+    const guint8 *pData;
+    guint64       length;
+    guint64      *pBlockSums;
+} tCacheVerify;
+
+static void
+checksumBlocks( gint from, gint to, gpointer userData ) {
+    tCacheVerify *pVerify = userData;
+
+    for( gint b = from; b < to; b++ ) {
+        guint64 start = (guint64)b * CACHE_BLOCK;
+
+        pVerify->pBlockSums[b] = blockChecksum( (const guint64 *)(pVerify->pData + start),
+                MIN( CACHE_BLOCK, pVerify->length - start ) / sizeof( guint64 ) );
+    }
+}
+
+/*!     \brief  Open a cache file
+ *
+ * Map a cache file and use its arrays directly as a network (read only)
+ *
+ * \ingroup cache
+ *
+ * \param sCachePath    path of the cache file
+ * \param sSourcePath   path of the file the network was loaded from, whose size and
+ *                      modification time must match those recorded (or NULL)
+ * \param bVerify       verify the checksum of the data
+ * \param ppError       where an error is reported (or NULL)
+ * \return              pointer to the network (free with smithNetworkFree), or NULL if
+ *                      the cache is missing, invalid or stale
+ */
+tSmithNetwork *
+sweepCacheOpen( const gchar *sCachePath, const gchar *sSourcePath, gboolean bVerify, GError **ppError ) {
+    GMappedFile *pMapping = g_mapped_file_new( sCachePath, FALSE, ppError );
+    const tCacheHeader *pHeader;
+    const guint8 *pData;
+    tSmithNetwork *pNetwork;
+    guint64 arrayBytes, length;
+    const gchar *sProblem = NULL;
+    GStatBuf status;
+
+    if( pMapping == NULL )
+        return NULL;
+
+    pHeader = (const tCacheHeader *)g_mapped_file_get_contents( pMapping );
+    length = g_mapped_file_get_length( pMapping );
+    arrayBytes = ( length >= sizeof( tCacheHeader ) ) ? alignedBytes( pHeader->nPoints * sizeof( gdouble ) ) : 0;
+
+    if( length < sizeof( tCacheHeader ) || memcmp( pHeader->magic, CACHE_MAGIC, 8 ) != 0
+            || pHeader->version != CACHE_VERSION || pHeader->byteOrder != CACHE_BYTE_ORDER )
+        sProblem = "not a cache file of this version and byte order";
+    else if( pHeader->nPorts < 1 || pHeader->nPorts > 99 || pHeader->nPoints > G_MAXINT
+            || pHeader->nNoise > G_MAXINT || pHeader->dataOffset % TRACE_ALIGNMENT != 0
+            || pHeader->dataLength != arrayBytes * (1 + 2 * pHeader->nPorts * pHeader->nPorts)
+                                      + alignedBytes( pHeader->nNoise * sizeof( tNoiseParameters ) )
+            || pHeader->dataOffset + pHeader->dataLength != length )
+        sProblem = "the cache is truncated or corrupt";
+    else if( sSourcePath && (g_stat( sSourcePath, &status ) != 0 || status.st_mtim.tv_sec != pHeader->sourceMtime
+                             || status.st_mtim.tv_nsec != pHeader->sourceMtimeNsec
+                             || (guint64)status.st_size != pHeader->sourceSize) )
+        sProblem = "the cache is out of date";
+
+    pData = (const guint8 *)pHeader + ( sProblem ? 0 : pHeader->dataOffset );
+    if( sProblem == NULL && bVerify ) {
+        gint nBlocks = (pHeader->dataLength + CACHE_BLOCK - 1) / CACHE_BLOCK;
+        tCacheVerify verify = { pData, pHeader->dataLength, g_new( guint64, nBlocks ) };
+        guint64 checksum = 0;
+
+        smithParallelFor( nBlocks, 1, checksumBlocks, &verify );
+        for( gint b = 0; b < nBlocks; b++ )
+            checksum = combineChecksum( checksum, verify.pBlockSums[b] );
+        g_free( verify.pBlockSums );
+        if( checksum != pHeader->checksum )
+            sProblem = "the checksum of the cache is wrong";
+    }
+    if( sProblem ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "%s: %s", sCachePath, sProblem );
+        g_mapped_file_unref( pMapping );
+        return NULL;
+    }
+
+    pNetwork = g_new0( tSmithNetwork, 1 );
+    pNetwork->nPorts = pHeader->nPorts;
+    pNetwork->type = pHeader->type;
+    pNetwork->Z0 = pHeader->Z0;
+    pNetwork->nPoints = pHeader->nPoints;
+    pNetwork->pFreq = (gdouble *)pData;
+    pNetwork->pParameters = g_new( tSmithTrace *, pNetwork->nPorts * pNetwork->nPorts );
+    for( gint i = 0; i < pNetwork->nPorts * pNetwork->nPorts; i++ ) {
+        tSmithTrace *pTrace = g_new0( tSmithTrace, 1 );
+
+        pTrace->flags.bBorrowed = TRUE;
+        pTrace->flags.bSharedFreq = TRUE;
+        pTrace->nPoints = pTrace->nAllocated = pNetwork->nPoints;
+        pTrace->pFreq = pNetwork->pFreq;
+        pTrace->pU = (gdouble *)(pData + arrayBytes * (1 + 2 * i));
+        pTrace->pV = (gdouble *)(pData + arrayBytes * (2 + 2 * i));
+        pNetwork->pParameters[i] = pTrace;
+    }
+    pNetwork->nNoise = pHeader->nNoise;
+    if( pNetwork->nNoise )
+        pNetwork->pNoise = (tNoiseParameters *)(pData + arrayBytes * (1 + 2 * pNetwork->nPorts * pNetwork->nPorts));
+    pNetwork->pMapping = pMapping;
+
+    return pNetwork;
+}
+
+/*!     \brief  Load a Touchstone file through its cache
+ *
+ * Open the cache of a Touchstone file if it is up to date, otherwise load the
+ * file and (re)write its cache (a cache that cannot be written is not an error)
+ *
+ * \ingroup cache
+ *
+ * \param sPath     path of the Touchstone file
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the network (free with smithNetworkFree), or NULL on error
+ */
+tSmithNetwork *
+touchstoneLoadCached( const gchar *sPath, GError **ppError ) {
+    gchar *sCachePath = g_strconcat( sPath, SWEEP_CACHE_SUFFIX, NULL );
+    tSmithNetwork *pNetwork = sweepCacheOpen( sCachePath, sPath, TRUE, NULL );
+    GStatBuf source;
+
+    // the source is examined before it is read: if it changes while being read, the
+    // cache records the old time and size and is found out of date when next opened
+    if( pNetwork == NULL ) {
+        gboolean bSource = ( g_stat( sPath, &source ) == 0 );
+
+        if( (pNetwork = touchstoneLoad( sPath, ppError )) != NULL && bSource )
+            sweepCacheWrite( pNetwork, sCachePath, &source, NULL );
+    }
+
+    g_free( sCachePath );
+    return pNetwork;
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHCACHE_H_
+#define GTKSMITHCACHE_H_
+
+#include <glib/gstdio.h>
+#include "GTKsmithNetwork.h"
+
+// Appended to the name of a Touchstone file to name its cache
+#define SWEEP_CACHE_SUFFIX  ".smcache"
+
+gboolean sweepCacheWrite( const tSmithNetwork *, const gchar *, const GStatBuf *, GError ** );
+tSmithNetwork *sweepCacheOpen( const gchar *, const gchar *, gboolean, GError ** );
+tSmithNetwork *touchstoneLoadCached( const gchar *, GError ** );
+
+#endif /* GTKSMITHCACHE_H_ */
@@ -47,6 +47,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "GTKsmithChart.h"
 
 static tSmithOptions defaultOptions = {
@@ -67,6 +68,7 @@ static tSmithOptions defaultOptions = {
         .colorRing       = { 0.0, 0.0, 0.0, 1.0 },
         .colorLine       = { 0.0, 0.0, 0.5, 1.0 },
         .colorAnnotation = { 0.0, 0.5, 0.0, 1.0 },
+        .colorRegion     = { 0.0, 0.0, 0.5, 0.25 },
 
         .annotationFontSize = 0.4
 };
@@ -123,6 +125,32 @@ RXtoUV( tRX rx ) {
     return rtn;
 }
 
+/*!     \brief  Convert Complex Gamma to normalized R+jX
+ *
+ * Convert a point in the complex gamma space to normalized R+jX.
+ * Z = (1+Gamma)/(1-Gamma). Multiply the numerator and denominator by the
+ * complex conjugate of the denominator (1-U + jV) which makes the
+ * denominator purely real.
+ *
+ * \ingroup Smith
+ *
+ * \param uv    structure containing the cartesian point on the gamma plane
+ * \return      the tRX structure containing the normalized R and X
+ */
+tRX
+UVtoRX( tUV uv ) {
+    gdouble Gminus1_magSqu;
+    tRX rtn;
+
+    // This is (1-Gamma) * its complex conjugate
+    Gminus1_magSqu = SQU(1.0 - uv.U) + SQU(uv.V);
+    // The real part of (1+U + jV) * (1-U + jV)
+    rtn.R = (1.0 - SQU(uv.U) - SQU(uv.V)) / Gminus1_magSqu;
+    // The imaginary part
+    rtn.X = uv.V * 2.0 / Gminus1_magSqu;
+    return rtn;
+}
+
 /*!     \brief  Turn off font metrics hinting
  *
  * Remove font metric hinting so that the font size remains the same
@@ -177,6 +205,415 @@ setCairoFontSize( cairo_t *cr, gdouble fSize ) {
     cairo_set_font_matrix(cr, &fMatrix);
 }
 
+// A style of stroke; the strokes of a style are merged into one path (in device space)
+typedef struct {
+    gdouble   red, green, blue, alpha;
+    gdouble   lineWidth;            // device units
+    GPtrArray *pPaths;              // cairo_path_t
+} tStrokeGroup;
+
+// State of a compact drawing of the chart (see tSmithOptions flags.bCompact).
+// Strokes are collected by style and stroked together at the end, outside the
+// areas behind the text (instead of clearing those areas with CAIRO_OPERATOR_CLEAR,
+// which PDF and SVG cannot express). With flags.bReuseGlyphs (for SVG), each
+// glyph is drawn once into a recording surface that is painted wherever it appears.
+typedef struct {
+    GArray     *pGroups;            // tStrokeGroup
+    GArray     *pKnockout;          // tUV (device space) points of the outlines kept clear
+    GArray     *pKnockoutStart;     // gint index of the first point of each outline
+    GHashTable *pGlyphs;            // "face size color character" -> cairo_surface_t (or NULL)
+} tCompact;
+
+/*!     \brief  Start a compact drawing
+ *
+ * Initialize the state of a compact drawing
+ *
+ * \ingroup drawing
+ *
+ * \param pCompact  pointer to the state
+ * \param bMerge    collect the strokes and the outlines to be kept clear
+ *                  (FALSE to only leave out the clearing, e.g. for a single label)
+ * \param bGlyphs   collect the glyphs (with bMerge)
+ */
+static void
+compactInit( tCompact *pCompact, gboolean bMerge, gboolean bGlyphs ) {
+    *pCompact = (tCompact){ 0 };
+    if( bMerge ) {
+        pCompact->pGroups = g_array_new( FALSE, FALSE, sizeof( tStrokeGroup ) );
+        pCompact->pKnockout = g_array_new( FALSE, FALSE, sizeof( tUV ) );
+        pCompact->pKnockoutStart = g_array_new( FALSE, FALSE, sizeof( gint ) );
+        if( bGlyphs )
+            pCompact->pGlyphs = g_hash_table_new_full( g_str_hash, g_str_equal,
+                    g_free, (GDestroyNotify)cairo_surface_destroy );
+    }
+}
+
+/*!     \brief  Free the state of a compact drawing
+ *
+ * Free the state of a compact drawing
+ *
+ * \ingroup drawing
+ *
+ * \param pCompact  pointer to the state
+ */
+static void
+compactClear( tCompact *pCompact ) {
+    if( pCompact->pGroups ) {
+        for( guint g = 0; g < pCompact->pGroups->len; g++ )
+            g_ptr_array_free( g_array_index( pCompact->pGroups, tStrokeGroup, g ).pPaths, TRUE );
+        g_array_free( pCompact->pGroups, TRUE );
+        g_array_free( pCompact->pKnockout, TRUE );
+        g_array_free( pCompact->pKnockoutStart, TRUE );
+        if( pCompact->pGlyphs )
+            g_hash_table_destroy( pCompact->pGlyphs );
+    }
+    *pCompact = (tCompact){ 0 };
+}
+
+/*!     \brief  Scale of the user space
+ *
+ * Length in device units of a unit length in user space, if the current
+ * transformation scales both axes alike (i.e. only rotates, mirrors and
+ * scales uniformly)
+ *
+ * \ingroup drawing
+ *
+ * \param cr        pointer to cairo context
+ * \return          the scale, or 0 if it is different in different directions
+ */
+static gdouble
+uniformScale( cairo_t *cr ) {
+    cairo_matrix_t m;
+    gdouble scale;
+
+    cairo_get_matrix( cr, &m );
+    scale = sqrt( fabs( m.xx * m.yy - m.xy * m.yx ) );
+    if( fabs( hypot( m.xx, m.yx ) - scale ) > 1e-9 * scale || fabs( hypot( m.xy, m.yy ) - scale ) > 1e-9 * scale )
+        return 0.0;
+    return scale;
+}
+
+/*!     \brief  Stroke the current path
+ *
+ * Stroke the current path, or in a compact drawing add it to the path of
+ * the strokes of the same color and line width
+ *
+ * \ingroup drawing
+ *
+ * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
+ */
+static void
+strokePath( cairo_t *cr, tCompact *pCompact ) {
+    tStrokeGroup style, *pGroup = NULL;
+    gdouble scale;
+
+    if( pCompact == NULL || pCompact->pGroups == NULL || (scale = uniformScale( cr )) == 0.0
+            || cairo_pattern_get_rgba( cairo_get_source( cr ), &style.red, &style.green,
+                                       &style.blue, &style.alpha ) != CAIRO_STATUS_SUCCESS ) {
+        cairo_stroke( cr );
+        return;
+    }
+    style.lineWidth = cairo_get_line_width( cr ) * scale;
+
+    for( guint g = 0; g < pCompact->pGroups->len && pGroup == NULL; g++ ) {
+        tStrokeGroup *pCandidate = &g_array_index( pCompact->pGroups, tStrokeGroup, g );
+
+        if( pCandidate->red == style.red && pCandidate->green == style.green && pCandidate->blue == style.blue
+                && pCandidate->alpha == style.alpha && fabs( pCandidate->lineWidth - style.lineWidth ) < 1e-6 )
+            pGroup = pCandidate;
+    }
+    if( pGroup == NULL ) {
+        style.pPaths = g_ptr_array_new_with_free_func( (GDestroyNotify)cairo_path_destroy );
+        g_array_append_val( pCompact->pGroups, style );
+        pGroup = &g_array_index( pCompact->pGroups, tStrokeGroup, pCompact->pGroups->len - 1 );
+    }
+
+    // the path is kept in device space, so strokes drawn in differently rotated spaces are merged
+    cairo_save( cr ); {
+        cairo_identity_matrix( cr );
+        g_ptr_array_add( pGroup->pPaths, cairo_copy_path( cr ) );
+    } cairo_restore( cr );
+    cairo_new_path( cr );
+}
+
+/*!     \brief  Clear the area of the current path
+ *
+ * Clear the area inside the current path (e.g. behind text), or in a compact
+ * drawing keep the strokes out of it. The path is consumed.
+ *
+ * \ingroup drawing
+ *
+ * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
+ */
+static void
+clearPath( cairo_t *cr, tCompact *pCompact ) {
+    cairo_path_t *pPath;
+
+    if( pCompact == NULL ) {
+        cairo_save( cr ); {
+            cairo_set_operator( cr, CAIRO_OPERATOR_CLEAR );
+            cairo_fill( cr );
+        } cairo_restore( cr );
+        return;
+    }
+
+    if( pCompact->pKnockout ) {
+        cairo_save( cr ); {
+            cairo_identity_matrix( cr );
+            pPath = cairo_copy_path_flat( cr );
+        } cairo_restore( cr );
+
+        for( gint i = 0; i < pPath->num_data; i += pPath->data[i].header.length ) {
+            cairo_path_data_t *pData = &pPath->data[i];
+
+            if( pData->header.type == CAIRO_PATH_MOVE_TO ) {
+                gint first = pCompact->pKnockout->len;
+                g_array_append_val( pCompact->pKnockoutStart, first );
+            }
+            if( pData->header.type == CAIRO_PATH_MOVE_TO || pData->header.type == CAIRO_PATH_LINE_TO ) {
+                tUV point = { pData[1].point.x, pData[1].point.y };
+                g_array_append_val( pCompact->pKnockout, point );
+            }
+        }
+        cairo_path_destroy( pPath );
+    }
+    cairo_new_path( cr );
+}
+
+/*!     \brief  Sort the knockout outlines into layers
+ *
+ * Give each outline collected by clearPath() the first layer in which it
+ * overlaps no other outline (by their bounding boxes), so that the outlines
+ * of a layer can be clipped out together with the even-odd rule. An outline
+ * drawn twice (e.g. the center of both grids) goes into two layers.
+ *
+ * \ingroup drawing
+ *
+ * \param pCompact  compact drawing state
+ * \param pLayer    where the layer of each outline is written
+ * \return          number of layers
+ */
+static gint
+knockoutLayers( const tCompact *pCompact, gint *pLayer ) {
+    gint nOutlines = pCompact->pKnockoutStart->len;
+    cairo_rectangle_t *pBounds = g_new( cairo_rectangle_t, nOutlines );
+    gint nLayers = 0;
+
+    for( gint k = 0; k < nOutlines; k++ ) {
+        gint start = g_array_index( pCompact->pKnockoutStart, gint, k );
+        gint end = k + 1 < nOutlines ? g_array_index( pCompact->pKnockoutStart, gint, k + 1 )
+                                     : (gint)pCompact->pKnockout->len;
+        gdouble x1 = G_MAXDOUBLE, y1 = G_MAXDOUBLE, x2 = -G_MAXDOUBLE, y2 = -G_MAXDOUBLE;
+
+        for( gint i = start; i < end; i++ ) {
+            tUV *pPoint = &g_array_index( pCompact->pKnockout, tUV, i );
+
+            x1 = MIN( x1, pPoint->U );
+            x2 = MAX( x2, pPoint->U );
+            y1 = MIN( y1, pPoint->V );
+            y2 = MAX( y2, pPoint->V );
+        }
+        pBounds[k] = (cairo_rectangle_t){ x1, y1, x2 - x1, y2 - y1 };
+
+        pLayer[k] = 0;
+        for( gint j = 0; j < k; j++ ) {
+            // (outlines are few, hundreds at most; any overlap moves on to the next layer and starts again)
+            if( pLayer[j] == pLayer[k]
+                    && pBounds[j].x < x2 && x1 < pBounds[j].x + pBounds[j].width
+                    && pBounds[j].y < y2 && y1 < pBounds[j].y + pBounds[j].height ) {
+                pLayer[k]++;
+                j = -1;
+            }
+        }
+        nLayers = MAX( nLayers, pLayer[k] + 1 );
+    }
+
+    g_free( pBounds );
+    return nLayers;
+}
+
+/*!     \brief  Stroke the collected paths of a compact drawing
+ *
+ * Stroke the path of each style of stroke, clipped to keep the strokes out of
+ * the outlines collected by clearPath(). Outlines may overlap (e.g. labels
+ * that touch, or the center drawn by both grids), where an even-odd clip of
+ * them all would let the strokes back in, so each layer of outlines that do
+ * not overlap (see knockoutLayers()) is clipped out in turn: the strokes are
+ * kept out of the union of the outlines.
+ *
+ * \ingroup drawing
+ *
+ * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state
+ */
+static void
+compactFinish( cairo_t *cr, tCompact *pCompact ) {
+    cairo_save( cr ); {
+        cairo_identity_matrix( cr );
+
+        if( pCompact->pKnockoutStart->len > 0 ) {
+            gdouble x1, y1, x2, y2;
+            gint nOutlines = pCompact->pKnockoutStart->len;
+            gint *pLayer = g_new( gint, nOutlines );
+            gint nLayers = knockoutLayers( pCompact, pLayer );
+
+            cairo_clip_extents( cr, &x1, &y1, &x2, &y2 );
+            cairo_set_fill_rule( cr, CAIRO_FILL_RULE_EVEN_ODD );
+            // the extents less the outlines of each layer (the clips intersect)
+            for( gint l = 0; l < nLayers; l++ ) {
+                cairo_new_path( cr );
+                cairo_rectangle( cr, x1, y1, x2 - x1, y2 - y1 );
+                for( gint k = 0; k < nOutlines; k++ ) {
+                    gint start = g_array_index( pCompact->pKnockoutStart, gint, k );
+                    gint end = k + 1 < nOutlines ? g_array_index( pCompact->pKnockoutStart, gint, k + 1 )
+                                                 : (gint)pCompact->pKnockout->len;
+
+                    if( pLayer[k] != l )
+                        continue;
+                    for( gint i = start; i < end; i++ ) {
+                        tUV *pPoint = &g_array_index( pCompact->pKnockout, tUV, i );
+
+                        if( i == start )
+                            cairo_move_to( cr, pPoint->U, pPoint->V );
+                        else
+                            cairo_line_to( cr, pPoint->U, pPoint->V );
+                    }
+                    cairo_close_path( cr );
+                }
+                cairo_clip( cr );
+            }
+            g_free( pLayer );
+        }
+
+        for( guint g = 0; g < pCompact->pGroups->len; g++ ) {
+            tStrokeGroup *pGroup = &g_array_index( pCompact->pGroups, tStrokeGroup, g );
+
+            cairo_set_source_rgba( cr, pGroup->red, pGroup->green, pGroup->blue, pGroup->alpha );
+            cairo_set_line_width( cr, pGroup->lineWidth );
+            cairo_new_path( cr );
+            for( guint p = 0; p < pGroup->pPaths->len; p++ )
+                cairo_append_path( cr, g_ptr_array_index( pGroup->pPaths, p ) );
+            cairo_stroke( cr );
+        }
+    } cairo_restore( cr );
+}
+
+/*!     \brief  Recording of a glyph
+ *
+ * Find (or draw the first time) the recording of a character at a size and color.
+ * The origin of the recording is the origin of the character.
+ *
+ * \ingroup drawing
+ *
+ * \param pCompact      compact drawing state
+ * \param pScaledFont   font of the character (in device units, not rotated)
+ * \param sChar         the character (UTF-8)
+ * \param rgba          color of the character (red, green, blue, alpha)
+ * \param pAdvance      where the advance of the character (device units) is written
+ * \return              the recording (owned by the state), or NULL if the character shows nothing
+ */
+static cairo_surface_t *
+glyphRecording( tCompact *pCompact, cairo_scaled_font_t *pScaledFont, const gchar *sChar,
+        const gdouble rgba[ 4 ], gdouble *pAdvance ) {
+    cairo_text_extents_t extents;
+    cairo_matrix_t fontMatrix;
+    cairo_surface_t *pGlyph;
+    gchar *sKey;
+
+    cairo_scaled_font_text_extents( pScaledFont, sChar, &extents );
+    *pAdvance = extents.x_advance;
+    if( extents.width == 0.0 || extents.height == 0.0 )
+        return NULL;
+
+    cairo_scaled_font_get_font_matrix( pScaledFont, &fontMatrix );
+    sKey = g_strdup_printf( "%p %.4g %.4g %.4g %.4g %.4g %s", (gpointer)cairo_scaled_font_get_font_face( pScaledFont ),
+            fontMatrix.xx, rgba[ 0 ], rgba[ 1 ], rgba[ 2 ], rgba[ 3 ], sChar );
+
+    if( (pGlyph = g_hash_table_lookup( pCompact->pGlyphs, sKey )) == NULL ) {
+        cairo_rectangle_t bounds = { floor( extents.x_bearing ) - 1, floor( extents.y_bearing ) - 1,
+                                     ceil( extents.width ) + 2, ceil( extents.height ) + 2 };
+        cairo_t *crGlyph;
+
+        pGlyph = cairo_recording_surface_create( CAIRO_CONTENT_COLOR_ALPHA, &bounds );
+        crGlyph = cairo_create( pGlyph );
+        cairo_set_scaled_font( crGlyph, pScaledFont );
+        cairo_set_source_rgba( crGlyph, rgba[ 0 ], rgba[ 1 ], rgba[ 2 ], rgba[ 3 ] );
+        cairo_move_to( crGlyph, 0, 0 );
+        cairo_show_text( crGlyph, sChar );
+        cairo_destroy( crGlyph );
+
+        g_hash_table_insert( pCompact->pGlyphs, sKey, pGlyph );
+    } else {
+        g_free( sKey );
+    }
+
+    return pGlyph;
+}
+
+/*!     \brief  Show text at the current point
+ *
+ * Show text at the current point like cairo_show_text(). In a compact drawing
+ * with flags.bReuseGlyphs each character is painted from a recording of it made
+ * once (in device units, not rotated), so that SVG output holds each glyph once
+ * however many times, and at whatever angles, it appears (SVG defines a glyph
+ * again for each angle). PDF keeps its glyphs in a font at any angle, and would
+ * paint each recording as a form of its own, so its text is shown as it is.
+ *
+ * \ingroup drawing
+ *
+ * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
+ * \param sText     NULL terminated string to show
+ */
+static void
+showText( cairo_t *cr, tCompact *pCompact, const gchar *sText ) {
+    cairo_matrix_t fontMatrix, identity;
+    cairo_font_options_t *pFontOptions;
+    cairo_scaled_font_t *pScaledFont;
+    gdouble rgba[ 4 ], x, y, scale;
+
+    cairo_get_font_matrix( cr, &fontMatrix );
+    // (the chart sets fonts with setCairoFontSize(), i.e. upright in the flipped user space)
+    if( pCompact == NULL || pCompact->pGlyphs == NULL || (scale = uniformScale( cr )) == 0.0
+            || fontMatrix.xy != 0.0 || fontMatrix.yx != 0.0 || fontMatrix.yy != -fontMatrix.xx
+            || cairo_pattern_get_rgba( cairo_get_source( cr ), &rgba[ 0 ], &rgba[ 1 ],
+                                       &rgba[ 2 ], &rgba[ 3 ] ) != CAIRO_STATUS_SUCCESS ) {
+        cairo_show_text( cr, sText );
+        return;
+    }
+
+    cairo_get_current_point( cr, &x, &y );
+    cairo_matrix_init_scale( &fontMatrix, fontMatrix.xx * scale, fontMatrix.xx * scale );
+    cairo_matrix_init_identity( &identity );
+    pFontOptions = cairo_font_options_create();
+    cairo_get_font_options( cr, pFontOptions );
+    pScaledFont = cairo_scaled_font_create( cairo_get_font_face( cr ), &fontMatrix, &identity, pFontOptions );
+    cairo_font_options_destroy( pFontOptions );
+
+    for( const gchar *pChar = sText; *pChar; pChar = g_utf8_next_char( pChar ) ) {
+        gchar *sChar = g_strndup( pChar, g_utf8_next_char( pChar ) - pChar );
+        gdouble advance;
+        cairo_surface_t *pGlyph = glyphRecording( pCompact, pScaledFont, sChar, rgba, &advance );
+
+        if( pGlyph ) {
+            cairo_save( cr ); {
+                // device units, y down, at the origin of the character
+                cairo_translate( cr, x, y );
+                cairo_scale( cr, 1.0 / scale, -1.0 / scale );
+                cairo_set_source_surface( cr, pGlyph, 0, 0 );
+                cairo_paint( cr );
+            } cairo_restore( cr );
+        }
+        x += advance / scale;
+        g_free( sChar );
+    }
+    cairo_scaled_font_destroy( pScaledFont );
+
+    cairo_move_to( cr, x, y );
+}
+
 
 /*!     \brief  Render a text string left justified from the specified point
  *
@@ -185,29 +622,26 @@ setCairoFontSize( cairo_t *cr, gdouble fSize ) {
  * \ingroup plot
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param sLabel    NULL terminated string to show
  * \param x         x position of the right edge of the label
  * \param y         y position of the bottom of the label
  *
  */
 static void
-leftJustifiedClearText(cairo_t *cr, gchar *sLabel, gdouble x, gdouble y)
+leftJustifiedClearText(cairo_t *cr, tCompact *pCompact, gchar *sLabel, gdouble x, gdouble y)
 {
     cairo_text_extents_t extents;
 
     cairo_text_extents (cr, sLabel, &extents);
 
-    cairo_save( cr );
-        cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
-        cairo_new_path( cr );
-        cairo_rectangle( cr, x, y, (extents.width + extents.x_bearing),
-                extents.height + extents.y_bearing );
-        cairo_stroke_preserve(cr);
-        cairo_fill( cr );
-    cairo_restore( cr );
+    cairo_new_path( cr );
+    cairo_rectangle( cr, x, y, (extents.width + extents.x_bearing),
+            extents.height + extents.y_bearing );
+    clearPath( cr, pCompact );
 
     cairo_move_to(cr, x, y );
-    cairo_show_text (cr, sLabel);
+    showText( cr, pCompact, sLabel );
 }
 
 /*!     \brief  Render a text string right justified from the specified point
@@ -217,30 +651,27 @@ leftJustifiedClearText(cairo_t *cr, gchar *sLabel, gdouble x, gdouble y)
  * \ingroup drawing
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param sLabel    NULL terminated string to show
  * \param x         x position of the right edge of the label
  * \param y         y position of the bottom of the label
  *
  */
 static void
-rightJustifiedClearText(cairo_t *cr, gchar *sLabel, gdouble x, gdouble y)
+rightJustifiedClearText(cairo_t *cr, tCompact *pCompact, gchar *sLabel, gdouble x, gdouble y)
 {
     cairo_text_extents_t extents;
 
     cairo_text_extents (cr, sLabel, &extents);
 
-    cairo_save( cr );
-        cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
-        cairo_new_path( cr );
-        cairo_rectangle( cr, x-(extents.width + extents.x_bearing),
-                y, (extents.width + extents.x_bearing),
-                extents.height + extents.y_bearing );
-        cairo_stroke_preserve(cr);
-        cairo_fill( cr );
-    cairo_restore( cr );
+    cairo_new_path( cr );
+    cairo_rectangle( cr, x-(extents.width + extents.x_bearing),
+            y, (extents.width + extents.x_bearing),
+            extents.height + extents.y_bearing );
+    clearPath( cr, pCompact );
 
     cairo_move_to(cr, x - stringWidthCairoText(cr, sLabel), y );
-    cairo_show_text (cr, sLabel);
+    showText( cr, pCompact, sLabel );
 }
 
 /*!     \brief  Render a text string center justified around the specified point
@@ -250,16 +681,17 @@ rightJustifiedClearText(cairo_t *cr, gchar *sLabel, gdouble x, gdouble y)
  * \ingroup drawing
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param sLabel    NULL terminated string to show
  * \param x         x position of the right edge of the label
  * \param y         y position of the bottom of the label
  *
  */
 static void
-centreJustifiedCairoText(cairo_t *cr, gchar *sLabel, gdouble x, gdouble y)
+centreJustifiedCairoText(cairo_t *cr, tCompact *pCompact, gchar *sLabel, gdouble x, gdouble y)
 {
     cairo_move_to(cr, x - stringWidthCairoText(cr, sLabel)/2.0, y);
-    cairo_show_text (cr, sLabel);
+    showText( cr, pCompact, sLabel );
 }
 
 
@@ -305,14 +737,15 @@ angleX( tRX rx ) {
  * \ingroup Smith
  *
  * \param cr            pointer to cairo context
+ * \param pCompact      compact drawing state (or NULL)
  * \param radius        radius of the arc
  * \param angleStart    starting at this angle
  * \param angleEnd      ending at this angle
  */
 static void
-drawArc( cairo_t *cr, tUV uv, gdouble radius, gdouble angleStart, gdouble angleEnd) {
+drawArc( cairo_t *cr, tCompact *pCompact, tUV uv, gdouble radius, gdouble angleStart, gdouble angleEnd) {
     cairo_arc( cr, uv.U * SMITH_RADIUS,  uv.V * SMITH_RADIUS, radius * SMITH_RADIUS, angleStart, angleEnd);
-    cairo_stroke( cr );
+    strokePath( cr, pCompact );
 }
 
 
@@ -323,12 +756,13 @@ drawArc( cairo_t *cr, tUV uv, gdouble radius, gdouble angleStart, gdouble angleE
  * \ingroup Smith
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param rArc      The resistance arc to plot
  * \param xFrom     Starting on this reactance arc
  * \param xTo       Ending on this reactance arc
  */
 static void
-drawRarc( cairo_t *cr, gdouble rArc, gdouble xFrom, gdouble xTo ) {
+drawRarc( cairo_t *cr, tCompact *pCompact, gdouble rArc, gdouble xFrom, gdouble xTo ) {
     tUV uv;
     tRX rx;
     gdouble radius, theta1, theta2;
@@ -340,7 +774,7 @@ drawRarc( cairo_t *cr, gdouble rArc, gdouble xFrom, gdouble xTo ) {
     theta1 = angleR( rx );
     rx.X = xTo;
     theta2 = angleR( rx );
-    drawArc( cr, uv, radius, theta1, theta2 );
+    drawArc( cr, pCompact, uv, radius, theta1, theta2 );
 }
 
 /*!     \brief  Draw a reactance arc between two resistance arcs
@@ -350,12 +784,13 @@ drawRarc( cairo_t *cr, gdouble rArc, gdouble xFrom, gdouble xTo ) {
  * \ingroup Smith
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param xArc      The reactance arc to plot
  * \param rFrom     Starting on this resistance arc
  * \param rTo       Ending on this resistance arc
  */
 static void
-drawXarc( cairo_t *cr, gdouble xArc, gdouble rFrom, gdouble rTo ) {
+drawXarc( cairo_t *cr, tCompact *pCompact, gdouble xArc, gdouble rFrom, gdouble rTo ) {
     tUV uv;
     tRX rx;
     gdouble radius, theta1, theta2;
@@ -371,7 +806,7 @@ drawXarc( cairo_t *cr, gdouble xArc, gdouble rFrom, gdouble rTo ) {
     rx.R = rTo;
     theta2 = angleX( rx );
     // draw the arc
-    drawArc( cr, uv, radius, theta1, theta2 );
+    drawArc( cr, pCompact, uv, radius, theta1, theta2 );
 }
 
 
@@ -392,13 +827,14 @@ drawXarc( cairo_t *cr, gdouble xArc, gdouble rFrom, gdouble rTo ) {
  * \ingroup Smith
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param RXstart   Start of block on the Smith chart (in R+jX space)
  * \param RXend     End of block on the Smith chart (in R+jX space)
  * \param minorInc  The spacing between the finest grid lines
  * \param majorInc  The spacing between the bold grid lines
  */
 static void
-drawBlock( cairo_t *cr, tRX RXstart, tRX RXend, gdouble minorInc, gint minorPerMajor ) {
+drawBlock( cairo_t *cr, tCompact *pCompact, tRX RXstart, tRX RXend, gdouble minorInc, gint minorPerMajor ) {
     gint rticks = 1;
     gint xticks = 1;
 
@@ -408,8 +844,8 @@ drawBlock( cairo_t *cr, tRX RXstart, tRX RXend, gdouble minorInc, gint minorPerM
         else
             cairo_set_line_width( cr, STROKE_WIDTH_MINOR );
 
-        drawRarc( cr, r, RXend.X, RXstart.X );
-        drawRarc( cr, r, -RXstart.X, -RXend.X );
+        drawRarc( cr, pCompact, r, RXend.X, RXstart.X );
+        drawRarc( cr, pCompact, r, -RXstart.X, -RXend.X );
     }
 
     for( gdouble x = RXstart.X + minorInc ; x <=  + RXend.X + minorInc/2.0; x += minorInc, xticks++ ) {
@@ -418,8 +854,8 @@ drawBlock( cairo_t *cr, tRX RXstart, tRX RXend, gdouble minorInc, gint minorPerM
         else
             cairo_set_line_width( cr, STROKE_WIDTH_MINOR );
 
-        drawXarc( cr, x, RXstart.R, RXend.R );
-        drawXarc( cr, -x, RXend.R, RXstart.R );
+        drawXarc( cr, pCompact, x, RXstart.R, RXend.R );
+        drawXarc( cr, pCompact, -x, RXend.R, RXstart.R );
     }
 
 }
@@ -433,9 +869,10 @@ drawBlock( cairo_t *cr, tRX RXstart, tRX RXend, gdouble minorInc, gint minorPerM
  * \ingroup Smith
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  */
 static void
-drawImmittanceGrid( cairo_t *cr, tRegion zones[], tSmithOptions *pOptions )
+drawImmittanceGrid( cairo_t *cr, tCompact *pCompact, tRegion zones[], tSmithOptions *pOptions )
 {
     gdouble minorinc;
     gint minorPerMajor;
@@ -450,15 +887,15 @@ drawImmittanceGrid( cairo_t *cr, tRegion zones[], tSmithOptions *pOptions )
             // This is a hack to handle the area on the sparse grid
             // near the G=20 circle to match Form ZY-01-N
             cairo_set_line_width( cr, STROKE_WIDTH_MAJOR );
-            drawRarc( cr, 20, 50, 20 );
-            drawRarc( cr, 20, -20, -50 );
+            drawRarc( cr, pCompact, 20, 50, 20 );
+            drawRarc( cr, pCompact, 20, -20, -50 );
 
-            drawXarc( cr,  20, 20, 50 );
-            drawXarc( cr, -20, 50, 20 );
+            drawXarc( cr, pCompact,  20, 20, 50 );
+            drawXarc( cr, pCompact, -20, 50, 20 );
         } else {
             rxFrom = (tRX){ 0.0, zones[ index ].region };
             rxTo = (tRX){ zones[ index + 1 ].region, zones[ index + 1 ].region };
-            drawBlock( cr, rxFrom, rxTo, minorinc, minorPerMajor );
+            drawBlock( cr, pCompact, rxFrom, rxTo, minorinc, minorPerMajor );
 
             // draw grid blocks around the centerline between R=0.2 and infinity
             rxFrom = (tRX){ zones[ index ].region, 0.0 };
@@ -466,7 +903,7 @@ drawImmittanceGrid( cairo_t *cr, tRegion zones[], tSmithOptions *pOptions )
 
             if( index == 7 )
                 minorPerMajor = 3; // nobody likes this
-            drawBlock( cr, rxFrom, rxTo, minorinc, minorPerMajor );
+            drawBlock( cr, pCompact, rxFrom, rxTo, minorinc, minorPerMajor );
         }
     }
 
@@ -475,32 +912,31 @@ drawImmittanceGrid( cairo_t *cr, tRegion zones[], tSmithOptions *pOptions )
     cairo_move_to( cr, -SMITH_RADIUS, 0 );
     cairo_line_to( cr, SMITH_RADIUS, 0 );
     // outer circle
-    cairo_stroke( cr );
+    strokePath( cr, pCompact );
     cairo_arc( cr, 0, 0, SMITH_RADIUS, 0, 2.0 * M_PI );
-    cairo_stroke( cr );
+    strokePath( cr, pCompact );
 
     // special case for arcs / circles at r and x = 50
-    drawRarc( cr, 50, 10000, 0 );
-    drawRarc( cr, 50, 0, -10000 );
+    drawRarc( cr, pCompact, 50, 10000, 0 );
+    drawRarc( cr, pCompact, 50, 0, -10000 );
 
-    drawXarc( cr, 50, 0, 10000 );
-    drawXarc( cr, -50, 10000, 0 );
+    drawXarc( cr, pCompact, 50, 0, 10000 );
+    drawXarc( cr, pCompact, -50, 10000, 0 );
 
     // Another hack
     if( zones == sparseGrid ) {
-        drawRarc( cr, 10, 10, 0 );
-        drawRarc( cr, 10, 0, -10 );
-        drawXarc( cr, 4, 4, 10 );
-        drawXarc( cr, -4, 10, 4 );
+        drawRarc( cr, pCompact, 10, 10, 0 );
+        drawRarc( cr, pCompact, 10, 0, -10 );
+        drawXarc( cr, pCompact, 4, 4, 10 );
+        drawXarc( cr, pCompact, -4, 10, 4 );
     }
 
     // dot at center
     cairo_new_path( cr );
-    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
     cairo_arc( cr, 0, 0, SMITH_RADIUS / 150, 0, 2.0 * M_PI );
-    cairo_fill( cr );
-    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+    clearPath( cr, pCompact );
 
+    // (stroked now, as in a compact drawing the grid is kept out of the dot)
     cairo_set_line_width( cr, STROKE_WIDTH_THIN );
     cairo_arc( cr, 0, 0, SMITH_RADIUS / 150, 0, 2.0 * M_PI );
     cairo_stroke( cr );
@@ -516,13 +952,14 @@ drawImmittanceGrid( cairo_t *cr, tRegion zones[], tSmithOptions *pOptions )
  * \ingroup plot
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param sLabel    NULL terminated string to show
  * \param x         x position of the right edge of the label
  * \param y         y position of the bottom of the label
  *
  */
 static void
-circleCairoText(cairo_t *cr, gchar *sLabel, gdouble radius, gdouble angle, gdouble centerX, gdouble centerY )
+circleCairoText(cairo_t *cr, tCompact *pCompact, gchar *sLabel, gdouble radius, gdouble angle, gdouble centerX, gdouble centerY )
 {
     cairo_text_extents_t extents;
     cairo_text_extents (cr, sLabel, &extents);
@@ -534,8 +971,6 @@ circleCairoText(cairo_t *cr, gchar *sLabel, gdouble radius, gdouble angle, gdoub
     cairo_save( cr ); {
         cairo_new_path( cr );
         cairo_set_line_width( cr, 0 );
-        // Clear the background
-        cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
         // text is rendered on an arc centered at centerX, centerY
         cairo_translate( cr, centerX, centerY );
         // turn the text arc space CW so that the end of the arc meets the x-axis
@@ -548,9 +983,8 @@ circleCairoText(cairo_t *cr, gchar *sLabel, gdouble radius, gdouble angle, gdoub
         cairo_arc( cr, centerX, centerY, radius + extents.height, 0.0, sweepAngle );
         // upper left back to lower left
         cairo_close_path( cr );
-        cairo_stroke_preserve(cr);
-        cairo_fill( cr );
-        cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+        // Clear the background
+        clearPath( cr, pCompact );
         // turn the text space back so that the lower left is actually left
         cairo_rotate( cr, sweepAngle-M_PI/2 );
         for( thisChar = sLabel, sChar[0] = *sLabel; *thisChar != 0; sChar[ 0 ] = *(++thisChar) ) {
@@ -559,7 +993,7 @@ circleCairoText(cairo_t *cr, gchar *sLabel, gdouble radius, gdouble angle, gdoub
             cairo_rotate( cr, -(extents.x_advance/2.0) / radius );
             // center the letter
             cairo_move_to( cr, -(extents.x_advance/2.0), radius );
-            cairo_show_text (cr, sChar);
+            showText( cr, pCompact, sChar );
             // complete the rotation required by thefull letter width
             cairo_rotate( cr, -(extents.x_advance / 2.0) / radius );
         }
@@ -573,11 +1007,12 @@ circleCairoText(cairo_t *cr, gchar *sLabel, gdouble radius, gdouble angle, gdoub
  * \ingroup plot
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param pOptions  pointer to options settings
  *
  */
 static void
-drawLabels( cairo_t *cr, tSmithOptions *pOptions ) {
+drawLabels( cairo_t *cr, tCompact *pCompact, tSmithOptions *pOptions ) {
     tUV uv;
     tRX rx;
     gdouble angle;
@@ -593,7 +1028,7 @@ drawLabels( cairo_t *cr, tSmithOptions *pOptions ) {
         angle = atan2( uv.V, uv.U );
         cairo_save( cr ); {
             cairo_rotate( cr, angle );
-            rightJustifiedClearText( cr,  labels[ index ].text, SMITH_RADIUS - labelMargin, 0.0 + labelMargin );
+            rightJustifiedClearText( cr, pCompact,  labels[ index ].text, SMITH_RADIUS - labelMargin, 0.0 + labelMargin );
         } cairo_restore( cr );
         // -X
         rx = (tRX){ 0.0, -labels[ index ].value };
@@ -601,14 +1036,14 @@ drawLabels( cairo_t *cr, tSmithOptions *pOptions ) {
         angle = atan2( uv.V, uv.U ) + M_PI;
         cairo_save( cr ); {
             cairo_rotate( cr, angle );
-            leftJustifiedClearText( cr, labels[ index ].text, -SMITH_RADIUS + labelMargin, 0.0 + labelMargin  );
+            leftJustifiedClearText( cr, pCompact, labels[ index ].text, -SMITH_RADIUS + labelMargin, 0.0 + labelMargin  );
         } cairo_restore( cr );
         // R (along the U axis)
         rx = (tRX){ labels[ index ].value, 0.0 };
         uv = RXtoUV( rx );
         cairo_save( cr ); {
             cairo_rotate( cr, M_PI / 2.0 );
-            leftJustifiedClearText( cr, labels[ index ].text, labelMargin, -uv.U + labelMargin );
+            leftJustifiedClearText( cr, pCompact, labels[ index ].text, labelMargin, -uv.U + labelMargin );
         } cairo_restore( cr );
     }
 
@@ -619,7 +1054,7 @@ drawLabels( cairo_t *cr, tSmithOptions *pOptions ) {
         cairo_save( cr ); {
             cairo_translate( cr, uv.U * SMITH_RADIUS, uv.V * SMITH_RADIUS );
             cairo_rotate( cr, angleX( rx ) + M_PI );
-            leftJustifiedClearText( cr, labels[ index ].text, labelMargin, labelMargin );
+            leftJustifiedClearText( cr, pCompact, labels[ index ].text, labelMargin, labelMargin );
         } cairo_restore( cr );
 
         // R labels on the X=-1 arc (lower - capacitive hemisphere)
@@ -628,7 +1063,7 @@ drawLabels( cairo_t *cr, tSmithOptions *pOptions ) {
         cairo_save( cr ); {
             cairo_translate( cr, uv.U * SMITH_RADIUS, uv.V * SMITH_RADIUS );
             cairo_rotate( cr, angleX( rx ) );
-            rightJustifiedClearText( cr, labels[ index ].text, -labelMargin, +labelMargin );
+            rightJustifiedClearText( cr, pCompact, labels[ index ].text, -labelMargin, +labelMargin );
         } cairo_restore( cr );
 
         // X labels on the R=1 circle (upper - inductive hemisphere)
@@ -637,7 +1072,7 @@ drawLabels( cairo_t *cr, tSmithOptions *pOptions ) {
         cairo_save( cr ); {
             cairo_translate( cr, uv.U * SMITH_RADIUS, uv.V * SMITH_RADIUS );
             cairo_rotate( cr, angleR( rx )  );
-            rightJustifiedClearText( cr, labels[ index ].text, -labelMargin, labelMargin );
+            rightJustifiedClearText( cr, pCompact, labels[ index ].text, -labelMargin, labelMargin );
         } cairo_restore( cr );
         // -X labels on the R=1 circle (lower - capacitive hemisphere)
         rx = (tRX){ 1.0, -labels[ index ].value };
@@ -645,7 +1080,7 @@ drawLabels( cairo_t *cr, tSmithOptions *pOptions ) {
         cairo_save( cr ); {
             cairo_translate( cr, uv.U * SMITH_RADIUS, uv.V * SMITH_RADIUS );
             cairo_rotate( cr, angleR( rx ) + M_PI );
-            leftJustifiedClearText( cr, labels[ index ].text, labelMargin, labelMargin );
+            leftJustifiedClearText( cr, pCompact, labels[ index ].text, labelMargin, labelMargin );
         } cairo_restore( cr );
     }
 }
@@ -657,15 +1092,16 @@ drawLabels( cairo_t *cr, tSmithOptions *pOptions ) {
  * \ingroup plot
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param areas     array of parameters describing the density of the grid
  * \param pOptions  pointer to options settings
  *
  */
 static void
-drawRXgrid( cairo_t *cr, tRegion areas[], tSmithOptions *pOptions ) {
+drawRXgrid( cairo_t *cr, tCompact *pCompact, tRegion areas[], tSmithOptions *pOptions ) {
     cairo_save( cr ); {
         cairo_set_source_rgba(cr, pOptions->colorRXgrid.red, pOptions->colorRXgrid.green, pOptions->colorRXgrid.blue, pOptions->colorRXgrid.alpha);
-        drawImmittanceGrid( cr, areas, pOptions );
+        drawImmittanceGrid( cr, pCompact, areas, pOptions );
     } cairo_restore( cr );
 }
 
@@ -676,17 +1112,18 @@ drawRXgrid( cairo_t *cr, tRegion areas[], tSmithOptions *pOptions ) {
  * \ingroup plot
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param areas     array of parameters describing the density of the grid
  * \param pOptions  pointer to options settings
  *
  */
 static void
-drawRXgridText( cairo_t *cr, tRegion areas[], tSmithOptions *pOptions ) {
+drawRXgridText( cairo_t *cr, tCompact *pCompact, tRegion areas[], tSmithOptions *pOptions ) {
     cairo_save( cr ); {
         cairo_set_source_rgba(cr, pOptions->colorRXtext.red, pOptions->colorRXtext.green, pOptions->colorRXtext.blue, pOptions->colorRXtext.alpha);
         cairo_set_line_width( cr, 0.0);
         if( pOptions->flags.bShowLabels )
-            drawLabels( cr, pOptions );
+            drawLabels( cr, pCompact, pOptions );
 
         if( pOptions->flags.bShowStrings ) {
             gdouble resistanceTextVpos = -( LABELFONTSIZE + SRpct(0.8) );
@@ -695,9 +1132,9 @@ drawRXgridText( cairo_t *cr, tRegion areas[], tSmithOptions *pOptions ) {
                 resistanceTextVpos -= ( LABELFONTSIZE + SRpct(0.4) );
             }
 
-            circleCairoText( cr, "INDUCTIVE REACTANCE COMPONENT (+jX/Zo)", SRpct(94), DEGtoRAD(141.7), 0, 0 );
-            circleCairoText( cr, "CAPACITIVE REACTANCE COMPONENT (-jX/Zo)", SRpct(94), DEGtoRAD(-141.7), 0, 0 );
-            leftJustifiedClearText( cr, "RESISTANCE COMPONENT (R/Zo)", SRpct(-32.5), resistanceTextVpos );
+            circleCairoText( cr, pCompact, "INDUCTIVE REACTANCE COMPONENT (+jX/Zo)", SRpct(94), DEGtoRAD(141.7), 0, 0 );
+            circleCairoText( cr, pCompact, "CAPACITIVE REACTANCE COMPONENT (-jX/Zo)", SRpct(94), DEGtoRAD(-141.7), 0, 0 );
+            leftJustifiedClearText( cr, pCompact, "RESISTANCE COMPONENT (R/Zo)", SRpct(-32.5), resistanceTextVpos );
         }
     } cairo_restore( cr );
 }
@@ -709,16 +1146,17 @@ drawRXgridText( cairo_t *cr, tRegion areas[], tSmithOptions *pOptions ) {
  * \ingroup plot
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param areas     array of parameters describing the density of the grid
  * \param pOptions  pointer to options settings
  *
  */
 static void
-drawGBgrid( cairo_t *cr, tRegion areas[], tSmithOptions *pOptions ) {
+drawGBgrid( cairo_t *cr, tCompact *pCompact, tRegion areas[], tSmithOptions *pOptions ) {
     cairo_save( cr ); {
         cairo_set_source_rgba(cr, pOptions->colorGBgrid.red, pOptions->colorGBgrid.green, pOptions->colorGBgrid.blue, pOptions->colorGBgrid.alpha);
         cairo_rotate( cr, M_PI );
-        drawImmittanceGrid( cr, areas, pOptions );
+        drawImmittanceGrid( cr, pCompact, areas, pOptions );
     } cairo_restore( cr);
 }
 
@@ -729,19 +1167,20 @@ drawGBgrid( cairo_t *cr, tRegion areas[], tSmithOptions *pOptions ) {
  * \ingroup plot
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param areas     array of parameters describing the density of the grid
  * \param pOptions  pointer to options settings
  *
  */
 static void
-drawGBgridText( cairo_t *cr, tRegion areas[], tSmithOptions *pOptions ) {
+drawGBgridText( cairo_t *cr, tCompact *pCompact, tRegion areas[], tSmithOptions *pOptions ) {
     cairo_save( cr ); {
         cairo_rotate( cr, M_PI );
         cairo_set_source_rgba(cr, pOptions->colorGBtext.red, pOptions->colorGBtext.green, pOptions->colorGBtext.blue, pOptions->colorGBtext.alpha);
         cairo_set_line_width( cr, 0.0);
 
         if( pOptions->flags.bShowLabels )
-            drawLabels( cr, pOptions );
+            drawLabels( cr, pCompact, pOptions );
 
         if( pOptions->flags.bShowStrings ) {
             gdouble reactanceTextAngle = 141.7;
@@ -752,11 +1191,11 @@ drawGBgridText( cairo_t *cr, tRegion areas[], tSmithOptions *pOptions ) {
                 reactanceTextAngle -= 27.0;
                 coductanceTextVpos += LABELFONTSIZE + SRpct(0.4);
             }
-            circleCairoText( cr, "CAPACITIVE SUSCEPTANCE COMPONENT (+jX/Yo)", SRpct(94),
+            circleCairoText( cr, pCompact, "CAPACITIVE SUSCEPTANCE COMPONENT (+jX/Yo)", SRpct(94),
                     DEGtoRAD(reactanceTextAngle), 0, 0 );
-            circleCairoText( cr, "INDUCTIVE SUSCEPTANCE COMPONENT (-jB/Yo)", SRpct(94),
+            circleCairoText( cr, pCompact, "INDUCTIVE SUSCEPTANCE COMPONENT (-jB/Yo)", SRpct(94),
                     DEGtoRAD(-reactanceTextAngle), 0, 0 );
-            leftJustifiedClearText( cr, "CONDUCTANCE COMPONENT (G/Yo)", SRpct(-32.5),
+            leftJustifiedClearText( cr, pCompact, "CONDUCTANCE COMPONENT (G/Yo)", SRpct(-32.5),
                     coductanceTextVpos + SRpct(0.8) );
         }
     } cairo_restore( cr);
@@ -810,11 +1249,12 @@ drawCurvedArrow( cairo_t *cr, gdouble radius, gdouble startAngle, gdouble stopAn
  * \ingroup plot
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param pOptions pointer to options settings
  *
  */
-void
-drawWavelengthRing( cairo_t *cr, tSmithOptions *pOptions ) {
+static void
+drawWavelengthRing( cairo_t *cr, tCompact *pCompact, tSmithOptions *pOptions ) {
     gint ix;
     gdouble lstep;
     cairo_save( cr ); {
@@ -824,14 +1264,14 @@ drawWavelengthRing( cairo_t *cr, tSmithOptions *pOptions ) {
 
         cairo_new_path( cr );
         cairo_arc( cr, 0, 0, WAVE_RING_RADIUS, 0, 2.0 * M_PI );
-        cairo_stroke( cr );
+        strokePath( cr, pCompact );
 
         for( ix=1, lstep = M_PI / 125; ix <= 250; ix++ ) {
             cairo_save( cr ); {
                 cairo_rotate( cr, ix * lstep);
                 cairo_move_to( cr, -(WAVE_RING_RADIUS + SRpct(0.8)) , 0 );
                 cairo_rel_line_to( cr, SRpct(1.6), 0);
-                cairo_stroke( cr );
+                strokePath( cr, pCompact );
             } cairo_restore( cr );
 
             if( ix % 5 == 0 && ix > 16 ) {
@@ -841,22 +1281,22 @@ drawWavelengthRing( cairo_t *cr, tSmithOptions *pOptions ) {
                     cairo_rotate( cr, ix * lstep);
                     cairo_translate( cr, -(WAVE_RING_RADIUS - SRpct(1.25) - LABELFONTSIZE), 0 );
                     cairo_rotate( cr, M_PI / 2.0);
-                    centreJustifiedCairoText( cr, sWaveNumber, 0.0, 0.0);
+                    centreJustifiedCairoText( cr, pCompact, sWaveNumber, 0.0, 0.0);
                 } cairo_restore( cr );
 
                 cairo_save( cr ); {
                     cairo_rotate( cr, -ix * lstep);
                     cairo_translate( cr, -(WAVE_RING_RADIUS + SRpct(1.5)), 0 );
                     cairo_rotate( cr, M_PI / 2.0);
-                    centreJustifiedCairoText( cr, sWaveNumber, 0.0, 0.0);
+                    centreJustifiedCairoText( cr, pCompact, sWaveNumber, 0.0, 0.0);
                 } cairo_restore( cr );
 
                 g_free( sWaveNumber );
             }
         }
 
-        circleCairoText( cr, "WAVELENGTHS TOWARD GENERATOR", WAVE_RING_RADIUS + SRpct(1.25), DEGtoRAD(165.6), 0, 0 );
-        circleCairoText( cr, "WAVELENGTHS TOWARD LOAD", WAVE_RING_RADIUS - SRpct( 3 ), DEGtoRAD(-165.5), 0, 0 );
+        circleCairoText( cr, pCompact, "WAVELENGTHS TOWARD GENERATOR", WAVE_RING_RADIUS + SRpct(1.25), DEGtoRAD(165.6), 0, 0 );
+        circleCairoText( cr, pCompact, "WAVELENGTHS TOWARD LOAD", WAVE_RING_RADIUS - SRpct( 3 ), DEGtoRAD(-165.5), 0, 0 );
 
         drawCurvedArrow( cr, WAVE_RING_RADIUS + SRpct(2.0), DEGtoRAD(178.2), DEGtoRAD(174.9) );
         drawCurvedArrow( cr, WAVE_RING_RADIUS + SRpct(2.0), DEGtoRAD(156.3), DEGtoRAD(153.0) );
@@ -867,7 +1307,7 @@ drawWavelengthRing( cairo_t *cr, tSmithOptions *pOptions ) {
         cairo_new_path( cr );
         cairo_set_line_width( cr, STROKE_WIDTH_MINOR );
         cairo_arc( cr, 0, 0, OUTER_BOUNDARY_WITH_RING, 0, 2.0 * M_PI );
-        cairo_stroke( cr );
+        strokePath( cr, pCompact );
     } cairo_restore( cr );
 }
 
@@ -878,18 +1318,19 @@ drawWavelengthRing( cairo_t *cr, tSmithOptions *pOptions ) {
  * \ingroup plot
  *
  * \param cr                pointer to cairo context
+ * \param pCompact          compact drawing state (or NULL)
  * \param radialAngle       angle of the radial
  * \param radialDistance    distance from the origin
  * \param sLable            pointer to sting to print
  *
  */
-void
-printNormalToRadial ( cairo_t *cr, gdouble radialAngle, gdouble radialDistance, gchar *sLabel ){
+static void
+printNormalToRadial ( cairo_t *cr, tCompact *pCompact, gdouble radialAngle, gdouble radialDistance, gchar *sLabel ){
     cairo_save( cr ); {
         cairo_rotate( cr, radialAngle );
         cairo_translate( cr, radialDistance, 0.0 );
         cairo_rotate( cr, -M_PI/2.0 );   // print on the normal to the radial
-        centreJustifiedCairoText( cr, sLabel, 0.0, 0.0);
+        centreJustifiedCairoText( cr, pCompact, sLabel, 0.0, 0.0);
     } cairo_restore( cr );
 }
 
@@ -928,11 +1369,12 @@ findTCradial( gdouble angleDegrees, gdouble unitRadius, gdouble coeffRadiuus ) {
  * \ingroup plot
  *
  * \param cr        pointer to cairo context
+ * \param pCompact  compact drawing state (or NULL)
  * \param pOptions pointer to options settings
  *
  */
-void
-drawAngleRing( cairo_t *cr, tSmithOptions *pOptions ) {
+static void
+drawAngleRing( cairo_t *cr, tCompact *pCompact, tSmithOptions *pOptions ) {
     gint deg;
 #define SSTRLEN 20
     gchar sstr[ SSTRLEN ];
@@ -943,27 +1385,27 @@ drawAngleRing( cairo_t *cr, tSmithOptions *pOptions ) {
         cairo_new_path( cr );
         cairo_arc( cr, 0, 0, ANGLE_RING_RADIUS, 0, 2.0 * M_PI );
         cairo_arc( cr, 0, 0, ANGLE_RING_RADIUS + SRpct( 3.5 ), 0, 2.0 * M_PI );
-        cairo_stroke( cr );
+        strokePath( cr, pCompact );
 
         cairo_save( cr ); {
             for( deg = 0; deg <= 178; deg += 2 ) {
                 cairo_move_to( cr, -ANGLE_RING_RADIUS, 0 );
                 cairo_rel_line_to( cr, SRpct( -1.5 ), 0 );
-                cairo_stroke( cr );
+                strokePath( cr, pCompact );
                 cairo_move_to( cr, ANGLE_RING_RADIUS, 0 );
                 cairo_rel_line_to( cr, SRpct( 1.5 ), 0 );
-                cairo_stroke( cr );
+                strokePath( cr, pCompact );
                 cairo_rotate( cr, DEGtoRAD( 2 ) );
             }
         } cairo_restore( cr );
 
         for( deg = 20; deg <= 170; deg += 10 ) {
             g_snprintf( sstr, SSTRLEN, "%d", deg );
-            printNormalToRadial ( cr, DEGtoRAD( deg ), ANGLE_RING_RADIUS + SRpct( 1 ), sstr );
+            printNormalToRadial ( cr, pCompact, DEGtoRAD( deg ), ANGLE_RING_RADIUS + SRpct( 1 ), sstr );
             g_snprintf( sstr, SSTRLEN, "%d", -deg );
-            printNormalToRadial ( cr, DEGtoRAD( -deg ), ANGLE_RING_RADIUS + SRpct( 1 ), sstr );
+            printNormalToRadial ( cr, pCompact, DEGtoRAD( -deg ), ANGLE_RING_RADIUS + SRpct( 1 ), sstr );
         }
-        printNormalToRadial ( cr, DEGtoRAD( 180 ), ANGLE_RING_RADIUS + SRpct( 1 ), "±180" );
+        printNormalToRadial ( cr, pCompact, DEGtoRAD( 180 ), ANGLE_RING_RADIUS + SRpct( 1 ), "±180" );
 
         cairo_save( cr ); {
             cairo_translate( cr, -SMITH_RADIUS, 0 );
@@ -973,27 +1415,27 @@ drawAngleRing( cairo_t *cr, tSmithOptions *pOptions ) {
                     cairo_rotate( cr, DEGtoRAD( deg ) );
                     cairo_move_to( cr, TCradial, 0 );
                     cairo_rel_line_to( cr, SRpct( deg <= 55 ? -1.5 : -2.0 ), 0 );
-                    cairo_stroke( cr );
+                    strokePath( cr, pCompact );
                     if( deg >= 10 && (deg % 5) == 0 ) {
                         cairo_move_to( cr, TCradial - SRpct( 0.85 ), 0);
                         g_snprintf( sstr, SSTRLEN, "%d", deg );
                         cairo_rel_move_to(cr,
                                 -stringWidthCairoText(cr, sstr) - (LABELFONTSIZE * deg/90),
                                 -LABELFONTSIZE * (deg <= 45 ? 0.33 : deg/90.0) );
-                        cairo_show_text (cr, sstr);
+                        showText( cr, pCompact, sstr );
                     }
                 } cairo_restore( cr );
                 cairo_save( cr ); {
                     cairo_rotate( cr, M_PI - DEGtoRAD( deg ) );
                     cairo_move_to( cr, -TCradial, 0 );
                     cairo_rel_line_to( cr, SRpct( deg <= 55 ? 1.5 : 2.0 ), 0 );
-                    cairo_stroke( cr );
+                    strokePath( cr, pCompact );
                     if( deg >= 10 && (deg % 5) == 0 ) {
                         cairo_move_to( cr, -TCradial + LABELFONTSIZE/(deg < 45 ? 3 : 2 ),
                                 -LABELFONTSIZE * (deg <= 45 ? 0.5 : deg/90.0) );
                                // deg <= 45 ? (-LABELFONTSIZE * 0.5) : (-LABELFONTSIZE * deg/90));
                         g_snprintf( sstr, SSTRLEN, "%d", -deg );
-                        cairo_show_text (cr, sstr);
+                        showText( cr, pCompact, sstr );
                     }
                 } cairo_restore( cr );
             }
@@ -1001,11 +1443,40 @@ drawAngleRing( cairo_t *cr, tSmithOptions *pOptions ) {
 
     } cairo_restore( cr );
 
-    circleCairoText( cr, "ANGLE OF REFLECTION COEFFICIENT IN DEGREES", ANGLE_RING_RADIUS + SRpct( 1 ), DEGtoRAD(0), 0, 0 );
-    circleCairoText( cr, "ANGLE OF TRANSMISSION COEFFICIENT IN DEGREES", ANGLE_RING_RADIUS - SRpct( 2.7 ), DEGtoRAD(0), 0, 0 );
+    circleCairoText( cr, pCompact, "ANGLE OF REFLECTION COEFFICIENT IN DEGREES", ANGLE_RING_RADIUS + SRpct( 1 ), DEGtoRAD(0), 0, 0 );
+    circleCairoText( cr, pCompact, "ANGLE OF TRANSMISSION COEFFICIENT IN DEGREES", ANGLE_RING_RADIUS - SRpct( 2.7 ), DEGtoRAD(0), 0, 0 );
 }
 
 
+/*!     \brief  Convert a position on the drawing area to Complex Gamma
+ *
+ * Convert a position on the drawing area (e.g. of the mouse pointer) to
+ * the point in gamma space drawn there. This is the inverse of the
+ * transformation saved by drawSmithChart() in pOptions->matrix.
+ *
+ * \ingroup plot
+ *
+ * \param x                 horizontal position on the drawing area
+ * \param y                 vertical position on the drawing area
+ * \param pOptions          pointer to options settings
+ * \return                  point in gamma Cartesian space (NAN if the chart has not been drawn)
+ *
+ */
+tUV
+deviceToUV( gdouble x, gdouble y, tSmithOptions *pOptions ) {
+    cairo_matrix_t inverse;
+
+    if( pOptions == NULL )
+        pOptions = &defaultOptions;
+
+    inverse = pOptions->matrix;
+    if( cairo_matrix_invert( &inverse ) != CAIRO_STATUS_SUCCESS )
+        return (tUV){ NAN, NAN };
+
+    cairo_matrix_transform_point( &inverse, &x, &y );
+    return (tUV){ x / SMITH_RADIUS, y / SMITH_RADIUS };
+}
+
 /*!     \brief  Draw a line on the Smith chart
  *
  * Draw a line on the Smith chart from two points in Cartesian gamma space
@@ -1194,6 +1665,365 @@ drawLineArrayOnSmithChart( cairo_t *cr, tUV uvPoints[], gint length, tSmithOptio
     } cairo_restore( cr );
 }
 
+/*!     \brief  Draw a trace on the Smith chart
+ *
+ * Draw lines on the Smith chart between the points of a trace
+ *
+ * \ingroup plot
+ *
+ * \param cr                pointer to the cairo context
+ * \param pTrace            pointer to the trace
+ * \param pOptions          pointer to options settings
+ *
+ */
+void
+drawTraceOnSmithChart( cairo_t *cr, const tSmithTrace *pTrace, tSmithOptions *pOptions ) {
+    if( pOptions == NULL )
+        pOptions = &defaultOptions;
+
+    if( pTrace == NULL || pTrace->nPoints == 0 )
+        return;
+
+    cairo_save( cr ); {
+        // restore scaling and transformation
+        cairo_set_matrix( cr, &pOptions->matrix );
+
+        cairo_set_line_width( cr, SRpct(pOptions->lineWidth) );
+        cairo_set_source_rgba(cr, pOptions->colorLine.red, pOptions->colorLine.green,
+                pOptions->colorLine.blue, pOptions->colorLine.alpha);
+
+        cairo_new_path( cr );
+
+        cairo_move_to( cr, pTrace->pU[0], pTrace->pV[0] );
+        for( gint i=1; i < pTrace->nPoints; i++ )
+            cairo_line_to( cr, pTrace->pU[i], pTrace->pV[i] );
+        cairo_stroke( cr );
+
+    } cairo_restore( cr );
+}
+
+/*!     \brief  Fill a region on the Smith chart
+ *
+ * Fill a region bounded by closed outlines (in Cartesian gamma space).
+ * Loop i is the points loopStart[i] to loopStart[i+1]-1. The outlines are
+ * filled together with the non-zero winding rule, so overlapping outlines of
+ * the same direction are filled as their union and an outline of the
+ * opposite direction inside another is a hole.
+ *
+ * \ingroup plot
+ *
+ * \param cr                pointer to the cairo context
+ * \param uvPoints          array of points of the outlines
+ * \param loopStart         index of the first point of each outline (nLoops + 1 entries)
+ * \param nLoops            number of outlines
+ * \param pOptions          pointer to options settings
+ *
+ */
+void
+drawRegionOnSmithChart( cairo_t *cr, const tUV uvPoints[], const gint loopStart[], gint nLoops,
+        tSmithOptions *pOptions ) {
+    if( pOptions == NULL )
+        pOptions = &defaultOptions;
+
+    cairo_save( cr ); {
+        // restore scaling and transformation
+        cairo_set_matrix( cr, &pOptions->matrix );
+
+        cairo_set_source_rgba(cr, pOptions->colorRegion.red, pOptions->colorRegion.green,
+                pOptions->colorRegion.blue, pOptions->colorRegion.alpha);
+        cairo_set_fill_rule( cr, CAIRO_FILL_RULE_WINDING );
+
+        cairo_new_path( cr );
+
+        for( gint loop=0; loop < nLoops; loop++ ) {
+            if( loopStart[ loop + 1 ] - loopStart[ loop ] < 3 )
+                continue;
+            cairo_move_to( cr, uvPoints[ loopStart[ loop ] ].U, uvPoints[ loopStart[ loop ] ].V );
+            for( gint i = loopStart[ loop ] + 1; i < loopStart[ loop + 1 ]; i++ )
+                cairo_line_to( cr, uvPoints[i].U, uvPoints[i].V );
+            cairo_close_path( cr );
+        }
+        cairo_fill( cr );
+
+    } cairo_restore( cr );
+}
+
+/*!     \brief  Draw arcs on the Smith chart
+ *
+ * Draw circular arcs (in Cartesian gamma space) on the Smith chart.
+ * The arcs are stroked together as one path.
+ *
+ * \ingroup plot
+ *
+ * \param cr                pointer to the cairo context
+ * \param arcs              array of arcs in gamma space
+ * \param length            number of arcs
+ * \param pOptions          pointer to options settings
+ *
+ */
+void
+drawArcArrayOnSmithChart( cairo_t *cr, const tArc arcs[], gint length, tSmithOptions *pOptions ) {
+    if( pOptions == NULL )
+        pOptions = &defaultOptions;
+
+    cairo_save( cr ); {
+        // restore scaling and transformation
+        cairo_set_matrix( cr, &pOptions->matrix );
+
+        cairo_set_line_width( cr, SRpct(pOptions->lineWidth) );
+        cairo_set_source_rgba(cr, pOptions->colorLine.red, pOptions->colorLine.green,
+                pOptions->colorLine.blue, pOptions->colorLine.alpha);
+
+        cairo_new_path( cr );
+
+        for( gint i=0; i < length; i++ ) {
+            cairo_new_sub_path( cr );
+            if( arcs[i].bNegative )
+                cairo_arc_negative( cr, arcs[i].center.U, arcs[i].center.V, arcs[i].radius,
+                        arcs[i].angleStart, arcs[i].angleEnd );
+            else
+                cairo_arc( cr, arcs[i].center.U, arcs[i].center.V, arcs[i].radius,
+                        arcs[i].angleStart, arcs[i].angleEnd );
+        }
+        cairo_stroke( cr );
+
+    } cairo_restore( cr );
+}
+
+/*!     \brief  Draw circles on the Smith chart
+ *
+ * Draw circles (in Cartesian gamma space) on the Smith chart, clipped to
+ * the chart. The circles are stroked together as one path.
+ *
+ * \ingroup plot
+ *
+ * \param cr                pointer to the cairo context
+ * \param circles           array of circles in gamma space
+ * \param length            number of circles
+ * \param pOptions          pointer to options settings
+ *
+ */
+void
+drawCircleArrayOnSmithChart( cairo_t *cr, const tCircle circles[], gint length, tSmithOptions *pOptions ) {
+    if( pOptions == NULL )
+        pOptions = &defaultOptions;
+
+    cairo_save( cr ); {
+        // restore scaling and transformation
+        cairo_set_matrix( cr, &pOptions->matrix );
+
+        cairo_new_path( cr );
+        cairo_arc( cr, 0.0, 0.0, SMITH_RADIUS, 0.0, 2.0 * M_PI );
+        cairo_clip( cr );
+
+        cairo_set_line_width( cr, SRpct(pOptions->lineWidth) );
+        cairo_set_source_rgba(cr, pOptions->colorLine.red, pOptions->colorLine.green,
+                pOptions->colorLine.blue, pOptions->colorLine.alpha);
+
+        for( gint i=0; i < length; i++ ) {
+            if( !isfinite( circles[i].radius ) || !isfinite( circles[i].center.U )
+                    || !isfinite( circles[i].center.V ) )
+                continue;
+            cairo_new_sub_path( cr );
+            cairo_arc( cr, circles[i].center.U, circles[i].center.V, circles[i].radius, 0.0, 2.0 * M_PI );
+        }
+        cairo_stroke( cr );
+
+    } cairo_restore( cr );
+}
+
+/*!     \brief  Path of the inside or outside of a circle
+ *
+ * Path of the inside of a circle, or of the outside (up to well beyond the
+ * chart) when filled or clipped with the even-odd rule
+ *
+ * \ingroup plot
+ *
+ * \param cr                pointer to the cairo context
+ * \param pCircle           pointer to the circle in gamma space
+ * \param bOutside          path of the outside of the circle
+ *
+ */
+static void
+circleRegionPath( cairo_t *cr, const tCircle *pCircle, gboolean bOutside ) {
+    cairo_new_path( cr );
+    cairo_arc( cr, pCircle->center.U, pCircle->center.V, pCircle->radius, 0.0, 2.0 * M_PI );
+    if( bOutside ) {
+        // a circle around the whole chart makes the inside of the circle a hole
+        cairo_new_sub_path( cr );
+        cairo_arc( cr, pCircle->center.U, pCircle->center.V,
+                pCircle->radius + hypot( pCircle->center.U, pCircle->center.V ) + 2.0 * SMITH_RADIUS,
+                0.0, 2.0 * M_PI );
+    }
+    cairo_set_fill_rule( cr, CAIRO_FILL_RULE_EVEN_ODD );
+}
+
+/*!     \brief  Shade a circle on the Smith chart
+ *
+ * Fill the part of the chart inside (or outside) a circle
+ * (in Cartesian gamma space) in the region color
+ *
+ * \ingroup plot
+ *
+ * \param cr                pointer to the cairo context
+ * \param pCircle           pointer to the circle in gamma space
+ * \param bOutside          fill the chart outside the circle rather than inside
+ * \param pOptions          pointer to options settings
+ *
+ */
+void
+fillCircleOnSmithChart( cairo_t *cr, const tCircle *pCircle, gboolean bOutside, tSmithOptions *pOptions ) {
+    if( pOptions == NULL )
+        pOptions = &defaultOptions;
+
+    if( !isfinite( pCircle->radius ) || !isfinite( pCircle->center.U ) || !isfinite( pCircle->center.V ) )
+        return;
+
+    cairo_save( cr ); {
+        // restore scaling and transformation
+        cairo_set_matrix( cr, &pOptions->matrix );
+
+        cairo_new_path( cr );
+        cairo_arc( cr, 0.0, 0.0, SMITH_RADIUS, 0.0, 2.0 * M_PI );
+        cairo_clip( cr );
+
+        cairo_set_source_rgba(cr, pOptions->colorRegion.red, pOptions->colorRegion.green,
+                pOptions->colorRegion.blue, pOptions->colorRegion.alpha);
+
+        circleRegionPath( cr, pCircle, bOutside );
+        cairo_fill( cr );
+
+    } cairo_restore( cr );
+}
+
+/*!     \brief  Clip to a circle on the Smith chart
+ *
+ * Restrict further drawing to the inside (or outside) of a circle
+ * (in Cartesian gamma space). Use between cairo_save() and cairo_restore().
+ *
+ * \ingroup plot
+ *
+ * \param cr                pointer to the cairo context
+ * \param pCircle           pointer to the circle in gamma space
+ * \param bOutside          clip to the outside of the circle rather than inside
+ * \param pOptions          pointer to options settings
+ *
+ */
+void
+clipCircleOnSmithChart( cairo_t *cr, const tCircle *pCircle, gboolean bOutside, tSmithOptions *pOptions ) {
+    cairo_matrix_t matrix;
+    cairo_fill_rule_t fillRule;
+
+    if( pOptions == NULL )
+        pOptions = &defaultOptions;
+
+    if( !isfinite( pCircle->radius ) || !isfinite( pCircle->center.U ) || !isfinite( pCircle->center.V ) )
+        return;
+
+    cairo_get_matrix( cr, &matrix );
+    fillRule = cairo_get_fill_rule( cr );
+    cairo_set_matrix( cr, &pOptions->matrix );
+
+    circleRegionPath( cr, pCircle, bOutside );
+    cairo_clip( cr );
+
+    cairo_set_fill_rule( cr, fillRule );
+    cairo_set_matrix( cr, &matrix );
+}
+
+/*!     \brief  Path of a half plane
+ *
+ * Path covering the part of the chart on the left of the line through two
+ * points (in Cartesian gamma space)
+ *
+ * \ingroup plot
+ *
+ * \param cr                pointer to the cairo context
+ * \param pLine             pointer to two distinct points of the line
+ */
+static void
+halfPlanePath( cairo_t *cr, const tLine *pLine ) {
+    gdouble length = hypot( pLine->B.U - pLine->A.U, pLine->B.V - pLine->A.V );
+    // along the line, and to its left, far enough from A to cover the chart
+    gdouble reach = hypot( pLine->A.U, pLine->A.V ) + 2.0 * SMITH_RADIUS;
+    tUV along = { (pLine->B.U - pLine->A.U) / length * reach, (pLine->B.V - pLine->A.V) / length * reach };
+
+    cairo_new_path( cr );
+    cairo_move_to( cr, pLine->A.U - along.U, pLine->A.V - along.V );
+    cairo_line_to( cr, pLine->A.U + along.U, pLine->A.V + along.V );
+    cairo_line_to( cr, pLine->A.U + along.U - along.V, pLine->A.V + along.V + along.U );
+    cairo_line_to( cr, pLine->A.U - along.U - along.V, pLine->A.V - along.V + along.U );
+    cairo_close_path( cr );
+}
+
+/*!     \brief  Shade a half plane on the Smith chart
+ *
+ * Fill the part of the chart on the left of the line from A to B
+ * (in Cartesian gamma space) in the region color
+ *
+ * \ingroup plot
+ *
+ * \param cr                pointer to the cairo context
+ * \param pLine             pointer to the line (A and B distinct)
+ * \param pOptions          pointer to options settings
+ *
+ */
+void
+fillHalfPlaneOnSmithChart( cairo_t *cr, const tLine *pLine, tSmithOptions *pOptions ) {
+    if( pOptions == NULL )
+        pOptions = &defaultOptions;
+
+    if( pLine->A.U == pLine->B.U && pLine->A.V == pLine->B.V )
+        return;
+
+    cairo_save( cr ); {
+        // restore scaling and transformation
+        cairo_set_matrix( cr, &pOptions->matrix );
+
+        cairo_new_path( cr );
+        cairo_arc( cr, 0.0, 0.0, SMITH_RADIUS, 0.0, 2.0 * M_PI );
+        cairo_clip( cr );
+
+        cairo_set_source_rgba(cr, pOptions->colorRegion.red, pOptions->colorRegion.green,
+                pOptions->colorRegion.blue, pOptions->colorRegion.alpha);
+
+        halfPlanePath( cr, pLine );
+        cairo_fill( cr );
+
+    } cairo_restore( cr );
+}
+
+/*!     \brief  Clip to a half plane on the Smith chart
+ *
+ * Restrict further drawing to the left of the line from A to B
+ * (in Cartesian gamma space). Use between cairo_save() and cairo_restore().
+ *
+ * \ingroup plot
+ *
+ * \param cr                pointer to the cairo context
+ * \param pLine             pointer to the line (A and B distinct)
+ * \param pOptions          pointer to options settings
+ *
+ */
+void
+clipHalfPlaneOnSmithChart( cairo_t *cr, const tLine *pLine, tSmithOptions *pOptions ) {
+    cairo_matrix_t matrix;
+
+    if( pOptions == NULL )
+        pOptions = &defaultOptions;
+
+    if( pLine->A.U == pLine->B.U && pLine->A.V == pLine->B.V )
+        return;
+
+    cairo_get_matrix( cr, &matrix );
+    cairo_set_matrix( cr, &pOptions->matrix );
+
+    halfPlanePath( cr, pLine );
+    cairo_clip( cr );
+
+    cairo_set_matrix( cr, &matrix );
+}
+
 /*!     \brief  Draw a point on the Smith chart
  *
  * Draw a point on the Smith chart
@@ -1245,11 +2075,18 @@ drawPointOnSmithChart( cairo_t *cr, tUV uvPoint, tSmithOptions *pOptions ) {
  */
 void
 annotatePointOnSmithChart( cairo_t *cr, gchar *sLabel, tUV uv, gboolean bLeft, tSmithOptions *pOptions ) {
+    tCompact compact, *pCompact = NULL;
     gdouble fontSize;
 
     if( pOptions == NULL )
         pOptions = &defaultOptions;
 
+    // (what is already drawn cannot be kept out of the label, so a compact label is drawn over it)
+    if( pOptions->flags.bCompact ) {
+        compactInit( &compact, FALSE, FALSE );
+        pCompact = &compact;
+    }
+
     cairo_save( cr ); {
         // restore scaling and transformation
         cairo_set_matrix( cr, &pOptions->matrix );
@@ -1265,10 +2102,13 @@ annotatePointOnSmithChart( cairo_t *cr, gchar *sLabel, tUV uv, gboolean bLeft, t
         setCairoFontSize( cr, fontSize );
 
         if( bLeft )
-            leftJustifiedClearText( cr,  sLabel, uv.U + (fontSize * 0.5), uv.V - (fontSize * 0.3) );
+            leftJustifiedClearText( cr, pCompact,  sLabel, uv.U + (fontSize * 0.5), uv.V - (fontSize * 0.3) );
         else
-            rightJustifiedClearText( cr, sLabel, uv.U - (fontSize * 0.5), uv.V - (fontSize * 0.3) );
+            rightJustifiedClearText( cr, pCompact, sLabel, uv.U - (fontSize * 0.5), uv.V - (fontSize * 0.3) );
     } cairo_restore( cr );
+
+    if( pCompact )
+        compactClear( pCompact );
 }
 
 /*!     \brief  Draw the Smith chart at the specified location
@@ -1287,10 +2127,16 @@ annotatePointOnSmithChart( cairo_t *cr, gchar *sLabel, tUV uv, gboolean bLeft, t
 void
 drawSmithChart( cairo_t *cr, gdouble centerX, gdouble centerY,
         gdouble radius, tSmithOptions *pOptions ) {
+    tCompact compact, *pCompact = NULL;
 
     if( pOptions == NULL )
         pOptions = &defaultOptions;
 
+    if( pOptions->flags.bCompact ) {
+        compactInit( &compact, TRUE, pOptions->flags.bReuseGlyphs );
+        pCompact = &compact;
+    }
+
     // Adjust scale factor to account for the wavelength / angle rings
    if( pOptions->flags.bDrawRing )
        radius /= ( OUTER_BOUNDARY_WITH_RING / SMITH_RADIUS );
@@ -1308,24 +2154,30 @@ drawSmithChart( cairo_t *cr, gdouble centerX, gdouble centerY,
        setCairoFontSize( cr, LABELFONTSIZE );
 
        if( pOptions->flags.bShowGB ) {
-           drawGBgrid( cr,  pOptions->flags.bSparceGB ? sparseGrid : stdGrid, pOptions );
+           drawGBgrid( cr, pCompact, pOptions->flags.bSparceGB ? sparseGrid : stdGrid, pOptions );
        }
        if( pOptions->flags.bShowRX ) {
-           drawRXgrid( cr,  stdGrid, pOptions );
+           drawRXgrid( cr, pCompact, stdGrid, pOptions );
        }
 
        if( pOptions->flags.bShowRX ) {
-           drawRXgridText( cr,  stdGrid, pOptions );
+           drawRXgridText( cr, pCompact, stdGrid, pOptions );
        }
        if( pOptions->flags.bShowGB ) {
-           drawGBgridText( cr,  pOptions->flags.bSparceGB ? sparseGrid : stdGrid, pOptions );
+           drawGBgridText( cr, pCompact, pOptions->flags.bSparceGB ? sparseGrid : stdGrid, pOptions );
        }
 
 
        if( pOptions->flags.bDrawRing ) {
            cairo_set_source_rgba(cr, pOptions->colorRing.red, pOptions->colorRing.green, pOptions->colorRing.blue, pOptions->colorRing.alpha);
-           drawWavelengthRing( cr, pOptions );
-           drawAngleRing( cr, pOptions );
+           drawWavelengthRing( cr, pCompact, pOptions );
+           drawAngleRing( cr, pCompact, pOptions );
+       }
+
+       // the strokes of a compact drawing are drawn last, around the text
+       if( pCompact ) {
+           compactFinish( cr, pCompact );
+           compactClear( pCompact );
        }
 
        // Save the transformation matrix relevant to the Smith chart.
@@ -28,6 +28,8 @@ typedef struct {
         guint bShowStrings : 1;
         guint bDrawRing    : 1;
         guint bSparceGB    : 1;
+        guint bCompact     : 1;    // smaller PDF / SVG output (merged grid paths, no clearing)
+        guint bReuseGlyphs : 1;    // with bCompact, each glyph drawn once and painted where it appears (SVG only)
     } flags;
 
     gdouble lineWidth;  // as a percentage of the radius
@@ -35,7 +37,8 @@ typedef struct {
 
     GdkRGBA colorRXgrid, colorGBgrid,
             colorRXtext, colorGBtext, colorRing,
-            colorLine, colorAnnotation;
+            colorLine, colorAnnotation,
+            colorRegion;    // filled regions (usually translucent)
 
     gchar   *annotationFont;
     gint    annotationFontSize; // as a percentage of the radius
@@ -67,6 +70,31 @@ typedef struct
     tUV A, B;
 } tLine;
 
+typedef struct {
+    tUV     center;
+    gdouble radius;
+    gdouble angleStart, angleEnd;   // radians
+    gboolean bNegative;             // clockwise (decreasing angle) from angleStart to angleEnd
+} tArc;
+
+typedef struct {
+    tUV     center;
+    gdouble radius;                 // INFINITY if the circle is a straight line
+} tCircle;
+
+// Trace data as a structure of arrays (see GTKsmithTrace.c)
+typedef struct {
+    struct {
+        guint bBorrowed     : 1;    // the arrays belong to someone else (e.g. a mapped file)
+        guint bSharedFreq   : 1;    // pFreq belongs to someone else (e.g. another trace)
+    } flags;
+
+    gint    nPoints;                // number of valid points
+    gint    nAllocated;             // capacity of the arrays
+    gdouble *pU, *pV;               // gamma
+    gdouble *pFreq;                 // frequency of each point in Hz (or NULL)
+} tSmithTrace;
+
 #define END (-1)
 #define SPECIAL_CASE (0)
 
@@ -101,10 +129,20 @@ typedef struct
 #define RIGHT_JUSTIFIED FALSE
 
 tUV RXtoUV( tRX );
+tRX UVtoRX( tUV );
+tUV deviceToUV( gdouble, gdouble, tSmithOptions * );
 void annotatePointOnSmithChart( cairo_t *, gchar *, tUV, gboolean, tSmithOptions * );
 void drawSmithChart( cairo_t *, gdouble, gdouble, gdouble, tSmithOptions * );
 void drawPointOnSmithChart( cairo_t *, tUV, tSmithOptions * );
 void drawLineArrayOnSmithChart( cairo_t *, tUV [], gint, tSmithOptions * );
 void drawBezierCurveOnSmithChart(cairo_t *, const tUV [], gint, tSmithOptions * );
+void drawArcArrayOnSmithChart( cairo_t *, const tArc [], gint, tSmithOptions * );
+void drawCircleArrayOnSmithChart( cairo_t *, const tCircle [], gint, tSmithOptions * );
+void fillCircleOnSmithChart( cairo_t *, const tCircle *, gboolean, tSmithOptions * );
+void clipCircleOnSmithChart( cairo_t *, const tCircle *, gboolean, tSmithOptions * );
+void fillHalfPlaneOnSmithChart( cairo_t *, const tLine *, tSmithOptions * );
+void clipHalfPlaneOnSmithChart( cairo_t *, const tLine *, tSmithOptions * );
+void drawTraceOnSmithChart( cairo_t *, const tSmithTrace *, tSmithOptions * );
+void drawRegionOnSmithChart( cairo_t *, const tUV [], const gint [], gint, tSmithOptions * );
 
 #endif /* GTKSMITHCHART_H_ */
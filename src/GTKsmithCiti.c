@@ -0,0 +1,394 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithCiti.c
+ * @brief CITIfile loader
+ *
+ * @author Michael G. Katzmann
+ *
+ * A CITIfile (as exported by many network analyzers) is loaded into a
+ * tSmithNetwork. The header declares the independent variable
+ * ("VAR FREQ MAG 201"), whose values follow in a SEG_LIST or VAR_LIST, and
+ * the data arrays ("DATA S[2,1] RI"), whose values then follow in the same
+ * order, one BEGIN ... END block each, a point per line.
+ *
+ * The header is read line by line, and the regions of the blocks are found.
+ * The blocks are then parsed in parallel, each by the parallel table parser
+ * of GTKsmithParse.c, directly into the trace of its parameter. Parameters
+ * named S[i,j] (or Sij, or Y and Z) are placed in the network; those not in
+ * the file are NULL (see smithNetworkParameter()). A file of one array with
+ * another name is taken as S11 of a one-port.
+ *
+ * Only the first package of a file, with one independent variable, is loaded.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GTKsmithCiti.h"
+#include "GTKsmithTrace.h"
+#include "GTKsmithParse.h"
+#include "GTKsmithParallel.h"
+
+typedef enum {
+    eCitiRI, eCitiMA, eCitiDB
+} tCitiFormat;
+
+typedef struct {
+    const gchar *pName, *pNameEnd;      // e.g. S[2,1]
+    tCitiFormat  format;
+    gint         parameter;             // row major in the network (or -1)
+    const gchar *pStart, *pEnd;         // the block of numbers (pStart NULL if there is none)
+    const gchar *pError;                // text that is not a number (or NULL)
+    gint64       nNumbers;
+} tCitiData;
+
+typedef struct {
+    tCitiData     *pData;
+    gint           nData;
+    tSmithNetwork *pNetwork;
+} tCitiLoad;
+
+/*!     \brief  End of a word
+ *
+ * Find the end of the word at p
+ *
+ * \ingroup citi
+ *
+ * \param p         start of the word
+ * \param pEnd      end of the text
+ * \return          the character after the word
+ */
+static const gchar *
+wordEnd( const gchar *p, const gchar *pEnd ) {
+    while( p < pEnd && *p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' )
+        p++;
+    return p;
+}
+
+/*!     \brief  Port indices of a data array
+ *
+ * Port indices and type of a data array from its name (S[2,1], S21, Y[1,1] ...)
+ *
+ * \ingroup citi
+ *
+ * \param pName     start of the name
+ * \param pNameEnd  end of the name
+ * \param pType     where the parameter type is written
+ * \param pRow      where the row (from 1) is written
+ * \param pColumn   where the column (from 1) is written
+ * \return          FALSE if the name is not that of a parameter
+ */
+static gboolean
+parameterFromName( const gchar *pName, const gchar *pNameEnd, tParameterType *pType, gint *pRow, gint *pColumn ) {
+    gchar *sName = g_strndup( pName, pNameEnd - pName );
+    gint row = 0, column = 0;
+    gboolean bParameter;
+
+    switch( g_ascii_toupper( sName[0] ) ) {
+    case 'S': *pType = eParameterS; break;
+    case 'Y': *pType = eParameterY; break;
+    case 'Z': *pType = eParameterZ; break;
+    default:  g_free( sName ); return FALSE;
+    }
+
+    if( sName[1] == '[' )
+        bParameter = sscanf( sName + 2, "%d,%d]", &row, &column ) == 2;
+    else
+        bParameter = strlen( sName ) == 3 && g_ascii_isdigit( sName[1] ) && g_ascii_isdigit( sName[2] )
+                     && (row = sName[1] - '0') > 0 && (column = sName[2] - '0') > 0;
+    g_free( sName );
+
+    *pRow = row;
+    *pColumn = column;
+    return bParameter && row > 0 && row < 100 && column > 0 && column < 100;
+}
+
+/*!     \brief  Parse data blocks
+ *
+ * Parse a range of the data blocks into the traces of their parameters
+ * (a parallel loop function over the blocks)
+ *
+ * \ingroup citi
+ *
+ * \param from      first block
+ * \param to        last block (exclusive)
+ * \param userData  pointer to the tCitiLoad
+ */
+static void
+parseBlocks( gint from, gint to, gpointer userData ) {
+    tCitiLoad *pLoad = userData;
+    gint nPoints = pLoad->pNetwork->nPoints;
+
+    for( gint d = from; d < to; d++ ) {
+        tCitiData *pData = &pLoad->pData[d];
+        tSmithTrace *pTrace;
+        tParseTable *pTable;
+
+        if( pData->parameter < 0 )
+            continue;
+        pTrace = pLoad->pNetwork->pParameters[ pData->parameter ];
+        pTable = smithParseTableNew( pData->pStart, pData->pEnd, 0 );
+        pData->nNumbers = smithParseTableCount( pTable );
+        if( pData->nNumbers == 2 * (gint64)nPoints ) {
+            gdouble *columns[] = { pTrace->pU, pTrace->pV };
+
+            pData->pError = smithParseTableStore( pTable, 2, columns, nPoints );
+        }
+        smithParseTableFree( pTable );
+
+        if( pData->format != eCitiRI && pData->nNumbers == 2 * (gint64)nPoints && pData->pError == NULL ) {
+            for( gint i = 0; i < nPoints; i++ ) {
+                gdouble magnitude = ( pData->format == eCitiDB ) ? pow( 10.0, pTrace->pU[i] / 20.0 ) : pTrace->pU[i];
+                gdouble angle = pTrace->pV[i] * (M_PI / 180.0);
+
+                pTrace->pU[i] = magnitude * cos( angle );
+                pTrace->pV[i] = magnitude * sin( angle );
+            }
+        }
+    }
+}
+
+/*!     \brief  Parse a CITIfile in memory
+ *
+ * Parse the text of a CITIfile into a network
+ *
+ * \ingroup citi
+ *
+ * \param pText     text of the file (need not be NUL terminated)
+ * \param length    length of the text
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the network (free with smithNetworkFree), or NULL on error
+ */
+tSmithNetwork *
+citifileParse( const gchar *pText, gsize length, GError **ppError ) {
+    const gchar *p = pText, *pEnd = pText + length, *q;
+    const gchar *pVarList = NULL, *pVarListEnd = NULL;
+    GArray *pData = g_array_new( FALSE, TRUE, sizeof( tCitiData ) );
+    GArray *pSegments = g_array_new( FALSE, FALSE, sizeof( gdouble ) );
+    tCitiLoad load = { 0 };
+    tParameterType type = eParameterS;
+    gboolean bCiti = FALSE, *pSelected = NULL;
+    gint nPoints = -1, nPorts = 0, nBlocks = 0;
+    const gchar *sProblem = NULL, *pInvalid = NULL;
+    tParseError problem = eParseErrorData;
+
+    // the header and the regions of the blocks
+    while( p < pEnd && sProblem == NULL ) {
+        const gchar *pNext = smithParseNextLine( p, pEnd );
+
+        if( (q = smithParseSkipSeparators( p, pNext )) == pNext || *q == '\n' ) {
+            // a blank line
+        } else if( smithParseKeyword( p, pNext, "CITIFILE" ) ) {
+            // a second package ends the first
+            if( bCiti )
+                break;
+            bCiti = TRUE;
+        } else if( !bCiti ) {
+            break;
+        } else if( (q = smithParseKeyword( p, pNext, "VAR" )) ) {
+            q = wordEnd( smithParseSkipSeparators( q, pNext ), pNext );       // name
+            q = wordEnd( smithParseSkipSeparators( q, pNext ), pNext );       // format
+            if( nPoints >= 0 )
+                sProblem = "More than one independent variable is not supported";
+            else if( (nPoints = (gint)g_ascii_strtoll( smithParseSkipSeparators( q, pNext ), NULL, 10 )) <= 0 )
+                sProblem = "The independent variable has no length";
+        } else if( (q = smithParseKeyword( p, pNext, "DATA" )) ) {
+            tCitiData data = { .parameter = -1 };
+
+            data.pName = smithParseSkipSeparators( q, pNext );
+            data.pNameEnd = wordEnd( data.pName, pNext );
+            q = data.pNameEnd;
+            if( smithParseKeyword( q, pNext, "RI" ) )
+                data.format = eCitiRI;
+            else if( smithParseKeyword( q, pNext, "MA" ) || smithParseKeyword( q, pNext, "MAGANGLE" ) )
+                data.format = eCitiMA;
+            else if( smithParseKeyword( q, pNext, "DB" ) || smithParseKeyword( q, pNext, "DBANGLE" ) )
+                data.format = eCitiDB;
+            else
+                sProblem = "A data array is not in a complex format (RI, MA or DB)";
+            g_array_append_val( pData, data );
+        } else if( smithParseKeyword( p, pNext, "SEG_LIST_BEGIN" ) ) {
+            for( ; pNext < pEnd && !smithParseKeyword( pNext, pEnd, "SEG_LIST_END" ); pNext = smithParseNextLine( pNext, pEnd ) ) {
+                gdouble start, stop, count;
+
+                if( (q = smithParseKeyword( pNext, pEnd, "SEG" )) == NULL
+                        || (q = smithParseNumber( smithParseSkipSeparators( q, pEnd ), pEnd, &start )) == NULL
+                        || (q = smithParseNumber( smithParseSkipSeparators( q, pEnd ), pEnd, &stop )) == NULL
+                        || smithParseNumber( smithParseSkipSeparators( q, pEnd ), pEnd, &count ) == NULL
+                        || !(count >= 1 && count <= G_MAXINT) ) {
+                    sProblem = "Invalid segment list";
+                    break;
+                }
+                for( gint i = 0; i < (gint)count; i++ ) {
+                    gdouble frequency = count > 1 ? start + (stop - start) * i / (count - 1) : start;
+
+                    g_array_append_val( pSegments, frequency );
+                }
+            }
+            pNext = smithParseNextLine( pNext, pEnd );
+        } else if( smithParseKeyword( p, pNext, "VAR_LIST_BEGIN" ) ) {
+            pVarList = pNext;
+            if( (pVarListEnd = smithParseFindKeyword( pNext, pEnd, "VAR_LIST_END" )) == NULL )
+                sProblem = "The variable list has no end";
+            else
+                pNext = smithParseNextLine( pVarListEnd, pEnd );
+        } else if( smithParseKeyword( p, pNext, "BEGIN" ) ) {
+            tCitiData *pBlock;
+
+            if( nBlocks == (gint)pData->len ) {
+                sProblem = "There are more blocks than data arrays";
+            } else {
+                pBlock = &g_array_index( pData, tCitiData, nBlocks++ );
+                pBlock->pStart = pNext;
+                if( (pBlock->pEnd = smithParseFindKeyword( pNext, pEnd, "END" )) == NULL )
+                    sProblem = "A data block has no end";
+                else
+                    pNext = smithParseNextLine( pBlock->pEnd, pEnd );
+            }
+        }
+        // (NAME, CONSTANT, COMMENT and # lines are ignored)
+
+        p = pNext;
+    }
+
+    if( sProblem == NULL ) {
+        if( !bCiti ) {
+            sProblem = "Not a CITIfile";
+            problem = eParseErrorFormat;
+        } else if( nPoints <= 0 ) {
+            sProblem = "There is no independent variable";
+        } else if( pData->len == 0 || nBlocks < (gint)pData->len ) {
+            sProblem = "A data array has no data block";
+        } else if( pSegments->len > 0 && pSegments->len != (guint)nPoints ) {
+            sProblem = "The segment list does not have the points of the independent variable";
+        }
+    }
+
+    // the place of each array in the network
+    load.pData = (tCitiData *)pData->data;
+    load.nData = pData->len;
+    for( gint d = 0; d < load.nData && sProblem == NULL; d++ ) {
+        tCitiData *pArray = &load.pData[d];
+        tParameterType arrayType;
+        gint row, column;
+
+        if( parameterFromName( pArray->pName, pArray->pNameEnd, &arrayType, &row, &column ) ) {
+            // a network holds parameters of one type
+            if( d > 0 && arrayType != type )
+                sProblem = "The data arrays are parameters of more than one type";
+            type = arrayType;
+            nPorts = MAX( nPorts, MAX( row, column ) );
+            pArray->parameter = row * 100 + column;     // (until the number of ports is known)
+        } else if( load.nData == 1 ) {
+            nPorts = 1;
+            pArray->parameter = 101;
+        } else {
+            sProblem = "A data array is not a parameter of a network";
+        }
+    }
+    if( sProblem == NULL ) {
+        pSelected = g_new0( gboolean, nPorts * nPorts );
+        for( gint d = 0; d < load.nData && sProblem == NULL; d++ ) {
+            tCitiData *pArray = &load.pData[d];
+
+            pArray->parameter = (pArray->parameter / 100 - 1) * nPorts + pArray->parameter % 100 - 1;
+            if( pSelected[ pArray->parameter ] )
+                sProblem = "A parameter is given twice";
+            pSelected[ pArray->parameter ] = TRUE;
+        }
+    }
+
+    if( sProblem ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, problem, "%s", sProblem );
+        g_free( pSelected );
+        g_array_free( pData, TRUE );
+        g_array_free( pSegments, TRUE );
+        return NULL;
+    }
+
+    load.pNetwork = smithNetworkNewSelected( nPorts, nPoints, pSelected );
+    load.pNetwork->type = type;
+    g_free( pSelected );
+
+    // the frequencies (or the point numbers if there are none)
+    if( pSegments->len > 0 ) {
+        memcpy( load.pNetwork->pFreq, pSegments->data, nPoints * sizeof( gdouble ) );
+    } else if( pVarList ) {
+        tParseTable *pTable = smithParseTableNew( pVarList, pVarListEnd, 0 );
+        gdouble *columns[] = { load.pNetwork->pFreq };
+
+        if( smithParseTableCount( pTable ) != nPoints )
+            sProblem = "The variable list does not have the points of the independent variable";
+        else
+            pInvalid = smithParseTableStore( pTable, 1, columns, nPoints );
+        smithParseTableFree( pTable );
+    } else {
+        for( gint i = 0; i < nPoints; i++ )
+            load.pNetwork->pFreq[i] = i;
+    }
+
+    // the blocks in parallel
+    if( sProblem == NULL && pInvalid == NULL )
+        smithParallelFor( load.nData, 1, parseBlocks, &load );
+    for( gint d = 0; d < load.nData && sProblem == NULL && pInvalid == NULL; d++ ) {
+        if( load.pData[d].nNumbers != 2 * (gint64)nPoints )
+            sProblem = "A data block does not have the points of the independent variable";
+        else
+            pInvalid = load.pData[d].pError;
+    }
+
+    if( sProblem )
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "%s", sProblem );
+    else if( pInvalid )
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorNumber,
+                     "Invalid number on line %d", smithParseLineNumber( pText, pInvalid ) );
+    if( sProblem || pInvalid ) {
+        smithNetworkFree( load.pNetwork );
+        load.pNetwork = NULL;
+    }
+
+    g_array_free( pData, TRUE );
+    g_array_free( pSegments, TRUE );
+    return load.pNetwork;
+}
+
+/*!     \brief  Load a CITIfile
+ *
+ * Load a CITIfile (memory mapped and parsed in parallel)
+ *
+ * \ingroup citi
+ *
+ * \param sPath     path of the file
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the network (free with smithNetworkFree), or NULL on error
+ */
+tSmithNetwork *
+citifileLoad( const gchar *sPath, GError **ppError ) {
+    GMappedFile *pMapped = g_mapped_file_new( sPath, FALSE, ppError );
+    tSmithNetwork *pNetwork;
+
+    if( pMapped == NULL )
+        return NULL;
+
+    pNetwork = citifileParse( g_mapped_file_get_contents( pMapped ), g_mapped_file_get_length( pMapped ), ppError );
+    if( pNetwork == NULL && ppError && *ppError )
+        g_prefix_error( ppError, "%s: ", sPath );
+
+    g_mapped_file_unref( pMapped );
+    return pNetwork;
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+
+#ifndef GTKSMITHCITI_H_
+#define GTKSMITHCITI_H_
+
+#include "GTKsmithNetwork.h"
+
+tSmithNetwork *citifileParse( const gchar *, gsize, GError ** );
+tSmithNetwork *citifileLoad( const gchar *, GError ** );
+
+#endif /* GTKSMITHCITI_H_ */
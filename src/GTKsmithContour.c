@@ -0,0 +1,397 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithContour.c
+ * @brief Contours of scattered samples (e.g. load-pull measurements)
+ *
+ * @author Michael G. Katzmann
+ *
+ * A field is made from samples of a quantity (e.g. output power or PAE)
+ * at scattered points in gamma space. The samples are triangulated (Delaunay)
+ * and the quantity is interpolated linearly over each triangle onto a regular
+ * grid covering the samples; grid points outside the triangulation have no value.
+ * The rows of the grid are interpolated in parallel.
+ *
+ * Contours are then extracted from the grid by marching squares, so changing
+ * the levels does not repeat the triangulation or interpolation. The segments
+ * in the grid cells are joined into lines through the grid edges they share.
+ * Contours of several fields (e.g. frequencies) and levels are extracted in parallel.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GTKsmithContour.h"
+#include "GTKsmithDelaunay.h"
+#include "GTKsmithParallel.h"
+
+struct sContourField {
+    tTriangulation *pTriangulation;
+    gdouble        *pSampleValues;
+    gint            nColumns, nRows;
+    tUV             origin;         // gamma at grid point (0,0)
+    gdouble         spacing;
+    gdouble        *pGrid;          // nColumns x nRows values (NAN outside the samples)
+};
+
+typedef struct {
+    gint edge[2];                   // grid edges joined by the segment
+} tSegment;
+
+typedef struct {
+    tContourField *pField;
+} tGridJob;
+
+/*!     \brief  Interpolated value at a point
+ *
+ * Interpolate the samples linearly over the triangle containing a point
+ *
+ * \ingroup contour
+ *
+ * \param pField    pointer to the field
+ * \param uv        the point
+ * \param pHint     pointer to the triangle to start searching from (updated)
+ * \return          the value (NAN if the point is outside the samples)
+ */
+static gdouble
+interpolate( const tContourField *pField, tUV uv, gint *pHint ) {
+    gdouble weights[3];
+    gint t = delaunayLocate( pField->pTriangulation, uv, *pHint, weights );
+    const gint *v;
+
+    if( t < 0 )
+        return NAN;
+    *pHint = t;
+    v = pField->pTriangulation->pTriangles[t].vertex;
+
+    return weights[0] * pField->pSampleValues[ v[0] ]
+         + weights[1] * pField->pSampleValues[ v[1] ]
+         + weights[2] * pField->pSampleValues[ v[2] ];
+}
+
+static void
+gridRange( gint from, gint to, gpointer userData ) {
+    tContourField *pField = ((tGridJob *)userData)->pField;
+    gint hint = 0;
+
+    for( gint row = from; row < to; row++ )
+        for( gint column = 0; column < pField->nColumns; column++ ) {
+            tUV uv = { pField->origin.U + column * pField->spacing, pField->origin.V + row * pField->spacing };
+
+            pField->pGrid[ (gsize)row * pField->nColumns + column ] = interpolate( pField, uv, &hint );
+        }
+}
+
+/*!     \brief  Create a field from scattered samples
+ *
+ * Triangulate samples and interpolate them onto a grid
+ *
+ * \ingroup contour
+ *
+ * \param gamma     array of the points (in gamma space) of the samples
+ * \param values    array of the values of the samples
+ * \param nSamples  number of samples
+ * \param gridSize  grid points across the larger extent of the samples (0 for CONTOUR_GRID)
+ * \return          pointer to the field (free with contourFieldFree)
+ */
+tContourField *
+contourFieldNew( const tUV gamma[], const gdouble values[], gint nSamples, gint gridSize ) {
+    tContourField *pField = g_new0( tContourField, 1 );
+    gdouble minU = G_MAXDOUBLE, minV = G_MAXDOUBLE, maxU = -G_MAXDOUBLE, maxV = -G_MAXDOUBLE;
+    tGridJob job = { pField };
+
+    if( gridSize < 2 )
+        gridSize = CONTOUR_GRID;
+
+    pField->pTriangulation = delaunayTriangulate( gamma, nSamples );
+    pField->pSampleValues = g_memdup2( values, nSamples * sizeof( gdouble ) );
+
+    for( gint i = 0; i < nSamples; i++ )
+        if( isfinite( gamma[i].U ) && isfinite( gamma[i].V ) ) {
+            minU = MIN( minU, gamma[i].U );  maxU = MAX( maxU, gamma[i].U );
+            minV = MIN( minV, gamma[i].V );  maxV = MAX( maxV, gamma[i].V );
+        }
+    if( minU > maxU ) {
+        pField->pGrid = g_new( gdouble, 1 );
+        return pField;
+    }
+
+    pField->spacing = MAX( MAX( maxU - minU, maxV - minV ), 1.0e-9 ) / (gridSize - 1);
+    pField->nColumns = (gint)ceil( (maxU - minU) / pField->spacing ) + 1;
+    pField->nRows = (gint)ceil( (maxV - minV) / pField->spacing ) + 1;
+    pField->origin = (tUV){ minU, minV };
+    pField->pGrid = g_new( gdouble, (gsize)pField->nColumns * pField->nRows );
+
+    smithParallelFor( pField->nRows, 8, gridRange, &job );
+
+    return pField;
+}
+
+/*!     \brief  Free a field
+ *
+ * Free a field
+ *
+ * \ingroup contour
+ *
+ * \param pField    pointer to the field
+ */
+void
+contourFieldFree( tContourField *pField ) {
+    if( pField == NULL )
+        return;
+
+    delaunayFree( pField->pTriangulation );
+    g_free( pField->pSampleValues );
+    g_free( pField->pGrid );
+    g_free( pField );
+}
+
+/*!     \brief  Value of a field at a point
+ *
+ * Value of a field at a point, interpolated from the samples
+ * (e.g. for a readout under the pointer)
+ *
+ * \ingroup contour
+ *
+ * \param pField    pointer to the field
+ * \param uv        point in gamma space
+ * \return          the value (NAN if the point is outside the samples)
+ */
+gdouble
+contourFieldValue( const tContourField *pField, tUV uv ) {
+    gint hint = 0;
+
+    return interpolate( pField, uv, &hint );
+}
+
+/*!     \brief  Point where a contour crosses a grid edge
+ *
+ * Point where the level crosses a grid edge (by linear interpolation)
+ *
+ * \ingroup contour
+ *
+ * \param pField    pointer to the field
+ * \param edge      edge id (2 x grid index of its lower/left end, + 1 if vertical)
+ * \param level     contour level
+ * \return          the point in gamma space
+ */
+static tUV
+edgePoint( const tContourField *pField, gint edge, gdouble level ) {
+    gint index = edge / 2;
+    gint other = index + ( (edge & 1) ? pField->nColumns : 1 );
+    gdouble a = pField->pGrid[ index ], b = pField->pGrid[ other ];
+    gdouble fraction = ( b != a ) ? (level - a) / (b - a) : 0.5;
+    gdouble column = index % pField->nColumns, row = index / pField->nColumns;
+
+    if( edge & 1 )
+        row += fraction;
+    else
+        column += fraction;
+
+    return (tUV){ pField->origin.U + column * pField->spacing, pField->origin.V + row * pField->spacing };
+}
+
+/*!     \brief  Extract a contour from a field
+ *
+ * Extract the lines at a level from a field (marching squares)
+ *
+ * \ingroup contour
+ *
+ * \param pField    pointer to the field
+ * \param level     contour level
+ * \return          pointer to the contour (free with contourFree)
+ */
+tContour *
+contourFieldExtract( const tContourField *pField, gdouble level ) {
+    // edges of a cell: 0 bottom, 1 right, 2 top, 3 left; pairs of edges joined for each case
+    static const gint8 cases[16][4] = {
+        { -1, -1, -1, -1 }, { 3, 0, -1, -1 }, { 0, 1, -1, -1 }, { 3, 1, -1, -1 },
+        { 1, 2, -1, -1 },   { 3, 0, 1, 2 },   { 0, 2, -1, -1 }, { 3, 2, -1, -1 },
+        { 2, 3, -1, -1 },   { 0, 2, -1, -1 }, { 0, 1, 2, 3 },   { 1, 2, -1, -1 },
+        { 1, 3, -1, -1 },   { 0, 1, -1, -1 }, { 0, 3, -1, -1 }, { -1, -1, -1, -1 } };
+    tContour *pContour = g_new0( tContour, 1 );
+    gint nColumns = pField->nColumns, nRows = pField->nRows;
+    gint nEdges = 2 * nColumns * nRows;
+    GArray *pSegments = g_array_new( FALSE, FALSE, sizeof( tSegment ) );
+    GArray *pLineStart = g_array_new( FALSE, FALSE, sizeof( gint ) );
+    GArray *pPoints = g_array_new( FALSE, FALSE, sizeof( tUV ) );
+    gint *pEdgeSegments, lineEnd = 0;
+    guint8 *pUsed;
+
+    pContour->level = level;
+    g_array_append_val( pLineStart, lineEnd );
+
+    for( gint row = 0; row < nRows - 1; row++ )
+        for( gint column = 0; column < nColumns - 1; column++ ) {
+            gint index = row * nColumns + column;
+            gdouble v[4] = { pField->pGrid[ index ], pField->pGrid[ index + 1 ],
+                             pField->pGrid[ index + nColumns + 1 ], pField->pGrid[ index + nColumns ] };
+            gint edge[4] = { 2 * index, 2 * (index + 1) + 1, 2 * (index + nColumns), 2 * index + 1 };
+            gint code = 0;
+            const gint8 *pCase;
+
+            if( !isfinite( v[0] ) || !isfinite( v[1] ) || !isfinite( v[2] ) || !isfinite( v[3] ) )
+                continue;
+            for( gint corner = 0; corner < 4; corner++ )
+                code |= ( v[ corner ] >= level ) << corner;
+            pCase = cases[ code ];
+
+            // saddles: the table separates the high corners; join them if the center is high
+            if( (code == 5 || code == 10) && (v[0] + v[1] + v[2] + v[3]) / 4.0 >= level )
+                pCase = cases[ 15 - code ];
+
+            for( gint s = 0; s < 4 && pCase[s] >= 0; s += 2 ) {
+                tSegment segment = { { edge[ pCase[s] ], edge[ pCase[ s + 1 ] ] } };
+                g_array_append_val( pSegments, segment );
+            }
+        }
+
+    // the (at most two) segments through each edge
+    pEdgeSegments = g_new( gint, 2 * (gsize)MAX( nEdges, 1 ) );
+    memset( pEdgeSegments, 0xff, 2 * (gsize)MAX( nEdges, 1 ) * sizeof( gint ) );      // -1
+    for( guint s = 0; s < pSegments->len; s++ )
+        for( gint end = 0; end < 2; end++ ) {
+            gint *pSlot = &pEdgeSegments[ 2 * g_array_index( pSegments, tSegment, s ).edge[ end ] ];
+            pSlot[ pSlot[0] >= 0 ] = s;
+        }
+
+    // join the segments into lines, first the open lines from their ends then the closed lines
+    pUsed = g_new0( guint8, MAX( pSegments->len, 1 ) );
+    for( gint pass = 0; pass < 2; pass++ )
+        for( guint first = 0; first < pSegments->len; first++ ) {
+            tSegment *pFirst = &g_array_index( pSegments, tSegment, first );
+            gint s = first, edge;
+
+            if( pUsed[ first ] )
+                continue;
+            // start an open line only at an edge with one segment
+            if( pass == 0 ) {
+                if( pEdgeSegments[ 2 * pFirst->edge[0] + 1 ] < 0 )
+                    edge = pFirst->edge[0];
+                else if( pEdgeSegments[ 2 * pFirst->edge[1] + 1 ] < 0 )
+                    edge = pFirst->edge[1];
+                else
+                    continue;
+            } else {
+                edge = pFirst->edge[0];
+            }
+
+            tUV uv = edgePoint( pField, edge, level );
+            g_array_append_val( pPoints, uv );
+            while( s >= 0 && !pUsed[s] ) {
+                tSegment *pSegment = &g_array_index( pSegments, tSegment, s );
+                gint *pSlot;
+
+                pUsed[s] = TRUE;
+                edge = ( pSegment->edge[0] == edge ) ? pSegment->edge[1] : pSegment->edge[0];
+                uv = edgePoint( pField, edge, level );
+                g_array_append_val( pPoints, uv );
+
+                pSlot = &pEdgeSegments[ 2 * edge ];
+                s = ( pSlot[0] == s ) ? pSlot[1] : pSlot[0];
+            }
+            lineEnd = pPoints->len;
+            g_array_append_val( pLineStart, lineEnd );
+        }
+
+    g_free( pUsed );
+    g_free( pEdgeSegments );
+    g_array_free( pSegments, TRUE );
+
+    pContour->nLines = pLineStart->len - 1;
+    pContour->pLineStart = (gint *)g_array_free( pLineStart, FALSE );
+    pContour->pPoints = (tUV *)g_array_free( pPoints, FALSE );
+
+    return pContour;
+}
+
+typedef struct {
+    tContourField **ppFields;
+    const gdouble  *pLevels;
+    gint            nLevels;
+    tContour      **ppContours;
+} tExtractJob;
+
+static void
+extractRange( gint from, gint to, gpointer userData ) {
+    tExtractJob *pJob = userData;
+
+    for( gint i = from; i < to; i++ )
+        pJob->ppContours[i] = contourFieldExtract( pJob->ppFields[ i / pJob->nLevels ],
+                pJob->pLevels[ i % pJob->nLevels ] );
+}
+
+/*!     \brief  Extract contours at several levels from several fields
+ *
+ * Extract the contours at each level from each field (e.g. one field per frequency)
+ * in parallel. The contours are written field by field:
+ * contours[ field * nLevels + level ].
+ *
+ * \ingroup contour
+ *
+ * \param ppFields  array of pointers to the fields
+ * \param nFields   number of fields
+ * \param levels    array of levels
+ * \param nLevels   number of levels
+ * \param ppContours    array of nFields x nLevels pointers to the contours (free each with contourFree)
+ */
+void
+contourExtractLevels( tContourField *ppFields[], gint nFields, const gdouble levels[], gint nLevels,
+        tContour *ppContours[] ) {
+    tExtractJob job = { ppFields, levels, nLevels, ppContours };
+
+    smithParallelFor( nFields * nLevels, 1, extractRange, &job );
+}
+
+/*!     \brief  Free a contour
+ *
+ * Free a contour
+ *
+ * \ingroup contour
+ *
+ * \param pContour  pointer to the contour
+ */
+void
+contourFree( tContour *pContour ) {
+    if( pContour == NULL )
+        return;
+
+    g_free( pContour->pLineStart );
+    g_free( pContour->pPoints );
+    g_free( pContour );
+}
+
+/*!     \brief  Draw a contour
+ *
+ * Draw the lines of a contour as smooth curves
+ *
+ * \ingroup contour
+ *
+ * \param cr        pointer to the cairo context
+ * \param pContour  pointer to the contour
+ * \param pOptions  pointer to options settings
+ */
+void
+drawContourOnSmithChart( cairo_t *cr, const tContour *pContour, tSmithOptions *pOptions ) {
+    for( gint line = 0; line < pContour->nLines; line++ ) {
+        gint length = pContour->pLineStart[ line + 1 ] - pContour->pLineStart[ line ];
+
+        if( length >= 2 )
+            drawBezierCurveOnSmithChart( cr, &pContour->pPoints[ pContour->pLineStart[ line ] ],
+                    length, pOptions );
+    }
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHCONTOUR_H_
+#define GTKSMITHCONTOUR_H_
+
+#include "GTKsmithChart.h"
+
+// Lines of equal value. Closed lines end with their first point repeated.
+typedef struct {
+    gdouble level;
+    gint    nLines;
+    gint   *pLineStart;     // index of the first point of each line (nLines + 1 entries)
+    tUV    *pPoints;
+} tContour;
+
+typedef struct sContourField tContourField;
+
+// Grid points across the samples (each way)
+#define CONTOUR_GRID    192
+
+tContourField *contourFieldNew( const tUV [], const gdouble [], gint, gint );
+void contourFieldFree( tContourField * );
+gdouble contourFieldValue( const tContourField *, tUV );
+tContour *contourFieldExtract( const tContourField *, gdouble );
+void contourExtractLevels( tContourField *[], gint, const gdouble [], gint, tContour *[] );
+void contourFree( tContour * );
+void drawContourOnSmithChart( cairo_t *, const tContour *, tSmithOptions * );
+
+#endif /* GTKSMITHCONTOUR_H_ */
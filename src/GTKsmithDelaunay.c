@@ -0,0 +1,510 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithDelaunay.c
+ * @brief Delaunay triangulation of points in gamma space
+ *
+ * @author Michael G. Katzmann
+ *
+ * The triangulation is built by inserting the points one at a time
+ * (Bowyer-Watson) into a large triangle enclosing them all. The triangle
+ * containing a new point is found by walking from the last triangle created,
+ * and the points are inserted in the order of a Hilbert curve through their
+ * bounding box so that the walk is short. The triangles whose circumcircle
+ * contains the new point form a cavity which is replaced by a fan of triangles
+ * around the point. Finally the triangles using the enclosing vertices are removed.
+ *
+ * Points that are not finite and duplicate points are not triangulated.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GTKsmithDelaunay.h"
+
+// Order of the Hilbert curve used to sort the points (2^HILBERT_ORDER cells across)
+#define HILBERT_ORDER   16
+
+// Size of the enclosing triangle relative to the extent of the points
+#define SUPER_SCALE     100.0
+
+typedef struct {
+    guint64 key;
+    gint    index;
+} tSortKey;
+
+typedef struct {
+    gint a, b;              // edge on the boundary of the cavity (counter-clockwise)
+    gint outer;             // triangle outside the cavity across the edge (or -1)
+} tCavityEdge;
+
+typedef struct {
+    tUV       *pPoints;
+    GArray    *pTriangles;  // of tTriangle
+    GArray    *pMark;       // of gint: insertion at which each triangle was found in a cavity
+    GArray    *pCavity;     // of gint: triangles in the cavity
+    GArray    *pStack;      // of gint
+    GArray    *pBoundary;   // of tCavityEdge
+    GArray    *pNewIndex;   // of gint: triangle made from each edge of the boundary
+} tBuild;
+
+/*!     \brief  Orientation of three points
+ *
+ * Twice the signed area of the triangle a, b, c
+ *
+ * \ingroup delaunay
+ *
+ * \return          positive if counter-clockwise, negative if clockwise, 0 if collinear
+ */
+static inline gdouble
+orient( tUV a, tUV b, tUV c ) {
+    return (b.U - a.U) * (c.V - a.V) - (b.V - a.V) * (c.U - a.U);
+}
+
+/*!     \brief  Is a point inside the circumcircle of a triangle
+ *
+ * In-circle determinant for the counter-clockwise triangle a, b, c
+ *
+ * \ingroup delaunay
+ *
+ * \return          positive if p is inside the circumcircle
+ */
+static inline gdouble
+inCircle( tUV a, tUV b, tUV c, tUV p ) {
+    gdouble adx = a.U - p.U, ady = a.V - p.V;
+    gdouble bdx = b.U - p.U, bdy = b.V - p.V;
+    gdouble cdx = c.U - p.U, cdy = c.V - p.V;
+
+    return (SQU(adx) + SQU(ady)) * (bdx * cdy - cdx * bdy)
+         - (SQU(bdx) + SQU(bdy)) * (adx * cdy - cdx * ady)
+         + (SQU(cdx) + SQU(cdy)) * (adx * bdy - bdx * ady);
+}
+
+/*!     \brief  Position of a cell along a Hilbert curve
+ *
+ * Position of a cell along a Hilbert curve
+ *
+ * \ingroup delaunay
+ *
+ * \param x         column of the cell
+ * \param y         row of the cell
+ * \return          distance along the curve
+ */
+static guint64
+hilbertKey( guint x, guint y ) {
+    guint64 key = 0;
+
+    for( guint s = 1u << (HILBERT_ORDER - 1); s > 0; s >>= 1 ) {
+        guint rx = (x & s) > 0, ry = (y & s) > 0;
+
+        key += (guint64)s * s * ((3 * rx) ^ ry);
+        // rotate the quadrant
+        if( ry == 0 ) {
+            if( rx == 1 ) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            guint t = x; x = y; y = t;
+        }
+    }
+    return key;
+}
+
+static gint
+compareSortKey( gconstpointer a, gconstpointer b ) {
+    const tSortKey *pA = a, *pB = b;
+
+    return ( pA->key > pB->key ) - ( pA->key < pB->key );
+}
+
+/*!     \brief  Find the triangle containing a point
+ *
+ * Walk from a triangle towards the point until the triangle containing it is found
+ *
+ * \ingroup delaunay
+ *
+ * \param pPoints   array of points
+ * \param pTri      array of triangles
+ * \param nTri      number of triangles
+ * \param p         the point
+ * \param start     triangle to start from
+ * \return          the triangle containing p (or -1 if p is outside the triangulation)
+ */
+static gint
+walk( const tUV *pPoints, const tTriangle *pTri, gint nTri, tUV p, gint start ) {
+    gint t = start;
+
+    // a walk in a Delaunay triangulation cannot cycle, but rounding might make it
+    for( gint step = 0; step < nTri && t >= 0; step++ ) {
+        gint e;
+
+        for( e = 0; e < 3; e++ ) {
+            // vary the first edge tested so that the walk does not favour a direction
+            gint edge = (e + step) % 3;
+            tUV a = pPoints[ pTri[t].vertex[ (edge + 1) % 3 ] ];
+            tUV b = pPoints[ pTri[t].vertex[ (edge + 2) % 3 ] ];
+
+            if( orient( a, b, p ) < 0.0 ) {
+                t = pTri[t].neighbour[ edge ];
+                break;
+            }
+        }
+        if( e == 3 )
+            return t;
+    }
+    if( t < 0 )
+        return -1;
+
+    // fall back to testing every triangle
+    for( t = 0; t < nTri; t++ ) {
+        if( pTri[t].vertex[0] >= 0
+                && orient( pPoints[ pTri[t].vertex[0] ], pPoints[ pTri[t].vertex[1] ], p ) >= 0.0
+                && orient( pPoints[ pTri[t].vertex[1] ], pPoints[ pTri[t].vertex[2] ], p ) >= 0.0
+                && orient( pPoints[ pTri[t].vertex[2] ], pPoints[ pTri[t].vertex[0] ], p ) >= 0.0 )
+            return t;
+    }
+    return -1;
+}
+
+/*!     \brief  Point a triangle's neighbour across an edge at a new triangle
+ *
+ * Point a triangle's neighbour across an edge at a new triangle
+ *
+ * \ingroup delaunay
+ *
+ * \param pTri      the triangle
+ * \param a         vertex of the shared edge
+ * \param b         other vertex of the shared edge
+ * \param neighbour new neighbour
+ */
+static void
+setNeighbour( tTriangle *pTri, gint a, gint b, gint neighbour ) {
+    for( gint i = 0; i < 3; i++ )
+        if( pTri->vertex[i] != a && pTri->vertex[i] != b ) {
+            pTri->neighbour[i] = neighbour;
+            return;
+        }
+}
+
+/*!     \brief  Insert a point into the triangulation
+ *
+ * Insert a point into the triangulation
+ *
+ * \ingroup delaunay
+ *
+ * \param pBuild    pointer to the triangulation being built
+ * \param ip        index of the point
+ * \param pLast     pointer to the triangle to start the search from (updated)
+ */
+static void
+insertPoint( tBuild *pBuild, gint ip, gint *pLast ) {
+    tUV *pPoints = pBuild->pPoints;
+    tUV p = pPoints[ ip ];
+    tTriangle *pTri = (tTriangle *)pBuild->pTriangles->data;
+    gint nTri = pBuild->pTriangles->len;
+    gint start = walk( pPoints, pTri, nTri, p, *pLast );
+    gint *pMark;
+
+    if( start < 0 )
+        return;
+    for( gint i = 0; i < 3; i++ )
+        if( pPoints[ pTri[ start ].vertex[i] ].U == p.U && pPoints[ pTri[ start ].vertex[i] ].V == p.V )
+            return;                                     // duplicate
+
+    g_array_set_size( pBuild->pMark, nTri );
+    pMark = (gint *)pBuild->pMark->data;
+    g_array_set_size( pBuild->pCavity, 0 );
+    g_array_set_size( pBuild->pStack, 0 );
+    g_array_set_size( pBuild->pBoundary, 0 );
+
+    // grow the cavity from the triangle containing the point
+    pMark[ start ] = ip;
+    g_array_append_val( pBuild->pCavity, start );
+    g_array_append_val( pBuild->pStack, start );
+    while( pBuild->pStack->len > 0 ) {
+        gint t = g_array_index( pBuild->pStack, gint, pBuild->pStack->len - 1 );
+
+        g_array_set_size( pBuild->pStack, pBuild->pStack->len - 1 );
+        for( gint e = 0; e < 3; e++ ) {
+            gint nb = pTri[t].neighbour[e];
+            tTriangle *pNb;
+
+            if( nb < 0 || pMark[ nb ] == ip )
+                continue;
+            pNb = &pTri[ nb ];
+            // the edge must face the point so that the cavity stays star shaped
+            if( (t == start || orient( pPoints[ pTri[t].vertex[ (e + 1) % 3 ] ],
+                                       pPoints[ pTri[t].vertex[ (e + 2) % 3 ] ], p ) > 0.0)
+                    && inCircle( pPoints[ pNb->vertex[0] ], pPoints[ pNb->vertex[1] ],
+                                 pPoints[ pNb->vertex[2] ], p ) > 0.0 ) {
+                pMark[ nb ] = ip;
+                g_array_append_val( pBuild->pCavity, nb );
+                g_array_append_val( pBuild->pStack, nb );
+            }
+        }
+    }
+
+    // the edges between the cavity and the rest of the triangulation
+    for( guint i = 0; i < pBuild->pCavity->len; i++ ) {
+        gint t = g_array_index( pBuild->pCavity, gint, i );
+
+        for( gint e = 0; e < 3; e++ ) {
+            gint nb = pTri[t].neighbour[e];
+
+            if( nb < 0 || pMark[ nb ] != ip ) {
+                tCavityEdge edge = { pTri[t].vertex[ (e + 1) % 3 ], pTri[t].vertex[ (e + 2) % 3 ], nb };
+                g_array_append_val( pBuild->pBoundary, edge );
+            }
+        }
+    }
+
+    // fan of new triangles (reusing the slots of the cavity)
+    guint nBoundary = pBuild->pBoundary->len;
+    tCavityEdge *pBoundary = (tCavityEdge *)pBuild->pBoundary->data;
+    gint *newIndex;
+
+    g_array_set_size( pBuild->pNewIndex, nBoundary );
+    newIndex = (gint *)pBuild->pNewIndex->data;
+    for( guint i = 0; i < nBoundary; i++ ) {
+        if( i < pBuild->pCavity->len ) {
+            newIndex[i] = g_array_index( pBuild->pCavity, gint, i );
+        } else {
+            tTriangle empty = { { -1, -1, -1 }, { -1, -1, -1 } };
+
+            newIndex[i] = pBuild->pTriangles->len;
+            g_array_append_val( pBuild->pTriangles, empty );
+        }
+    }
+    pTri = (tTriangle *)pBuild->pTriangles->data;
+    // (only in degenerate cases) unused slots of the cavity are marked empty
+    for( guint i = nBoundary; i < pBuild->pCavity->len; i++ ) {
+        tTriangle *pEmpty = &pTri[ g_array_index( pBuild->pCavity, gint, i ) ];
+
+        pEmpty->vertex[0] = pEmpty->vertex[1] = pEmpty->vertex[2] = -1;
+        pEmpty->neighbour[0] = pEmpty->neighbour[1] = pEmpty->neighbour[2] = -1;
+    }
+
+    for( guint i = 0; i < nBoundary; i++ ) {
+        tTriangle *pNew = &pTri[ newIndex[i] ];
+
+        pNew->vertex[0] = pBoundary[i].a;
+        pNew->vertex[1] = pBoundary[i].b;
+        pNew->vertex[2] = ip;
+        pNew->neighbour[0] = pNew->neighbour[1] = -1;
+        pNew->neighbour[2] = pBoundary[i].outer;
+        if( pBoundary[i].outer >= 0 )
+            setNeighbour( &pTri[ pBoundary[i].outer ], pBoundary[i].a, pBoundary[i].b, newIndex[i] );
+
+        // the cavity is small, so its edges are simply searched
+        for( guint j = 0; j < nBoundary; j++ ) {
+            if( pBoundary[j].a == pBoundary[i].b )
+                pNew->neighbour[0] = newIndex[j];       // across b-p
+            if( pBoundary[j].b == pBoundary[i].a )
+                pNew->neighbour[1] = newIndex[j];       // across p-a
+        }
+    }
+
+    *pLast = newIndex[0];
+}
+
+/*!     \brief  Delaunay triangulation of points
+ *
+ * Triangulate points in gamma space. The vertices of the triangles
+ * are the indices of the points in the array given.
+ *
+ * \ingroup delaunay
+ *
+ * \param points    array of points
+ * \param nPoints   number of points
+ * \return          pointer to the triangulation (free with delaunayFree)
+ */
+tTriangulation *
+delaunayTriangulate( const tUV points[], gint nPoints ) {
+    tTriangulation *pTriangulation = g_new0( tTriangulation, 1 );
+    tBuild build;
+    tSortKey *pOrder = g_new( tSortKey, MAX( nPoints, 1 ) );
+    gint nOrder = 0, last = 0;
+    gdouble minU = G_MAXDOUBLE, minV = G_MAXDOUBLE, maxU = -G_MAXDOUBLE, maxV = -G_MAXDOUBLE;
+    gdouble extent, cells;
+    tUV center;
+    tTriangle super = { { nPoints, nPoints + 1, nPoints + 2 }, { -1, -1, -1 } };
+
+    pTriangulation->nPoints = nPoints;
+    pTriangulation->pPoints = g_new( tUV, nPoints + 3 );
+    memcpy( pTriangulation->pPoints, points, nPoints * sizeof( tUV ) );
+
+    for( gint i = 0; i < nPoints; i++ ) {
+        if( !isfinite( points[i].U ) || !isfinite( points[i].V ) )
+            continue;
+        minU = MIN( minU, points[i].U );  maxU = MAX( maxU, points[i].U );
+        minV = MIN( minV, points[i].V );  maxV = MAX( maxV, points[i].V );
+        pOrder[ nOrder++ ].index = i;
+    }
+    if( nOrder == 0 ) {
+        g_free( pOrder );
+        return pTriangulation;
+    }
+
+    extent = MAX( MAX( maxU - minU, maxV - minV ), 1.0e-9 );
+    cells = (gdouble)((1u << HILBERT_ORDER) - 1);
+    for( gint i = 0; i < nOrder; i++ ) {
+        tUV uv = points[ pOrder[i].index ];
+        pOrder[i].key = hilbertKey( (guint)((uv.U - minU) / extent * cells),
+                                    (guint)((uv.V - minV) / extent * cells) );
+    }
+    qsort( pOrder, nOrder, sizeof( tSortKey ), compareSortKey );
+
+    // enclosing triangle
+    center = (tUV){ (minU + maxU) / 2.0, (minV + maxV) / 2.0 };
+    pTriangulation->pPoints[ nPoints ]     = (tUV){ center.U - SUPER_SCALE * extent, center.V - SUPER_SCALE * extent };
+    pTriangulation->pPoints[ nPoints + 1 ] = (tUV){ center.U + SUPER_SCALE * extent, center.V - SUPER_SCALE * extent };
+    pTriangulation->pPoints[ nPoints + 2 ] = (tUV){ center.U, center.V + SUPER_SCALE * extent };
+
+    build.pPoints = pTriangulation->pPoints;
+    build.pTriangles = g_array_sized_new( FALSE, FALSE, sizeof( tTriangle ), 2 * nOrder + 1 );
+    build.pMark = g_array_sized_new( FALSE, TRUE, sizeof( gint ), 2 * nOrder + 1 );
+    build.pCavity = g_array_new( FALSE, FALSE, sizeof( gint ) );
+    build.pStack = g_array_new( FALSE, FALSE, sizeof( gint ) );
+    build.pBoundary = g_array_new( FALSE, FALSE, sizeof( tCavityEdge ) );
+    build.pNewIndex = g_array_new( FALSE, FALSE, sizeof( gint ) );
+    g_array_append_val( build.pTriangles, super );
+    g_array_set_size( build.pMark, 1 );
+    g_array_index( build.pMark, gint, 0 ) = -1;
+
+    for( gint i = 0; i < nOrder; i++ ) {
+        guint nBefore = build.pTriangles->len;
+
+        insertPoint( &build, pOrder[i].index, &last );
+        // new triangles have not been in any cavity
+        g_array_set_size( build.pMark, build.pTriangles->len );
+        for( guint t = nBefore; t < build.pTriangles->len; t++ )
+            g_array_index( build.pMark, gint, t ) = -1;
+    }
+
+    // remove the triangles using the enclosing vertices (and empty slots)
+    {
+        tTriangle *pTri = (tTriangle *)build.pTriangles->data;
+        gint nTri = build.pTriangles->len, nKept = 0;
+        gint *pNewIndex = g_new( gint, nTri );
+
+        for( gint t = 0; t < nTri; t++ ) {
+            gboolean bKeep = pTri[t].vertex[0] >= 0
+                    && pTri[t].vertex[0] < nPoints && pTri[t].vertex[1] < nPoints && pTri[t].vertex[2] < nPoints;
+            pNewIndex[t] = bKeep ? nKept++ : -1;
+        }
+        pTriangulation->nTriangles = nKept;
+        pTriangulation->pTriangles = g_new( tTriangle, MAX( nKept, 1 ) );
+        for( gint t = 0; t < nTri; t++ ) {
+            tTriangle *pNew;
+
+            if( pNewIndex[t] < 0 )
+                continue;
+            pNew = &pTriangulation->pTriangles[ pNewIndex[t] ];
+            *pNew = pTri[t];
+            for( gint e = 0; e < 3; e++ )
+                pNew->neighbour[e] = ( pTri[t].neighbour[e] >= 0 ) ? pNewIndex[ pTri[t].neighbour[e] ] : -1;
+        }
+        g_free( pNewIndex );
+    }
+
+    g_array_free( build.pTriangles, TRUE );
+    g_array_free( build.pMark, TRUE );
+    g_array_free( build.pCavity, TRUE );
+    g_array_free( build.pStack, TRUE );
+    g_array_free( build.pBoundary, TRUE );
+    g_array_free( build.pNewIndex, TRUE );
+    g_free( pOrder );
+
+    return pTriangulation;
+}
+
+/*!     \brief  Free a triangulation
+ *
+ * Free a triangulation
+ *
+ * \ingroup delaunay
+ *
+ * \param pTriangulation    pointer to the triangulation
+ */
+void
+delaunayFree( tTriangulation *pTriangulation ) {
+    if( pTriangulation == NULL )
+        return;
+
+    g_free( pTriangulation->pPoints );
+    g_free( pTriangulation->pTriangles );
+    g_free( pTriangulation );
+}
+
+/*!     \brief  Find the triangle containing a point
+ *
+ * Find the triangle containing a point and the barycentric coordinates
+ * of the point in it (the weights of the triangle's vertices for interpolation).
+ * Successive queries are fastest when each starts from the previous result.
+ *
+ * \ingroup delaunay
+ *
+ * \param pTriangulation    pointer to the triangulation
+ * \param uv                the point
+ * \param start             triangle to start the search from
+ * \param weights           where the barycentric coordinates are written (or NULL)
+ * \return                  index of the triangle (or -1 if the point is outside the triangulation)
+ */
+gint
+delaunayLocate( const tTriangulation *pTriangulation, tUV uv, gint start, gdouble weights[3] ) {
+    const tUV *pPoints = pTriangulation->pPoints;
+    gint t;
+
+    if( pTriangulation->nTriangles == 0 || !isfinite( uv.U ) || !isfinite( uv.V ) )
+        return -1;
+
+    t = walk( pPoints, pTriangulation->pTriangles, pTriangulation->nTriangles, uv,
+              CLAMP( start, 0, pTriangulation->nTriangles - 1 ) );
+    if( t >= 0 && weights ) {
+        const gint *v = pTriangulation->pTriangles[t].vertex;
+        gdouble area = orient( pPoints[ v[0] ], pPoints[ v[1] ], pPoints[ v[2] ] );
+
+        weights[0] = orient( uv, pPoints[ v[1] ], pPoints[ v[2] ] ) / area;
+        weights[1] = orient( pPoints[ v[0] ], uv, pPoints[ v[2] ] ) / area;
+        weights[2] = 1.0 - weights[0] - weights[1];
+    }
+    return t;
+}
+
+/*!     \brief  Circumradius of a triangle
+ *
+ * Radius of the circle through the vertices of a triangle
+ *
+ * \ingroup delaunay
+ *
+ * \param pTriangulation    pointer to the triangulation
+ * \param t                 index of the triangle
+ * \return                  the radius (infinite if the triangle is degenerate)
+ */
+gdouble
+delaunayCircumradius( const tTriangulation *pTriangulation, gint t ) {
+    const gint *v = pTriangulation->pTriangles[t].vertex;
+    tUV a = pTriangulation->pPoints[ v[0] ];
+    tUV b = pTriangulation->pPoints[ v[1] ];
+    tUV c = pTriangulation->pPoints[ v[2] ];
+    gdouble ab = hypot( b.U - a.U, b.V - a.V );
+    gdouble bc = hypot( c.U - b.U, c.V - b.V );
+    gdouble ca = hypot( a.U - c.U, a.V - c.V );
+    gdouble area2 = fabs( orient( a, b, c ) );
+
+    return ( area2 > 0.0 ) ? ab * bc * ca / (2.0 * area2) : INFINITY;
+}
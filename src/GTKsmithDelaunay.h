@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHDELAUNAY_H_
+#define GTKSMITHDELAUNAY_H_
+
+#include "GTKsmithChart.h"
+
+typedef struct {
+    gint vertex[3];         // indices of the points (counter-clockwise)
+    gint neighbour[3];      // triangle across the edge opposite vertex[i] (-1 on the hull)
+} tTriangle;
+
+typedef struct {
+    gint       nPoints;
+    tUV       *pPoints;     // copy of the points triangulated
+    gint       nTriangles;
+    tTriangle *pTriangles;
+} tTriangulation;
+
+tTriangulation *delaunayTriangulate( const tUV [], gint );
+void delaunayFree( tTriangulation * );
+gint delaunayLocate( const tTriangulation *, tUV, gint, gdouble [3] );
+gdouble delaunayCircumradius( const tTriangulation *, gint );
+
+#endif /* GTKSMITHDELAUNAY_H_ */
@@ -0,0 +1,444 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithEnvelope.c
+ * @brief Envelope of a family of traces
+ *
+ * @author Michael G. Katzmann
+ *
+ * A family of traces (e.g. a Monte Carlo tolerance analysis) is reduced to
+ * the outline of the region it covers, which is drawn as one filled shape.
+ *
+ * The hull envelope is the convex hull of the points of all traces at each
+ * frequency (or at each pair of adjacent frequencies, so that the hulls overlap
+ * and together cover the region swept over the band). The hulls are found in
+ * parallel. Filled with the non-zero winding rule they draw as their union.
+ * The hull of two adjacent frequencies is found from their individual hulls.
+ *
+ * The alpha shape is the union of the triangles of the Delaunay triangulation
+ * of all points whose circumradius is no more than alpha. It follows concave
+ * outlines and holes. The points are first thinned to one per cell of a grid
+ * of alpha / ALPHA_CELLS, which does not change the shape at that resolution.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GTKsmithEnvelope.h"
+#include "GTKsmithDelaunay.h"
+#include "GTKsmithParallel.h"
+
+// Frequencies whose hulls are found by each worker at a time
+#define HULL_GRAIN      16
+
+// Grid cells per alpha used to thin the points of an alpha shape
+#define ALPHA_CELLS     4
+
+// Largest number of grid cells across the points of an alpha shape
+#define ALPHA_MAX_GRID  2048
+
+typedef struct {
+    tSmithTrace **ppTraces;
+    gint          nTraces;
+    gint          nFrequencies;
+    gboolean      bAdjacent;
+    GArray      **ppChunkPoints;    // hull points of each chunk (of tUV)
+    GArray      **ppChunkLengths;   // length of each hull in the chunk (of gint)
+} tHullJob;
+
+static gint
+compareUV( gconstpointer a, gconstpointer b ) {
+    const tUV *pA = a, *pB = b;
+
+    if( pA->U != pB->U )
+        return ( pA->U > pB->U ) - ( pA->U < pB->U );
+    return ( pA->V > pB->V ) - ( pA->V < pB->V );
+}
+
+static inline gdouble
+cross( tUV o, tUV a, tUV b ) {
+    return (a.U - o.U) * (b.V - o.V) - (a.V - o.V) * (b.U - o.U);
+}
+
+/*!     \brief  Convex hull of points
+ *
+ * Convex hull of points (monotone chain). The points are sorted in place.
+ *
+ * \ingroup envelope
+ *
+ * \param pPoints   array of points (sorted)
+ * \param n         number of points
+ * \param pHull     where the hull is written counter-clockwise (room for n + 1 points)
+ * \return          number of points in the hull
+ */
+static gint
+convexHull( tUV *pPoints, gint n, tUV *pHull ) {
+    gint k = 0;
+
+    if( n < 3 ) {
+        memcpy( pHull, pPoints, n * sizeof( tUV ) );
+        return n;
+    }
+
+    qsort( pPoints, n, sizeof( tUV ), compareUV );
+    // lower hull
+    for( gint i = 0; i < n; i++ ) {
+        while( k >= 2 && cross( pHull[ k - 2 ], pHull[ k - 1 ], pPoints[i] ) <= 0.0 )
+            k--;
+        pHull[ k++ ] = pPoints[i];
+    }
+    // upper hull
+    for( gint i = n - 2, lower = k + 1; i >= 0; i-- ) {
+        while( k >= lower && cross( pHull[ k - 2 ], pHull[ k - 1 ], pPoints[i] ) <= 0.0 )
+            k--;
+        pHull[ k++ ] = pPoints[i];
+    }
+
+    return k - 1;       // the first point is repeated at the end
+}
+
+/*!     \brief  Convex hull of the trace points at a frequency
+ *
+ * Convex hull of the points of all traces at a frequency. Points inside the
+ * quadrilateral of the extreme points cannot be on the hull and are discarded
+ * before the hull is found.
+ *
+ * \ingroup envelope
+ *
+ * \param pJob      pointer to the job
+ * \param f         index of the frequency
+ * \param pPoints   work array (room for nTraces points)
+ * \param pHull     where the hull is written (room for nTraces + 1 points)
+ * \return          number of points in the hull
+ */
+static gint
+frequencyHull( tHullJob *pJob, gint f, tUV *pPoints, tUV *pHull ) {
+    tUV extreme[4];         // lowest V, highest U, highest V, lowest U (counter-clockwise)
+    gint n = 0, nKept = 0;
+
+    for( gint t = 0; t < pJob->nTraces; t++ ) {
+        tUV uv = { pJob->ppTraces[t]->pU[f], pJob->ppTraces[t]->pV[f] };
+
+        if( !isfinite( uv.U ) || !isfinite( uv.V ) )
+            continue;
+        if( n == 0 )
+            extreme[0] = extreme[1] = extreme[2] = extreme[3] = uv;
+        if( uv.V < extreme[0].V ) extreme[0] = uv;
+        if( uv.U > extreme[1].U ) extreme[1] = uv;
+        if( uv.V > extreme[2].V ) extreme[2] = uv;
+        if( uv.U < extreme[3].U ) extreme[3] = uv;
+        pPoints[ n++ ] = uv;
+    }
+
+    for( gint i = 0; i < n; i++ ) {
+        gboolean bInside = TRUE;
+
+        for( gint e = 0; e < 4 && bInside; e++ )
+            bInside = cross( extreme[e], extreme[ (e + 1) % 4 ], pPoints[i] ) > 0.0;
+        if( !bInside )
+            pPoints[ nKept++ ] = pPoints[i];
+    }
+
+    return convexHull( pPoints, nKept, pHull );
+}
+
+static void
+hullRange( gint from, gint to, gpointer userData ) {
+    tHullJob *pJob = userData;
+    gint maxPoints = 2 * pJob->nTraces + 1;
+    tUV *pPoints = g_new( tUV, maxPoints );
+    tUV *pHull = g_new( tUV, maxPoints );
+    tUV *pPairHull = g_new( tUV, maxPoints );
+    GArray *pChunkPoints = g_array_new( FALSE, FALSE, sizeof( tUV ) );
+    GArray *pChunkLengths = g_array_new( FALSE, FALSE, sizeof( gint ) );
+    gint nHull = 0;
+
+    if( pJob->bAdjacent )
+        nHull = frequencyHull( pJob, from, pPoints, pHull );
+
+    for( gint f = from; f < to; f++ ) {
+        if( pJob->bAdjacent ) {
+            // the hull of two frequencies is the hull of their hulls
+            gint nPair;
+
+            memcpy( pPoints, pHull, nHull * sizeof( tUV ) );
+            nPair = nHull;
+            nHull = frequencyHull( pJob, f + 1, pPoints + nPair, pHull );
+            memcpy( pPoints + nPair, pHull, nHull * sizeof( tUV ) );
+            nPair = convexHull( pPoints, nPair + nHull, pPairHull );
+
+            g_array_append_vals( pChunkPoints, pPairHull, nPair );
+            g_array_append_val( pChunkLengths, nPair );
+        } else {
+            nHull = frequencyHull( pJob, f, pPoints, pHull );
+
+            g_array_append_vals( pChunkPoints, pHull, nHull );
+            g_array_append_val( pChunkLengths, nHull );
+        }
+    }
+
+    pJob->ppChunkPoints[ from / HULL_GRAIN ] = pChunkPoints;
+    pJob->ppChunkLengths[ from / HULL_GRAIN ] = pChunkLengths;
+    g_free( pPoints );
+    g_free( pHull );
+    g_free( pPairHull );
+}
+
+/*!     \brief  Envelope of traces as convex hulls across frequency
+ *
+ * The convex hulls of the points of all traces at each frequency. The traces
+ * are taken to have the same frequencies (the shortest trace sets the number).
+ * Loop i is the hull at frequency point i (or of the points at frequency points
+ * i and i + 1 if bAdjacent, in which case the loops together cover the band).
+ *
+ * \ingroup envelope
+ *
+ * \param ppTraces  array of pointers to the traces
+ * \param nTraces   number of traces
+ * \param bAdjacent hull the points of adjacent frequencies together
+ * \return          pointer to the envelope (free with envelopeFree)
+ */
+tEnvelope *
+envelopeHulls( tSmithTrace *ppTraces[], gint nTraces, gboolean bAdjacent ) {
+    tEnvelope *pEnvelope = g_new0( tEnvelope, 1 );
+    tHullJob job = { ppTraces, nTraces, G_MAXINT, bAdjacent };
+    gint nChunks, nTotal = 0;
+
+    for( gint t = 0; t < nTraces; t++ )
+        job.nFrequencies = MIN( job.nFrequencies, ppTraces[t]->nPoints );
+    if( nTraces == 0 || job.nFrequencies <= (bAdjacent ? 1 : 0) ) {
+        pEnvelope->pLoopStart = g_new0( gint, 1 );
+        return pEnvelope;
+    }
+    if( bAdjacent )
+        job.nFrequencies--;
+
+    nChunks = (job.nFrequencies + HULL_GRAIN - 1) / HULL_GRAIN;
+    job.ppChunkPoints = g_new0( GArray *, nChunks );
+    job.ppChunkLengths = g_new0( GArray *, nChunks );
+    smithParallelFor( job.nFrequencies, HULL_GRAIN, hullRange, &job );
+
+    // gather the hulls in frequency order
+    for( gint c = 0; c < nChunks; c++ )
+        nTotal += job.ppChunkPoints[c]->len;
+    pEnvelope->nLoops = job.nFrequencies;
+    pEnvelope->pLoopStart = g_new( gint, job.nFrequencies + 1 );
+    pEnvelope->pPoints = g_new( tUV, MAX( nTotal, 1 ) );
+    pEnvelope->pLoopStart[0] = 0;
+    for( gint c = 0, loop = 0; c < nChunks; c++ ) {
+        memcpy( pEnvelope->pPoints + pEnvelope->pLoopStart[ loop ], job.ppChunkPoints[c]->data,
+                job.ppChunkPoints[c]->len * sizeof( tUV ) );
+        for( guint i = 0; i < job.ppChunkLengths[c]->len; i++, loop++ )
+            pEnvelope->pLoopStart[ loop + 1 ] = pEnvelope->pLoopStart[ loop ]
+                    + g_array_index( job.ppChunkLengths[c], gint, i );
+        g_array_free( job.ppChunkPoints[c], TRUE );
+        g_array_free( job.ppChunkLengths[c], TRUE );
+    }
+    g_free( job.ppChunkPoints );
+    g_free( job.ppChunkLengths );
+
+    return pEnvelope;
+}
+
+typedef struct {
+    const tTriangulation *pTriangulation;
+    gdouble               alpha;
+    guint8               *pKeep;
+} tAlphaJob;
+
+static void
+alphaRange( gint from, gint to, gpointer userData ) {
+    tAlphaJob *pJob = userData;
+
+    for( gint t = from; t < to; t++ )
+        pJob->pKeep[t] = delaunayCircumradius( pJob->pTriangulation, t ) <= pJob->alpha;
+}
+
+typedef struct {
+    gint a, b;
+} tEdge;
+
+static gint
+compareEdge( gconstpointer a, gconstpointer b ) {
+    const tEdge *pA = a, *pB = b;
+
+    return ( pA->a > pB->a ) - ( pA->a < pB->a );
+}
+
+/*!     \brief  Envelope of traces as an alpha shape
+ *
+ * The alpha shape of the points of all traces: the region covered by the
+ * Delaunay triangles with a circumradius of no more than alpha. Outer
+ * outlines are counter-clockwise and holes clockwise.
+ *
+ * \ingroup envelope
+ *
+ * \param ppTraces  array of pointers to the traces
+ * \param nTraces   number of traces
+ * \param alpha     largest circumradius (in gamma) of a triangle in the shape
+ * \return          pointer to the envelope (free with envelopeFree)
+ */
+tEnvelope *
+envelopeAlphaShape( tSmithTrace *ppTraces[], gint nTraces, gdouble alpha ) {
+    tEnvelope *pEnvelope = g_new0( tEnvelope, 1 );
+    gdouble minU = G_MAXDOUBLE, minV = G_MAXDOUBLE, maxU = -G_MAXDOUBLE, maxV = -G_MAXDOUBLE;
+    gdouble cellSize;
+    gint nColumns, nRows;
+    gint *pCell;
+    GArray *pThinned, *pLoopStart, *pLoopPoints;
+    tTriangulation *pTriangulation;
+    tAlphaJob job;
+    tEdge *pEdges;
+    gint nEdges = 0, loopEnd = 0;
+    guint8 *pUsed;
+
+    pEnvelope->pLoopStart = g_new0( gint, 1 );
+    if( !(alpha > 0.0) )
+        return pEnvelope;
+
+    for( gint t = 0; t < nTraces; t++ )
+        for( gint i = 0; i < ppTraces[t]->nPoints; i++ )
+            if( isfinite( ppTraces[t]->pU[i] ) && isfinite( ppTraces[t]->pV[i] ) ) {
+                minU = MIN( minU, ppTraces[t]->pU[i] );  maxU = MAX( maxU, ppTraces[t]->pU[i] );
+                minV = MIN( minV, ppTraces[t]->pV[i] );  maxV = MAX( maxV, ppTraces[t]->pV[i] );
+            }
+    if( minU > maxU )
+        return pEnvelope;
+
+    // thin the points to one per grid cell
+    cellSize = MAX( alpha / ALPHA_CELLS, MAX( maxU - minU, maxV - minV ) / ALPHA_MAX_GRID );
+    nColumns = (gint)((maxU - minU) / cellSize) + 1;
+    nRows = (gint)((maxV - minV) / cellSize) + 1;
+    pCell = g_new( gint, (gsize)nColumns * nRows );
+    memset( pCell, 0xff, (gsize)nColumns * nRows * sizeof( gint ) );       // -1
+    pThinned = g_array_new( FALSE, FALSE, sizeof( tUV ) );
+    for( gint t = 0; t < nTraces; t++ )
+        for( gint i = 0; i < ppTraces[t]->nPoints; i++ ) {
+            tUV uv = { ppTraces[t]->pU[i], ppTraces[t]->pV[i] };
+            gsize cell;
+
+            if( !isfinite( uv.U ) || !isfinite( uv.V ) )
+                continue;
+            cell = (gsize)((uv.V - minV) / cellSize) * nColumns + (gsize)((uv.U - minU) / cellSize);
+            if( pCell[ cell ] < 0 ) {
+                pCell[ cell ] = pThinned->len;
+                g_array_append_val( pThinned, uv );
+            }
+        }
+    g_free( pCell );
+
+    pTriangulation = delaunayTriangulate( (tUV *)pThinned->data, pThinned->len );
+    g_array_free( pThinned, TRUE );
+
+    job.pTriangulation = pTriangulation;
+    job.alpha = alpha;
+    job.pKeep = g_new( guint8, MAX( pTriangulation->nTriangles, 1 ) );
+    smithParallelFor( pTriangulation->nTriangles, PARALLEL_GRAIN * 16, alphaRange, &job );
+
+    // directed edges between kept triangles and the rest
+    pEdges = g_new( tEdge, 3 * (gsize)MAX( pTriangulation->nTriangles, 1 ) );
+    for( gint t = 0; t < pTriangulation->nTriangles; t++ ) {
+        const tTriangle *pTri = &pTriangulation->pTriangles[t];
+
+        if( !job.pKeep[t] )
+            continue;
+        for( gint e = 0; e < 3; e++ )
+            if( pTri->neighbour[e] < 0 || !job.pKeep[ pTri->neighbour[e] ] )
+                pEdges[ nEdges++ ] = (tEdge){ pTri->vertex[ (e + 1) % 3 ], pTri->vertex[ (e + 2) % 3 ] };
+    }
+    g_free( job.pKeep );
+    qsort( pEdges, nEdges, sizeof( tEdge ), compareEdge );
+
+    // join the edges into loops
+    pUsed = g_new0( guint8, MAX( nEdges, 1 ) );
+    pLoopStart = g_array_new( FALSE, FALSE, sizeof( gint ) );
+    pLoopPoints = g_array_new( FALSE, FALSE, sizeof( tUV ) );
+    g_array_append_val( pLoopStart, loopEnd );
+    for( gint first = 0; first < nEdges; first++ ) {
+        gint e = first;
+
+        if( pUsed[ first ] )
+            continue;
+        while( e >= 0 && !pUsed[e] ) {
+            gint low = 0, high = nEdges, next = -1;
+
+            pUsed[e] = TRUE;
+            g_array_append_val( pLoopPoints, pTriangulation->pPoints[ pEdges[e].a ] );
+
+            // an unused edge starting where this one ends
+            while( low < high ) {
+                gint middle = (low + high) / 2;
+
+                if( pEdges[ middle ].a < pEdges[e].b )
+                    low = middle + 1;
+                else
+                    high = middle;
+            }
+            for( ; low < nEdges && pEdges[ low ].a == pEdges[e].b; low++ )
+                if( !pUsed[ low ] ) {
+                    next = low;
+                    break;
+                }
+            e = next;
+        }
+        loopEnd = pLoopPoints->len;
+        g_array_append_val( pLoopStart, loopEnd );
+    }
+    g_free( pUsed );
+    g_free( pEdges );
+    delaunayFree( pTriangulation );
+
+    g_free( pEnvelope->pLoopStart );
+    pEnvelope->nLoops = pLoopStart->len - 1;
+    pEnvelope->pLoopStart = (gint *)g_array_free( pLoopStart, FALSE );
+    pEnvelope->pPoints = (tUV *)g_array_free( pLoopPoints, FALSE );
+
+    return pEnvelope;
+}
+
+/*!     \brief  Free an envelope
+ *
+ * Free an envelope
+ *
+ * \ingroup envelope
+ *
+ * \param pEnvelope pointer to the envelope
+ */
+void
+envelopeFree( tEnvelope *pEnvelope ) {
+    if( pEnvelope == NULL )
+        return;
+
+    g_free( pEnvelope->pLoopStart );
+    g_free( pEnvelope->pPoints );
+    g_free( pEnvelope );
+}
+
+/*!     \brief  Draw an envelope
+ *
+ * Fill the region of an envelope (in the region color of the options)
+ *
+ * \ingroup envelope
+ *
+ * \param cr        pointer to the cairo context
+ * \param pEnvelope pointer to the envelope
+ * \param pOptions  pointer to options settings
+ */
+void
+drawEnvelopeOnSmithChart( cairo_t *cr, const tEnvelope *pEnvelope, tSmithOptions *pOptions ) {
+    drawRegionOnSmithChart( cr, pEnvelope->pPoints, pEnvelope->pLoopStart, pEnvelope->nLoops, pOptions );
+}
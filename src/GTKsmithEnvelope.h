@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHENVELOPE_H_
+#define GTKSMITHENVELOPE_H_
+
+#include "GTKsmithChart.h"
+
+// Closed outlines to fill with drawRegionOnSmithChart()
+typedef struct {
+    gint  nLoops;
+    gint *pLoopStart;       // index of the first point of each loop (nLoops + 1 entries)
+    tUV  *pPoints;
+} tEnvelope;
+
+tEnvelope *envelopeHulls( tSmithTrace *[], gint, gboolean );
+tEnvelope *envelopeAlphaShape( tSmithTrace *[], gint, gdouble );
+void envelopeFree( tEnvelope * );
+void drawEnvelopeOnSmithChart( cairo_t *, const tEnvelope *, tSmithOptions * );
+
+#endif /* GTKSMITHENVELOPE_H_ */
@@ -0,0 +1,775 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithFit.c
+ * @brief Rational (vector fitting) models of sweeps
+ *
+ * @author Michael G. Katzmann
+ *
+ * A sweep is approximated by f(s) = d + s e + sum( r_n / (s - a_n) ) with
+ * s = j f / fScale, using the vector fitting method (Gustavsen and Semlyen).
+ * The poles (real or complex conjugate pairs, so that the model is a real
+ * system) start spread over the band. Each iteration solves the linear least
+ * squares problem
+ *
+ *    sum( c_n phi_n(s) ) + d + s e - f(s) sum( c~_n phi_n(s) ) = f(s)
+ *
+ * where phi_n are the partial fractions of the current poles, and the new poles
+ * are the zeros of sigma(s) = 1 + sum( c~_n phi_n(s) ), i.e. the eigenvalues of
+ * A - b c~'. Unstable poles are reflected into the left half plane. Finally the
+ * residues are found with the poles fixed.
+ *
+ * The rows of the least squares problems (the real and imaginary parts at
+ * each point) are reduced in parallel: each chunk of points is reduced to
+ * a small triangular matrix by Householder QR, then the stacked triangles
+ * are reduced again.
+ *
+ * Evaluating the model at any frequency takes O(order) operations.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <complex.h>
+#include "GTKsmithFit.h"
+#include "GTKsmithTrace.h"
+#include "GTKsmithParallel.h"
+
+// Relative change of the poles at which the relocation has converged
+#define FIT_POLE_TOLERANCE  1.0e-9
+
+// A pole is real, or the first or second of a complex conjugate pair
+typedef enum {
+    ePoleReal, ePolePairFirst, ePolePairSecond
+} tPoleKind;
+
+typedef struct {
+    const tSmithTrace *pTrace;
+    tFitDomain         domain;
+    gdouble            frequencyScale;
+    gint               order;
+    const double complex *pPoles;
+    const tPoleKind   *pKinds;
+    gboolean           bSigma;      // include the sigma columns (pole identification)
+    gint               nColumns;    // unknowns + right hand side
+    gint               grain;
+    gint               nStacked;    // rows of pTriangles
+    gdouble           *pTriangles;  // the triangle of each chunk stacked (column major)
+} tFitSystem;
+
+/*!     \brief  Reduce a matrix to upper triangular form
+ *
+ * Householder QR of a column major matrix in place (only R is kept)
+ *
+ * \ingroup fit
+ *
+ * \param pA        the matrix (element i,j at pA[ j * nRows + i ])
+ * \param nRows     number of rows
+ * \param nColumns  number of columns
+ */
+static void
+householderTriangle( gdouble *pA, gint nRows, gint nColumns ) {
+    for( gint k = 0; k < MIN( nRows, nColumns ); k++ ) {
+        gdouble *pV = pA + (gsize)k * nRows;
+        gdouble normSqu = 0.0, norm, alpha, vNormSqu;
+
+        for( gint i = k; i < nRows; i++ )
+            normSqu += SQU( pV[i] );
+        if( normSqu == 0.0 )
+            continue;
+        norm = sqrt( normSqu );
+        alpha = pV[k] > 0.0 ? -norm : norm;
+        // v = column k below the diagonal with v[k] = A[k][k] - alpha
+        vNormSqu = normSqu - SQU( pV[k] ) + SQU( pV[k] - alpha );
+        pV[k] -= alpha;
+
+        for( gint j = k + 1; j < nColumns; j++ ) {
+            gdouble *pColumn = pA + (gsize)j * nRows;
+            gdouble dot = 0.0;
+
+            for( gint i = k; i < nRows; i++ )
+                dot += pV[i] * pColumn[i];
+            dot *= 2.0 / vNormSqu;
+            for( gint i = k; i < nRows; i++ )
+                pColumn[i] -= dot * pV[i];
+        }
+        pV[k] = alpha;
+        for( gint i = k + 1; i < nRows; i++ )
+            pV[i] = 0.0;
+    }
+}
+
+/*!     \brief  Partial fractions of the poles
+ *
+ * Evaluate the real basis functions of the poles at s:
+ * 1/(s-a) for a real pole, 1/(s-a) + 1/(s-a*) and j/(s-a) - j/(s-a*) for a pair
+ *
+ * \ingroup fit
+ *
+ * \param s         complex frequency
+ * \param pPoles    the poles
+ * \param pKinds    the kind of each pole
+ * \param order     number of poles
+ * \param phi       where the basis functions are written
+ */
+static void
+partialFractions( double complex s, const double complex *pPoles, const tPoleKind *pKinds,
+        gint order, double complex phi[] ) {
+    for( gint n = 0; n < order; n++ ) {
+        if( pKinds[n] == ePoleReal ) {
+            phi[n] = 1.0 / (s - pPoles[n]);
+        } else if( pKinds[n] == ePolePairFirst ) {
+            double complex p = 1.0 / (s - pPoles[n]), q = 1.0 / (s - conj( pPoles[n] ));
+
+            phi[n] = p + q;
+            phi[n + 1] = I * p - I * q;
+            n++;
+        }
+    }
+}
+
+/*!     \brief  Value to be fitted at a point of the trace
+ *
+ * Gamma, or the normalized impedance, at a point of the trace
+ *
+ * \ingroup fit
+ *
+ * \param pTrace    pointer to the trace
+ * \param domain    gamma or impedance
+ * \param i         index of the point
+ * \return          the value (not finite if the point cannot be fitted)
+ */
+static inline double complex
+fitData( const tSmithTrace *pTrace, tFitDomain domain, gint i ) {
+    double complex gamma = pTrace->pU[i] + I * pTrace->pV[i];
+
+    return ( domain == eFitGamma ) ? gamma : (1.0 + gamma) / (1.0 - gamma);
+}
+
+/*!     \brief  Reduce a range of points of the least squares problem
+ *
+ * Build the rows of the points in the range and reduce them to a triangle
+ * (a parallel loop function)
+ *
+ * \ingroup fit
+ *
+ * \param from      first point
+ * \param to        last point (exclusive)
+ * \param userData  pointer to the tFitSystem
+ */
+static void
+reduceRange( gint from, gint to, gpointer userData ) {
+    tFitSystem *pSystem = userData;
+    gint nColumns = pSystem->nColumns, order = pSystem->order;
+    gint nRows = 2 * (to - from);
+    gdouble *pA = g_new0( gdouble, (gsize)nRows * nColumns );
+    double complex *phi = g_new( double complex, order );
+    gint firstRow = (from / pSystem->grain) * nColumns;
+
+    for( gint i = from; i < to; i++ ) {
+        double complex f = fitData( pSystem->pTrace, pSystem->domain, i );
+        double complex s = I * pSystem->pTrace->pFreq[i] / pSystem->frequencyScale;
+        gint row = 2 * (i - from);
+        gint column = 0;
+
+        // a point that cannot be fitted leaves its rows zero
+        if( !isfinite( creal( f ) ) || !isfinite( cimag( f ) ) )
+            continue;
+
+        partialFractions( s, pSystem->pPoles, pSystem->pKinds, order, phi );
+        for( gint n = 0; n < order; n++, column++ ) {
+            pA[ column * nRows + row ] = creal( phi[n] );
+            pA[ column * nRows + row + 1 ] = cimag( phi[n] );
+        }
+        pA[ column++ * nRows + row ] = 1.0;
+        if( pSystem->domain == eFitImpedance )
+            pA[ column++ * nRows + row + 1 ] = cimag( s );
+        if( pSystem->bSigma ) {
+            for( gint n = 0; n < order; n++, column++ ) {
+                double complex fPhi = -f * phi[n];
+
+                pA[ column * nRows + row ] = creal( fPhi );
+                pA[ column * nRows + row + 1 ] = cimag( fPhi );
+            }
+        }
+        pA[ column * nRows + row ] = creal( f );
+        pA[ column * nRows + row + 1 ] = cimag( f );
+    }
+
+    householderTriangle( pA, nRows, nColumns );
+    for( gint j = 0; j < nColumns; j++ )
+        for( gint i = 0; i < nColumns; i++ )
+            pSystem->pTriangles[ (gsize)j * pSystem->nStacked + firstRow + i ] =
+                    ( i <= j && i < nRows ) ? pA[ (gsize)j * nRows + i ] : 0.0;
+
+    g_free( phi );
+    g_free( pA );
+}
+
+/*!     \brief  Solve the least squares problem
+ *
+ * Build and solve the least squares problem for the current poles
+ *
+ * \ingroup fit
+ *
+ * \param pSystem   pointer to the problem (poles and options)
+ * \param solution  where the unknowns are written
+ */
+static void
+solveSystem( tFitSystem *pSystem, gdouble solution[] ) {
+    gint nPoints = pSystem->pTrace->nPoints, nColumns, nUnknowns, nChunks;
+
+    nUnknowns = pSystem->order * ( pSystem->bSigma ? 2 : 1 ) + ( pSystem->domain == eFitImpedance ? 2 : 1 );
+    nColumns = pSystem->nColumns = nUnknowns + 1;
+    pSystem->grain = MAX( PARALLEL_GRAIN, nColumns );
+    nChunks = (nPoints + pSystem->grain - 1) / pSystem->grain;
+    pSystem->nStacked = nChunks * nColumns;
+    pSystem->pTriangles = g_new( gdouble, (gsize)pSystem->nStacked * nColumns );
+
+    smithParallelFor( nPoints, pSystem->grain, reduceRange, pSystem );
+    // the stacked triangles reduce to the triangle of the whole problem
+    householderTriangle( pSystem->pTriangles, pSystem->nStacked, nColumns );
+
+#define R(i,j)  pSystem->pTriangles[ (gsize)(j) * pSystem->nStacked + (i) ]
+    for( gint j = nUnknowns - 1; j >= 0; j-- ) {
+        gdouble sum = R(j, nUnknowns), columnNorm = 0.0;
+
+        for( gint i = 0; i <= j; i++ )
+            columnNorm = hypot( columnNorm, R(i, j) );
+        for( gint k = j + 1; k < nUnknowns; k++ )
+            sum -= R(j, k) * solution[k];
+        // an unknown that the data does not determine is left at zero
+        solution[j] = ( fabs( R(j, j) ) > 1.0e-13 * columnNorm ) ? sum / R(j, j) : 0.0;
+    }
+#undef R
+
+    g_free( pSystem->pTriangles );
+    pSystem->pTriangles = NULL;
+}
+
+/*!     \brief  Reduce a matrix to upper Hessenberg form
+ *
+ * Reduce a general matrix to upper Hessenberg form by elimination with pivoting
+ * (the eigenvalues are unchanged)
+ *
+ * \ingroup fit
+ *
+ * \param a         the matrix (row major, n x n)
+ * \param n         order of the matrix
+ */
+static void
+hessenberg( gdouble *a, gint n ) {
+#define A(i,j)  a[ (i) * n + (j) ]
+    for( gint m = 1; m < n - 1; m++ ) {
+        gdouble x = 0.0;
+        gint pivot = m;
+
+        for( gint j = m; j < n; j++ ) {
+            if( fabs( A(j, m - 1) ) > fabs( x ) ) {
+                x = A(j, m - 1);
+                pivot = j;
+            }
+        }
+        if( pivot != m ) {
+            for( gint j = m - 1; j < n; j++ ) {
+                gdouble t = A(pivot, j); A(pivot, j) = A(m, j); A(m, j) = t;
+            }
+            for( gint j = 0; j < n; j++ ) {
+                gdouble t = A(j, pivot); A(j, pivot) = A(j, m); A(j, m) = t;
+            }
+        }
+        if( x != 0.0 ) {
+            for( gint i = m + 1; i < n; i++ ) {
+                gdouble y = A(i, m - 1);
+
+                if( y != 0.0 ) {
+                    y /= x;
+                    A(i, m - 1) = 0.0;
+                    for( gint j = m; j < n; j++ )
+                        A(i, j) -= y * A(m, j);
+                    for( gint j = 0; j < n; j++ )
+                        A(j, m) += y * A(j, i);
+                }
+            }
+        }
+    }
+#undef A
+}
+
+/*!     \brief  Eigenvalues of an upper Hessenberg matrix
+ *
+ * Eigenvalues of an upper Hessenberg matrix by the shifted QR algorithm
+ * (Francis double shift). Complex conjugate pairs are adjacent.
+ *
+ * \ingroup fit
+ *
+ * \param a         the matrix (row major, n x n), destroyed
+ * \param n         order of the matrix
+ * \param wr        where the real parts are written
+ * \param wi        where the imaginary parts are written
+ * \return          FALSE if the iteration did not converge
+ */
+static gboolean
+hessenbergEigenvalues( gdouble *a, gint n, gdouble wr[], gdouble wi[] ) {
+    // 1 based indexing, as the algorithm is usually given
+#define A(i,j)  a[ ((i) - 1) * n + (j) - 1 ]
+    gint nn, m, l, its;
+    gdouble z = 0.0, y, x, w, v, u, t = 0.0, s, r = 0.0, q = 0.0, p = 0.0, norm = 0.0;
+
+    for( gint i = 1; i <= n; i++ )
+        for( gint j = MAX( i - 1, 1 ); j <= n; j++ )
+            norm += fabs( A(i, j) );
+
+    nn = n;
+    while( nn >= 1 ) {
+        its = 0;
+        do {
+            // look for a small subdiagonal element
+            for( l = nn; l >= 2; l-- ) {
+                s = fabs( A(l - 1, l - 1) ) + fabs( A(l, l) );
+                if( s == 0.0 )
+                    s = norm;
+                if( fabs( A(l, l - 1) ) + s == s ) {
+                    A(l, l - 1) = 0.0;
+                    break;
+                }
+            }
+            x = A(nn, nn);
+            if( l == nn ) {
+                // one root found
+                wr[ nn - 1 ] = x + t;
+                wi[ nn-- - 1 ] = 0.0;
+            } else {
+                y = A(nn - 1, nn - 1);
+                w = A(nn, nn - 1) * A(nn - 1, nn);
+                if( l == nn - 1 ) {
+                    // two roots found
+                    p = 0.5 * (y - x);
+                    q = p * p + w;
+                    z = sqrt( fabs( q ) );
+                    x += t;
+                    if( q >= 0.0 ) {
+                        z = p + copysign( z, p );
+                        wr[ nn - 2 ] = wr[ nn - 1 ] = x + z;
+                        if( z != 0.0 )
+                            wr[ nn - 1 ] = x - w / z;
+                        wi[ nn - 2 ] = wi[ nn - 1 ] = 0.0;
+                    } else {
+                        wr[ nn - 2 ] = wr[ nn - 1 ] = x + p;
+                        wi[ nn - 2 ] = -z;
+                        wi[ nn - 1 ] = z;
+                    }
+                    nn -= 2;
+                } else {
+                    if( its == 60 )
+                        return FALSE;
+                    if( its == 10 || its == 20 ) {
+                        // exceptional shift
+                        t += x;
+                        for( gint i = 1; i <= nn; i++ )
+                            A(i, i) -= x;
+                        s = fabs( A(nn, nn - 1) ) + fabs( A(nn - 1, nn - 2) );
+                        y = x = 0.75 * s;
+                        w = -0.4375 * s * s;
+                    }
+                    ++its;
+                    for( m = nn - 2; m >= l; m-- ) {
+                        z = A(m, m);
+                        r = x - z;
+                        s = y - z;
+                        p = (r * s - w) / A(m + 1, m) + A(m, m + 1);
+                        q = A(m + 1, m + 1) - z - r - s;
+                        r = A(m + 2, m + 1);
+                        s = fabs( p ) + fabs( q ) + fabs( r );
+                        p /= s;
+                        q /= s;
+                        r /= s;
+                        if( m == l )
+                            break;
+                        u = fabs( A(m, m - 1) ) * (fabs( q ) + fabs( r ));
+                        v = fabs( p ) * (fabs( A(m - 1, m - 1) ) + fabs( z ) + fabs( A(m + 1, m + 1) ));
+                        if( u + v == v )
+                            break;
+                    }
+                    for( gint i = m + 2; i <= nn; i++ ) {
+                        A(i, i - 2) = 0.0;
+                        if( i != m + 2 )
+                            A(i, i - 3) = 0.0;
+                    }
+                    for( gint k = m; k <= nn - 1; k++ ) {
+                        if( k != m ) {
+                            p = A(k, k - 1);
+                            q = A(k + 1, k - 1);
+                            r = 0.0;
+                            if( k != nn - 1 )
+                                r = A(k + 2, k - 1);
+                            if( (x = fabs( p ) + fabs( q ) + fabs( r )) != 0.0 ) {
+                                p /= x;
+                                q /= x;
+                                r /= x;
+                            }
+                        }
+                        if( (s = copysign( sqrt( p * p + q * q + r * r ), p )) != 0.0 ) {
+                            if( k == m ) {
+                                if( l != m )
+                                    A(k, k - 1) = -A(k, k - 1);
+                            } else
+                                A(k, k - 1) = -s * x;
+                            p += s;
+                            x = p / s;
+                            y = q / s;
+                            z = r / s;
+                            q /= p;
+                            r /= p;
+                            for( gint j = k; j <= nn; j++ ) {
+                                p = A(k, j) + q * A(k + 1, j);
+                                if( k != nn - 1 ) {
+                                    p += r * A(k + 2, j);
+                                    A(k + 2, j) -= p * z;
+                                }
+                                A(k + 1, j) -= p * y;
+                                A(k, j) -= p * x;
+                            }
+                            for( gint i = l; i <= MIN( nn, k + 3 ); i++ ) {
+                                p = x * A(i, k) + y * A(i, k + 1);
+                                if( k != nn - 1 ) {
+                                    p += z * A(i, k + 2);
+                                    A(i, k + 2) -= p * r;
+                                }
+                                A(i, k + 1) -= p * q;
+                                A(i, k) -= p;
+                            }
+                        }
+                    }
+                }
+            }
+        } while( l < nn - 1 );
+    }
+#undef A
+    return TRUE;
+}
+
+/*!     \brief  Relocate the poles
+ *
+ * Replace the poles by the zeros of sigma(s), the eigenvalues of A - b c~'
+ * (unstable poles are reflected into the left half plane)
+ *
+ * \ingroup fit
+ *
+ * \param pPoles    the poles (updated)
+ * \param pKinds    the kind of each pole (updated)
+ * \param order     number of poles
+ * \param sigma     the coefficients c~ of sigma(s)
+ * \return          FALSE if the eigenvalues could not be found (the poles are unchanged)
+ */
+static gboolean
+relocatePoles( double complex *pPoles, tPoleKind *pKinds, gint order, const gdouble sigma[] ) {
+    gdouble *pH = g_new0( gdouble, order * order );
+    gdouble *wr = g_new( gdouble, order ), *wi = g_new( gdouble, order );
+    gboolean bConverged;
+
+    for( gint n = 0; n < order; n++ ) {
+        if( pKinds[n] == ePoleReal ) {
+            pH[ n * order + n ] = creal( pPoles[n] );
+            for( gint k = 0; k < order; k++ )
+                pH[ n * order + k ] -= sigma[k];
+        } else if( pKinds[n] == ePolePairFirst ) {
+            // [ re im; -im re ] with b = [ 2; 0 ]
+            pH[ n * order + n ] = pH[ (n + 1) * order + n + 1 ] = creal( pPoles[n] );
+            pH[ n * order + n + 1 ] = cimag( pPoles[n] );
+            pH[ (n + 1) * order + n ] = -cimag( pPoles[n] );
+            for( gint k = 0; k < order; k++ )
+                pH[ n * order + k ] -= 2.0 * sigma[k];
+        }
+    }
+
+    hessenberg( pH, order );
+    bConverged = hessenbergEigenvalues( pH, order, wr, wi );
+    if( bConverged ) {
+        for( gint n = 0; n < order; n++ ) {
+            gdouble re = -fabs( wr[n] );
+
+            // a pole on the imaginary axis is moved just inside the stable half plane
+            if( re == 0.0 )
+                re = -1.0e-6 * MAX( fabs( wi[n] ), 1.0 );
+            if( wi[n] == 0.0 || n == order - 1 ) {
+                pPoles[n] = re;
+                pKinds[n] = ePoleReal;
+            } else {
+                pPoles[n] = re + I * fabs( wi[n] );
+                pPoles[n + 1] = conj( pPoles[n] );
+                pKinds[n] = ePolePairFirst;
+                pKinds[n + 1] = ePolePairSecond;
+                n++;
+            }
+        }
+    }
+
+    g_free( wi );
+    g_free( wr );
+    g_free( pH );
+    return bConverged;
+}
+
+/*!     \brief  Evaluate the model
+ *
+ * Evaluate the model (in its own domain) at a complex frequency
+ *
+ * \ingroup fit
+ *
+ * \param pModel    pointer to the model
+ * \param s         j frequency / frequencyScale
+ * \return          value of the model
+ */
+static double complex
+modelValue( const tRationalModel *pModel, double complex s ) {
+    double complex f = pModel->constant + s * pModel->proportional;
+
+    for( gint n = 0; n < pModel->order; n++ )
+        f += (pModel->pResidues[n].U + I * pModel->pResidues[n].V)
+                / (s - (pModel->pPoles[n].U + I * pModel->pPoles[n].V));
+
+    return f;
+}
+
+/*!     \brief  Gamma of the model at a frequency
+ *
+ * Evaluate the reflection coefficient of the model at a frequency
+ *
+ * \ingroup fit
+ *
+ * \param pModel        pointer to the model
+ * \param frequency     frequency (Hz)
+ * \return              gamma
+ */
+tUV
+rationalModelGamma( const tRationalModel *pModel, gdouble frequency ) {
+    double complex f = modelValue( pModel, I * frequency / pModel->frequencyScale );
+
+    if( pModel->domain == eFitImpedance )
+        f = (f - 1.0) / (f + 1.0);
+
+    return (tUV){ creal( f ), cimag( f ) };
+}
+
+typedef struct {
+    const tRationalModel *pModel;
+    const tSmithTrace    *pTrace;
+    gdouble               fLow, step;
+    gdouble              *pSumSqu, *pMax;   // for each chunk
+} tFitEvaluation;
+
+static void
+errorRange( gint from, gint to, gpointer userData ) {
+    tFitEvaluation *pEval = userData;
+    gdouble sumSqu = 0.0, maxErr = 0.0;
+
+    for( gint i = from; i < to; i++ ) {
+        tUV uv = rationalModelGamma( pEval->pModel, pEval->pTrace->pFreq[i] );
+        gdouble err = hypot( uv.U - pEval->pTrace->pU[i], uv.V - pEval->pTrace->pV[i] );
+
+        if( !isfinite( err ) )
+            continue;
+        sumSqu += SQU( err );
+        maxErr = MAX( maxErr, err );
+    }
+    pEval->pSumSqu[ from / PARALLEL_GRAIN ] = sumSqu;
+    pEval->pMax[ from / PARALLEL_GRAIN ] = maxErr;
+}
+
+/*!     \brief  Fit a rational model to a trace
+ *
+ * Fit a rational model of a given order to a trace (which must have frequencies)
+ * by vector fitting
+ *
+ * \ingroup fit
+ *
+ * \param pTrace        pointer to the trace
+ * \param domain        fit gamma or the impedance (better for loads near a short circuit)
+ * \param order         number of poles
+ * \param iterations    most pole relocations (0 for FIT_ITERATIONS)
+ * \param pReport       where the fit error is written (or NULL)
+ * \return              pointer to the model (free with rationalModelFree), or NULL
+ */
+tRationalModel *
+rationalFit( const tSmithTrace *pTrace, tFitDomain domain, gint order, gint iterations, tFitReport *pReport ) {
+    tRationalModel *pModel;
+    double complex *pPoles, *previous;
+    tPoleKind *pKinds;
+    gdouble *solution, fLow = INFINITY, fHigh = -INFINITY, low;
+    gint nPairs = order / 2;
+    tFitSystem system = { pTrace, domain, 0.0, order, NULL, NULL, TRUE };
+
+    if( pTrace == NULL || pTrace->pFreq == NULL || pTrace->nPoints < 1 || order < 1 )
+        return NULL;
+    if( iterations <= 0 )
+        iterations = FIT_ITERATIONS;
+
+    for( gint i = 0; i < pTrace->nPoints; i++ ) {
+        fLow = MIN( fLow, pTrace->pFreq[i] );
+        fHigh = MAX( fHigh, pTrace->pFreq[i] );
+    }
+    if( !(fHigh > 0.0) )
+        return NULL;
+
+    // starting poles: pairs spread over the band with light damping, and a real pole if order is odd
+    pPoles = g_new( double complex, order );
+    pKinds = g_new( tPoleKind, order );
+    previous = g_new( double complex, order );
+    low = MAX( fLow, 0.01 * fHigh ) / fHigh;
+    for( gint k = 0; k < nPairs; k++ ) {
+        gdouble beta = ( nPairs == 1 ) ? (low + 1.0) / 2.0 : low + (1.0 - low) * k / (nPairs - 1);
+
+        pPoles[ 2 * k ] = -beta / 100.0 + I * beta;
+        pPoles[ 2 * k + 1 ] = conj( pPoles[ 2 * k ] );
+        pKinds[ 2 * k ] = ePolePairFirst;
+        pKinds[ 2 * k + 1 ] = ePolePairSecond;
+    }
+    if( order % 2 ) {
+        pPoles[ order - 1 ] = -0.5;
+        pKinds[ order - 1 ] = ePoleReal;
+    }
+
+    system.frequencyScale = fHigh;
+    system.pPoles = pPoles;
+    system.pKinds = pKinds;
+    solution = g_new( gdouble, 2 * order + 2 );
+
+    if( pReport )
+        pReport->iterations = 0;
+    for( gint iteration = 0; iteration < iterations; iteration++ ) {
+        gdouble change = 0.0;
+
+        memcpy( previous, pPoles, order * sizeof( double complex ) );
+        system.bSigma = TRUE;
+        solveSystem( &system, solution );
+        // the sigma coefficients follow c, d (and e)
+        if( !relocatePoles( pPoles, pKinds, order, solution + order + ( domain == eFitImpedance ? 2 : 1 ) ) )
+            break;
+        if( pReport )
+            pReport->iterations++;
+        // stop when the poles have settled
+        for( gint n = 0; n < order; n++ )
+            change = MAX( change, cabs( pPoles[n] - previous[n] ) / cabs( pPoles[n] ) );
+        if( change < FIT_POLE_TOLERANCE )
+            break;
+    }
+
+    // residues with the final poles
+    system.bSigma = FALSE;
+    solveSystem( &system, solution );
+
+    pModel = g_new0( tRationalModel, 1 );
+    pModel->domain = domain;
+    pModel->order = order;
+    pModel->frequencyScale = fHigh;
+    pModel->fLow = fLow;
+    pModel->fHigh = fHigh;
+    pModel->pPoles = g_new( tUV, order );
+    pModel->pResidues = g_new( tUV, order );
+    for( gint n = 0; n < order; n++ ) {
+        pModel->pPoles[n] = (tUV){ creal( pPoles[n] ), cimag( pPoles[n] ) };
+        if( pKinds[n] == ePoleReal ) {
+            pModel->pResidues[n] = (tUV){ solution[n], 0.0 };
+        } else if( pKinds[n] == ePolePairFirst ) {
+            pModel->pResidues[n] = (tUV){ solution[n], solution[n + 1] };
+            pModel->pResidues[n + 1] = (tUV){ solution[n], -solution[n + 1] };
+        }
+    }
+    pModel->constant = solution[ order ];
+    pModel->proportional = ( domain == eFitImpedance ) ? solution[ order + 1 ] : 0.0;
+
+    if( pReport ) {
+        gint nChunks = (pTrace->nPoints + PARALLEL_GRAIN - 1) / PARALLEL_GRAIN;
+        tFitEvaluation eval = { pModel, pTrace, 0.0, 0.0,
+                                g_new( gdouble, nChunks ), g_new( gdouble, nChunks ) };
+        gdouble sumSqu = 0.0;
+
+        smithParallelFor( pTrace->nPoints, PARALLEL_GRAIN, errorRange, &eval );
+        pReport->maxError = 0.0;
+        for( gint i = 0; i < nChunks; i++ ) {
+            sumSqu += eval.pSumSqu[i];
+            pReport->maxError = MAX( pReport->maxError, eval.pMax[i] );
+        }
+        pReport->rmsError = sqrt( sumSqu / pTrace->nPoints );
+        g_free( eval.pSumSqu );
+        g_free( eval.pMax );
+    }
+
+    g_free( solution );
+    g_free( previous );
+    g_free( pKinds );
+    g_free( pPoles );
+    return pModel;
+}
+
+/*!     \brief  Free a rational model
+ *
+ * Free a rational model
+ *
+ * \ingroup fit
+ *
+ * \param pModel    pointer to the model
+ */
+void
+rationalModelFree( tRationalModel *pModel ) {
+    if( pModel == NULL )
+        return;
+
+    g_free( pModel->pPoles );
+    g_free( pModel->pResidues );
+    g_free( pModel );
+}
+
+static void
+traceRange( gint from, gint to, gpointer userData ) {
+    tFitEvaluation *pEval = userData;
+    tSmithTrace *pTrace = (tSmithTrace *)pEval->pTrace;
+
+    for( gint i = from; i < to; i++ ) {
+        tUV uv;
+
+        pTrace->pFreq[i] = pEval->fLow + i * pEval->step;
+        uv = rationalModelGamma( pEval->pModel, pTrace->pFreq[i] );
+        pTrace->pU[i] = uv.U;
+        pTrace->pV[i] = uv.V;
+    }
+}
+
+/*!     \brief  Trace of the model
+ *
+ * Evaluate the model at evenly spaced frequencies (in parallel), e.g. to
+ * redraw a zoomed part of a sweep at the resolution of the display
+ *
+ * \ingroup fit
+ *
+ * \param pModel    pointer to the model
+ * \param fLow      first frequency (Hz)
+ * \param fHigh     last frequency (Hz)
+ * \param nPoints   number of points
+ * \return          pointer to the trace (free with smithTraceFree)
+ */
+tSmithTrace *
+rationalModelTrace( const tRationalModel *pModel, gdouble fLow, gdouble fHigh, gint nPoints ) {
+    tSmithTrace *pTrace = smithTraceNew( nPoints, TRUE );
+    tFitEvaluation eval = { pModel, pTrace, fLow, nPoints > 1 ? (fHigh - fLow) / (nPoints - 1) : 0.0 };
+
+    smithParallelFor( nPoints, PARALLEL_GRAIN, traceRange, &eval );
+    pTrace->nPoints = MAX( nPoints, 0 );
+
+    return pTrace;
+}
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHFIT_H_
+#define GTKSMITHFIT_H_
+
+#include "GTKsmithChart.h"
+
+typedef enum {
+    eFitGamma,          // fit gamma(f)
+    eFitImpedance       // fit the normalized impedance z(f)
+} tFitDomain;
+
+// f(s) = d + s e + sum( residue / (s - pole) ) with s = j frequency / frequencyScale
+typedef struct {
+    tFitDomain domain;
+    gint       order;           // number of poles
+    gdouble    frequencyScale;  // Hz
+    gdouble    fLow, fHigh;     // band of the data fitted (Hz)
+    tUV       *pPoles;          // complex conjugate pairs are adjacent (upper first)
+    tUV       *pResidues;
+    gdouble    constant;        // d
+    gdouble    proportional;    // e (0 when fitting gamma)
+} tRationalModel;
+
+typedef struct {
+    gdouble rmsError;           // RMS of |gamma(model) - gamma(data)| over the points fitted
+    gdouble maxError;           // largest |gamma(model) - gamma(data)|
+    gint    iterations;         // pole relocations performed (fewer if the poles settle)
+} tFitReport;
+
+#define FIT_ITERATIONS  10
+
+tRationalModel *rationalFit( const tSmithTrace *, tFitDomain, gint, gint, tFitReport * );
+void rationalModelFree( tRationalModel * );
+tUV rationalModelGamma( const tRationalModel *, gdouble );
+tSmithTrace *rationalModelTrace( const tRationalModel *, gdouble, gdouble, gint );
+
+#endif /* GTKSMITHFIT_H_ */
@@ -0,0 +1,189 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithGain.c
+ * @brief Constant gain circles of a two-port
+ *
+ * @author Michael G. Katzmann
+ *
+ * With D = S11 S22 - S12 S21, the Rollett factor
+ * K = (1 - |S11|^2 - |S22|^2 + |D|^2) / (2 |S12 S21|) and g = G / |S21|^2
+ *
+ *  operating power gain (load plane):
+ *      center = g conj(S22 - D conj(S11)) / (1 + g (|S22|^2 - |D|^2))
+ *      radius = sqrt(1 - 2 K |S12 S21| g + |S12 S21|^2 g^2) / |1 + g (|S22|^2 - |D|^2)|
+ *
+ *  available power gain (source plane): the same with S11 and S22 exchanged.
+ *
+ *  transducer gain (load plane) for a source gamma S, which gives the output
+ *  reflection gamma out = S22 + S12 S21 gamma S / (1 - S11 gamma S). With
+ *      g = G |1 - S11 gamma S|^2 / (|S21|^2 (1 - |gamma S|^2))
+ *      center = g conj(gamma out) / (1 + g |gamma out|^2)
+ *      radius = sqrt(|center|^2 + (1 - g) / (1 + g |gamma out|^2))
+ *
+ * The S-parameters are given as traces (real part in U, imaginary part in V)
+ * sharing the same frequencies. The circles for all levels at all frequencies
+ * are calculated in parallel. A gain that cannot be reached gives a circle
+ * that is not finite.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "GTKsmithGain.h"
+#include "GTKsmithParallel.h"
+
+// Frequencies whose circles are calculated by each worker at a time
+#define GAIN_GRAIN      64
+
+typedef struct {
+    tGainType      type;
+    const gdouble *S11r, *S11i, *S12r, *S12i, *S21r, *S21i, *S22r, *S22i;
+    const tUV     *pGammaSource;
+    const gdouble *pLevels;
+    gint           nLevels;
+    tCircle       *pCircles;
+} tGainJob;
+
+static const tCircle noCircle = { { NAN, NAN }, NAN };
+
+static void
+gainRange( gint from, gint to, gpointer userData ) {
+    tGainJob *pJob = userData;
+
+    for( gint f = from; f < to; f++ ) {
+        tCircle *pCircles = &pJob->pCircles[ (gsize)f * pJob->nLevels ];
+        gdouble S11r = pJob->S11r[f], S11i = pJob->S11i[f];
+        gdouble S22r = pJob->S22r[f], S22i = pJob->S22i[f];
+        gdouble S21r = pJob->S21r[f], S21i = pJob->S21i[f];
+        // S12 S21
+        gdouble Pr = pJob->S12r[f] * S21r - pJob->S12i[f] * S21i;
+        gdouble Pi = pJob->S12r[f] * S21i + pJob->S12i[f] * S21r;
+        gdouble magSquS21 = SQU(S21r) + SQU(S21i);
+
+        if( pJob->type == eGainTransducer ) {
+            tUV gS = pJob->pGammaSource ? pJob->pGammaSource[f] : (tUV){ 0.0, 0.0 };
+            // 1 - S11 gamma S
+            gdouble Qr = 1.0 - (S11r * gS.U - S11i * gS.V), Qi = -(S11r * gS.V + S11i * gS.U);
+            gdouble magSquQ = SQU(Qr) + SQU(Qi);
+            // S12 S21 gamma S / (1 - S11 gamma S)
+            gdouble Nr = Pr * gS.U - Pi * gS.V, Ni = Pr * gS.V + Pi * gS.U;
+            gdouble outR = S22r + (Nr * Qr + Ni * Qi) / magSquQ;
+            gdouble outI = S22i + (Ni * Qr - Nr * Qi) / magSquQ;
+            gdouble magSquOut = SQU(outR) + SQU(outI);
+            gdouble gScale = magSquQ / (magSquS21 * (1.0 - SQU(gS.U) - SQU(gS.V)));
+
+            for( gint level = 0; level < pJob->nLevels; level++ ) {
+                gdouble g = pow( 10.0, pJob->pLevels[ level ] / 10.0 ) * gScale;
+                gdouble denominator = 1.0 + g * magSquOut;
+                tUV center = { g * outR / denominator, -g * outI / denominator };
+                gdouble radiusSqu = SQU(center.U) + SQU(center.V) + (1.0 - g) / denominator;
+
+                pCircles[ level ] = ( radiusSqu >= 0.0 ) ? (tCircle){ center, sqrt( radiusSqu ) } : noCircle;
+            }
+        } else {
+            // D = S11 S22 - S12 S21
+            gdouble Dr = S11r * S22r - S11i * S22i - Pr;
+            gdouble Di = S11r * S22i + S11i * S22r - Pi;
+            gdouble magSquD = SQU(Dr) + SQU(Di);
+            gdouble magSquS11 = SQU(S11r) + SQU(S11i);
+            gdouble magSquS22 = SQU(S22r) + SQU(S22i);
+            gdouble magP = hypot( Pr, Pi );
+            gdouble K = (1.0 - magSquS11 - magSquS22 + magSquD) / (2.0 * magP);
+            gdouble Cr, Ci, magSquSii;
+
+            if( pJob->type == eGainOperating ) {
+                // C = S22 - D conj(S11)
+                Cr = S22r - (Dr * S11r + Di * S11i);
+                Ci = S22i - (Di * S11r - Dr * S11i);
+                magSquSii = magSquS22;
+            } else {
+                // C = S11 - D conj(S22)
+                Cr = S11r - (Dr * S22r + Di * S22i);
+                Ci = S11i - (Di * S22r - Dr * S22i);
+                magSquSii = magSquS11;
+            }
+
+            for( gint level = 0; level < pJob->nLevels; level++ ) {
+                gdouble g = pow( 10.0, pJob->pLevels[ level ] / 10.0 ) / magSquS21;
+                gdouble denominator = 1.0 + g * (magSquSii - magSquD);
+                gdouble radicand = 1.0 - 2.0 * K * magP * g + SQU(magP * g);
+
+                if( !(radicand >= 0.0) || denominator == 0.0 ) {
+                    pCircles[ level ] = noCircle;
+                    continue;
+                }
+                pCircles[ level ].center = (tUV){ g * Cr / denominator, -g * Ci / denominator };
+                pCircles[ level ].radius = sqrt( radicand ) / fabs( denominator );
+            }
+        }
+    }
+}
+
+/*!     \brief  Constant gain circles over frequency
+ *
+ * Calculate the constant gain circles for several gains at each frequency.
+ * The circles are written frequency by frequency: circles[ f * nLevels + level ].
+ * The traces must have the same number of points (the shortest sets the number).
+ *
+ * \ingroup gain
+ *
+ * \param type          available (source plane), operating or transducer (load plane) gain
+ * \param pS11          pointer to the S11 trace
+ * \param pS12          pointer to the S12 trace
+ * \param pS21          pointer to the S21 trace
+ * \param pS22          pointer to the S22 trace
+ * \param gammaSource   array of the source reflection coefficient at each frequency
+ *                      (transducer gain only, NULL for a Z0 source)
+ * \param levels        array of gains in dB
+ * \param nLevels       number of gains
+ * \param circles       array of (number of frequencies) x nLevels circles
+ */
+void
+gainCircles( tGainType type, const tSmithTrace *pS11, const tSmithTrace *pS12, const tSmithTrace *pS21,
+        const tSmithTrace *pS22, const tUV gammaSource[], const gdouble levels[], gint nLevels,
+        tCircle circles[] ) {
+    tGainJob job = { type, pS11->pU, pS11->pV, pS12->pU, pS12->pV, pS21->pU, pS21->pV,
+                     pS22->pU, pS22->pV, gammaSource, levels, nLevels, circles };
+    gint nPoints = MIN( MIN( pS11->nPoints, pS12->nPoints ), MIN( pS21->nPoints, pS22->nPoints ) );
+
+    smithParallelFor( nPoints, GAIN_GRAIN, gainRange, &job );
+}
+
+/*!     \brief  Draw gain circles in the stable region
+ *
+ * Draw gain circles (in the line color) clipped to the chart and to the
+ * stable side of the stability circle of the same plane
+ * (source circle for available gain, load circle for operating and transducer gain)
+ *
+ * \ingroup gain
+ *
+ * \param cr            pointer to the cairo context
+ * \param circles       array of gain circles
+ * \param nCircles      number of circles
+ * \param pStability    pointer to the stability circle (or NULL not to clip to it)
+ * \param pOptions      pointer to options settings
+ */
+void
+drawGainCirclesOnSmithChart( cairo_t *cr, const tCircle circles[], gint nCircles,
+        const tStabilityCircle *pStability, tSmithOptions *pOptions ) {
+    cairo_save( cr ); {
+        if( pStability )
+            clipStableOnSmithChart( cr, pStability, pOptions );
+
+        drawCircleArrayOnSmithChart( cr, circles, nCircles, pOptions );
+    } cairo_restore( cr );
+}
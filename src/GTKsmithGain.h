@@ -0,0 +1,33 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHGAIN_H_
+#define GTKSMITHGAIN_H_
+
+#include "GTKsmithChart.h"
+#include "GTKsmithStability.h"
+
+typedef enum {
+    eGainAvailable,         // source plane
+    eGainOperating,         // load plane
+    eGainTransducer         // load plane, for a given source
+} tGainType;
+
+void gainCircles( tGainType, const tSmithTrace *, const tSmithTrace *, const tSmithTrace *, const tSmithTrace *,
+        const tUV [], const gdouble [], gint, tCircle [] );
+void drawGainCirclesOnSmithChart( cairo_t *, const tCircle [], gint, const tStabilityCircle *, tSmithOptions * );
+
+#endif /* GTKSMITHGAIN_H_ */
@@ -0,0 +1,619 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithHistory.c
+ * @brief Append only file of every sweep, for scrubbing through a soak test
+ *
+ * @author Michael G. Katzmann
+ *
+ * Sweeps are appended to a file of fixed size records, so record n is at a
+ * known offset and nothing about the history has to be held in memory. The
+ * file is a 128 byte header, the frequency axis (if given) and the records.
+ * A record is a 64 byte header (timestamp and number of points) followed by
+ * the real and the imaginary arrays of gamma, as doubles or floats, each
+ * array on a 64 byte boundary.
+ *
+ * The timestamps are also appended to an index file beside the history,
+ * one gint64 per record, so that finding the record of a time by bisection
+ * touches only a few pages of the index and then the one record.
+ *
+ * Records are written with pwrite() and read through a read only mapping
+ * of the file, which reaches beyond its end and is extended when the file
+ * outgrows it. A record or index entry
+ * left incomplete by a crash is ignored (and overwritten by the next append).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "GTKsmithHistory.h"
+#include "GTKsmithTrace.h"
+#include "GTKsmithParse.h"
+
+#define HISTORY_MAGIC       "SMITHHS1"
+#define HISTORY_VERSION     1
+#define HISTORY_BYTE_ORDER  0x01020304
+// Mappings extend this far beyond the end of a file, so that they are not remapped for every sweep appended
+#define HISTORY_MAP_SLACK   ((gsize)64 << 20)
+
+typedef struct {
+    gchar   magic[8];
+    guint32 version;
+    guint32 byteOrder;
+    guint32 maxPoints;
+    guint32 layout;
+    guint32 bFrequency;         // the frequency axis follows the header
+    guint32 reserved0;
+    guint64 recordOffset;       // of the first record
+    guint64 recordBytes;
+    guint8  reserved[80];
+} tHistoryHeader;
+
+G_STATIC_ASSERT( sizeof( tHistoryHeader ) == 128 );
+
+typedef struct {
+    gint64  timestamp;
+    guint32 nPoints;
+    guint8  reserved[52];
+} tRecordHeader;
+
+G_STATIC_ASSERT( sizeof( tRecordHeader ) == 64 );
+
+struct sSweepHistory {
+    gchar         *sPath;
+    gint           fd, indexFd;
+    gboolean       bReadOnly;       // the files could only be opened to read
+    tHistoryHeader header;
+    gint64         nRecords;        // complete records within the mappings
+
+    const guint8  *pMap;            // read only mapping of the history
+    gsize          mapLength;
+    const gint64  *pIndexMap;       // and of the index
+    gsize          indexMapLength;
+
+    tSmithTrace    trace;           // the record last read (borrowing its arrays)
+    gdouble       *pConvertedU;     // gamma of a float record
+    gdouble       *pConvertedV;
+    gdouble       *pPointNumbers;   // frequency of a history without a frequency axis
+    guint8        *pRecord;         // the record being appended
+};
+
+/*!     \brief  Round up to the alignment
+ *
+ * Round a size up to a multiple of TRACE_ALIGNMENT
+ *
+ * \ingroup history
+ *
+ * \param bytes     size
+ * \return          rounded size
+ */
+static inline gsize
+alignedBytes( gsize bytes ) {
+    return (bytes + TRACE_ALIGNMENT - 1) & ~(gsize)(TRACE_ALIGNMENT - 1);
+}
+
+/*!     \brief  Size of the arrays of a record
+ *
+ * Size of the real or imaginary array of a record
+ *
+ * \ingroup history
+ *
+ * \param pHeader   header of the history
+ * \return          bytes
+ */
+static inline gsize
+arrayBytes( const tHistoryHeader *pHeader ) {
+    return alignedBytes( (gsize)pHeader->maxPoints
+                         * (pHeader->layout == eHistoryFloat ? sizeof( gfloat ) : sizeof( gdouble )) );
+}
+
+/*!     \brief  Set an error from errno
+ *
+ * Set a file error from errno
+ *
+ * \ingroup history
+ *
+ * \param ppError   where the error is reported (or NULL)
+ * \param sPath     the file
+ */
+static void
+setErrnoError( GError **ppError, const gchar *sPath ) {
+    gint error = errno;
+
+    g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( error ), "%s: %s", sPath, g_strerror( error ) );
+}
+
+/*!     \brief  Write all of a buffer at an offset
+ *
+ * Write all of a buffer at an offset of a file
+ *
+ * \ingroup history
+ *
+ * \param fd        file descriptor
+ * \param pData     data
+ * \param length    bytes
+ * \param offset    offset in the file
+ * \return          FALSE on error (errno is set)
+ */
+static gboolean
+writeAt( gint fd, const void *pData, gsize length, off_t offset ) {
+    const guint8 *p = pData;
+
+    while( length > 0 ) {
+        gssize n = pwrite( fd, p, length, offset );
+
+        if( n < 0 && errno == EINTR )
+            continue;
+        if( n <= 0 ) {
+            if( n == 0 )
+                errno = EIO;
+            return FALSE;
+        }
+        p += n;
+        length -= n;
+        offset += n;
+    }
+    return TRUE;
+}
+
+/*!     \brief  Count the complete records
+ *
+ * Count the complete records of the files (with their index entries)
+ *
+ * \ingroup history
+ *
+ * \param pHistory      pointer to the history
+ * \param pStatus       where the status of the history file is written
+ * \param pIndexStatus  where the status of the index file is written
+ * \return              number of records, or -1 on error (errno is set)
+ */
+static gint64
+countRecords( tSweepHistory *pHistory, struct stat *pStatus, struct stat *pIndexStatus ) {
+    gint64 nRecords;
+
+    if( fstat( pHistory->fd, pStatus ) != 0 || fstat( pHistory->indexFd, pIndexStatus ) != 0 )
+        return -1;
+
+    nRecords = MIN( ( pStatus->st_size - (off_t)pHistory->header.recordOffset ) / (off_t)pHistory->header.recordBytes,
+                    pIndexStatus->st_size / (off_t)sizeof( gint64 ) );
+    return MAX( nRecords, 0 );
+}
+
+/*!     \brief  Bring the mappings up to date
+ *
+ * Count the complete records (with their index entries) and extend the
+ * mappings of the history and index to cover them. The count is kept only
+ * once both mappings cover it.
+ *
+ * \ingroup history
+ *
+ * \param pHistory  pointer to the history
+ * \return          FALSE if a file could not be examined or mapped (the mappings and count are unchanged)
+ */
+static gboolean
+historyRefresh( tSweepHistory *pHistory ) {
+    struct stat status, indexStatus;
+    gint64 nRecords = countRecords( pHistory, &status, &indexStatus );
+
+    if( nRecords < 0 )
+        return FALSE;
+
+    // only the complete records within the file are ever read from the slack
+    if( (gsize)status.st_size > pHistory->mapLength ) {
+        gsize length = status.st_size + HISTORY_MAP_SLACK;
+        void *pMap = mmap( NULL, length, PROT_READ, MAP_SHARED, pHistory->fd, 0 );
+
+        if( pMap == MAP_FAILED )
+            return FALSE;
+        if( pHistory->pMap )
+            munmap( (void *)pHistory->pMap, pHistory->mapLength );
+        pHistory->pMap = pMap;
+        pHistory->mapLength = length;
+    }
+    if( (gsize)indexStatus.st_size > pHistory->indexMapLength ) {
+        gsize length = indexStatus.st_size + HISTORY_MAP_SLACK / 64;
+        void *pMap = mmap( NULL, length, PROT_READ, MAP_SHARED, pHistory->indexFd, 0 );
+
+        if( pMap == MAP_FAILED )
+            return FALSE;
+        if( pHistory->pIndexMap )
+            munmap( (void *)pHistory->pIndexMap, pHistory->indexMapLength );
+        pHistory->pIndexMap = pMap;
+        pHistory->indexMapLength = length;
+    }
+    pHistory->nRecords = nRecords;
+
+    return TRUE;
+}
+
+/*!     \brief  Open the files of a history
+ *
+ * Open the history and index files and make the history object
+ *
+ * \ingroup history
+ *
+ * \param sPath     path of the history
+ * \param flags     open() flags (O_RDWR without O_CREAT falls back to O_RDONLY if the files cannot be written)
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the history, or NULL on error
+ */
+static tSweepHistory *
+historyOpenFiles( const gchar *sPath, gint flags, GError **ppError ) {
+    gchar *sIndexPath = g_strconcat( sPath, SWEEP_HISTORY_INDEX_SUFFIX, NULL );
+    tSweepHistory *pHistory = g_new0( tSweepHistory, 1 );
+
+    pHistory->fd = open( sPath, flags | O_CLOEXEC, 0644 );
+    pHistory->indexFd = pHistory->fd < 0 ? -1 : open( sIndexPath, flags | O_CLOEXEC, 0644 );
+    // an existing history that cannot be written can still be read (e.g. to scrub through it)
+    if( pHistory->indexFd < 0 && (flags & O_ACCMODE) == O_RDWR && !(flags & O_CREAT)
+            && (errno == EACCES || errno == EPERM || errno == EROFS) ) {
+        if( pHistory->fd >= 0 )
+            close( pHistory->fd );
+        pHistory->bReadOnly = TRUE;
+        pHistory->fd = open( sPath, O_RDONLY | O_CLOEXEC );
+        pHistory->indexFd = pHistory->fd < 0 ? -1 : open( sIndexPath, O_RDONLY | O_CLOEXEC );
+    }
+    if( pHistory->indexFd < 0 ) {
+        setErrnoError( ppError, pHistory->fd < 0 ? sPath : sIndexPath );
+        if( pHistory->fd >= 0 )
+            close( pHistory->fd );
+        g_free( pHistory );
+        pHistory = NULL;
+    } else {
+        pHistory->sPath = g_strdup( sPath );
+    }
+
+    g_free( sIndexPath );
+    return pHistory;
+}
+
+/*!     \brief  Create a sweep history
+ *
+ * Create (or replace) a history file and its index, to append sweeps to
+ *
+ * \ingroup history
+ *
+ * \param sPath     path of the history file
+ * \param maxPoints most points in a sweep
+ * \param pFreq     frequency axis of the sweeps (maxPoints values, or NULL)
+ * \param layout    doubles or floats
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the history (free with sweepHistoryFree), or NULL on error
+ */
+tSweepHistory *
+sweepHistoryCreate( const gchar *sPath, gint maxPoints, const gdouble *pFreq, tHistoryLayout layout, GError **ppError ) {
+    tSweepHistory *pHistory;
+    tHistoryHeader *pHeader;
+    gsize freqBytes = pFreq ? alignedBytes( maxPoints * sizeof( gdouble ) ) : 0;
+    guint8 *pStart;
+    gboolean bOK;
+
+    g_return_val_if_fail( maxPoints > 0, NULL );
+
+    if( (pHistory = historyOpenFiles( sPath, O_RDWR | O_CREAT | O_TRUNC, ppError )) == NULL )
+        return NULL;
+
+    pHeader = &pHistory->header;
+    memcpy( pHeader->magic, HISTORY_MAGIC, sizeof( pHeader->magic ) );
+    pHeader->version = HISTORY_VERSION;
+    pHeader->byteOrder = HISTORY_BYTE_ORDER;
+    pHeader->maxPoints = maxPoints;
+    pHeader->layout = layout;
+    pHeader->bFrequency = pFreq != NULL;
+    pHeader->recordOffset = sizeof( tHistoryHeader ) + freqBytes;
+    pHeader->recordBytes = sizeof( tRecordHeader ) + 2 * arrayBytes( pHeader );
+
+    pStart = g_malloc0( pHeader->recordOffset );
+    memcpy( pStart, pHeader, sizeof( tHistoryHeader ) );
+    if( pFreq )
+        memcpy( pStart + sizeof( tHistoryHeader ), pFreq, maxPoints * sizeof( gdouble ) );
+    bOK = writeAt( pHistory->fd, pStart, pHeader->recordOffset, 0 ) && historyRefresh( pHistory );
+    g_free( pStart );
+
+    if( !bOK ) {
+        setErrnoError( ppError, sPath );
+        sweepHistoryFree( pHistory );
+        return NULL;
+    }
+
+    return pHistory;
+}
+
+/*!     \brief  Open a sweep history
+ *
+ * Open an existing history file, to scrub through it and append to it. A
+ * history that cannot be written is opened to read only (appending fails).
+ *
+ * \ingroup history
+ *
+ * \param sPath     path of the history file
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the history (free with sweepHistoryFree), or NULL on error
+ */
+tSweepHistory *
+sweepHistoryOpen( const gchar *sPath, GError **ppError ) {
+    tSweepHistory *pHistory = historyOpenFiles( sPath, O_RDWR, ppError );
+    tHistoryHeader *pHeader;
+    const gchar *sProblem = NULL;
+
+    if( pHistory == NULL )
+        return NULL;
+
+    pHeader = &pHistory->header;
+    if( pread( pHistory->fd, pHeader, sizeof( tHistoryHeader ), 0 ) != sizeof( tHistoryHeader )
+            || memcmp( pHeader->magic, HISTORY_MAGIC, sizeof( pHeader->magic ) ) != 0 )
+        sProblem = "not a sweep history";
+    else if( pHeader->version != HISTORY_VERSION )
+        sProblem = "unknown version of sweep history";
+    else if( pHeader->byteOrder != HISTORY_BYTE_ORDER )
+        sProblem = "sweep history of the other byte order";
+    else if( pHeader->maxPoints == 0 || pHeader->layout > eHistoryFloat
+            || pHeader->recordBytes != sizeof( tRecordHeader ) + 2 * arrayBytes( pHeader )
+            || pHeader->recordOffset != sizeof( tHistoryHeader )
+                    + (pHeader->bFrequency ? alignedBytes( pHeader->maxPoints * sizeof( gdouble ) ) : 0) )
+        sProblem = "the header of the sweep history is damaged";
+
+    if( sProblem ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "%s: %s", sPath, sProblem );
+        sweepHistoryFree( pHistory );
+        return NULL;
+    }
+    if( !historyRefresh( pHistory ) ) {
+        setErrnoError( ppError, sPath );
+        sweepHistoryFree( pHistory );
+        return NULL;
+    }
+
+    return pHistory;
+}
+
+/*!     \brief  Close a sweep history
+ *
+ * Close a sweep history (the files remain)
+ *
+ * \ingroup history
+ *
+ * \param pHistory  pointer to the history
+ */
+void
+sweepHistoryFree( tSweepHistory *pHistory ) {
+    if( pHistory == NULL )
+        return;
+
+    if( pHistory->pMap )
+        munmap( (void *)pHistory->pMap, pHistory->mapLength );
+    if( pHistory->pIndexMap )
+        munmap( (void *)pHistory->pIndexMap, pHistory->indexMapLength );
+    close( pHistory->fd );
+    close( pHistory->indexFd );
+    g_aligned_free( pHistory->pConvertedU );
+    g_aligned_free( pHistory->pConvertedV );
+    g_aligned_free( pHistory->pPointNumbers );
+    g_free( pHistory->pRecord );
+    g_free( pHistory->sPath );
+    g_free( pHistory );
+}
+
+/*!     \brief  Append a sweep
+ *
+ * Append a sweep to the history (points beyond the maximum of the history are dropped).
+ * Timestamps should not decrease from one sweep to the next.
+ *
+ * \ingroup history
+ *
+ * \param pHistory  pointer to the history
+ * \param pTrace    the sweep
+ * \param timestamp time of the sweep (e.g. g_get_real_time())
+ * \param ppError   where an error is reported (or NULL)
+ * \return          FALSE on error
+ */
+gboolean
+sweepHistoryAppend( tSweepHistory *pHistory, const tSmithTrace *pTrace, gint64 timestamp, GError **ppError ) {
+    const tHistoryHeader *pHeader = &pHistory->header;
+    gsize bytes = arrayBytes( pHeader );
+    gint n = MIN( pTrace->nPoints, (gint)pHeader->maxPoints );
+    struct stat status, indexStatus;
+    tRecordHeader *pRecordHeader;
+    guint8 *pArrays;
+    gint64 nRecords;
+
+    if( pHistory->bReadOnly ) {
+        errno = EACCES;
+        setErrnoError( ppError, pHistory->sPath );
+        return FALSE;
+    }
+
+    if( pHistory->pRecord == NULL )
+        pHistory->pRecord = g_malloc0( pHeader->recordBytes );
+    pRecordHeader = (tRecordHeader *)pHistory->pRecord;
+    pArrays = pHistory->pRecord + sizeof( tRecordHeader );
+
+    pRecordHeader->timestamp = timestamp;
+    pRecordHeader->nPoints = n;
+    if( pHeader->layout == eHistoryFloat ) {
+        gfloat *pU = (gfloat *)pArrays, *pV = (gfloat *)(pArrays + bytes);
+
+        for( gint i = 0; i < n; i++ ) {
+            pU[i] = pTrace->pU[i];
+            pV[i] = pTrace->pV[i];
+        }
+    } else {
+        memcpy( pArrays, pTrace->pU, n * sizeof( gdouble ) );
+        memcpy( pArrays + bytes, pTrace->pV, n * sizeof( gdouble ) );
+    }
+
+    // another process may have appended since (or a crash left a partial record)
+    if( (nRecords = countRecords( pHistory, &status, &indexStatus )) < 0 ) {
+        setErrnoError( ppError, pHistory->sPath );
+        return FALSE;
+    }
+
+    // the record first, so an index entry always has its record
+    if( !writeAt( pHistory->fd, pHistory->pRecord, pHeader->recordBytes,
+                  pHeader->recordOffset + nRecords * pHeader->recordBytes )
+            || !writeAt( pHistory->indexFd, &timestamp, sizeof( timestamp ), nRecords * sizeof( gint64 ) ) ) {
+        setErrnoError( ppError, pHistory->sPath );
+        return FALSE;
+    }
+    // (the record is counted when the mappings are next extended to it)
+
+    return TRUE;
+}
+
+/*!     \brief  Number of sweeps in the history
+ *
+ * Number of sweeps in the history (including those appended by another process)
+ *
+ * \ingroup history
+ *
+ * \param pHistory  pointer to the history
+ * \return          number of records, or -1 if the history could not be mapped
+ */
+gint64
+sweepHistoryCount( tSweepHistory *pHistory ) {
+    if( !historyRefresh( pHistory ) )
+        return -1;
+    return pHistory->nRecords;
+}
+
+/*!     \brief  Time span of the history
+ *
+ * Times of the first and last sweeps of the history (e.g. for the range of a scrubber)
+ *
+ * \ingroup history
+ *
+ * \param pHistory  pointer to the history
+ * \param pFirst    where the time of the first sweep is written
+ * \param pLast     where the time of the last sweep is written
+ * \return          FALSE if the history is empty (or cannot be mapped)
+ */
+gboolean
+sweepHistoryTimeRange( tSweepHistory *pHistory, gint64 *pFirst, gint64 *pLast ) {
+    if( sweepHistoryCount( pHistory ) <= 0 )
+        return FALSE;
+
+    *pFirst = pHistory->pIndexMap[0];
+    *pLast = pHistory->pIndexMap[ pHistory->nRecords - 1 ];
+    return TRUE;
+}
+
+/*!     \brief  Find the sweep of a time
+ *
+ * Find the last sweep at or before a time, by bisection of the timestamp index
+ *
+ * \ingroup history
+ *
+ * \param pHistory  pointer to the history
+ * \param timestamp time
+ * \return          record number (0 if the time is before the first sweep), or -1 if the history is empty (or cannot be mapped)
+ */
+gint64
+sweepHistoryFind( tSweepHistory *pHistory, gint64 timestamp ) {
+    gint64 low = 0, high;
+
+    if( (high = sweepHistoryCount( pHistory )) <= 0 )
+        return -1;
+
+    // the first record later than the time
+    while( low < high ) {
+        gint64 middle = low + (high - low) / 2;
+
+        if( pHistory->pIndexMap[ middle ] <= timestamp )
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    return MAX( low - 1, 0 );
+}
+
+/*!     \brief  Read a sweep
+ *
+ * Read a sweep of the history, touching only that record. Double records are
+ * used in place in the mapping; float records are converted. The frequency is
+ * that of the history, or the point number if it has none.
+ *
+ * \ingroup history
+ *
+ * \param pHistory      pointer to the history
+ * \param n             record number
+ * \param pTimestamp    where the time of the sweep is written (or NULL)
+ * \return              the sweep (owned by the history, valid until the next call), or NULL if there is no record n
+ */
+const tSmithTrace *
+sweepHistoryRecord( tSweepHistory *pHistory, gint64 n, gint64 *pTimestamp ) {
+    const tHistoryHeader *pHeader = &pHistory->header;
+    gsize bytes = arrayBytes( pHeader );
+    const tRecordHeader *pRecordHeader;
+    const guint8 *pArrays;
+    tSmithTrace *pTrace;
+    gint nPoints;
+
+    // the record may have been appended since the history was last counted or mapped
+    if( n < 0 )
+        return NULL;
+    if( (n >= pHistory->nRecords || pHeader->recordOffset + (n + 1) * pHeader->recordBytes > pHistory->mapLength)
+            && n >= sweepHistoryCount( pHistory ) )
+        return NULL;
+
+    pRecordHeader = (const tRecordHeader *)(pHistory->pMap + pHeader->recordOffset + n * pHeader->recordBytes);
+    pArrays = (const guint8 *)pRecordHeader + sizeof( tRecordHeader );
+    nPoints = MIN( pRecordHeader->nPoints, pHeader->maxPoints );
+
+    pTrace = &pHistory->trace;
+    pTrace->flags.bBorrowed = TRUE;
+    pTrace->nAllocated = pHeader->maxPoints;
+    if( pHeader->bFrequency ) {
+        // the mapping may have moved since the last record
+        pTrace->pFreq = (gdouble *)(pHistory->pMap + sizeof( tHistoryHeader ));
+    } else {
+        if( pHistory->pPointNumbers == NULL ) {
+            pHistory->pPointNumbers = g_aligned_alloc( pHeader->maxPoints, sizeof( gdouble ), TRACE_ALIGNMENT );
+            for( guint i = 0; i < pHeader->maxPoints; i++ )
+                pHistory->pPointNumbers[i] = i;
+        }
+        pTrace->pFreq = pHistory->pPointNumbers;
+    }
+
+    if( pHeader->layout == eHistoryFloat ) {
+        const gfloat *pU = (const gfloat *)pArrays, *pV = (const gfloat *)(pArrays + bytes);
+
+        if( pHistory->pConvertedU == NULL ) {
+            pHistory->pConvertedU = g_aligned_alloc( pHeader->maxPoints, sizeof( gdouble ), TRACE_ALIGNMENT );
+            pHistory->pConvertedV = g_aligned_alloc( pHeader->maxPoints, sizeof( gdouble ), TRACE_ALIGNMENT );
+        }
+        pTrace->pU = pHistory->pConvertedU;
+        pTrace->pV = pHistory->pConvertedV;
+        for( gint i = 0; i < nPoints; i++ ) {
+            pTrace->pU[i] = pU[i];
+            pTrace->pV[i] = pV[i];
+        }
+    } else {
+        pTrace->pU = (gdouble *)pArrays;
+        pTrace->pV = (gdouble *)(pArrays + bytes);
+    }
+    pTrace->nPoints = nPoints;
+
+    if( pTimestamp )
+        *pTimestamp = pRecordHeader->timestamp;
+    return pTrace;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHHISTORY_H_
+#define GTKSMITHHISTORY_H_
+
+#include "GTKsmithChart.h"
+
+typedef enum {
+    eHistoryDouble,     // gamma as doubles, read in place
+    eHistoryFloat       // gamma as floats (half the size), converted when read
+} tHistoryLayout;
+
+typedef struct sSweepHistory tSweepHistory;
+
+// Appended to the name of a history file to name its timestamp index
+#define SWEEP_HISTORY_INDEX_SUFFIX  ".index"
+
+tSweepHistory *sweepHistoryCreate( const gchar *, gint, const gdouble *, tHistoryLayout, GError ** );
+tSweepHistory *sweepHistoryOpen( const gchar *, GError ** );
+void sweepHistoryFree( tSweepHistory * );
+gboolean sweepHistoryAppend( tSweepHistory *, const tSmithTrace *, gint64, GError ** );
+gint64 sweepHistoryCount( tSweepHistory * );
+gboolean sweepHistoryTimeRange( tSweepHistory *, gint64 *, gint64 * );
+gint64 sweepHistoryFind( tSweepHistory *, gint64 );
+const tSmithTrace *sweepHistoryRecord( tSweepHistory *, gint64, gint64 * );
+
+#endif /* GTKSMITHHISTORY_H_ */
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithIndex.c
+ * @brief Spatial index of trace points for hit testing
+ *
+ * @author Michael G. Katzmann
+ *
+ * The gamma plane is divided into a uniform grid of cells covering the
+ * unit circle. Each cell holds the points (of all traces) that fall into it.
+ * Points outside the grid (|gamma| > 1) are kept in the nearest edge cell.
+ *
+ * A nearest point query searches rings of cells outward from the cell
+ * containing the query point until no unsearched cell can hold a closer point.
+ *
+ * Points appended to a trace are added to the index without re-indexing the
+ * points already there.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "GTKsmithIndex.h"
+
+// The grid covers -GRID_EXTENT to +GRID_EXTENT in U and V
+#define GRID_EXTENT     (1.0)
+
+typedef struct {
+    gdouble U, V;
+    gint    trace, index;
+} tIndexEntry;
+
+typedef struct {
+    gint         n, nAllocated;
+    tIndexEntry *pEntries;
+} tIndexCell;
+
+struct sSpatialIndex {
+    gint        nDivisions;
+    gdouble     cellSize;
+    tIndexCell *pCells;         // nDivisions x nDivisions cells
+    GArray     *nIndexed;       // number of points indexed for each trace id
+};
+
+/*!     \brief  Create an empty spatial index
+ *
+ * Create an empty spatial index
+ *
+ * \ingroup index
+ *
+ * \param nDivisions    grid cells across the diameter of the chart (0 for default)
+ * \return              pointer to the index (free with spatialIndexFree)
+ */
+tSpatialIndex *
+spatialIndexNew( gint nDivisions ) {
+    tSpatialIndex *pIndex = g_new0( tSpatialIndex, 1 );
+
+    if( nDivisions <= 0 )
+        nDivisions = SPATIAL_INDEX_DIVISIONS;
+
+    pIndex->nDivisions = nDivisions;
+    pIndex->cellSize = 2.0 * GRID_EXTENT / nDivisions;
+    pIndex->pCells = g_new0( tIndexCell, nDivisions * nDivisions );
+    pIndex->nIndexed = g_array_new( FALSE, TRUE, sizeof( gint ) );
+
+    return pIndex;
+}
+
+/*!     \brief  Free the spatial index
+ *
+ * Free the spatial index
+ *
+ * \ingroup index
+ *
+ * \param pIndex    pointer to the index
+ */
+void
+spatialIndexFree( tSpatialIndex *pIndex ) {
+    if( pIndex == NULL )
+        return;
+
+    for( gint i = 0; i < pIndex->nDivisions * pIndex->nDivisions; i++ )
+        g_free( pIndex->pCells[i].pEntries );
+    g_free( pIndex->pCells );
+    g_array_free( pIndex->nIndexed, TRUE );
+    g_free( pIndex );
+}
+
+/*!     \brief  Grid column or row of a coordinate
+ *
+ * Grid column or row of a coordinate (clamped to the edge of the grid)
+ *
+ * \ingroup index
+ *
+ * \param pIndex    pointer to the index
+ * \param coord     U or V coordinate
+ * \return          column or row
+ */
+static inline gint
+gridPosition( tSpatialIndex *pIndex, gdouble coord ) {
+    gdouble position = floor( (coord + GRID_EXTENT) / pIndex->cellSize );
+
+    return (gint)CLAMP( position, 0.0, (gdouble)(pIndex->nDivisions - 1) );
+}
+
+/*!     \brief  Remove all points of a trace from the index
+ *
+ * Remove all points of a trace from the index
+ *
+ * \ingroup index
+ *
+ * \param pIndex    pointer to the index
+ * \param trace     trace id
+ */
+void
+spatialIndexRemoveTrace( tSpatialIndex *pIndex, gint trace ) {
+    if( trace < 0 || trace >= (gint)pIndex->nIndexed->len
+            || g_array_index( pIndex->nIndexed, gint, trace ) == 0 )
+        return;
+
+    for( gint i = 0; i < pIndex->nDivisions * pIndex->nDivisions; i++ ) {
+        tIndexCell *pCell = &pIndex->pCells[i];
+        gint kept = 0;
+
+        for( gint j = 0; j < pCell->n; j++ )
+            if( pCell->pEntries[j].trace != trace )
+                pCell->pEntries[ kept++ ] = pCell->pEntries[j];
+        pCell->n = kept;
+    }
+    g_array_index( pIndex->nIndexed, gint, trace ) = 0;
+}
+
+/*!     \brief  Add the points of a trace to the index
+ *
+ * Bring the index up to date with the points of a trace.
+ * Only the points beyond those already indexed for this trace are added, so
+ * streaming data can be indexed as it is appended. If the trace has become
+ * shorter than what was indexed, the trace is indexed afresh.
+ *
+ * \ingroup index
+ *
+ * \param pIndex    pointer to the index
+ * \param trace     trace id (a small non-negative integer)
+ * \param uvPoints  array of points in gamma space
+ * \param length    number of points now in the trace
+ */
+void
+spatialIndexUpdate( tSpatialIndex *pIndex, gint trace, const tUV uvPoints[], gint length ) {
+    gint *pnIndexed;
+
+    g_return_if_fail( trace >= 0 );
+
+    if( trace >= (gint)pIndex->nIndexed->len )
+        g_array_set_size( pIndex->nIndexed, trace + 1 );
+    if( length < g_array_index( pIndex->nIndexed, gint, trace ) )
+        spatialIndexRemoveTrace( pIndex, trace );
+
+    pnIndexed = &g_array_index( pIndex->nIndexed, gint, trace );
+    for( gint i = *pnIndexed; i < length; i++ ) {
+        tIndexCell *pCell;
+
+        if( !isfinite( uvPoints[i].U ) || !isfinite( uvPoints[i].V ) )
+            continue;
+
+        pCell = &pIndex->pCells[ gridPosition( pIndex, uvPoints[i].V ) * pIndex->nDivisions
+                                 + gridPosition( pIndex, uvPoints[i].U ) ];
+        if( pCell->n == pCell->nAllocated ) {
+            pCell->nAllocated = MAX( 8, pCell->nAllocated * 2 );
+            pCell->pEntries = g_renew( tIndexEntry, pCell->pEntries, pCell->nAllocated );
+        }
+        pCell->pEntries[ pCell->n++ ] = (tIndexEntry){ uvPoints[i].U, uvPoints[i].V, trace, i };
+    }
+    *pnIndexed = MAX( *pnIndexed, length );
+}
+
+/*!     \brief  Consider the points in a cell for the nearest k
+ *
+ * Insert the points of the cell that are closer than the current
+ * k nearest into the (sorted) list of nearest points.
+ *
+ * \ingroup index
+ *
+ * \param pCell     pointer to the cell
+ * \param uv        query point
+ * \param k         number of nearest points sought
+ * \param results   sorted list of the nearest points (distance squared)
+ * \param pnFound   pointer to the number of points in the list
+ */
+static void
+searchCell( tIndexCell *pCell, tUV uv, gint k, tNearestPoint results[], gint *pnFound ) {
+    for( gint j = 0; j < pCell->n; j++ ) {
+        tIndexEntry *pEntry = &pCell->pEntries[j];
+        gdouble distSqu = SQU( pEntry->U - uv.U ) + SQU( pEntry->V - uv.V );
+        gint position;
+
+        if( *pnFound == k && distSqu >= results[ k - 1 ].distance )
+            continue;
+
+        // insertion into the sorted list (k is small)
+        position = ( *pnFound < k ) ? (*pnFound)++ : k - 1;
+        for( ; position > 0 && results[ position - 1 ].distance > distSqu; position-- )
+            results[ position ] = results[ position - 1 ];
+        results[ position ] = (tNearestPoint){ pEntry->trace, pEntry->index, distSqu };
+    }
+}
+
+/*!     \brief  Find the trace points nearest to a point
+ *
+ * Find the k points (of all indexed traces) nearest to a point in gamma space.
+ * Use deviceToUV() to convert a pointer position on the drawing area to gamma space.
+ *
+ * \ingroup index
+ *
+ * \param pIndex    pointer to the index
+ * \param uv        query point in gamma space
+ * \param k         number of nearest points sought
+ * \param results   array of k results, sorted nearest first
+ * \return          number of results found (less than k if the index has fewer points)
+ */
+gint
+spatialIndexNearest( tSpatialIndex *pIndex, tUV uv, gint k, tNearestPoint results[] ) {
+    gint nFound = 0;
+    gint column, row, n = pIndex->nDivisions;
+
+    if( k <= 0 || !isfinite( uv.U ) || !isfinite( uv.V ) )
+        return 0;
+
+    column = gridPosition( pIndex, uv.U );
+    row = gridPosition( pIndex, uv.V );
+
+    for( gint ring = 0; ring < n; ring++ ) {
+        gdouble bound;
+
+        for( gint dy = -ring; dy <= ring; dy++ ) {
+            gint y = row + dy;
+            // cells along the top and bottom of the ring, but only the ends of the rows between
+            gint dxStep = ( dy == -ring || dy == ring ) ? 1 : MAX( 2 * ring, 1 );
+
+            if( y < 0 || y >= n )
+                continue;
+            for( gint dx = -ring; dx <= ring; dx += dxStep ) {
+                gint x = column + dx;
+
+                if( x >= 0 && x < n )
+                    searchCell( &pIndex->pCells[ y * n + x ], uv, k, results, &nFound );
+            }
+        }
+
+        // no point in the cells beyond this ring can be closer than this
+        bound = ring * pIndex->cellSize;
+        if( nFound == k && results[ k - 1 ].distance <= SQU( bound ) )
+            break;
+    }
+
+    for( gint i = 0; i < nFound; i++ )
+        results[i].distance = sqrt( results[i].distance );
+
+    return nFound;
+}
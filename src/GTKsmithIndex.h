@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHINDEX_H_
+#define GTKSMITHINDEX_H_
+
+#include "GTKsmithChart.h"
+
+typedef struct {
+    gint    trace;      // trace id given to spatialIndexUpdate()
+    gint    index;      // index of the point in the trace
+    gdouble distance;   // distance from the query point (in gamma)
+} tNearestPoint;
+
+typedef struct sSpatialIndex tSpatialIndex;
+
+// Grid divisions across the diameter of the chart
+#define SPATIAL_INDEX_DIVISIONS 256
+
+tSpatialIndex *spatialIndexNew( gint );
+void spatialIndexFree( tSpatialIndex * );
+void spatialIndexUpdate( tSpatialIndex *, gint, const tUV [], gint );
+void spatialIndexRemoveTrace( tSpatialIndex *, gint );
+gint spatialIndexNearest( tSpatialIndex *, tUV, gint, tNearestPoint [] );
+
+#endif /* GTKSMITHINDEX_H_ */
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithLot.c
+ * @brief Index of the Touchstone files of a directory tree
+ *
+ * @author Michael G. Katzmann
+ *
+ * Production test leaves a Touchstone file for each part of a lot. The
+ * directory tree is walked for Touchstone files (.snp and .ts), which are then
+ * loaded in parallel, a file to each claim on the shared pool, so a large file
+ * does not hold up the others (each load is itself parallel as well).
+ *
+ * Only a summary of each file is kept: its frequency range, the worst |gamma|
+ * of a parameter in a band and a decimated preview of that parameter, so that
+ * the whole lot can be drawn or ranked without keeping thousands of networks.
+ * The summaries are indexed by file path.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GTKsmithLot.h"
+#include "GTKsmithTrace.h"
+#include "GTKsmithTouchstone.h"
+#include "GTKsmithCache.h"
+#include "GTKsmithParallel.h"
+
+struct sLotIndex {
+    gint        nEntries;
+    tLotEntry  *pEntries;           // sorted by path
+    GHashTable *pByPath;            // path to entry
+    gint        nFailures;
+};
+
+typedef struct {
+    tLotOptions options;
+    tLotEntry  *pEntries;
+} tLotLoad;
+
+/*!     \brief  Is a file name that of a Touchstone file
+ *
+ * Is a file name that of a Touchstone file (.snp or .ts)
+ *
+ * \ingroup lot
+ *
+ * \param sName     file name
+ * \return          TRUE for a Touchstone file
+ */
+static gboolean
+isTouchstoneName( const gchar *sName ) {
+    const gchar *sExtension = strrchr( sName, '.' );
+
+    return touchstonePortsFromName( sName ) > 0
+            || (sExtension && g_ascii_strcasecmp( sExtension, ".ts" ) == 0);
+}
+
+/*!     \brief  Find the Touchstone files of a directory tree
+ *
+ * Add the paths of the Touchstone files in a directory and its subdirectories
+ * (symbolic links to directories are not followed)
+ *
+ * \ingroup lot
+ *
+ * \param sDirectory    directory
+ * \param pPaths        array of paths to add to
+ * \param ppError       where an error is reported (or NULL)
+ * \return              FALSE if the directory could not be read
+ */
+static gboolean
+findTouchstoneFiles( const gchar *sDirectory, GPtrArray *pPaths, GError **ppError ) {
+    GDir *pDir = g_dir_open( sDirectory, 0, ppError );
+    const gchar *sName;
+
+    if( pDir == NULL )
+        return FALSE;
+
+    while( (sName = g_dir_read_name( pDir )) != NULL ) {
+        gchar *sPath = g_build_filename( sDirectory, sName, NULL );
+
+        if( g_file_test( sPath, G_FILE_TEST_IS_DIR ) ) {
+            // an unreadable subdirectory is skipped rather than failing the lot
+            if( !g_file_test( sPath, G_FILE_TEST_IS_SYMLINK ) )
+                findTouchstoneFiles( sPath, pPaths, NULL );
+            g_free( sPath );
+        } else if( isTouchstoneName( sName ) && g_file_test( sPath, G_FILE_TEST_IS_REGULAR ) ) {
+            g_ptr_array_add( pPaths, sPath );
+        } else {
+            g_free( sPath );
+        }
+    }
+    g_dir_close( pDir );
+
+    return TRUE;
+}
+
+/*!     \brief  Compare paths
+ *
+ * Comparison of two paths in a GPtrArray for g_ptr_array_sort()
+ */
+static gint
+comparePaths( gconstpointer a, gconstpointer b ) {
+    return strcmp( *(const gchar **)a, *(const gchar **)b );
+}
+
+/*!     \brief  Summarize a network
+ *
+ * Fill the summary of a file from its network
+ *
+ * \ingroup lot
+ *
+ * \param pEntry    entry of the file
+ * \param pNetwork  the network loaded from the file
+ * \param pOptions  the options of the load
+ */
+static void
+summarizeNetwork( tLotEntry *pEntry, const tSmithNetwork *pNetwork, const tLotOptions *pOptions ) {
+    gint row = pOptions->row > 0 ? pOptions->row : 1, column = pOptions->column > 0 ? pOptions->column : 1;
+    gint nPreview = pOptions->nPreview > 0 ? pOptions->nPreview : LOT_PREVIEW_POINTS;
+    gboolean bAll = pOptions->fLow == 0.0 && pOptions->fHigh == 0.0;
+    const tSmithTrace *pTrace;
+    gdouble worstSqu = -1.0;
+    gint n = pNetwork->nPoints;
+
+    pEntry->nPorts = pNetwork->nPorts;
+    pEntry->nPoints = n;
+    pEntry->fMin = n > 0 ? pNetwork->pFreq[0] : NAN;
+    pEntry->fMax = n > 0 ? pNetwork->pFreq[ n - 1 ] : NAN;
+    pEntry->worstGamma = pEntry->worstFrequency = NAN;
+
+    if( row > pNetwork->nPorts || column > pNetwork->nPorts ) {
+        pEntry->sError = g_strdup_printf( "no parameter %d%d in a %d-port", row, column, pNetwork->nPorts );
+        return;
+    }
+    pTrace = smithNetworkParameter( pNetwork, row, column );
+
+    for( gint i = 0; i < n; i++ ) {
+        gdouble magSqu = SQU( pTrace->pU[i] ) + SQU( pTrace->pV[i] );
+
+        if( (bAll || (pTrace->pFreq[i] >= pOptions->fLow && pTrace->pFreq[i] <= pOptions->fHigh))
+                && magSqu > worstSqu ) {
+            worstSqu = magSqu;
+            pEntry->worstFrequency = pTrace->pFreq[i];
+        }
+    }
+    if( worstSqu >= 0.0 )
+        pEntry->worstGamma = sqrt( worstSqu );
+
+    // evenly spaced points, including the first and last
+    nPreview = MIN( nPreview, n );
+    pEntry->pPreview = smithTraceNew( nPreview, TRUE );
+    for( gint k = 0; k < nPreview; k++ ) {
+        gint i = nPreview > 1 ? (gint)(((gint64)k * (n - 1) + (nPreview - 1) / 2) / (nPreview - 1)) : 0;
+
+        smithTraceAppend( pEntry->pPreview, (tUV){ pTrace->pU[i], pTrace->pV[i] }, pTrace->pFreq[i] );
+    }
+}
+
+/*!     \brief  Load and summarize files
+ *
+ * Load and summarize a range of the files (a parallel loop function)
+ *
+ * \ingroup lot
+ *
+ * \param from      first file
+ * \param to        last file (exclusive)
+ * \param userData  pointer to the tLotLoad
+ */
+static void
+loadFiles( gint from, gint to, gpointer userData ) {
+    tLotLoad *pLoad = userData;
+
+    for( gint f = from; f < to; f++ ) {
+        tLotEntry *pEntry = &pLoad->pEntries[f];
+        GError *pError = NULL;
+        // only the parameter summarized is parsed
+        const gint selection[][2] = { { MAX( pLoad->options.row, 1 ), MAX( pLoad->options.column, 1 ) } };
+        tSmithNetwork *pNetwork = pLoad->options.bCached ? touchstoneLoadCached( pEntry->sPath, &pError )
+                                                         : touchstoneLoadSelected( pEntry->sPath, selection, 1, &pError );
+
+        if( pNetwork == NULL ) {
+            pEntry->sError = g_strdup( pError->message );
+            pEntry->fMin = pEntry->fMax = pEntry->worstGamma = pEntry->worstFrequency = NAN;
+            g_error_free( pError );
+            continue;
+        }
+        summarizeNetwork( pEntry, pNetwork, &pLoad->options );
+        smithNetworkFree( pNetwork );
+    }
+}
+
+/*!     \brief  Load the Touchstone files of a directory tree
+ *
+ * Load and summarize all the Touchstone files in a directory and its
+ * subdirectories, in parallel. Files that cannot be loaded are kept in
+ * the index with the reason (see lotIndexFailures()).
+ *
+ * \ingroup lot
+ *
+ * \param sDirectory    top directory of the lot
+ * \param pOptions      band, parameter and preview (or NULL for S11 over all frequencies)
+ * \param ppError       where an error is reported (or NULL)
+ * \return              pointer to the index (free with lotIndexFree), or NULL if the directory cannot be read
+ */
+tLotIndex *
+lotIndexLoad( const gchar *sDirectory, const tLotOptions *pOptions, GError **ppError ) {
+    GPtrArray *pPaths = g_ptr_array_new();
+    tLotLoad load = { { 0 } };
+    tLotIndex *pIndex;
+
+    if( !findTouchstoneFiles( sDirectory, pPaths, ppError ) ) {
+        g_ptr_array_free( pPaths, TRUE );
+        return NULL;
+    }
+    g_ptr_array_sort( pPaths, comparePaths );
+
+    pIndex = g_new0( tLotIndex, 1 );
+    pIndex->nEntries = pPaths->len;
+    pIndex->pEntries = g_new0( tLotEntry, pIndex->nEntries );
+    pIndex->pByPath = g_hash_table_new( g_str_hash, g_str_equal );
+    for( gint f = 0; f < pIndex->nEntries; f++ ) {
+        // the entries own the paths
+        pIndex->pEntries[f].sPath = g_ptr_array_index( pPaths, f );
+        g_hash_table_insert( pIndex->pByPath, pIndex->pEntries[f].sPath, &pIndex->pEntries[f] );
+    }
+    g_ptr_array_free( pPaths, TRUE );
+
+    if( pOptions )
+        load.options = *pOptions;
+    load.pEntries = pIndex->pEntries;
+    smithParallelFor( pIndex->nEntries, 1, loadFiles, &load );
+
+    for( gint f = 0; f < pIndex->nEntries; f++ )
+        if( pIndex->pEntries[f].sError )
+            pIndex->nFailures++;
+
+    return pIndex;
+}
+
+/*!     \brief  Free a lot index
+ *
+ * Free a lot index and its summaries
+ *
+ * \ingroup lot
+ *
+ * \param pIndex    pointer to the index
+ */
+void
+lotIndexFree( tLotIndex *pIndex ) {
+    if( pIndex == NULL )
+        return;
+
+    for( gint f = 0; f < pIndex->nEntries; f++ ) {
+        g_free( pIndex->pEntries[f].sPath );
+        g_free( pIndex->pEntries[f].sError );
+        smithTraceFree( pIndex->pEntries[f].pPreview );
+    }
+    g_hash_table_destroy( pIndex->pByPath );
+    g_free( pIndex->pEntries );
+    g_free( pIndex );
+}
+
+/*!     \brief  Number of files in a lot
+ *
+ * Number of Touchstone files found (including those that could not be loaded)
+ *
+ * \ingroup lot
+ *
+ * \param pIndex    pointer to the index
+ * \return          number of entries
+ */
+gint
+lotIndexCount( const tLotIndex *pIndex ) {
+    return pIndex->nEntries;
+}
+
+/*!     \brief  Number of files that could not be loaded
+ *
+ * Number of files that could not be loaded (their entries have sError set)
+ *
+ * \ingroup lot
+ *
+ * \param pIndex    pointer to the index
+ * \return          number of failures
+ */
+gint
+lotIndexFailures( const tLotIndex *pIndex ) {
+    return pIndex->nFailures;
+}
+
+/*!     \brief  Summary of a file by position
+ *
+ * Summary of the n'th file of the lot (in order of path)
+ *
+ * \ingroup lot
+ *
+ * \param pIndex    pointer to the index
+ * \param n         position (0 to lotIndexCount() - 1)
+ * \return          pointer to the summary (owned by the index), or NULL
+ */
+const tLotEntry *
+lotIndexEntry( const tLotIndex *pIndex, gint n ) {
+    return ( n >= 0 && n < pIndex->nEntries ) ? &pIndex->pEntries[n] : NULL;
+}
+
+/*!     \brief  Summary of a file by path
+ *
+ * Summary of a file (path as found under the directory given to lotIndexLoad())
+ *
+ * \ingroup lot
+ *
+ * \param pIndex    pointer to the index
+ * \param sPath     path of the file
+ * \return          pointer to the summary (owned by the index), or NULL if not in the lot
+ */
+const tLotEntry *
+lotIndexLookup( const tLotIndex *pIndex, const gchar *sPath ) {
+    return g_hash_table_lookup( pIndex->pByPath, sPath );
+}
+
+/*!     \brief  Draw a lot on the Smith chart
+ *
+ * Overlay the preview traces of all the files of a lot
+ *
+ * \ingroup lot
+ *
+ * \param cr        pointer to the cairo context
+ * \param pIndex    pointer to the index
+ * \param pOptions  pointer to options settings
+ */
+void
+drawLotOnSmithChart( cairo_t *cr, const tLotIndex *pIndex, tSmithOptions *pOptions ) {
+    for( gint f = 0; f < pIndex->nEntries; f++ )
+        drawTraceOnSmithChart( cr, pIndex->pEntries[f].pPreview, pOptions );
+}
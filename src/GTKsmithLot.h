@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHLOT_H_
+#define GTKSMITHLOT_H_
+
+#include "GTKsmithChart.h"
+
+typedef struct {
+    gdouble  fLow, fHigh;       // band for the worst |gamma| (Hz, both 0 for all frequencies)
+    gint     row, column;       // parameter summarized (1 based, 0 for S11)
+    gint     nPreview;          // points in the preview traces (0 for LOT_PREVIEW_POINTS)
+    gboolean bCached;           // load through (and write) the binary caches of GTKsmithCache.c
+} tLotOptions;
+
+// The summary of a Touchstone file of a lot
+typedef struct {
+    gchar       *sPath;
+    gint         nPorts;
+    gint         nPoints;
+    gdouble      fMin, fMax;        // frequency range (Hz)
+    gdouble      worstGamma;        // largest |gamma| in the band (NAN if no point is in the band)
+    gdouble      worstFrequency;    // where it occurs
+    tSmithTrace *pPreview;          // decimated trace of the parameter (with frequency)
+    gchar       *sError;            // why the file could not be loaded (or NULL, with the fields above unset)
+} tLotEntry;
+
+typedef struct sLotIndex tLotIndex;
+
+#define LOT_PREVIEW_POINTS  64
+
+tLotIndex *lotIndexLoad( const gchar *, const tLotOptions *, GError ** );
+void lotIndexFree( tLotIndex * );
+gint lotIndexCount( const tLotIndex * );
+gint lotIndexFailures( const tLotIndex * );
+const tLotEntry *lotIndexEntry( const tLotIndex *, gint );
+const tLotEntry *lotIndexLookup( const tLotIndex *, const gchar * );
+void drawLotOnSmithChart( cairo_t *, const tLotIndex *, tSmithOptions * );
+
+#endif /* GTKSMITHLOT_H_ */
@@ -0,0 +1,580 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithMarker.c
+ * @brief Marker searches over traces
+ *
+ * @author Michael G. Katzmann
+ *
+ * The searches divide the trace into chunks of MARKER_GRAIN points which
+ * are searched in parallel. Within a chunk, the quantity searched for is
+ * calculated for a block of points at a time from the U and V arrays of the
+ * trace (a loop the compiler vectorizes) before the block is scanned.
+ *
+ * Positions are refined between the trace points: extrema by fitting a
+ * parabola through the neighbouring points, crossings by linear interpolation.
+ *
+ * Frequency markers are located on the (monotonic) frequency axis of the
+ * trace by bisection and gamma is interpolated between the bracketing points.
+ * A tracking marker moves to the extremum found in each new sweep.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "GTKsmithMarker.h"
+#include "GTKsmithTrace.h"
+#include "GTKsmithParallel.h"
+
+#define MARKER_BLOCK    256
+
+typedef struct {
+    const tSmithTrace *pTrace;
+    tMarkerSearch      search;
+    tUV                target;
+    gint              *pBestIndex;      // best point of each chunk
+    gdouble           *pBestKey;
+} tExtremumSearch;
+
+typedef struct {
+    const tSmithTrace *pTrace;
+    gdouble            magnitude;       // threshold (|gamma| crossings only)
+    GArray           **ppChunkFound;    // positions found in each chunk
+} tCrossingSearch;
+
+/*!     \brief  Search a range of the trace for the smallest key
+ *
+ * Find the point with the smallest key (|gamma|^2, -|gamma|^2 or distance^2)
+ * in a range of points
+ *
+ * \ingroup marker
+ *
+ * \param from      first point
+ * \param to        last point + 1
+ * \param userData  pointer to the search
+ */
+static void
+extremumRange( gint from, gint to, gpointer userData ) {
+    tExtremumSearch *pSearch = userData;
+    const gdouble *pU = pSearch->pTrace->pU, *pV = pSearch->pTrace->pV;
+    gdouble key[ MARKER_BLOCK ];
+    gdouble best = INFINITY;
+    gint bestIndex = -1;
+
+    for( gint block = from; block < to; block += MARKER_BLOCK ) {
+        const gdouble *restrict U = pU + block;
+        const gdouble *restrict V = pV + block;
+        gint n = MIN( MARKER_BLOCK, to - block );
+
+        switch( pSearch->search ) {
+        case eMarkerMinGamma:
+            for( gint i = 0; i < n; i++ )
+                key[i] = U[i] * U[i] + V[i] * V[i];
+            break;
+        case eMarkerMaxVSWR:
+            for( gint i = 0; i < n; i++ )
+                key[i] = -(U[i] * U[i] + V[i] * V[i]);
+            break;
+        case eMarkerNearest:
+            for( gint i = 0; i < n; i++ )
+                key[i] = SQU( U[i] - pSearch->target.U ) + SQU( V[i] - pSearch->target.V );
+            break;
+        }
+
+        for( gint i = 0; i < n; i++ ) {
+            if( key[i] < best ) {
+                best = key[i];
+                bestIndex = block + i;
+            }
+        }
+    }
+
+    pSearch->pBestKey[ from / MARKER_GRAIN ] = best;
+    pSearch->pBestIndex[ from / MARKER_GRAIN ] = bestIndex;
+}
+
+/*!     \brief  Magnitude of gamma of a trace point
+ *
+ * Magnitude of gamma of a trace point
+ *
+ * \ingroup marker
+ *
+ * \param pTrace    pointer to the trace
+ * \param i         index of the point
+ * \return          |gamma|
+ */
+static inline gdouble
+gammaMagnitude( const tSmithTrace *pTrace, gint i ) {
+    return hypot( pTrace->pU[i], pTrace->pV[i] );
+}
+
+/*!     \brief  VSWR from |gamma|
+ *
+ * VSWR from |gamma|
+ *
+ * \ingroup marker
+ *
+ * \param magnitude |gamma|
+ * \return          VSWR (infinite if |gamma| >= 1)
+ */
+static inline gdouble
+gammaToVSWR( gdouble magnitude ) {
+    return ( magnitude < 1.0 ) ? (1.0 + magnitude) / (1.0 - magnitude) : INFINITY;
+}
+
+/*!     \brief  Refine the position of an extremum of |gamma|
+ *
+ * Fit a parabola through |gamma| at the point and its neighbours
+ * to find the fractional position and value of the extremum.
+ *
+ * \ingroup marker
+ *
+ * \param pTrace    pointer to the trace
+ * \param i         index of the extreme point
+ * \param pPosition pointer to where the position is written
+ */
+static void
+refineExtremum( const tSmithTrace *pTrace, gint i, tMarkerPosition *pPosition ) {
+    gdouble y0, y1, y2, curvature, delta = 0.0;
+
+    y1 = gammaMagnitude( pTrace, i );
+    if( i > 0 && i < pTrace->nPoints - 1 ) {
+        y0 = gammaMagnitude( pTrace, i - 1 );
+        y2 = gammaMagnitude( pTrace, i + 1 );
+        curvature = y0 - 2.0 * y1 + y2;
+        if( curvature != 0.0 && isfinite( curvature ) )
+            delta = CLAMP( 0.5 * (y0 - y2) / curvature, -0.5, 0.5 );
+        y1 -= 0.25 * (y0 - y2) * delta;
+    }
+
+    if( delta < 0.0 ) {
+        pPosition->index = i - 1;
+        pPosition->fraction = 1.0 + delta;
+    } else {
+        pPosition->index = i;
+        pPosition->fraction = delta;
+    }
+    pPosition->value = y1;
+}
+
+/*!     \brief  Refine the position of the point nearest a target
+ *
+ * Find the point on the segments either side of the nearest trace point
+ * that is closest to the target.
+ *
+ * \ingroup marker
+ *
+ * \param pTrace    pointer to the trace
+ * \param i         index of the nearest trace point
+ * \param target    target point in gamma space
+ * \param pPosition pointer to where the position is written
+ */
+static void
+refineNearest( const tSmithTrace *pTrace, gint i, tUV target, tMarkerPosition *pPosition ) {
+    pPosition->index = i;
+    pPosition->fraction = 0.0;
+    pPosition->value = hypot( pTrace->pU[i] - target.U, pTrace->pV[i] - target.V );
+
+    for( gint segment = MAX( i - 1, 0 ); segment <= MIN( i, pTrace->nPoints - 2 ); segment++ ) {
+        gdouble dU = pTrace->pU[ segment + 1 ] - pTrace->pU[ segment ];
+        gdouble dV = pTrace->pV[ segment + 1 ] - pTrace->pV[ segment ];
+        gdouble lengthSqu = SQU( dU ) + SQU( dV );
+        gdouble t, distance;
+
+        if( lengthSqu == 0.0 )
+            continue;
+        t = ( (target.U - pTrace->pU[ segment ]) * dU + (target.V - pTrace->pV[ segment ]) * dV ) / lengthSqu;
+        t = CLAMP( t, 0.0, 1.0 );
+        distance = hypot( pTrace->pU[ segment ] + t * dU - target.U,
+                          pTrace->pV[ segment ] + t * dV - target.V );
+        if( distance < pPosition->value ) {
+            pPosition->index = segment;
+            pPosition->fraction = t;
+            pPosition->value = distance;
+        }
+    }
+}
+
+/*!     \brief  Find the extreme point of a trace
+ *
+ * Search the trace in parallel chunks for the point with the smallest key
+ * and refine its position.
+ *
+ * \ingroup marker
+ *
+ * \param pTrace    pointer to the trace
+ * \param search    which search
+ * \param target    target point (eMarkerNearest only)
+ * \param pPosition pointer to where the position is written
+ * \return          TRUE if a point was found
+ */
+static gboolean
+markerExtremum( const tSmithTrace *pTrace, tMarkerSearch search, tUV target, tMarkerPosition *pPosition ) {
+    gint nChunks, best = -1;
+    tExtremumSearch extremumSearch;
+
+    if( pTrace == NULL || pTrace->nPoints == 0 )
+        return FALSE;
+
+    nChunks = (pTrace->nPoints + MARKER_GRAIN - 1) / MARKER_GRAIN;
+    extremumSearch = (tExtremumSearch){ pTrace, search, target,
+            g_new( gint, nChunks ), g_new( gdouble, nChunks ) };
+
+    smithParallelFor( pTrace->nPoints, MARKER_GRAIN, extremumRange, &extremumSearch );
+
+    for( gint chunk = 0; chunk < nChunks; chunk++ ) {
+        if( extremumSearch.pBestIndex[ chunk ] >= 0
+                && (best < 0 || extremumSearch.pBestKey[ chunk ] < extremumSearch.pBestKey[ best ]) )
+            best = chunk;
+    }
+
+    if( best >= 0 ) {
+        if( search == eMarkerNearest )
+            refineNearest( pTrace, extremumSearch.pBestIndex[ best ], target, pPosition );
+        else
+            refineExtremum( pTrace, extremumSearch.pBestIndex[ best ], pPosition );
+    }
+
+    g_free( extremumSearch.pBestIndex );
+    g_free( extremumSearch.pBestKey );
+
+    return best >= 0;
+}
+
+/*!     \brief  Find the point of best match
+ *
+ * Find the position of the minimum |gamma| of the trace
+ *
+ * \ingroup marker
+ *
+ * \param pTrace    pointer to the trace
+ * \param pPosition pointer to where the position is written (value is |gamma|)
+ * \return          TRUE if found
+ */
+gboolean
+markerMinGamma( const tSmithTrace *pTrace, tMarkerPosition *pPosition ) {
+    return markerExtremum( pTrace, eMarkerMinGamma, (tUV){ 0.0, 0.0 }, pPosition );
+}
+
+/*!     \brief  Find the point of maximum VSWR
+ *
+ * Find the position of the maximum VSWR (maximum |gamma|) of the trace
+ *
+ * \ingroup marker
+ *
+ * \param pTrace    pointer to the trace
+ * \param pPosition pointer to where the position is written (value is the VSWR)
+ * \return          TRUE if found
+ */
+gboolean
+markerMaxVSWR( const tSmithTrace *pTrace, tMarkerPosition *pPosition ) {
+    gboolean bFound = markerExtremum( pTrace, eMarkerMaxVSWR, (tUV){ 0.0, 0.0 }, pPosition );
+
+    if( bFound )
+        pPosition->value = gammaToVSWR( pPosition->value );
+    return bFound;
+}
+
+/*!     \brief  Find the point nearest to a target
+ *
+ * Find the position along the trace nearest a target point.
+ * Use RXtoUV() to find the nearest point to an impedance.
+ *
+ * \ingroup marker
+ *
+ * \param pTrace    pointer to the trace
+ * \param target    target point in gamma space
+ * \param pPosition pointer to where the position is written (value is the distance)
+ * \return          TRUE if found
+ */
+gboolean
+markerNearest( const tSmithTrace *pTrace, tUV target, tMarkerPosition *pPosition ) {
+    return markerExtremum( pTrace, eMarkerNearest, target, pPosition );
+}
+
+/*!     \brief  Find the X=0 crossings in a range of the trace
+ *
+ * Find where the trace crosses the real axis (V changes sign)
+ * between points of the range and the following point
+ *
+ * \ingroup marker
+ *
+ * \param from      first point
+ * \param to        last point + 1
+ * \param userData  pointer to the search
+ */
+static void
+resonanceRange( gint from, gint to, gpointer userData ) {
+    tCrossingSearch *pSearch = userData;
+    const tSmithTrace *pTrace = pSearch->pTrace;
+    GArray *pFound = g_array_new( FALSE, FALSE, sizeof( tMarkerPosition ) );
+
+    to = MIN( to, pTrace->nPoints - 1 );
+    for( gint i = from; i < to; i++ ) {
+        gdouble v0 = pTrace->pV[i], v1 = pTrace->pV[ i + 1 ];
+
+        if( (v0 < 0.0) != (v1 < 0.0) && v0 != v1 ) {
+            tMarkerPosition position = { i, v0 / (v0 - v1), 0.0 };
+
+            position.value = UVtoRX( smithTracePointAt( pTrace, i, position.fraction ) ).R;
+            g_array_append_val( pFound, position );
+        }
+    }
+
+    pSearch->ppChunkFound[ from / MARKER_GRAIN ] = pFound;
+}
+
+/*!     \brief  Find the |gamma| threshold crossings in a range of the trace
+ *
+ * Find where |gamma| crosses the threshold between points of the range
+ * and the following point
+ *
+ * \ingroup marker
+ *
+ * \param from      first point
+ * \param to        last point + 1
+ * \param userData  pointer to the search
+ */
+static void
+gammaCrossingRange( gint from, gint to, gpointer userData ) {
+    tCrossingSearch *pSearch = userData;
+    const tSmithTrace *pTrace = pSearch->pTrace;
+    GArray *pFound = g_array_new( FALSE, FALSE, sizeof( tMarkerPosition ) );
+    gdouble thresholdSqu = SQU( pSearch->magnitude );
+    gdouble magSqu[ MARKER_BLOCK + 1 ];
+
+    to = MIN( to, pTrace->nPoints - 1 );
+    for( gint block = from; block < to; block += MARKER_BLOCK ) {
+        const gdouble *restrict U = pTrace->pU + block;
+        const gdouble *restrict V = pTrace->pV + block;
+        gint n = MIN( MARKER_BLOCK, to - block );
+
+        // include the point following the block
+        for( gint i = 0; i <= n; i++ )
+            magSqu[i] = U[i] * U[i] + V[i] * V[i];
+
+        for( gint i = 0; i < n; i++ ) {
+            if( (magSqu[i] < thresholdSqu) != (magSqu[ i + 1 ] < thresholdSqu) ) {
+                gdouble m0 = sqrt( magSqu[i] ), m1 = sqrt( magSqu[ i + 1 ] );
+                tMarkerPosition position = { block + i, (pSearch->magnitude - m0) / (m1 - m0),
+                                             m1 < m0 ? 1.0 : -1.0 };
+                g_array_append_val( pFound, position );
+            }
+        }
+    }
+
+    pSearch->ppChunkFound[ from / MARKER_GRAIN ] = pFound;
+}
+
+/*!     \brief  Find crossings along a trace
+ *
+ * Search the trace in parallel chunks and collect the crossings found in order.
+ *
+ * \ingroup marker
+ *
+ * \param pTrace    pointer to the trace
+ * \param func      search of a range
+ * \param magnitude threshold (|gamma| crossings only)
+ * \param pFound    array of tMarkerPosition to which the crossings are appended
+ * \return          number of crossings found
+ */
+static gint
+markerCrossings( const tSmithTrace *pTrace, tParallelFunc func, gdouble magnitude, GArray *pFound ) {
+    gint nChunks, nFound = 0;
+    tCrossingSearch crossingSearch;
+
+    if( pTrace == NULL || pTrace->nPoints < 2 )
+        return 0;
+
+    // the last point has no following point, so is not searched
+    nChunks = (pTrace->nPoints - 1 + MARKER_GRAIN - 1) / MARKER_GRAIN;
+    crossingSearch = (tCrossingSearch){ pTrace, magnitude, g_new0( GArray *, nChunks ) };
+
+    smithParallelFor( pTrace->nPoints - 1, MARKER_GRAIN, func, &crossingSearch );
+
+    for( gint chunk = 0; chunk < nChunks; chunk++ ) {
+        GArray *pChunkFound = crossingSearch.ppChunkFound[ chunk ];
+
+        g_array_append_vals( pFound, pChunkFound->data, pChunkFound->len );
+        nFound += pChunkFound->len;
+        g_array_free( pChunkFound, TRUE );
+    }
+    g_free( crossingSearch.ppChunkFound );
+
+    return nFound;
+}
+
+/*!     \brief  Find the resonances of a trace
+ *
+ * Find where the reactance of the trace passes through zero (i.e. where the
+ * trace crosses the real axis of the chart).
+ *
+ * \ingroup marker
+ *
+ * \param pTrace    pointer to the trace
+ * \param pFound    array of tMarkerPosition to which the crossings are appended
+ *                  (value is the normalized resistance at the crossing)
+ * \return          number of crossings found
+ */
+gint
+markerResonances( const tSmithTrace *pTrace, GArray *pFound ) {
+    return markerCrossings( pTrace, resonanceRange, 0.0, pFound );
+}
+
+/*!     \brief  Find the band edges of a trace
+ *
+ * Find where |gamma| crosses a threshold (e.g. the return loss specification).
+ *
+ * \ingroup marker
+ *
+ * \param pTrace    pointer to the trace
+ * \param magnitude threshold |gamma|
+ * \param pFound    array of tMarkerPosition to which the crossings are appended
+ *                  (value is +1 where |gamma| falls below the threshold, -1 where it rises above)
+ * \return          number of crossings found
+ */
+gint
+markerGammaCrossings( const tSmithTrace *pTrace, gdouble magnitude, GArray *pFound ) {
+    return markerCrossings( pTrace, gammaCrossingRange, magnitude, pFound );
+}
+
+typedef struct {
+    tSmithTrace    **ppTraces;
+    tMarkerSearch    search;
+    tUV              target;
+    tMarkerPosition *pResults;
+} tTracesSearch;
+
+static void
+searchTracesRange( gint from, gint to, gpointer userData ) {
+    tTracesSearch *pSearch = userData;
+
+    for( gint i = from; i < to; i++ ) {
+        if( !markerExtremum( pSearch->ppTraces[i], pSearch->search, pSearch->target, &pSearch->pResults[i] ) )
+            pSearch->pResults[i] = (tMarkerPosition){ -1, 0.0, NAN };
+        else if( pSearch->search == eMarkerMaxVSWR )
+            pSearch->pResults[i].value = gammaToVSWR( pSearch->pResults[i].value );
+    }
+}
+
+/*!     \brief  Search many traces at once
+ *
+ * Perform the same search on many traces, in parallel
+ *
+ * \ingroup marker
+ *
+ * \param ppTraces  array of pointers to the traces
+ * \param nTraces   number of traces
+ * \param search    which search
+ * \param target    target point (eMarkerNearest only)
+ * \param results   array of nTraces results (index is -1 if the trace is empty)
+ */
+void
+markerSearchTraces( tSmithTrace *ppTraces[], gint nTraces, tMarkerSearch search,
+        tUV target, tMarkerPosition results[] ) {
+    tTracesSearch tracesSearch = { ppTraces, search, target, results };
+
+    smithParallelFor( nTraces, 1, searchTracesRange, &tracesSearch );
+}
+
+/*!     \brief  Re-evaluate frequency markers on a new sweep
+ *
+ * Place each marker on the trace at its frequency. A tracking marker first
+ * moves its frequency to the best (or worst) match in the trace.
+ * Call after each sweep.
+ *
+ * \ingroup marker
+ *
+ * \param markers   array of markers
+ * \param nMarkers  number of markers
+ * \param pTrace    pointer to the trace (with a frequency axis)
+ */
+void
+markerUpdate( tMarker markers[], gint nMarkers, const tSmithTrace *pTrace ) {
+    tMarkerPosition extremum[ eTrackMaxVSWR + 1 ];
+    gboolean bFound[ eTrackMaxVSWR + 1 ] = { FALSE };
+    gboolean bSearched[ eTrackMaxVSWR + 1 ] = { FALSE };
+
+    for( gint i = 0; i < nMarkers; i++ ) {
+        tMarker *pMarker = &markers[i];
+        tMarkerTracking tracking = pMarker->tracking;
+
+        // each search is made once per sweep however many markers track it
+        if( tracking != eTrackOff && !bSearched[ tracking ] ) {
+            bFound[ tracking ] = ( tracking == eTrackMinGamma ) ?
+                    markerMinGamma( pTrace, &extremum[ tracking ] )
+                  : markerMaxVSWR( pTrace, &extremum[ tracking ] );
+            bSearched[ tracking ] = TRUE;
+        }
+        if( tracking != eTrackOff && bFound[ tracking ] && pTrace->pFreq ) {
+            pMarker->frequency = smithTraceFrequencyAt( pTrace,
+                    extremum[ tracking ].index, extremum[ tracking ].fraction );
+        }
+
+        pMarker->bValid = smithTraceGammaAtFrequency( pTrace, pMarker->frequency,
+                pMarker->interpolation, &pMarker->uv );
+    }
+}
+
+/*!     \brief  Format a frequency for display
+ *
+ * Format a frequency with an engineering unit (e.g. 433.92 MHz)
+ *
+ * \ingroup marker
+ *
+ * \param frequency frequency in Hz
+ * \param sBuffer   buffer for the text
+ * \param size      size of the buffer
+ */
+static void
+formatFrequency( gdouble frequency, gchar *sBuffer, gsize size ) {
+    static const gchar *sUnits[] = { "Hz", "kHz", "MHz", "GHz", "THz" };
+    gint unit = 0;
+
+    while( fabs( frequency ) >= 1000.0 && unit < (gint)G_N_ELEMENTS( sUnits ) - 1 ) {
+        frequency /= 1000.0;
+        unit++;
+    }
+    g_snprintf( sBuffer, size, "%.6g %s", frequency, sUnits[ unit ] );
+}
+
+/*!     \brief  Draw frequency markers
+ *
+ * Draw the valid markers as points labelled with their
+ * label (or frequency if they have none)
+ *
+ * \ingroup marker
+ *
+ * \param cr        pointer to the cairo context
+ * \param markers   array of markers
+ * \param nMarkers  number of markers
+ * \param pOptions  pointer to options settings
+ */
+void
+drawMarkersOnSmithChart( cairo_t *cr, const tMarker markers[], gint nMarkers, tSmithOptions *pOptions ) {
+    gchar sFrequency[ 32 ];
+
+    for( gint i = 0; i < nMarkers; i++ ) {
+        if( !markers[i].bValid )
+            continue;
+
+        drawPointOnSmithChart( cr, markers[i].uv, pOptions );
+        if( markers[i].sLabel == NULL )
+            formatFrequency( markers[i].frequency, sFrequency, sizeof( sFrequency ) );
+        annotatePointOnSmithChart( cr, markers[i].sLabel ? markers[i].sLabel : sFrequency,
+                markers[i].uv, TRUE, pOptions );
+    }
+}
@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHMARKER_H_
+#define GTKSMITHMARKER_H_
+
+#include "GTKsmithChart.h"
+#include "GTKsmithTrace.h"
+
+// A position along a trace: 'fraction' of the way from point 'index' to the next
+typedef struct {
+    gint    index;
+    gdouble fraction;
+    gdouble value;      // the value found (depends on the search)
+} tMarkerPosition;
+
+typedef enum {
+    eMarkerMinGamma, eMarkerMaxVSWR, eMarkerNearest
+} tMarkerSearch;
+
+typedef enum {
+    eTrackOff,          // the marker stays at its frequency
+    eTrackMinGamma,     // the marker follows the best match
+    eTrackMaxVSWR       // the marker follows the worst match
+} tMarkerTracking;
+
+// A marker placed by frequency. Re-evaluate it with markerUpdate() after each sweep.
+typedef struct {
+    gdouble         frequency;      // Hz (updated when tracking)
+    tMarkerTracking tracking;
+    tInterpolation  interpolation;  // between the trace points
+    gchar          *sLabel;         // NULL to label with the frequency
+
+    // set by markerUpdate()
+    gboolean        bValid;         // the frequency lies within the trace
+    tUV             uv;             // gamma at the frequency
+} tMarker;
+
+// Number of trace points searched by each worker at a time
+#define MARKER_GRAIN    16384
+
+gboolean markerMinGamma( const tSmithTrace *, tMarkerPosition * );
+gboolean markerMaxVSWR( const tSmithTrace *, tMarkerPosition * );
+gboolean markerNearest( const tSmithTrace *, tUV, tMarkerPosition * );
+gint markerResonances( const tSmithTrace *, GArray * );
+gint markerGammaCrossings( const tSmithTrace *, gdouble, GArray * );
+void markerSearchTraces( tSmithTrace *[], gint, tMarkerSearch, tUV, tMarkerPosition [] );
+void markerUpdate( tMarker [], gint, const tSmithTrace * );
+void drawMarkersOnSmithChart( cairo_t *, const tMarker [], gint, tSmithOptions * );
+
+#endif /* GTKSMITHMARKER_H_ */
@@ -0,0 +1,272 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithMatch.c
+ * @brief Lumped element matching networks
+ *
+ * @author Michael G. Katzmann
+ *
+ * Adding a series reactance moves the impedance along a constant R circle,
+ * adding a shunt susceptance moves it along a constant G circle.
+ * An L network matches a load to the center of the chart by moving along
+ * one of these circles to where it intersects the R=1 (or G=1) circle, and
+ * then along that circle to the center.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "GTKsmithMatch.h"
+#include "GTKsmithParallel.h"
+
+// Loads this close to the R=1 or G=1 circles have a single solution
+#define MATCH_EPSILON   1.0e-12
+
+/*!     \brief  Arc along a constant resistance circle
+ *
+ * The path of an impedance along the R=r circle from X=xFrom to X=xTo
+ * (i.e. the effect of adding series reactance xTo - xFrom).
+ * Increasing reactance moves clockwise around the circle.
+ *
+ * \ingroup match
+ *
+ * \param r         normalized resistance of the circle
+ * \param xFrom     starting normalized reactance
+ * \param xTo       ending normalized reactance
+ * \return          arc in gamma space
+ */
+tArc
+constantRarc( gdouble r, gdouble xFrom, gdouble xTo ) {
+    tArc arc;
+    tUV uvFrom = RXtoUV( (tRX){ r, xFrom } );
+    tUV uvTo = RXtoUV( (tRX){ r, xTo } );
+
+    arc.center = (tUV){ r / (r + 1.0), 0.0 };
+    arc.radius = 1.0 / (r + 1.0);
+    arc.angleStart = atan2( uvFrom.V, uvFrom.U - arc.center.U );
+    arc.angleEnd = atan2( uvTo.V, uvTo.U - arc.center.U );
+    arc.bNegative = ( xTo > xFrom );
+
+    return arc;
+}
+
+/*!     \brief  Arc along a constant conductance circle
+ *
+ * The path of an admittance along the G=g circle from B=bFrom to B=bTo
+ * (i.e. the effect of adding shunt susceptance bTo - bFrom).
+ * Increasing susceptance moves clockwise around the circle.
+ *
+ * \ingroup match
+ *
+ * \param g         normalized conductance of the circle
+ * \param bFrom     starting normalized susceptance
+ * \param bTo       ending normalized susceptance
+ * \return          arc in gamma space
+ */
+tArc
+constantGarc( gdouble g, gdouble bFrom, gdouble bTo ) {
+    tArc arc;
+    // the admittance chart is the impedance chart rotated by 180 degrees
+    tUV uvFrom = RXtoUV( (tRX){ g, bFrom } );
+    tUV uvTo = RXtoUV( (tRX){ g, bTo } );
+
+    arc.center = (tUV){ -g / (g + 1.0), 0.0 };
+    arc.radius = 1.0 / (g + 1.0);
+    arc.angleStart = atan2( -uvFrom.V, -uvFrom.U - arc.center.U );
+    arc.angleEnd = atan2( -uvTo.V, -uvTo.U - arc.center.U );
+    arc.bNegative = ( bTo > bFrom );
+
+    return arc;
+}
+
+/*!     \brief  Arc along a transmission line
+ *
+ * The path of a reflection coefficient moving along a (lossless, matched)
+ * transmission line toward the generator: clockwise around the constant |gamma|
+ * circle by 4 pi radians per wavelength.
+ *
+ * \ingroup match
+ *
+ * \param gammaFrom         starting reflection coefficient
+ * \param wavelengths       length of the line in wavelengths
+ * \return                  arc in gamma space
+ */
+tArc
+lineArc( tUV gammaFrom, gdouble wavelengths ) {
+    tArc arc;
+
+    arc.center = (tUV){ 0.0, 0.0 };
+    arc.radius = hypot( gammaFrom.U, gammaFrom.V );
+    arc.angleStart = atan2( gammaFrom.V, gammaFrom.U );
+    arc.angleEnd = arc.angleStart - 4.0 * M_PI * wavelengths;
+    arc.bNegative = TRUE;
+
+    return arc;
+}
+
+/*!     \brief  Describe a series element
+ *
+ * Determine the component (L or C) and its value for a normalized series reactance
+ *
+ * \ingroup match
+ *
+ * \param x         normalized reactance
+ * \param frequency frequency in Hz (or 0 if unknown)
+ * \param Z0        characteristic impedance
+ * \return          the element
+ */
+static tElement
+seriesElement( gdouble x, gdouble frequency, gdouble Z0 ) {
+    tElement element = { x >= 0.0 ? eSeriesL : eSeriesC, 0.0, x };
+    gdouble omega = 2.0 * M_PI * frequency;
+
+    if( omega > 0.0 && x != 0.0 )
+        element.value = ( x > 0.0 ) ? x * Z0 / omega : -1.0 / (omega * x * Z0);
+
+    return element;
+}
+
+/*!     \brief  Describe a shunt element
+ *
+ * Determine the component (L or C) and its value for a normalized shunt susceptance
+ *
+ * \ingroup match
+ *
+ * \param b         normalized susceptance
+ * \param frequency frequency in Hz (or 0 if unknown)
+ * \param Z0        characteristic impedance
+ * \return          the element
+ */
+static tElement
+shuntElement( gdouble b, gdouble frequency, gdouble Z0 ) {
+    tElement element = { b >= 0.0 ? eShuntC : eShuntL, 0.0, b };
+    gdouble omega = 2.0 * M_PI * frequency;
+
+    if( omega > 0.0 && b != 0.0 )
+        element.value = ( b > 0.0 ) ? b / (omega * Z0) : -Z0 / (omega * b);
+
+    return element;
+}
+
+/*!     \brief  Find all L network matching solutions for a load
+ *
+ * Find the (up to four) L networks that match the load to the center of the chart.
+ *
+ * With the shunt element at the load (possible when G <= 1), the shunt element moves
+ * the admittance along its G circle to the R=1 circle, and the series element
+ * cancels the remaining reactance.
+ * With the series element at the load (possible when R <= 1), the series element
+ * moves the impedance along its R circle to the G=1 circle, and the shunt element
+ * cancels the remaining susceptance.
+ *
+ * \ingroup match
+ *
+ * \param gammaLoad reflection coefficient of the load
+ * \param frequency frequency in Hz (or 0 for normalized values only)
+ * \param Z0        characteristic impedance (to calculate component values)
+ * \param pSet      pointer to where the solutions are written
+ * \return          TRUE if there is at least one solution
+ */
+gboolean
+solveLmatch( tUV gammaLoad, gdouble frequency, gdouble Z0, tLmatchSet *pSet ) {
+    tRX z = UVtoRX( gammaLoad );
+    gdouble magSqu = SQU(z.R) + SQU(z.X);
+    gdouble g, b, root;
+    tLmatch *pMatch;
+
+    pSet->nSolutions = 0;
+    if( !(z.R > 0.0) || !isfinite( magSqu ) )
+        return FALSE;
+
+    // load admittance
+    g = z.R / magSqu;
+    b = -z.X / magSqu;
+
+    // shunt element at the load
+    if( g <= 1.0 + MATCH_EPSILON ) {
+        root = ( g - SQU(g) > MATCH_EPSILON ) ? sqrt( g - SQU(g) ) : 0.0;
+        for( gint sign = 1; sign >= -1; sign -= 2 ) {
+            gdouble bIntersect = sign * root;
+            gdouble xIntersect = -bIntersect / g;
+
+            pMatch = &pSet->solution[ pSet->nSolutions++ ];
+            pMatch->element[0] = shuntElement( bIntersect - b, frequency, Z0 );
+            pMatch->element[1] = seriesElement( -xIntersect, frequency, Z0 );
+            pMatch->path[0] = constantGarc( g, b, bIntersect );
+            pMatch->path[1] = constantRarc( 1.0, xIntersect, 0.0 );
+            // only one solution when on the R=1 circle
+            if( root == 0.0 )
+                break;
+        }
+    }
+
+    // series element at the load
+    if( z.R <= 1.0 + MATCH_EPSILON ) {
+        root = ( z.R - SQU(z.R) > MATCH_EPSILON ) ? sqrt( z.R - SQU(z.R) ) : 0.0;
+        for( gint sign = 1; sign >= -1; sign -= 2 ) {
+            gdouble xIntersect = sign * root;
+            gdouble bIntersect = -xIntersect / z.R;
+
+            pMatch = &pSet->solution[ pSet->nSolutions++ ];
+            pMatch->element[0] = seriesElement( xIntersect - z.X, frequency, Z0 );
+            pMatch->element[1] = shuntElement( -bIntersect, frequency, Z0 );
+            pMatch->path[0] = constantRarc( z.R, z.X, xIntersect );
+            pMatch->path[1] = constantGarc( 1.0, bIntersect, 0.0 );
+            // only one solution when on the G=1 circle
+            if( root == 0.0 )
+                break;
+        }
+    }
+
+    return pSet->nSolutions > 0;
+}
+
+typedef struct {
+    const tUV     *gammaLoad;
+    const gdouble *frequency;
+    gdouble        Z0;
+    tLmatchSet    *solutions;
+} tLmatchSweep;
+
+static void
+solveLmatchRange( gint from, gint to, gpointer userData ) {
+    tLmatchSweep *pSweep = userData;
+
+    for( gint i = from; i < to; i++ )
+        solveLmatch( pSweep->gammaLoad[i], pSweep->frequency ? pSweep->frequency[i] : 0.0,
+                pSweep->Z0, &pSweep->solutions[i] );
+}
+
+/*!     \brief  Find the L network solutions for every point of a trace
+ *
+ * Find the L network solutions for every point of a trace.
+ * The points are solved in parallel on all cores.
+ *
+ * \ingroup match
+ *
+ * \param gammaLoad array of load reflection coefficients
+ * \param frequency array of frequencies (Hz) of the points (or NULL)
+ * \param length    number of points
+ * \param Z0        characteristic impedance (to calculate component values)
+ * \param solutions array (of length points) where the solutions are written
+ */
+void
+solveLmatchSweep( const tUV gammaLoad[], const gdouble frequency[], gint length,
+        gdouble Z0, tLmatchSet solutions[] ) {
+    tLmatchSweep sweep = { gammaLoad, frequency, Z0, solutions };
+
+    smithParallelFor( length, PARALLEL_GRAIN, solveLmatchRange, &sweep );
+}
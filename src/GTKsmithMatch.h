@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHMATCH_H_
+#define GTKSMITHMATCH_H_
+
+#include "GTKsmithChart.h"
+
+typedef enum {
+    eSeriesL, eSeriesC, eShuntL, eShuntC
+} tElementType;
+
+typedef struct {
+    tElementType type;
+    gdouble value;          // H or F (0 if no frequency was given or the element is not needed)
+    gdouble immittance;     // normalized reactance (series) or susceptance (shunt)
+} tElement;
+
+// An L network. The first element is connected to the load.
+typedef struct {
+    tElement element[2];
+    tArc     path[2];       // load -> intermediate point -> center of the chart
+} tLmatch;
+
+#define MAX_L_SOLUTIONS 4
+
+typedef struct {
+    gint    nSolutions;
+    tLmatch solution[ MAX_L_SOLUTIONS ];
+} tLmatchSet;
+
+tArc constantRarc( gdouble, gdouble, gdouble );
+tArc constantGarc( gdouble, gdouble, gdouble );
+tArc lineArc( tUV, gdouble );
+gboolean solveLmatch( tUV, gdouble, gdouble, tLmatchSet * );
+void solveLmatchSweep( const tUV [], const gdouble [], gint, gdouble, tLmatchSet [] );
+
+#endif /* GTKSMITHMATCH_H_ */
@@ -0,0 +1,495 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithMdif.c
+ * @brief MDIF file loader
+ *
+ * @author Michael G. Katzmann
+ *
+ * An MDIF file (as exported by load-pull systems and simulators) is a list
+ * of blocks ("BEGIN <name>" ... "END"), each a table of numbers whose columns
+ * are named on "%" lines, preceded by the values of the variables ("VAR
+ * name = value") it was measured or simulated at. A variable keeps its value
+ * for the following blocks until it is given another. '!' begins a comment.
+ * A complex column ("gamma(complex)") is two numbers in each row, and is two
+ * columns, its real and imaginary parts ("gamma_re" and "gamma_im").
+ *
+ * The structure of the file is read line by line, and the blocks are then
+ * parsed in parallel, each by the parallel table parser of GTKsmithParse.c
+ * directly into an aligned array for each column. Any pair of columns (e.g.
+ * the real and imaginary parts of gamma, with the frequency) is then a trace,
+ * borrowing the arrays (mdifBlockTrace()).
+ *
+ * A block with a Touchstone option line ("# GHz S MA R 50", as in an ACDATA
+ * block) has its first column (the frequency) scaled to Hz, and the pairs of
+ * columns after it converted to real and imaginary parts.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GTKsmithMdif.h"
+#include "GTKsmithTrace.h"
+#include "GTKsmithParse.h"
+#include "GTKsmithParallel.h"
+
+typedef enum {
+    eMdifRI, eMdifMA, eMdifDB
+} tMdifFormat;
+
+typedef struct {
+    const gchar *pStart, *pEnd;         // the numbers of the block
+    gboolean     bOptions;              // the block has an option line
+    gdouble      frequencyUnit;
+    tMdifFormat  format;
+    const gchar *sProblem;              // (or NULL)
+    const gchar *pInvalid;              // text that is not a number (or NULL)
+} tMdifRegion;
+
+typedef struct {
+    tMdifFile   *pFile;
+    tMdifRegion *pRegions;
+} tMdifLoad;
+
+/*!     \brief  Copy a name without its type
+ *
+ * Copy a name of a variable or column, without any type ("Power(real)" is "Power")
+ *
+ * \ingroup mdif
+ *
+ * \param p         start of the name
+ * \param pEnd      end of the name
+ * \return          the name (free with g_free)
+ */
+static gchar *
+nameWithoutType( const gchar *p, const gchar *pEnd ) {
+    const gchar *pType = memchr( p, '(', pEnd - p );
+
+    return g_strndup( p, (pType ? pType : pEnd) - p );
+}
+
+/*!     \brief  Add the columns of a name on a '%' line
+ *
+ * Add a column without its type, or two for a complex column ("gamma(complex)"
+ * is "gamma_re" and "gamma_im", as the file has its real and imaginary parts)
+ *
+ * \ingroup mdif
+ *
+ * \param pColumns  names of the columns of the block
+ * \param p         start of the name
+ * \param pEnd      end of the name
+ */
+static void
+addColumns( GPtrArray *pColumns, const gchar *p, const gchar *pEnd ) {
+    const gchar *pType = memchr( p, '(', pEnd - p );
+    gchar *sName = nameWithoutType( p, pEnd );
+
+    if( pType && pEnd - pType >= 8 && g_ascii_strncasecmp( pType, "(complex", 8 ) == 0 ) {
+        g_ptr_array_add( pColumns, g_strconcat( sName, "_re", NULL ) );
+        g_ptr_array_add( pColumns, g_strconcat( sName, "_im", NULL ) );
+        g_free( sName );
+    } else
+        g_ptr_array_add( pColumns, sName );
+}
+
+/*!     \brief  End of the text of a line
+ *
+ * Find the end of the text of a line (its new line or comment)
+ *
+ * \ingroup mdif
+ *
+ * \param p         position in the line
+ * \param pEnd      end of the text
+ * \return          the new line, the '!' of a comment, or pEnd
+ */
+static const gchar *
+lineEnd( const gchar *p, const gchar *pEnd ) {
+    while( p < pEnd && *p != '\n' && *p != '!' )
+        p++;
+    return p;
+}
+
+/*!     \brief  Parse a variable
+ *
+ * Parse a variable line ("VAR name(type) = value") and set its value
+ *
+ * \ingroup mdif
+ *
+ * \param p         text after VAR
+ * \param pEnd      end of the line
+ * \param pNames    names of the variables so far
+ * \param pValues   their values
+ */
+static void
+parseVariable( const gchar *p, const gchar *pEnd, GPtrArray *pNames, GArray *pValues ) {
+    const gchar *pEquals = memchr( p, '=', pEnd - p ), *pName, *pNameEnd;
+    gdouble value = NAN;
+    gchar *sName;
+
+    if( pEquals == NULL )
+        return;
+    pName = smithParseSkipSeparators( p, pEquals );
+    for( pNameEnd = pEquals; pNameEnd > pName && g_ascii_isspace( pNameEnd[-1] ); )
+        pNameEnd--;
+    sName = nameWithoutType( pName, pNameEnd );
+    smithParseNumber( smithParseSkipSeparators( pEquals + 1, pEnd ), pEnd, &value );
+
+    for( guint i = 0; i < pNames->len; i++ ) {
+        if( g_ascii_strcasecmp( g_ptr_array_index( pNames, i ), sName ) == 0 ) {
+            g_array_index( pValues, gdouble, i ) = value;
+            g_free( sName );
+            return;
+        }
+    }
+    g_ptr_array_add( pNames, sName );
+    g_array_append_val( pValues, value );
+}
+
+/*!     \brief  Parse the option line of a block
+ *
+ * Parse the frequency unit and the format of an option line ("# GHz S MA R 50")
+ *
+ * \ingroup mdif
+ *
+ * \param p         text after the '#'
+ * \param pEnd      end of the line
+ * \param pRegion   pointer to the region of the block
+ */
+static void
+parseOptionLine( const gchar *p, const gchar *pEnd, tMdifRegion *pRegion ) {
+    static const struct {
+        const gchar *sName;
+        gdouble      unit;          // (0 for a format)
+        tMdifFormat  format;
+    } options[] = {
+        { "HZ", 1.0 }, { "KHZ", 1.0e3 }, { "MHZ", 1.0e6 }, { "GHZ", 1.0e9 },
+        { "MA", 0.0, eMdifMA }, { "DB", 0.0, eMdifDB }, { "RI", 0.0, eMdifRI }
+    };
+
+    pRegion->bOptions = TRUE;
+    pRegion->frequencyUnit = 1.0e9;
+    pRegion->format = eMdifMA;
+    while( (p = smithParseSkipSeparators( p, pEnd )) < pEnd ) {
+        for( gint i = 0; i < (gint)G_N_ELEMENTS( options ); i++ ) {
+            if( smithParseKeyword( p, pEnd, options[i].sName ) ) {
+                if( options[i].unit != 0.0 )
+                    pRegion->frequencyUnit = options[i].unit;
+                else
+                    pRegion->format = options[i].format;
+            }
+        }
+        while( p < pEnd && !g_ascii_isspace( *p ) )
+            p++;
+    }
+}
+
+/*!     \brief  Parse blocks
+ *
+ * Parse a range of the blocks into their columns (a parallel loop function over the blocks)
+ *
+ * \ingroup mdif
+ *
+ * \param from      first block
+ * \param to        last block (exclusive)
+ * \param userData  pointer to the tMdifLoad
+ */
+static void
+parseBlocks( gint from, gint to, gpointer userData ) {
+    tMdifLoad *pLoad = userData;
+
+    for( gint b = from; b < to; b++ ) {
+        tMdifBlock *pBlock = &pLoad->pFile->pBlocks[b];
+        tMdifRegion *pRegion = &pLoad->pRegions[b];
+        tParseTable *pTable;
+        gint64 nNumbers;
+
+        if( pBlock->nColumns == 0 ) {
+            pRegion->sProblem = "A block has no column names (% line)";
+            continue;
+        }
+        pTable = smithParseTableNew( pRegion->pStart, pRegion->pEnd, '!' );
+        nNumbers = smithParseTableCount( pTable );
+        if( nNumbers % pBlock->nColumns != 0 || nNumbers / pBlock->nColumns > G_MAXINT ) {
+            pRegion->sProblem = "The numbers of a block do not fill its columns";
+            smithParseTableFree( pTable );
+            continue;
+        }
+
+        pBlock->nRows = (gint)(nNumbers / pBlock->nColumns);
+        for( gint c = 0; c < pBlock->nColumns; c++ )
+            pBlock->pColumns[c] = g_aligned_alloc( MAX( pBlock->nRows, 1 ), sizeof( gdouble ), TRACE_ALIGNMENT );
+        pRegion->pInvalid = smithParseTableStore( pTable, pBlock->nColumns, pBlock->pColumns, pBlock->nRows );
+        smithParseTableFree( pTable );
+        if( pRegion->pInvalid || !pRegion->bOptions )
+            continue;
+
+        // the frequency in Hz and the pairs of parameters as real and imaginary parts
+        for( gint i = 0; i < pBlock->nRows; i++ )
+            pBlock->pColumns[0][i] *= pRegion->frequencyUnit;
+        for( gint c = 1; c + 1 < pBlock->nColumns && pRegion->format != eMdifRI; c += 2 ) {
+            gdouble *restrict pU = pBlock->pColumns[c], *restrict pV = pBlock->pColumns[ c + 1 ];
+
+            for( gint i = 0; i < pBlock->nRows; i++ ) {
+                gdouble magnitude = ( pRegion->format == eMdifDB ) ? pow( 10.0, pU[i] / 20.0 ) : pU[i];
+                gdouble angle = pV[i] * (M_PI / 180.0);
+
+                pU[i] = magnitude * cos( angle );
+                pV[i] = magnitude * sin( angle );
+            }
+        }
+    }
+}
+
+/*!     \brief  Parse an MDIF file in memory
+ *
+ * Parse the text of an MDIF file into its blocks
+ *
+ * \ingroup mdif
+ *
+ * \param pText     text of the file (need not be NUL terminated)
+ * \param length    length of the text
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the file (free with mdifFree), or NULL on error
+ */
+tMdifFile *
+mdifParse( const gchar *pText, gsize length, GError **ppError ) {
+    const gchar *p = pText, *pEnd = pText + length, *q;
+    GPtrArray *pNames = g_ptr_array_new_with_free_func( g_free );
+    GArray *pValues = g_array_new( FALSE, FALSE, sizeof( gdouble ) );
+    GArray *pBlocks = g_array_new( FALSE, TRUE, sizeof( tMdifBlock ) );
+    GArray *pRegions = g_array_new( FALSE, TRUE, sizeof( tMdifRegion ) );
+    const gchar *sProblem = NULL, *pInvalid = NULL;
+    tMdifLoad load;
+
+    // the variables and the regions of the blocks
+    while( p < pEnd && sProblem == NULL ) {
+        const gchar *pNext = smithParseNextLine( p, pEnd ), *pLine = lineEnd( p, pNext );
+
+        if( (q = smithParseKeyword( p, pLine, "VAR" )) ) {
+            parseVariable( q, pLine, pNames, pValues );
+        } else if( (q = smithParseKeyword( p, pLine, "BEGIN" )) ) {
+            tMdifBlock block = { 0 };
+            tMdifRegion region = { 0 };
+            GPtrArray *pColumns = g_ptr_array_new();
+
+            q = smithParseSkipSeparators( q, pLine );
+            while( pLine > q && g_ascii_isspace( pLine[-1] ) )
+                pLine--;
+            block.sName = g_strndup( q, pLine - q );
+            block.nVariables = pNames->len;
+            block.sVariables = g_new( gchar *, pNames->len );
+            for( guint i = 0; i < pNames->len; i++ )
+                block.sVariables[i] = g_strdup( g_ptr_array_index( pNames, i ) );
+            block.pVariables = g_memdup2( pValues->data, pValues->len * sizeof( gdouble ) );
+
+            // the header of the block (option and column lines), then the numbers up to END
+            for( p = pNext; p < pEnd; p = smithParseNextLine( p, pEnd ) ) {
+                const gchar *pFirst = smithParseSkipSeparators( p, pEnd );
+
+                pLine = lineEnd( p, pEnd );
+                if( pFirst < pLine && *pFirst == '#' ) {
+                    parseOptionLine( pFirst + 1, pLine, &region );
+                } else if( pFirst < pLine && *pFirst == '%' ) {
+                    for( q = pFirst + 1; (q = smithParseSkipSeparators( q, pLine )) < pLine; ) {
+                        const gchar *pName = q;
+
+                        while( q < pLine && !g_ascii_isspace( *q ) )
+                            q++;
+                        addColumns( pColumns, pName, q );
+                    }
+                } else if( pFirst < pLine ) {
+                    break;
+                }
+            }
+            region.pStart = p;
+            if( (region.pEnd = smithParseFindKeyword( p, pEnd, "END" )) == NULL ) {
+                sProblem = "A block has no end";
+                region.pEnd = pEnd;
+            }
+            pNext = smithParseNextLine( region.pEnd, pEnd );
+
+            block.nColumns = pColumns->len;
+            block.sColumns = (gchar **)g_ptr_array_free( pColumns, FALSE );
+            block.pColumns = g_new0( gdouble *, block.nColumns );
+            g_array_append_val( pBlocks, block );
+            g_array_append_val( pRegions, region );
+        }
+        p = pNext;
+    }
+
+    load.pFile = g_new0( tMdifFile, 1 );
+    load.pFile->nBlocks = pBlocks->len;
+    load.pFile->pBlocks = (tMdifBlock *)g_array_free( pBlocks, FALSE );
+    load.pRegions = (tMdifRegion *)pRegions->data;
+    if( sProblem == NULL && load.pFile->nBlocks == 0 )
+        sProblem = "There are no blocks (not an MDIF file)";
+
+    // the blocks in parallel
+    if( sProblem == NULL )
+        smithParallelFor( load.pFile->nBlocks, 1, parseBlocks, &load );
+    for( gint b = 0; b < load.pFile->nBlocks && sProblem == NULL && pInvalid == NULL; b++ ) {
+        sProblem = load.pRegions[b].sProblem;
+        pInvalid = load.pRegions[b].pInvalid;
+    }
+
+    if( sProblem )
+        g_set_error( ppError, SMITH_PARSE_ERROR, load.pFile->nBlocks == 0 ? eParseErrorFormat : eParseErrorData,
+                     "%s", sProblem );
+    else if( pInvalid )
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorNumber,
+                     "Invalid number on line %d", smithParseLineNumber( pText, pInvalid ) );
+    if( sProblem || pInvalid ) {
+        mdifFree( load.pFile );
+        load.pFile = NULL;
+    }
+
+    g_ptr_array_free( pNames, TRUE );
+    g_array_free( pValues, TRUE );
+    g_array_free( pRegions, TRUE );
+    return load.pFile;
+}
+
+/*!     \brief  Load an MDIF file
+ *
+ * Load an MDIF file (memory mapped and parsed in parallel)
+ *
+ * \ingroup mdif
+ *
+ * \param sPath     path of the file
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the file (free with mdifFree), or NULL on error
+ */
+tMdifFile *
+mdifLoad( const gchar *sPath, GError **ppError ) {
+    GMappedFile *pMapped = g_mapped_file_new( sPath, FALSE, ppError );
+    tMdifFile *pFile;
+
+    if( pMapped == NULL )
+        return NULL;
+
+    pFile = mdifParse( g_mapped_file_get_contents( pMapped ), g_mapped_file_get_length( pMapped ), ppError );
+    if( pFile == NULL && ppError && *ppError )
+        g_prefix_error( ppError, "%s: ", sPath );
+
+    g_mapped_file_unref( pMapped );
+    return pFile;
+}
+
+/*!     \brief  Free an MDIF file
+ *
+ * Free an MDIF file and its blocks (traces borrowing the columns must be freed first)
+ *
+ * \ingroup mdif
+ *
+ * \param pFile     pointer to the file
+ */
+void
+mdifFree( tMdifFile *pFile ) {
+    if( pFile == NULL )
+        return;
+
+    for( gint b = 0; b < pFile->nBlocks; b++ ) {
+        tMdifBlock *pBlock = &pFile->pBlocks[b];
+
+        for( gint v = 0; v < pBlock->nVariables; v++ )
+            g_free( pBlock->sVariables[v] );
+        for( gint c = 0; c < pBlock->nColumns; c++ ) {
+            g_free( pBlock->sColumns[c] );
+            g_aligned_free( pBlock->pColumns[c] );
+        }
+        g_free( pBlock->sName );
+        g_free( pBlock->sVariables );
+        g_free( pBlock->pVariables );
+        g_free( pBlock->sColumns );
+        g_free( pBlock->pColumns );
+    }
+    g_free( pFile->pBlocks );
+    g_free( pFile );
+}
+
+/*!     \brief  Column of a block
+ *
+ * Find a column of a block by name (ignoring case)
+ *
+ * \ingroup mdif
+ *
+ * \param pBlock    pointer to the block
+ * \param sName     name of the column (without its type)
+ * \return          index of the column, or -1 if there is none of that name
+ */
+gint
+mdifBlockColumn( const tMdifBlock *pBlock, const gchar *sName ) {
+    for( gint c = 0; c < pBlock->nColumns; c++ ) {
+        if( g_ascii_strcasecmp( pBlock->sColumns[c], sName ) == 0 )
+            return c;
+    }
+    return -1;
+}
+
+/*!     \brief  Value of a variable of a block
+ *
+ * Value of a variable of a block, by name (ignoring case)
+ *
+ * \ingroup mdif
+ *
+ * \param pBlock    pointer to the block
+ * \param sName     name of the variable (without its type)
+ * \param pValue    where the value is written
+ * \return          FALSE if the block has no variable of that name
+ */
+gboolean
+mdifBlockVariable( const tMdifBlock *pBlock, const gchar *sName, gdouble *pValue ) {
+    for( gint v = 0; v < pBlock->nVariables; v++ ) {
+        if( g_ascii_strcasecmp( pBlock->sVariables[v], sName ) == 0 ) {
+            *pValue = pBlock->pVariables[v];
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+/*!     \brief  Trace of two columns of a block
+ *
+ * A trace of the points of two columns (e.g. the real and imaginary parts of
+ * gamma), with a third as its frequency. The trace borrows the arrays of the
+ * block, so it must be freed before the file.
+ *
+ * \ingroup mdif
+ *
+ * \param pBlock        pointer to the block
+ * \param uColumn       column of the real part of gamma
+ * \param vColumn       column of the imaginary part of gamma
+ * \param freqColumn    column of the frequency (or -1 for none)
+ * \return              pointer to the trace (free with smithTraceFree), or NULL if a column is not in the block
+ */
+tSmithTrace *
+mdifBlockTrace( const tMdifBlock *pBlock, gint uColumn, gint vColumn, gint freqColumn ) {
+    tSmithTrace *pTrace;
+
+    if( uColumn < 0 || uColumn >= pBlock->nColumns || vColumn < 0 || vColumn >= pBlock->nColumns
+            || freqColumn >= pBlock->nColumns )
+        return NULL;
+
+    pTrace = g_new0( tSmithTrace, 1 );
+    pTrace->pU = pBlock->pColumns[ uColumn ];
+    pTrace->pV = pBlock->pColumns[ vColumn ];
+    pTrace->pFreq = freqColumn >= 0 ? pBlock->pColumns[ freqColumn ] : NULL;
+    pTrace->nPoints = pTrace->nAllocated = pBlock->nRows;
+    pTrace->flags.bBorrowed = TRUE;
+
+    return pTrace;
+}
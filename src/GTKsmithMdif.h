@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+
+#ifndef GTKSMITHMDIF_H_
+#define GTKSMITHMDIF_H_
+
+#include "GTKsmithChart.h"
+
+// A block of an MDIF file: a table of numbers with the values of the variables it was measured at
+typedef struct {
+    gchar    *sName;            // e.g. ACDATA
+    gint      nVariables;
+    gchar   **sVariables;       // names (without their type)
+    gdouble  *pVariables;       // values (NAN for those that are not numbers)
+    gint      nColumns;
+    gchar   **sColumns;         // names (without their type; name_re and name_im for a complex column)
+    gint      nRows;
+    gdouble **pColumns;         // the values of each column (aligned arrays of nRows)
+} tMdifBlock;
+
+typedef struct {
+    gint        nBlocks;
+    tMdifBlock *pBlocks;
+} tMdifFile;
+
+tMdifFile *mdifParse( const gchar *, gsize, GError ** );
+tMdifFile *mdifLoad( const gchar *, GError ** );
+void mdifFree( tMdifFile * );
+gint mdifBlockColumn( const tMdifBlock *, const gchar * );
+gboolean mdifBlockVariable( const tMdifBlock *, const gchar *, gdouble * );
+tSmithTrace *mdifBlockTrace( const tMdifBlock *, gint, gint, gint );
+
+#endif /* GTKSMITHMDIF_H_ */
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithNetwork.c
+ * @brief Multi-port network data
+ *
+ * @author Michael G. Katzmann
+ *
+ * A network holds the n x n parameters (S, Y, Z, H or G) of an n-port as
+ * traces, so that any parameter (e.g. S11 of a file just loaded) can be used
+ * directly with the rest of the library. The traces share one frequency axis
+ * owned by the network.
+ *
+ * The arrays of a network opened from a cache file (GTKsmithCache.c) are
+ * in the mapped file, which is released when the network is freed.
+ *
+ * A network may be loaded with only some of its parameters (e.g. S11 of an
+ * .s4p file). The traces of the others are NULL until they are first asked
+ * for with smithNetworkParameter(), which has the decoder of the network
+ * (e.g. GTKsmithTouchstone.c) decode them then.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "GTKsmithNetwork.h"
+#include "GTKsmithTrace.h"
+
+/*!     \brief  Create a trace of a parameter
+ *
+ * Create a trace for a parameter, sharing the frequency axis of the network
+ *
+ * \ingroup network
+ *
+ * \param pNetwork  pointer to the network
+ * \return          the trace (nPoints set)
+ */
+tSmithTrace *
+smithNetworkTraceNew( const tSmithNetwork *pNetwork ) {
+    tSmithTrace *pTrace = smithTraceNew( pNetwork->nPoints, FALSE );
+
+    pTrace->pFreq = pNetwork->pFreq;
+    pTrace->flags.bSharedFreq = TRUE;
+    pTrace->nPoints = pNetwork->nPoints;
+
+    return pTrace;
+}
+
+/*!     \brief  Create a network
+ *
+ * Create a network of S parameters (Z0 = 50 ohms) with room for a number of points
+ * (nPoints is set to the number of points)
+ *
+ * \ingroup network
+ *
+ * \param nPorts    number of ports
+ * \param nPoints   number of frequency points
+ * \return          pointer to the network (free with smithNetworkFree)
+ */
+tSmithNetwork *
+smithNetworkNew( gint nPorts, gint nPoints ) {
+    return smithNetworkNewSelected( nPorts, nPoints, NULL );
+}
+
+/*!     \brief  Create a network with some of its parameters
+ *
+ * Create a network as smithNetworkNew() does, but with traces for only the
+ * selected parameters (the others are NULL, to be decoded later)
+ *
+ * \ingroup network
+ *
+ * \param nPorts    number of ports
+ * \param nPoints   number of frequency points
+ * \param pSelected nPorts x nPorts flags, row major, of the parameters to create (or NULL for all)
+ * \return          pointer to the network (free with smithNetworkFree)
+ */
+tSmithNetwork *
+smithNetworkNewSelected( gint nPorts, gint nPoints, const gboolean *pSelected ) {
+    tSmithNetwork *pNetwork = g_new0( tSmithNetwork, 1 );
+
+    pNetwork->nPorts = nPorts;
+    pNetwork->type = eParameterS;
+    pNetwork->Z0 = 50.0;
+    pNetwork->nPoints = nPoints;
+    pNetwork->pFreq = g_aligned_alloc( MAX( nPoints, 1 ), sizeof( gdouble ), TRACE_ALIGNMENT );
+    pNetwork->pParameters = g_new0( tSmithTrace *, nPorts * nPorts );
+    for( gint i = 0; i < nPorts * nPorts; i++ ) {
+        if( pSelected == NULL || pSelected[i] )
+            pNetwork->pParameters[i] = smithNetworkTraceNew( pNetwork );
+    }
+
+    return pNetwork;
+}
+
+/*!     \brief  Free a network
+ *
+ * Free a network and its traces
+ *
+ * \ingroup network
+ *
+ * \param pNetwork  pointer to the network
+ */
+void
+smithNetworkFree( tSmithNetwork *pNetwork ) {
+    if( pNetwork == NULL )
+        return;
+
+    for( gint i = 0; i < pNetwork->nPorts * pNetwork->nPorts; i++ )
+        smithTraceFree( pNetwork->pParameters[i] );
+    g_free( pNetwork->pParameters );
+    if( pNetwork->freeDecoder )
+        pNetwork->freeDecoder( pNetwork->pDecoder );
+    if( pNetwork->pMapping ) {
+        g_mapped_file_unref( pNetwork->pMapping );
+    } else {
+        g_aligned_free( pNetwork->pFreq );
+        g_free( pNetwork->pNoise );
+    }
+    g_free( pNetwork );
+}
+
+/*!     \brief  Trace of a parameter
+ *
+ * Return the trace of a parameter of the network (e.g. 2, 1 for S21).
+ * A parameter not decoded when the network was loaded is decoded now.
+ *
+ * \ingroup network
+ *
+ * \param pNetwork  pointer to the network
+ * \param i         port (1 to nPorts)
+ * \param j         port (1 to nPorts)
+ * \return          the trace (owned by the network), or NULL if it cannot be decoded
+ */
+tSmithTrace *
+smithNetworkParameter( const tSmithNetwork *pNetwork, gint i, gint j ) {
+    gint index;
+    tSmithTrace *pTrace;
+
+    g_return_val_if_fail( i >= 1 && i <= pNetwork->nPorts && j >= 1 && j <= pNetwork->nPorts, NULL );
+
+    index = (i - 1) * pNetwork->nPorts + (j - 1);
+    pTrace = g_atomic_pointer_get( &pNetwork->pParameters[ index ] );
+    if( pTrace == NULL && pNetwork->decodeParameter )
+        pTrace = pNetwork->decodeParameter( pNetwork->pDecoder, index );
+
+    return pTrace;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHNETWORK_H_
+#define GTKSMITHNETWORK_H_
+
+#include "GTKsmithChart.h"
+#include "GTKsmithNoise.h"
+
+typedef enum {
+    eParameterS, eParameterY, eParameterZ, eParameterH, eParameterG
+} tParameterType;
+
+// Decodes a parameter (row major index) not decoded when the network was loaded
+typedef tSmithTrace *(*tParameterDecoder)( gpointer, gint );
+
+// The parameters of an n-port over frequency. Each parameter is a trace
+// (U the real and V the imaginary part) sharing the frequency axis of the network.
+typedef struct {
+    gint              nPorts;
+    tParameterType    type;
+    gdouble           Z0;               // reference impedance (ohms)
+    gint              nPoints;
+    gdouble          *pFreq;            // Hz
+    tSmithTrace     **pParameters;      // nPorts x nPorts, row major
+    gint              nNoise;
+    tNoiseParameters *pNoise;           // two-port noise parameters (or NULL)
+    GMappedFile      *pMapping;         // the arrays are in a mapped cache file, read only (or NULL)
+    tParameterDecoder decodeParameter;  // decodes parameters on first access (or NULL)
+    gpointer          pDecoder;         // data of the decoder (freed with freeDecoder)
+    GDestroyNotify    freeDecoder;
+} tSmithNetwork;
+
+tSmithNetwork *smithNetworkNew( gint, gint );
+tSmithNetwork *smithNetworkNewSelected( gint, gint, const gboolean * );
+tSmithTrace *smithNetworkTraceNew( const tSmithNetwork * );
+void smithNetworkFree( tSmithNetwork * );
+tSmithTrace *smithNetworkParameter( const tSmithNetwork *, gint, gint );
+
+#endif /* GTKSMITHNETWORK_H_ */
@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithNoise.c
+ * @brief Constant noise figure circles
+ *
+ * @author Michael G. Katzmann
+ *
+ * The noise factor F of a two-port driven from a source reflection
+ * coefficient gamma S is
+ *
+ *      F = Fmin + 4 (Rn / Z0) |gamma S - gamma opt|^2 / ((1 - |gamma S|^2) |1 + gamma opt|^2)
+ *
+ * so the sources giving a noise factor F lie on a circle. With
+ *
+ *      N = (F - Fmin) |1 + gamma opt|^2 / (4 Rn / Z0)
+ *
+ *      center = gamma opt / (N + 1)
+ *      radius = sqrt( N (N + 1 - |gamma opt|^2) ) / (N + 1)
+ *
+ * The circles are calculated for every level at every frequency in parallel.
+ * The noise parameters can be interpolated (linearly in frequency) to other
+ * frequencies than those at which they were measured.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "GTKsmithNoise.h"
+#include "GTKsmithParallel.h"
+
+// Frequencies whose circles are calculated by each worker at a time
+#define NOISE_GRAIN     64
+
+typedef struct {
+    const tNoiseParameters *pParameters;
+    gint                    nParameters;
+    gdouble                 Z0;
+    const gdouble          *pLevels;
+    gint                    nLevels;
+    const gdouble          *pFrequencies;
+    tCircle                *pCircles;
+} tNoiseJob;
+
+/*!     \brief  Noise parameters at a frequency
+ *
+ * Interpolate the noise parameters (given in order of increasing
+ * frequency) linearly to a frequency
+ *
+ * \ingroup noise
+ *
+ * \param pParameters   array of noise parameters
+ * \param nParameters   number of frequencies in the array
+ * \param frequency     frequency in Hz
+ * \param pResult       where the interpolated parameters are written
+ * \return              FALSE if the frequency is outside those of the parameters
+ */
+gboolean
+noiseParametersAt( const tNoiseParameters pParameters[], gint nParameters, gdouble frequency,
+        tNoiseParameters *pResult ) {
+    gint low = 0, high = nParameters - 1;
+    gdouble fraction;
+    const tNoiseParameters *pLow, *pHigh;
+
+    if( nParameters == 0 || !(frequency >= pParameters[ low ].frequency
+                              && frequency <= pParameters[ high ].frequency) )
+        return FALSE;
+
+    while( high - low > 1 ) {
+        gint middle = low + (high - low) / 2;
+
+        if( pParameters[ middle ].frequency <= frequency )
+            low = middle;
+        else
+            high = middle;
+    }
+
+    pLow = &pParameters[ low ];
+    pHigh = &pParameters[ high ];
+    fraction = ( pHigh->frequency > pLow->frequency ) ?
+            (frequency - pLow->frequency) / (pHigh->frequency - pLow->frequency) : 0.0;
+
+    pResult->frequency = frequency;
+    pResult->NFmin = pLow->NFmin + fraction * (pHigh->NFmin - pLow->NFmin);
+    pResult->gammaOpt.U = pLow->gammaOpt.U + fraction * (pHigh->gammaOpt.U - pLow->gammaOpt.U);
+    pResult->gammaOpt.V = pLow->gammaOpt.V + fraction * (pHigh->gammaOpt.V - pLow->gammaOpt.V);
+    pResult->Rn = pLow->Rn + fraction * (pHigh->Rn - pLow->Rn);
+
+    return TRUE;
+}
+
+static void
+noiseRange( gint from, gint to, gpointer userData ) {
+    tNoiseJob *pJob = userData;
+
+    for( gint f = from; f < to; f++ ) {
+        tCircle *pCircles = &pJob->pCircles[ (gsize)f * pJob->nLevels ];
+        tNoiseParameters noise;
+        gdouble Fmin, magSquOpt, scale;
+
+        if( pJob->pFrequencies ) {
+            if( !noiseParametersAt( pJob->pParameters, pJob->nParameters, pJob->pFrequencies[f], &noise ) ) {
+                for( gint level = 0; level < pJob->nLevels; level++ )
+                    pCircles[ level ] = (tCircle){ { NAN, NAN }, NAN };
+                continue;
+            }
+        } else {
+            noise = pJob->pParameters[f];
+        }
+
+        Fmin = pow( 10.0, noise.NFmin / 10.0 );
+        magSquOpt = SQU(noise.gammaOpt.U) + SQU(noise.gammaOpt.V);
+        scale = (SQU(1.0 + noise.gammaOpt.U) + SQU(noise.gammaOpt.V)) / (4.0 * noise.Rn / pJob->Z0);
+
+        for( gint level = 0; level < pJob->nLevels; level++ ) {
+            gdouble N = (pow( 10.0, pJob->pLevels[ level ] / 10.0 ) - Fmin) * scale;
+
+            // no circle for a noise figure below the minimum
+            if( !(N >= 0.0) ) {
+                pCircles[ level ] = (tCircle){ { NAN, NAN }, NAN };
+                continue;
+            }
+            pCircles[ level ].center = (tUV){ noise.gammaOpt.U / (N + 1.0), noise.gammaOpt.V / (N + 1.0) };
+            pCircles[ level ].radius = sqrt( N * (N + 1.0 - magSquOpt) ) / (N + 1.0);
+        }
+    }
+}
+
+/*!     \brief  Constant noise figure circles over frequency
+ *
+ * Calculate the constant noise figure circles for several noise figures at
+ * each frequency. The circles are written frequency by frequency:
+ * circles[ f * nLevels + level ]. A circle is not finite (and is not drawn)
+ * if the noise figure is below the minimum or the frequency is outside those
+ * of the parameters.
+ *
+ * \ingroup noise
+ *
+ * \param pParameters   array of noise parameters (in order of increasing frequency)
+ * \param nParameters   number of frequencies in the array
+ * \param Z0            characteristic impedance (that Rn is normalized to)
+ * \param levels        array of noise figures in dB
+ * \param nLevels       number of noise figures
+ * \param frequencies   array of frequencies to interpolate the parameters to (or NULL
+ *                      for the frequencies of the parameters)
+ * \param nFrequencies  number of frequencies (ignored if frequencies is NULL)
+ * \param circles       array of (number of frequencies) x nLevels circles
+ */
+void
+noiseCircles( const tNoiseParameters pParameters[], gint nParameters, gdouble Z0,
+        const gdouble levels[], gint nLevels, const gdouble frequencies[], gint nFrequencies,
+        tCircle circles[] ) {
+    tNoiseJob job = { pParameters, nParameters, Z0, levels, nLevels, frequencies, circles };
+
+    if( frequencies == NULL )
+        nFrequencies = nParameters;
+
+    smithParallelFor( nFrequencies, NOISE_GRAIN, noiseRange, &job );
+}
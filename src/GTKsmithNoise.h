@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHNOISE_H_
+#define GTKSMITHNOISE_H_
+
+#include "GTKsmithChart.h"
+
+// Noise parameters of a two-port at a frequency (as in a Touchstone noise block)
+typedef struct {
+    gdouble frequency;      // Hz
+    gdouble NFmin;          // minimum noise figure in dB
+    tUV     gammaOpt;       // source reflection coefficient giving NFmin
+    gdouble Rn;             // equivalent noise resistance in ohms
+} tNoiseParameters;
+
+gboolean noiseParametersAt( const tNoiseParameters [], gint, gdouble, tNoiseParameters * );
+void noiseCircles( const tNoiseParameters [], gint, gdouble, const gdouble [], gint,
+        const gdouble [], gint, tCircle [] );
+
+#endif /* GTKSMITHNOISE_H_ */
@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithParallel.c
+ * @brief Parallel loop over the processor cores
+ *
+ * @author Michael G. Katzmann
+ *
+ * A loop is divided into chunks of 'grain' items. The workers of a shared
+ * GThreadPool (and the calling thread) repeatedly claim the next unprocessed
+ * chunk until none remain, so that a slow chunk does not hold up the others.
+ *
+ * The caller only waits for the items to be completed, not for the pool
+ * tasks to run. A pool thread that is itself blocked in a nested call
+ * therefore cannot deadlock the loop; the caller will simply process the
+ * remaining chunks itself.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "GTKsmithParallel.h"
+
+typedef struct {
+    tParallelFunc func;
+    gpointer      userData;
+    gint          nItems, grain;
+
+    gint          next;         // next item to claim (atomic)
+    gint          refCount;     // caller + queued pool tasks (atomic)
+
+    GMutex        mutex;
+    GCond         cond;
+    gint          nCompleted;   // items processed (protected by mutex)
+} tParallelJob;
+
+static GThreadPool *pSharedPool = NULL;
+static gint nThreads = 0;
+
+/*!     \brief  Release a reference to the job
+ *
+ * Free the job when the last reference is dropped
+ *
+ * \ingroup parallel
+ *
+ * \param pJob      pointer to the job
+ */
+static void
+parallelJobUnref( tParallelJob *pJob ) {
+    if( g_atomic_int_dec_and_test( &pJob->refCount ) ) {
+        g_mutex_clear( &pJob->mutex );
+        g_cond_clear( &pJob->cond );
+        g_free( pJob );
+    }
+}
+
+/*!     \brief  Claim and process chunks until the loop is exhausted
+ *
+ * Claim and process chunks until the loop is exhausted
+ *
+ * \ingroup parallel
+ *
+ * \param pJob      pointer to the job
+ */
+static void
+parallelRunChunks( tParallelJob *pJob ) {
+    gint from, to;
+
+    while( (from = g_atomic_int_add( &pJob->next, pJob->grain )) < pJob->nItems ) {
+        to = MIN( from + pJob->grain, pJob->nItems );
+        pJob->func( from, to, pJob->userData );
+
+        g_mutex_lock( &pJob->mutex );
+        pJob->nCompleted += to - from;
+        if( pJob->nCompleted == pJob->nItems )
+            g_cond_broadcast( &pJob->cond );
+        g_mutex_unlock( &pJob->mutex );
+    }
+}
+
+/*!     \brief  Thread pool task
+ *
+ * Thread pool task (help with the chunks of a job)
+ *
+ * \ingroup parallel
+ *
+ * \param data      pointer to the job
+ * \param poolData  unused
+ */
+static void
+parallelWorker( gpointer data, gpointer poolData ) {
+    tParallelJob *pJob = data;
+
+    parallelRunChunks( pJob );
+    parallelJobUnref( pJob );
+}
+
+/*!     \brief  Number of threads that take part in a parallel loop
+ *
+ * Return the number of threads (pool workers and the caller) that take part
+ * in a parallel loop. The shared pool is created on the first call.
+ *
+ * \ingroup parallel
+ *
+ * \return          number of threads
+ */
+gint
+smithParallelThreads( void ) {
+    static gsize initialized = 0;
+
+    if( g_once_init_enter( &initialized ) ) {
+        nThreads = MAX( (gint)g_get_num_processors(), 1 );
+        if( nThreads > 1 )
+            pSharedPool = g_thread_pool_new( parallelWorker, NULL, nThreads - 1, FALSE, NULL );
+        g_once_init_leave( &initialized, 1 );
+    }
+
+    return pSharedPool ? nThreads : 1;
+}
+
+/*!     \brief  Run a loop in parallel over all cores
+ *
+ * Call func( from, to, userData ) for consecutive ranges of 'grain' items
+ * (the last may be shorter) until all 'nItems' items are processed.
+ * 'from' is always a multiple of 'grain'. Ranges are processed
+ * concurrently and in no particular order. Returns when all items are done.
+ *
+ * \ingroup parallel
+ *
+ * \param nItems    number of items in the loop
+ * \param grain     number of items per chunk (0 for PARALLEL_GRAIN)
+ * \param func      function to process a range of items
+ * \param userData  pointer passed to func
+ */
+void
+smithParallelFor( gint nItems, gint grain, tParallelFunc func, gpointer userData ) {
+    tParallelJob *pJob;
+    gint nHelpers;
+
+    if( nItems <= 0 )
+        return;
+    if( grain <= 0 )
+        grain = PARALLEL_GRAIN;
+
+    nHelpers = MIN( smithParallelThreads(), (nItems + grain - 1) / grain ) - 1;
+    if( nHelpers <= 0 ) {
+        for( gint from = 0; from < nItems; from += grain )
+            func( from, MIN( from + grain, nItems ), userData );
+        return;
+    }
+
+    pJob = g_new0( tParallelJob, 1 );
+    pJob->func = func;
+    pJob->userData = userData;
+    pJob->nItems = nItems;
+    pJob->grain = grain;
+    pJob->refCount = nHelpers + 1;
+    g_mutex_init( &pJob->mutex );
+    g_cond_init( &pJob->cond );
+
+    for( gint i = 0; i < nHelpers; i++ ) {
+        if( !g_thread_pool_push( pSharedPool, pJob, NULL ) )
+            parallelJobUnref( pJob );
+    }
+
+    // the caller works too
+    parallelRunChunks( pJob );
+
+    g_mutex_lock( &pJob->mutex );
+    while( pJob->nCompleted < pJob->nItems )
+        g_cond_wait( &pJob->cond, &pJob->mutex );
+    g_mutex_unlock( &pJob->mutex );
+
+    parallelJobUnref( pJob );
+}
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHPARALLEL_H_
+#define GTKSMITHPARALLEL_H_
+
+#include <glib.h>
+
+// Process the items [from, to) of a parallel loop
+typedef void (*tParallelFunc)( gint from, gint to, gpointer userData );
+
+// Default number of items handed to a worker at a time
+#define PARALLEL_GRAIN  256
+
+gint smithParallelThreads( void );
+void smithParallelFor( gint nItems, gint grain, tParallelFunc func, gpointer userData );
+
+#endif /* GTKSMITHPARALLEL_H_ */
@@ -0,0 +1,584 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithParse.c
+ * @brief Parsing of numeric text files
+ *
+ * @author Michael G. Katzmann
+ *
+ * Text files of measurements (Touchstone, CITIfile, MDIF) are mostly numbers.
+ * The file (usually memory mapped) is split into chunks at line boundaries so
+ * that the chunks can be parsed in parallel.
+ *
+ * Numbers are parsed directly from the (not NUL terminated) text. The digits
+ * are accumulated as an integer with a decimal exponent; when the integer is
+ * exactly representable (< 2^53) and the power of ten is too (|exponent| <= 22),
+ * one multiplication or division gives the correctly rounded result. Other
+ * numbers (very long or with large exponents) fall back to g_ascii_strtod().
+ *
+ * A region of a file that holds only numbers (the data of a Touchstone file,
+ * a block of a CITIfile or MDIF file) is a table of rows of a fixed number of
+ * columns, however it is split into lines. A tParseTable counts the numbers
+ * of each chunk of the region in parallel; the index of the first number of
+ * each chunk then gives the row and column of every number, so the chunks are
+ * parsed in parallel again, each number straight into the array of its column.
+ * A table may end before its region, at a line that is not part of it (the
+ * keywords or noise parameters after the network data of a Touchstone file).
+ */
+
+#define _GNU_SOURCE     // memmem()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GTKsmithParse.h"
+#include "GTKsmithParallel.h"
+
+typedef struct {
+    const gchar *pStart, *pEnd;
+    const gchar *pStop;         // the line that ends the table in this chunk (or NULL)
+    gint64       nNumbers;      // numbers in the chunk (before pStop)
+    gint64       first;         // index in the table of the first number of the chunk
+    const gchar *pError;        // text that is not a number (or NULL)
+} tTableChunk;
+
+struct sParseTable {
+    tTableChunk    *pChunks;
+    gint            nChunks;
+    gchar           comment;        // starts a comment to the end of the line (or 0)
+    tParseLineStop  stop;           // does a line end the table (or NULL)
+    gpointer        pStopData;
+    const gchar    *pStop;          // the line that ends the table (or NULL)
+    gint64          nNumbers;
+
+    // where the numbers are stored (smithParseTableStore())
+    gint            nColumns;
+    gdouble * const*ppColumns;
+    gint64          nRows;
+};
+
+G_DEFINE_QUARK( smith-parse-error-quark, smith_parse_error )
+
+/*!     \brief  Error domain of the file parsers
+ *
+ * Error domain of the file parsers
+ *
+ * \ingroup parse
+ *
+ * \return          the error quark
+ */
+GQuark
+smithParseErrorQuark( void ) {
+    return smith_parse_error_quark();
+}
+
+/*!     \brief  Split text into chunks at line boundaries
+ *
+ * Split text into chunks of about chunkSize bytes, each starting at the beginning of a line
+ *
+ * \ingroup parse
+ *
+ * \param pStart    start of the text
+ * \param pEnd      end of the text
+ * \param chunkSize approximate bytes in each chunk (0 for PARSE_CHUNK_SIZE)
+ * \param ppChunks  where the array of chunks is written (free with g_free)
+ * \return          number of chunks
+ */
+gint
+smithParseSplit( const gchar *pStart, const gchar *pEnd, gsize chunkSize, tParseChunk **ppChunks ) {
+    gsize length = pEnd - pStart;
+    gint nChunks = 0;
+    tParseChunk *pChunks;
+
+    if( chunkSize == 0 )
+        chunkSize = PARSE_CHUNK_SIZE;
+    pChunks = g_new( tParseChunk, length / chunkSize + 1 );
+
+    for( const gchar *p = pStart; p < pEnd; ) {
+        const gchar *pNext = ( (gsize)(pEnd - p) > chunkSize ) ? p + chunkSize : pEnd;
+
+        // extend the chunk to the end of its last line
+        pNext = smithParseNextLine( pNext > p ? pNext - 1 : p, pEnd );
+        pChunks[ nChunks++ ] = (tParseChunk){ p, pNext };
+        p = pNext;
+    }
+
+    *ppChunks = pChunks;
+    return nChunks;
+}
+
+/*!     \brief  Start of the next line
+ *
+ * Find the start of the line after the one containing p
+ *
+ * \ingroup parse
+ *
+ * \param p         position in the text
+ * \param pEnd      end of the text
+ * \return          start of the next line (or pEnd)
+ */
+const gchar *
+smithParseNextLine( const gchar *p, const gchar *pEnd ) {
+    const gchar *pNewline = memchr( p, '\n', pEnd - p );
+
+    return pNewline ? pNewline + 1 : pEnd;
+}
+
+/*!     \brief  Parse a number
+ *
+ * Parse a decimal floating point number at p (without leading white space)
+ *
+ * \ingroup parse
+ *
+ * \param p         start of the number
+ * \param pEnd      end of the text
+ * \param pValue    where the number is written
+ * \return          the character after the number, or NULL if there is no number at p
+ */
+const gchar *
+smithParseNumber( const gchar *p, const gchar *pEnd, gdouble *pValue ) {
+    static const gdouble powersOfTen[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const gchar *q = p;
+    gboolean bNegative = FALSE, bDigits = FALSE, bExact = TRUE;
+    guint64 mantissa = 0;
+    gint nDigits = 0, exponent = 0;
+    gdouble value;
+
+    if( q < pEnd && (*q == '-' || *q == '+') )
+        bNegative = ( *q++ == '-' );
+
+    for( ; q < pEnd && g_ascii_isdigit( *q ); q++, bDigits = TRUE ) {
+        if( nDigits < 19 ) {
+            mantissa = mantissa * 10 + (*q - '0');
+            nDigits += ( mantissa != 0 );
+        } else {
+            exponent++;
+            bExact = FALSE;
+        }
+    }
+    if( q < pEnd && *q == '.' ) {
+        for( q++; q < pEnd && g_ascii_isdigit( *q ); q++, bDigits = TRUE ) {
+            if( nDigits < 19 ) {
+                mantissa = mantissa * 10 + (*q - '0');
+                nDigits += ( mantissa != 0 );
+                exponent--;
+            } else {
+                bExact = FALSE;
+            }
+        }
+    }
+    if( !bDigits )
+        return NULL;
+
+    if( q < pEnd && (*q == 'e' || *q == 'E') ) {
+        const gchar *r = q + 1;
+        gboolean bNegativeExponent = FALSE;
+        gint e = 0;
+
+        if( r < pEnd && (*r == '-' || *r == '+') )
+            bNegativeExponent = ( *r++ == '-' );
+        if( r < pEnd && g_ascii_isdigit( *r ) ) {
+            for( ; r < pEnd && g_ascii_isdigit( *r ); r++ )
+                e = MIN( e * 10 + (*r - '0'), 100000 );
+            exponent += bNegativeExponent ? -e : e;
+            q = r;
+        }
+    }
+
+    if( bExact && mantissa < ((guint64)1 << 53) && exponent >= -22 && exponent <= 22 ) {
+        value = ( exponent >= 0 ) ? (gdouble)mantissa * powersOfTen[ exponent ]
+                                  : (gdouble)mantissa / powersOfTen[ -exponent ];
+    } else {
+        gchar buffer[ 64 ];
+
+        if( q - p >= (gssize)sizeof( buffer ) )
+            return NULL;
+        memcpy( buffer, p, q - p );
+        buffer[ q - p ] = 0;
+        value = fabs( g_ascii_strtod( buffer, NULL ) );
+    }
+
+    *pValue = bNegative ? -value : value;
+    return q;
+}
+
+/*!     \brief  Is the character a separator between numbers
+ *
+ * Is the character white space (other than a new line) or a comma
+ *
+ * \ingroup parse
+ *
+ * \param c         the character
+ * \return          TRUE if it separates numbers
+ */
+static inline gboolean
+isSeparator( gchar c ) {
+    return c == ' ' || c == '\t' || c == '\r' || c == ',';
+}
+
+/*!     \brief  Skip separators
+ *
+ * Skip white space (not new lines) and commas
+ *
+ * \ingroup parse
+ *
+ * \param p         position in the text
+ * \param pEnd      end of the text
+ * \return          the first character that is not a separator
+ */
+const gchar *
+smithParseSkipSeparators( const gchar *p, const gchar *pEnd ) {
+    while( p < pEnd && isSeparator( *p ) )
+        p++;
+    return p;
+}
+
+/*!     \brief  Skip a word
+ *
+ * Skip to the end of a word (a number or a keyword): the next separator,
+ * new line or comment
+ *
+ * \ingroup parse
+ *
+ * \param p         position in the text
+ * \param pEnd      end of the text
+ * \param comment   character that starts a comment (or 0)
+ * \return          the first character after the word (p itself if it is not in a word)
+ */
+const gchar *
+smithParseSkipWord( const gchar *p, const gchar *pEnd, gchar comment ) {
+    while( p < pEnd && !isSeparator( *p ) && *p != '\n' && (*p != comment || comment == 0) )
+        p++;
+    return p;
+}
+
+/*!     \brief  Does a line start with a keyword
+ *
+ * Compare the word at the start of a line (after any white space) with a keyword, ignoring case
+ *
+ * \ingroup parse
+ *
+ * \param p         start of the line
+ * \param pEnd      end of the text
+ * \param sKeyword  the keyword
+ * \return          the text after the keyword, or NULL if the line does not start with it
+ */
+const gchar *
+smithParseKeyword( const gchar *p, const gchar *pEnd, const gchar *sKeyword ) {
+    gsize length = strlen( sKeyword );
+
+    p = smithParseSkipSeparators( p, pEnd );
+    if( (gsize)(pEnd - p) < length || g_ascii_strncasecmp( p, sKeyword, length ) != 0 )
+        return NULL;
+    p += length;
+    // the whole word
+    if( p < pEnd && !isSeparator( *p ) && *p != '\n' )
+        return NULL;
+    return p;
+}
+
+/*!     \brief  Find the line of a keyword
+ *
+ * Find the first line that starts with a keyword (e.g. the END of a block).
+ * The keyword is searched for as it is written (in upper case), so that the
+ * lines before it need not be examined one by one.
+ *
+ * \ingroup parse
+ *
+ * \param p         start of a line
+ * \param pEnd      end of the text
+ * \param sKeyword  the keyword
+ * \return          start of the line of the keyword, or NULL if there is none
+ */
+const gchar *
+smithParseFindKeyword( const gchar *p, const gchar *pEnd, const gchar *sKeyword ) {
+    gsize length = strlen( sKeyword );
+
+    for( const gchar *q = p; (q = memmem( q, pEnd - q, sKeyword, length )) != NULL; q += length ) {
+        const gchar *pLine = q;
+
+        // only separators before it on its line
+        while( pLine > p && (pLine[-1] == ' ' || pLine[-1] == '\t') )
+            pLine--;
+        if( (pLine == p || pLine[-1] == '\n') && smithParseKeyword( pLine, pEnd, sKeyword ) )
+            return pLine;
+    }
+    return NULL;
+}
+
+/*!     \brief  Line number of a position in the text
+ *
+ * Line number (from 1) of a position in the text, for error messages
+ *
+ * \ingroup parse
+ *
+ * \param pText     start of the text
+ * \param p         position in the text
+ * \return          line number
+ */
+gint
+smithParseLineNumber( const gchar *pText, const gchar *p ) {
+    gint line = 1;
+
+    for( const gchar *q = pText; (q = memchr( q, '\n', p - q )) != NULL; q++ )
+        line++;
+    return line;
+}
+
+/*!     \brief  Count the numbers of chunks of a table
+ *
+ * Count the numbers of a range of the chunks, up to a line that ends the
+ * table (a parallel loop function)
+ *
+ * \ingroup parse
+ *
+ * \param from      first chunk
+ * \param to        last chunk (exclusive)
+ * \param userData  pointer to the tParseTable
+ */
+static void
+countTableChunks( gint from, gint to, gpointer userData ) {
+    tParseTable *pTable = userData;
+
+    for( gint c = from; c < to; c++ ) {
+        tTableChunk *pChunk = &pTable->pChunks[c];
+        const gchar *p = pChunk->pStart, *pEnd = pChunk->pEnd;
+        gint64 nNumbers = 0;
+
+        if( pTable->stop ) {
+            // line by line, as a line may end the table
+            while( p < pEnd ) {
+                const gchar *pLine = p, *pFirst = smithParseSkipSeparators( p, pEnd );
+                gint nLine = 0;
+
+                for( p = pFirst; p < pEnd && *p != '\n' && *p != pTable->comment; p = smithParseSkipSeparators( p, pEnd ) ) {
+                    nLine++;
+                    p = smithParseSkipWord( p, pEnd, pTable->comment );
+                }
+                if( nLine > 0 && pTable->stop( pFirst, nLine, pTable->pStopData ) ) {
+                    pChunk->pStop = pLine;
+                    break;
+                }
+                nNumbers += nLine;
+                p = smithParseNextLine( p, pEnd );
+            }
+        } else {
+            while( (p = smithParseSkipSeparators( p, pEnd )) < pEnd ) {
+                if( *p == '\n' ) {
+                    p++;
+                } else if( *p == pTable->comment ) {
+                    p = smithParseNextLine( p, pEnd );
+                } else {
+                    nNumbers++;
+                    p = smithParseSkipWord( p, pEnd, pTable->comment );
+                }
+            }
+        }
+        pChunk->nNumbers = nNumbers;
+    }
+}
+
+/*!     \brief  Parse the numbers of chunks of a table
+ *
+ * Parse the numbers of a range of the chunks into their columns (a parallel loop function)
+ *
+ * \ingroup parse
+ *
+ * \param from      first chunk
+ * \param to        last chunk (exclusive)
+ * \param userData  pointer to the tParseTable
+ */
+static void
+storeTableChunks( gint from, gint to, gpointer userData ) {
+    tParseTable *pTable = userData;
+
+    for( gint c = from; c < to; c++ ) {
+        tTableChunk *pChunk = &pTable->pChunks[c];
+        const gchar *p = pChunk->pStart, *pEnd = pChunk->pEnd;
+        gint64 row = pChunk->first / pTable->nColumns;
+        gint column = pChunk->first % pTable->nColumns;
+
+        pChunk->pError = NULL;
+        while( (p = smithParseSkipSeparators( p, pEnd )) < pEnd && row < pTable->nRows ) {
+            gdouble *pColumn = pTable->ppColumns[ column ];
+
+            if( *p == '\n' ) {
+                p++;
+                continue;
+            } else if( *p == pTable->comment ) {
+                p = smithParseNextLine( p, pEnd );
+                continue;
+            } else if( pColumn == NULL ) {
+                // a column not wanted is only stepped over
+                p = smithParseSkipWord( p, pEnd, pTable->comment );
+            } else {
+                const gchar *q = smithParseNumber( p, pEnd, &pColumn[ row ] );
+
+                if( q == NULL || smithParseSkipWord( q, pEnd, pTable->comment ) != q ) {
+                    pChunk->pError = p;
+                    break;
+                }
+                p = q;
+            }
+            if( ++column == pTable->nColumns ) {
+                column = 0;
+                row++;
+            }
+        }
+    }
+}
+
+/*!     \brief  Count the numbers of a region of text
+ *
+ * Split a region of text holding only numbers into chunks, and count the
+ * numbers of the chunks in parallel
+ *
+ * \ingroup parse
+ *
+ * \param pStart    start of the region (at the start of a line)
+ * \param pEnd      end of the region
+ * \param comment   character that starts a comment to the end of the line (or 0)
+ * \return          pointer to the table (free with smithParseTableFree)
+ */
+tParseTable *
+smithParseTableNew( const gchar *pStart, const gchar *pEnd, gchar comment ) {
+    return smithParseTableNewUntil( pStart, pEnd, comment, NULL, NULL );
+}
+
+/*!     \brief  Count the numbers of a region of text up to a line that ends it
+ *
+ * Split a region of text into chunks, and count the numbers of the chunks in
+ * parallel up to the first line for which stop() is TRUE (e.g. a keyword that
+ * follows the numbers). stop() is called, from several threads, with the
+ * first character and the count of the numbers (words) of each line that is
+ * not empty, and not for the lines after one that ends its chunk.
+ *
+ * \ingroup parse
+ *
+ * \param pStart    start of the region (at the start of a line)
+ * \param pEnd      end of the region
+ * \param comment   character that starts a comment to the end of the line (or 0)
+ * \param stop      does a line end the table (or NULL for the whole region)
+ * \param pStopData data for stop()
+ * \return          pointer to the table (free with smithParseTableFree)
+ */
+tParseTable *
+smithParseTableNewUntil( const gchar *pStart, const gchar *pEnd, gchar comment, tParseLineStop stop,
+                         gpointer pStopData ) {
+    tParseTable *pTable = g_new0( tParseTable, 1 );
+    tParseChunk *pParts;
+
+    // (a new line, never taken for a comment, when there are none)
+    pTable->comment = comment ? comment : '\n';
+    pTable->stop = stop;
+    pTable->pStopData = pStopData;
+    pTable->nChunks = smithParseSplit( pStart, pEnd, PARSE_CHUNK_SIZE, &pParts );
+    pTable->pChunks = g_new0( tTableChunk, pTable->nChunks );
+    for( gint c = 0; c < pTable->nChunks; c++ ) {
+        pTable->pChunks[c].pStart = pParts[c].pStart;
+        pTable->pChunks[c].pEnd = pParts[c].pEnd;
+    }
+    g_free( pParts );
+
+    smithParallelFor( pTable->nChunks, 1, countTableChunks, pTable );
+    for( gint c = 0; c < pTable->nChunks; c++ ) {
+        pTable->pChunks[c].first = pTable->nNumbers;
+        pTable->nNumbers += pTable->pChunks[c].nNumbers;
+        if( pTable->pChunks[c].pStop ) {
+            // (the chunks after the end are not stored)
+            pTable->pStop = pTable->pChunks[c].pEnd = pTable->pChunks[c].pStop;
+            pTable->nChunks = c + 1;
+            break;
+        }
+    }
+
+    return pTable;
+}
+
+/*!     \brief  End of a table
+ *
+ * The line that ends a table (see smithParseTableNewUntil())
+ *
+ * \ingroup parse
+ *
+ * \param pTable    pointer to the table
+ * \return          start of the line, or NULL if the table is the whole region
+ */
+const gchar *
+smithParseTableStop( const tParseTable *pTable ) {
+    return pTable->pStop;
+}
+
+/*!     \brief  Numbers in a table
+ *
+ * Number of numbers in the region of a table
+ *
+ * \ingroup parse
+ *
+ * \param pTable    pointer to the table
+ * \return          number of numbers
+ */
+gint64
+smithParseTableCount( const tParseTable *pTable ) {
+    return pTable->nNumbers;
+}
+
+/*!     \brief  Parse a table into columns
+ *
+ * Parse the numbers of a table, in parallel, into the array of their columns
+ * (the numbers are rows of nColumns numbers). Numbers beyond nRows rows are ignored.
+ *
+ * \ingroup parse
+ *
+ * \param pTable    pointer to the table
+ * \param nColumns  numbers in each row
+ * \param ppColumns array of nRows values for each column (NULL for a column that is not wanted)
+ * \param nRows     rows to parse
+ * \return          NULL, or the first text that is not a number
+ */
+const gchar *
+smithParseTableStore( tParseTable *pTable, gint nColumns, gdouble * const *ppColumns, gint64 nRows ) {
+    pTable->nColumns = nColumns;
+    pTable->ppColumns = ppColumns;
+    pTable->nRows = nRows;
+    smithParallelFor( pTable->nChunks, 1, storeTableChunks, pTable );
+
+    for( gint c = 0; c < pTable->nChunks; c++ ) {
+        if( pTable->pChunks[c].pError )
+            return pTable->pChunks[c].pError;
+    }
+    return NULL;
+}
+
+/*!     \brief  Free a table
+ *
+ * Free a table
+ *
+ * \ingroup parse
+ *
+ * \param pTable    pointer to the table
+ */
+void
+smithParseTableFree( tParseTable *pTable ) {
+    if( pTable == NULL )
+        return;
+
+    g_free( pTable->pChunks );
+    g_free( pTable );
+}
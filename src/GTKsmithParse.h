@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHPARSE_H_
+#define GTKSMITHPARSE_H_
+
+#include "GTKsmithChart.h"
+
+#define SMITH_PARSE_ERROR   (smithParseErrorQuark())
+
+typedef enum {
+    eParseErrorFormat,      // not a file of the expected format
+    eParseErrorNumber,      // text that is not a number where one is expected
+    eParseErrorData         // the data is incomplete or inconsistent
+} tParseError;
+
+// A part of a text file, beginning at the start of a line
+typedef struct {
+    const gchar *pStart, *pEnd;
+} tParseChunk;
+
+// Bytes in each chunk parsed in parallel
+#define PARSE_CHUNK_SIZE    (1 << 20)
+
+// A region of text holding only numbers, counted and stored by column (see smithParseTableNew())
+typedef struct sParseTable tParseTable;
+
+// Does a line (its first character and the count of its numbers) end a table (see smithParseTableNewUntil())
+typedef gboolean (*tParseLineStop)( const gchar *, gint, gpointer );
+
+GQuark smithParseErrorQuark( void );
+gint smithParseSplit( const gchar *, const gchar *, gsize, tParseChunk ** );
+const gchar *smithParseNumber( const gchar *, const gchar *, gdouble * );
+const gchar *smithParseNextLine( const gchar *, const gchar * );
+const gchar *smithParseSkipSeparators( const gchar *, const gchar * );
+const gchar *smithParseSkipWord( const gchar *, const gchar *, gchar );
+const gchar *smithParseKeyword( const gchar *, const gchar *, const gchar * );
+const gchar *smithParseFindKeyword( const gchar *, const gchar *, const gchar * );
+gint smithParseLineNumber( const gchar *, const gchar * );
+tParseTable *smithParseTableNew( const gchar *, const gchar *, gchar );
+tParseTable *smithParseTableNewUntil( const gchar *, const gchar *, gchar, tParseLineStop, gpointer );
+const gchar *smithParseTableStop( const tParseTable * );
+gint64 smithParseTableCount( const tParseTable * );
+const gchar *smithParseTableStore( tParseTable *, gint, gdouble * const *, gint64 );
+void smithParseTableFree( tParseTable * );
+
+#endif /* GTKSMITHPARSE_H_ */
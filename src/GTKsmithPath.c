@@ -0,0 +1,371 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithPath.c
+ * @brief Path on the chart of a network of components
+ *
+ * @author Michael G. Katzmann
+ *
+ * Starting from the load, each element moves the reflection coefficient
+ * along an exact arc:
+ *   series L or C      along the constant R circle (the same circles drawRarc() draws)
+ *   shunt L, C or stub along the constant G circle
+ *   line               clockwise around the circle of constant |gamma| referred to
+ *                      the line impedance; for a line of impedance Zl, with
+ *                      k = (Zl - Z0) / (Zl + Z0), gamma = (gamma' + k) / (1 + k gamma')
+ *                      maps the circle |gamma'| = p to the circle through
+ *                      (p + k) / (1 + k p) and (k - p) / (1 - k p)
+ *
+ * The reflection coefficient after each element is kept, so when an element
+ * is changed only the arcs from that element onward are recalculated
+ * (lazily, when the arcs are next asked for).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <complex.h>
+#include "GTKsmithPath.h"
+#include "GTKsmithMatch.h"
+
+#define SPEED_OF_LIGHT  299792458.0
+
+struct sComponentPath {
+    tUV           gammaStart;
+    gdouble       frequency, Z0;
+    gint          nElements, nAllocated;
+    tPathElement *pElements;
+    tUV          *pGamma;       // gamma after each element
+    tArc         *pArcs;        // path of each element
+    gint          nValid;       // elements whose gamma and arc are up to date
+};
+
+/*!     \brief  Create a component path
+ *
+ * Create a component path with no elements
+ *
+ * \ingroup path
+ *
+ * \param gammaStart    reflection coefficient of the load
+ * \param frequency     frequency (Hz)
+ * \param Z0            characteristic impedance of the chart (ohms)
+ * \return              pointer to the path (free with componentPathFree)
+ */
+tComponentPath *
+componentPathNew( tUV gammaStart, gdouble frequency, gdouble Z0 ) {
+    tComponentPath *pPath = g_new0( tComponentPath, 1 );
+
+    pPath->gammaStart = gammaStart;
+    pPath->frequency = frequency;
+    pPath->Z0 = Z0;
+
+    return pPath;
+}
+
+/*!     \brief  Free a component path
+ *
+ * Free a component path
+ *
+ * \ingroup path
+ *
+ * \param pPath     pointer to the path
+ */
+void
+componentPathFree( tComponentPath *pPath ) {
+    if( pPath == NULL )
+        return;
+
+    g_free( pPath->pElements );
+    g_free( pPath->pGamma );
+    g_free( pPath->pArcs );
+    g_free( pPath );
+}
+
+/*!     \brief  Add an element to the generator end of the path
+ *
+ * Add an element to the generator end of the path
+ *
+ * \ingroup path
+ *
+ * \param pPath     pointer to the path
+ * \param pElement  pointer to the element (copied)
+ * \return          index of the element
+ */
+gint
+componentPathAppend( tComponentPath *pPath, const tPathElement *pElement ) {
+    if( pPath->nElements == pPath->nAllocated ) {
+        pPath->nAllocated = MAX( 8, pPath->nAllocated * 2 );
+        pPath->pElements = g_renew( tPathElement, pPath->pElements, pPath->nAllocated );
+        pPath->pGamma = g_renew( tUV, pPath->pGamma, pPath->nAllocated );
+        pPath->pArcs = g_renew( tArc, pPath->pArcs, pPath->nAllocated );
+    }
+    pPath->pElements[ pPath->nElements ] = *pElement;
+
+    return pPath->nElements++;
+}
+
+/*!     \brief  Replace an element of the path
+ *
+ * Replace an element; the arcs from this element on are recalculated when next needed
+ *
+ * \ingroup path
+ *
+ * \param pPath     pointer to the path
+ * \param index     index of the element
+ * \param pElement  pointer to the new element (copied)
+ */
+void
+componentPathSetElement( tComponentPath *pPath, gint index, const tPathElement *pElement ) {
+    g_return_if_fail( index >= 0 && index < pPath->nElements );
+
+    pPath->pElements[ index ] = *pElement;
+    pPath->nValid = MIN( pPath->nValid, index );
+}
+
+/*!     \brief  Change the value of an element of the path
+ *
+ * Change the value (H, F or meters) of an element (e.g. while it is dragged);
+ * the arcs from this element on are recalculated when next needed
+ *
+ * \ingroup path
+ *
+ * \param pPath     pointer to the path
+ * \param index     index of the element
+ * \param value     new value
+ */
+void
+componentPathSetValue( tComponentPath *pPath, gint index, gdouble value ) {
+    g_return_if_fail( index >= 0 && index < pPath->nElements );
+
+    pPath->pElements[ index ].value = value;
+    pPath->nValid = MIN( pPath->nValid, index );
+}
+
+/*!     \brief  Change the load of the path
+ *
+ * Change the load reflection coefficient (all arcs are recalculated when next needed)
+ *
+ * \ingroup path
+ *
+ * \param pPath         pointer to the path
+ * \param gammaStart    reflection coefficient of the load
+ */
+void
+componentPathSetStart( tComponentPath *pPath, tUV gammaStart ) {
+    pPath->gammaStart = gammaStart;
+    pPath->nValid = 0;
+}
+
+/*!     \brief  Change the frequency of the path
+ *
+ * Change the frequency (all arcs are recalculated when next needed)
+ *
+ * \ingroup path
+ *
+ * \param pPath         pointer to the path
+ * \param frequency     frequency (Hz)
+ */
+void
+componentPathSetFrequency( tComponentPath *pPath, gdouble frequency ) {
+    pPath->frequency = frequency;
+    pPath->nValid = 0;
+}
+
+/*!     \brief  Arc of a degenerate path
+ *
+ * An arc of zero radius at a point (an element with no effect, e.g. series to an open circuit)
+ *
+ * \ingroup path
+ *
+ * \param uv        the point
+ * \return          arc in gamma space
+ */
+static tArc
+pointArc( tUV uv ) {
+    return (tArc){ uv, 0.0, 0.0, 0.0, FALSE };
+}
+
+/*!     \brief  Apply an element to a reflection coefficient
+ *
+ * Find the reflection coefficient after an element and the arc it follows
+ *
+ * \ingroup path
+ *
+ * \param pPath     pointer to the path (frequency and Z0)
+ * \param pElement  pointer to the element
+ * \param gamma     reflection coefficient before the element
+ * \param pArc      where the arc is written
+ * \return          reflection coefficient after the element
+ */
+static double complex
+applyElement( tComponentPath *pPath, const tPathElement *pElement, double complex gamma, tArc *pArc ) {
+    gdouble omega = 2.0 * M_PI * pPath->frequency;
+    gdouble wavelengths = 0.0, immittance = 0.0;
+    tUV uvFrom = { creal( gamma ), cimag( gamma ) };
+
+    if( pElement->type == ePathLine || pElement->type == ePathShuntOpenStub
+            || pElement->type == ePathShuntShortStub )
+        wavelengths = pElement->value * pPath->frequency
+                / (SPEED_OF_LIGHT * ( pElement->velocityFactor > 0.0 ? pElement->velocityFactor : 1.0 ));
+
+    switch( pElement->type ) {
+    case ePathSeriesL:
+    case ePathSeriesC: {
+        double complex z = (1.0 + gamma) / (1.0 - gamma);
+
+        immittance = ( pElement->type == ePathSeriesL ) ? omega * pElement->value / pPath->Z0
+                                                        : -1.0 / (omega * pElement->value * pPath->Z0);
+        if( !isfinite( creal( z ) ) || !isfinite( cimag( z ) ) || !isfinite( immittance ) ) {
+            *pArc = pointArc( uvFrom );
+            return gamma;
+        }
+        *pArc = constantRarc( creal( z ), cimag( z ), cimag( z ) + immittance );
+        z += I * immittance;
+        return (z - 1.0) / (z + 1.0);
+    }
+    case ePathShuntL:
+    case ePathShuntC:
+    case ePathShuntOpenStub:
+    case ePathShuntShortStub: {
+        double complex y = (1.0 - gamma) / (1.0 + gamma);
+
+        switch( pElement->type ) {
+        case ePathShuntL:           immittance = -pPath->Z0 / (omega * pElement->value); break;
+        case ePathShuntC:           immittance = omega * pElement->value * pPath->Z0; break;
+        case ePathShuntOpenStub:    immittance = pPath->Z0 / pElement->lineZ0 * tan( 2.0 * M_PI * wavelengths ); break;
+        default:                    immittance = -pPath->Z0 / pElement->lineZ0 / tan( 2.0 * M_PI * wavelengths ); break;
+        }
+        if( !isfinite( creal( y ) ) || !isfinite( cimag( y ) ) || !isfinite( immittance ) ) {
+            *pArc = pointArc( uvFrom );
+            return gamma;
+        }
+        *pArc = constantGarc( creal( y ), cimag( y ), cimag( y ) + immittance );
+        y += I * immittance;
+        return (1.0 - y) / (1.0 + y);
+    }
+    case ePathLine:
+    default: {
+        // reflection coefficient referred to the line
+        gdouble k = (pElement->lineZ0 - pPath->Z0) / (pElement->lineZ0 + pPath->Z0);
+        double complex gammaLine = (gamma - k) / (1.0 - k * gamma);
+        gdouble p = cabs( gammaLine );
+        double complex gammaEnd = (gammaLine * cexp( -I * 4.0 * M_PI * wavelengths ) + k)
+                / (1.0 + k * gammaLine * cexp( -I * 4.0 * M_PI * wavelengths ));
+        gdouble right = (p + k) / (1.0 + k * p), left = (k - p) / (1.0 - k * p);
+        gdouble turns = floor( 2.0 * wavelengths );
+
+        if( k == 0.0 ) {
+            *pArc = lineArc( uvFrom, wavelengths );
+            return gammaEnd;
+        }
+        pArc->center = (tUV){ (right + left) / 2.0, 0.0 };
+        pArc->radius = (right - left) / 2.0;
+        pArc->angleStart = atan2( cimag( gamma ), creal( gamma ) - pArc->center.U );
+        pArc->angleEnd = atan2( cimag( gammaEnd ), creal( gammaEnd ) - pArc->center.U );
+        // the map preserves the clockwise sense, but not the angle turned
+        if( pArc->angleEnd > pArc->angleStart )
+            pArc->angleEnd -= 2.0 * M_PI;
+        pArc->angleEnd -= 2.0 * M_PI * turns;
+        pArc->bNegative = TRUE;
+        return gammaEnd;
+    }
+    }
+}
+
+/*!     \brief  Bring the path up to date
+ *
+ * Recalculate the reflection coefficients and arcs from the first element
+ * that has changed to the generator end
+ *
+ * \ingroup path
+ *
+ * \param pPath     pointer to the path
+ */
+static void
+componentPathUpdate( tComponentPath *pPath ) {
+    double complex gamma;
+
+    if( pPath->nValid >= pPath->nElements )
+        return;
+
+    gamma = ( pPath->nValid == 0 ) ? pPath->gammaStart.U + I * pPath->gammaStart.V
+            : pPath->pGamma[ pPath->nValid - 1 ].U + I * pPath->pGamma[ pPath->nValid - 1 ].V;
+    for( gint i = pPath->nValid; i < pPath->nElements; i++ ) {
+        gamma = applyElement( pPath, &pPath->pElements[i], gamma, &pPath->pArcs[i] );
+        pPath->pGamma[i] = (tUV){ creal( gamma ), cimag( gamma ) };
+    }
+    pPath->nValid = pPath->nElements;
+}
+
+/*!     \brief  Arcs of the path
+ *
+ * Return the arc of each element (recalculating those that have changed)
+ *
+ * \ingroup path
+ *
+ * \param pPath     pointer to the path
+ * \param pnArcs    where the number of arcs (elements) is written
+ * \return          array of arcs (valid until the path is next changed)
+ */
+const tArc *
+componentPathArcs( tComponentPath *pPath, gint *pnArcs ) {
+    componentPathUpdate( pPath );
+    *pnArcs = pPath->nElements;
+
+    return pPath->pArcs;
+}
+
+/*!     \brief  Reflection coefficient along the path
+ *
+ * Return the reflection coefficient after an element
+ *
+ * \ingroup path
+ *
+ * \param pPath     pointer to the path
+ * \param index     index of the element (-1 for the load)
+ * \return          reflection coefficient
+ */
+tUV
+componentPathGamma( tComponentPath *pPath, gint index ) {
+    g_return_val_if_fail( index < pPath->nElements, pPath->gammaStart );
+
+    if( index < 0 )
+        return pPath->gammaStart;
+    componentPathUpdate( pPath );
+
+    return pPath->pGamma[ index ];
+}
+
+/*!     \brief  Draw the path of a network
+ *
+ * Draw the arcs of the path, with a point at the load and after each element
+ *
+ * \ingroup path
+ *
+ * \param cr        pointer to cairo structure
+ * \param pPath     pointer to the path
+ * \param pOptions  pointer to the chart options
+ */
+void
+drawComponentPathOnSmithChart( cairo_t *cr, tComponentPath *pPath, tSmithOptions *pOptions ) {
+    gint nArcs;
+    const tArc *pArcs = componentPathArcs( pPath, &nArcs );
+
+    drawArcArrayOnSmithChart( cr, pArcs, nArcs, pOptions );
+    drawPointOnSmithChart( cr, pPath->gammaStart, pOptions );
+    for( gint i = 0; i < nArcs; i++ )
+        drawPointOnSmithChart( cr, pPath->pGamma[i], pOptions );
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHPATH_H_
+#define GTKSMITHPATH_H_
+
+#include "GTKsmithChart.h"
+
+typedef enum {
+    ePathSeriesL, ePathSeriesC, ePathShuntL, ePathShuntC,
+    ePathLine, ePathShuntOpenStub, ePathShuntShortStub
+} tPathElementType;
+
+typedef struct {
+    tPathElementType type;
+    gdouble value;          // H, F or (lines and stubs) length in meters
+    gdouble lineZ0;         // characteristic impedance of a line or stub (ohms)
+    gdouble velocityFactor; // of a line or stub
+} tPathElement;
+
+// A network of elements in order from the load, with the path of each on the chart
+typedef struct sComponentPath tComponentPath;
+
+tComponentPath *componentPathNew( tUV, gdouble, gdouble );
+void componentPathFree( tComponentPath * );
+gint componentPathAppend( tComponentPath *, const tPathElement * );
+void componentPathSetElement( tComponentPath *, gint, const tPathElement * );
+void componentPathSetValue( tComponentPath *, gint, gdouble );
+void componentPathSetStart( tComponentPath *, tUV );
+void componentPathSetFrequency( tComponentPath *, gdouble );
+const tArc *componentPathArcs( tComponentPath *, gint * );
+tUV componentPathGamma( tComponentPath *, gint );
+void drawComponentPathOnSmithChart( cairo_t *, tComponentPath *, tSmithOptions * );
+
+#endif /* GTKSMITHPATH_H_ */
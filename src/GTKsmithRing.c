@@ -0,0 +1,524 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithRing.c
+ * @brief Ring of sweeps in shared memory
+ *
+ * @author Michael G. Katzmann
+ *
+ * An acquisition process (the single producer) writes sweeps into the slots
+ * of a ring in shared memory and the chart draws them where they lie, without
+ * copying or parsing. The memory is a POSIX shared memory object when the ring
+ * is named, or an anonymous memfd that is passed to the other process (e.g.
+ * inherited by a child or sent over a Unix domain socket).
+ *
+ * The memory holds a 128 byte header followed by the slots. Each slot has a
+ * 64 byte header and the frequency, real and imaginary arrays of up to
+ * maxPoints points, each on a 64 byte boundary (TRACE_ALIGNMENT).
+ *
+ * Each slot carries a sequence counter: it is SLOT_WRITING while the producer
+ * fills the slot and the number of the sweep once it is complete, after which
+ * the number is published in the header. A reader takes the slot of the
+ * latest published sweep and, when it has finished with it, checks that the
+ * counter still holds the same number; if not, the producer has lapped the
+ * ring while the sweep was being drawn and the result should be discarded.
+ * The producer never waits for readers.
+ */
+
+#define _GNU_SOURCE     // memfd_create()
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "GTKsmithRing.h"
+#include "GTKsmithTrace.h"
+
+#define RING_MAGIC          "SMITHRG1"
+#define RING_VERSION        1
+#define SLOT_WRITING        G_MAXUINT64
+
+typedef struct {
+    gchar   magic[8];
+    guint32 version;
+    guint32 nSlots;
+    guint32 maxPoints;
+    guint32 reserved0;
+    guint64 slotBytes;
+    guint8  reserved1[32];
+    guint64 published;          // number of the latest complete sweep (0 for none), on its own cache line
+    guint8  reserved2[56];
+} tRingHeader;
+
+G_STATIC_ASSERT( sizeof( tRingHeader ) == 128 );
+
+typedef struct {
+    guint64 sequence;           // sweep number, or SLOT_WRITING
+    gint64  timestamp;          // g_get_monotonic_time() when the sweep was completed
+    guint32 nPoints;
+    guint8  reserved[44];
+} tSlotHeader;
+
+G_STATIC_ASSERT( sizeof( tSlotHeader ) == 64 );
+
+struct sSweepRing {
+    gint         fd;
+    gchar       *sName;         // shared memory object to unlink (creator of a named ring only)
+    gsize        length;
+    tRingHeader *pHeader;
+    gboolean     bProducer;
+    guint64      written;       // sweeps written (producer)
+    tSmithTrace  view;          // the slot being written or read
+    tSlotHeader *pViewSlot;
+    guint64      viewSequence;
+    guint64      watched;       // sequence last drawn by sweepRingWatch()
+};
+
+/*!     \brief  Bytes for an array of a slot
+ *
+ * Bytes for an array of a slot, rounded up to the alignment
+ *
+ * \ingroup ring
+ *
+ * \param maxPoints points in a slot
+ * \return          bytes
+ */
+static inline gsize
+arrayBytes( guint32 maxPoints ) {
+    return ((gsize)maxPoints * sizeof( gdouble ) + TRACE_ALIGNMENT - 1) & ~(gsize)(TRACE_ALIGNMENT - 1);
+}
+
+/*!     \brief  Header of a slot
+ *
+ * Header of a slot of the ring
+ *
+ * \ingroup ring
+ *
+ * \param pRing     pointer to the ring
+ * \param slot      slot number
+ * \return          pointer to the slot header
+ */
+static inline tSlotHeader *
+slotHeader( tSweepRing *pRing, guint64 slot ) {
+    return (tSlotHeader *)((guint8 *)pRing->pHeader + sizeof( tRingHeader ) + slot * pRing->pHeader->slotBytes);
+}
+
+/*!     \brief  Point the view at a slot
+ *
+ * Point the borrowed trace of the ring at the arrays of a slot
+ *
+ * \ingroup ring
+ *
+ * \param pRing     pointer to the ring
+ * \param pSlot     pointer to the slot header
+ */
+static void
+viewSlot( tSweepRing *pRing, tSlotHeader *pSlot ) {
+    gsize bytes = arrayBytes( pRing->pHeader->maxPoints );
+    guint8 *pArrays = (guint8 *)pSlot + sizeof( tSlotHeader );
+
+    pRing->pViewSlot = pSlot;
+    pRing->view.pFreq = (gdouble *)pArrays;
+    pRing->view.pU = (gdouble *)(pArrays + bytes);
+    pRing->view.pV = (gdouble *)(pArrays + 2 * bytes);
+    pRing->view.nAllocated = pRing->pHeader->maxPoints;
+    pRing->view.flags.bBorrowed = TRUE;
+}
+
+/*!     \brief  Map the memory of a ring
+ *
+ * Map the shared memory of a ring, and check the header of a ring
+ * that was not created by this process
+ *
+ * \ingroup ring
+ *
+ * \param fd        file descriptor of the memory
+ * \param bCreated  the memory has just been created (and sized)
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the ring, or NULL on error
+ */
+static tSweepRing *
+ringMap( gint fd, gboolean bCreated, GError **ppError ) {
+    struct stat status;
+    tSweepRing *pRing;
+    void *pMemory;
+
+    if( fstat( fd, &status ) != 0 ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ), "sweep ring: %s", g_strerror( errno ) );
+        return NULL;
+    }
+    if( status.st_size < (off_t)sizeof( tRingHeader ) ) {
+        g_set_error( ppError, G_FILE_ERROR, G_FILE_ERROR_INVAL, "sweep ring: not a sweep ring" );
+        return NULL;
+    }
+
+    // readers only read the memory
+    pMemory = mmap( NULL, status.st_size, bCreated ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0 );
+    if( pMemory == MAP_FAILED ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ), "sweep ring: %s", g_strerror( errno ) );
+        return NULL;
+    }
+
+    pRing = g_new0( tSweepRing, 1 );
+    pRing->fd = fd;
+    pRing->length = status.st_size;
+    pRing->pHeader = pMemory;
+
+    if( !bCreated ) {
+        tRingHeader *pHeader = pRing->pHeader;
+
+        if( memcmp( pHeader->magic, RING_MAGIC, sizeof( pHeader->magic ) ) != 0
+                || pHeader->version != RING_VERSION || pHeader->nSlots == 0
+                || pHeader->slotBytes != sizeof( tSlotHeader ) + 3 * arrayBytes( pHeader->maxPoints )
+                || sizeof( tRingHeader ) + pHeader->nSlots * pHeader->slotBytes > pRing->length ) {
+            g_set_error( ppError, G_FILE_ERROR, G_FILE_ERROR_INVAL, "sweep ring: not a sweep ring" );
+            munmap( pMemory, pRing->length );
+            g_free( pRing );
+            return NULL;
+        }
+    }
+
+    return pRing;
+}
+
+/*!     \brief  Create a ring of sweeps
+ *
+ * Create a ring of sweeps in shared memory, to be written by this process.
+ * A named ring (e.g. "/vna-sweeps") is a POSIX shared memory object that other
+ * processes attach to with sweepRingAttach() and is removed by sweepRingFree().
+ * An unnamed ring is a memfd; pass sweepRingFd() to the reader for sweepRingAttachFd().
+ *
+ * \ingroup ring
+ *
+ * \param sName     name of the shared memory object (or NULL)
+ * \param nSlots    sweeps held (0 for SWEEP_RING_SLOTS)
+ * \param maxPoints most points in a sweep
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the ring (free with sweepRingFree), or NULL on error
+ */
+tSweepRing *
+sweepRingCreate( const gchar *sName, gint nSlots, gint maxPoints, GError **ppError ) {
+    tSweepRing *pRing;
+    gsize slotBytes, length;
+    gint fd;
+
+    if( nSlots <= 0 )
+        nSlots = SWEEP_RING_SLOTS;
+    g_return_val_if_fail( maxPoints > 0, NULL );
+
+    slotBytes = sizeof( tSlotHeader ) + 3 * arrayBytes( maxPoints );
+    length = sizeof( tRingHeader ) + nSlots * slotBytes;
+
+    if( sName )
+        fd = shm_open( sName, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600 );
+    else
+        fd = memfd_create( "sweep ring", MFD_CLOEXEC );
+    if( fd < 0 || ftruncate( fd, length ) != 0 ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ), "%s: %s",
+                     sName ? sName : "sweep ring", g_strerror( errno ) );
+        if( fd >= 0 ) {
+            close( fd );
+            if( sName )
+                shm_unlink( sName );
+        }
+        return NULL;
+    }
+
+    if( (pRing = ringMap( fd, TRUE, ppError )) == NULL ) {
+        close( fd );
+        if( sName )
+            shm_unlink( sName );
+        return NULL;
+    }
+
+    // the memory is zero filled: no sweeps are published and no slot holds one
+    pRing->pHeader->version = RING_VERSION;
+    pRing->pHeader->nSlots = nSlots;
+    pRing->pHeader->maxPoints = maxPoints;
+    pRing->pHeader->slotBytes = slotBytes;
+    // the magic is written last, so a reader never accepts a half made header
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+    memcpy( pRing->pHeader->magic, RING_MAGIC, sizeof( pRing->pHeader->magic ) );
+
+    pRing->sName = g_strdup( sName );
+    pRing->bProducer = TRUE;
+
+    return pRing;
+}
+
+/*!     \brief  Attach to a named ring
+ *
+ * Attach to a ring created by another process with sweepRingCreate(), to read it
+ *
+ * \ingroup ring
+ *
+ * \param sName     name of the shared memory object
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the ring (free with sweepRingFree), or NULL on error
+ */
+tSweepRing *
+sweepRingAttach( const gchar *sName, GError **ppError ) {
+    tSweepRing *pRing;
+    gint fd = shm_open( sName, O_RDONLY | O_CLOEXEC, 0 );
+
+    if( fd < 0 ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ), "%s: %s", sName, g_strerror( errno ) );
+        return NULL;
+    }
+    if( (pRing = ringMap( fd, FALSE, ppError )) == NULL )
+        close( fd );
+
+    return pRing;
+}
+
+/*!     \brief  Attach to a ring by file descriptor
+ *
+ * Attach to a ring from the file descriptor of its memory, to read it.
+ * The ring takes ownership of the descriptor.
+ *
+ * \ingroup ring
+ *
+ * \param fd        file descriptor of the memory (from sweepRingFd() of the producer)
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the ring (free with sweepRingFree), or NULL on error
+ */
+tSweepRing *
+sweepRingAttachFd( gint fd, GError **ppError ) {
+    return ringMap( fd, FALSE, ppError );
+}
+
+/*!     \brief  Free a ring
+ *
+ * Unmap a ring (and remove the shared memory object of a named ring created
+ * by this process; readers already attached keep their mapping)
+ *
+ * \ingroup ring
+ *
+ * \param pRing     pointer to the ring
+ */
+void
+sweepRingFree( tSweepRing *pRing ) {
+    if( pRing == NULL )
+        return;
+
+    munmap( pRing->pHeader, pRing->length );
+    close( pRing->fd );
+    if( pRing->sName )
+        shm_unlink( pRing->sName );
+    g_free( pRing->sName );
+    g_free( pRing );
+}
+
+/*!     \brief  File descriptor of the ring
+ *
+ * File descriptor of the memory of the ring (e.g. to pass an unnamed ring to another process)
+ *
+ * \ingroup ring
+ *
+ * \param pRing     pointer to the ring
+ * \return          file descriptor (owned by the ring)
+ */
+gint
+sweepRingFd( tSweepRing *pRing ) {
+    return pRing->fd;
+}
+
+/*!     \brief  Most points in a sweep
+ *
+ * Most points a sweep of the ring can hold
+ *
+ * \ingroup ring
+ *
+ * \param pRing     pointer to the ring
+ * \return          points
+ */
+gint
+sweepRingMaxPoints( tSweepRing *pRing ) {
+    return pRing->pHeader->maxPoints;
+}
+
+/*!     \brief  Start writing a sweep
+ *
+ * Start writing the next sweep (producer only). Fill the arrays of the returned
+ * trace (up to nAllocated points) in place and set nPoints, then call sweepRingEndWrite().
+ *
+ * \ingroup ring
+ *
+ * \param pRing     pointer to the ring
+ * \return          trace in the slot of the next sweep (owned by the ring)
+ */
+tSmithTrace *
+sweepRingBeginWrite( tSweepRing *pRing ) {
+    tSlotHeader *pSlot;
+
+    g_return_val_if_fail( pRing->bProducer, NULL );
+
+    pSlot = slotHeader( pRing, pRing->written % pRing->pHeader->nSlots );
+    // readers of the sweep in this slot see that it is going
+    __atomic_store_n( &pSlot->sequence, SLOT_WRITING, __ATOMIC_RELAXED );
+    __atomic_thread_fence( __ATOMIC_RELEASE );
+
+    viewSlot( pRing, pSlot );
+    pRing->view.nPoints = 0;
+
+    return &pRing->view;
+}
+
+/*!     \brief  Finish writing a sweep
+ *
+ * Publish the sweep started by sweepRingBeginWrite()
+ *
+ * \ingroup ring
+ *
+ * \param pRing     pointer to the ring
+ * \return          number of the sweep
+ */
+guint64
+sweepRingEndWrite( tSweepRing *pRing ) {
+    tSlotHeader *pSlot = pRing->pViewSlot;
+    guint64 sequence;
+
+    g_return_val_if_fail( pRing->bProducer && pSlot != NULL, 0 );
+
+    sequence = ++pRing->written;
+
+    pSlot->nPoints = CLAMP( pRing->view.nPoints, 0, (gint)pRing->pHeader->maxPoints );
+    pSlot->timestamp = g_get_monotonic_time();
+    __atomic_store_n( &pSlot->sequence, sequence, __ATOMIC_RELEASE );
+    __atomic_store_n( &pRing->pHeader->published, sequence, __ATOMIC_RELEASE );
+    pRing->pViewSlot = NULL;
+
+    return sequence;
+}
+
+/*!     \brief  Number of the latest sweep
+ *
+ * Number of the latest complete sweep (0 if none), to poll for new sweeps
+ *
+ * \ingroup ring
+ *
+ * \param pRing     pointer to the ring
+ * \return          sweep number
+ */
+guint64
+sweepRingSequence( tSweepRing *pRing ) {
+    return __atomic_load_n( &pRing->pHeader->published, __ATOMIC_ACQUIRE );
+}
+
+/*!     \brief  Acquire the latest sweep
+ *
+ * Acquire the latest complete sweep, in place in the shared memory. Call
+ * sweepRingRelease() when it has been used, which reports whether the producer
+ * overwrote it meanwhile.
+ *
+ * \ingroup ring
+ *
+ * \param pRing         pointer to the ring
+ * \param pSequence     where the number of the sweep is written (or NULL)
+ * \param pTimestamp    where g_get_monotonic_time() at its completion is written (or NULL)
+ * \return              the sweep (owned by the ring), or NULL if there is none
+ */
+const tSmithTrace *
+sweepRingAcquire( tSweepRing *pRing, guint64 *pSequence, gint64 *pTimestamp ) {
+    for( ;; ) {
+        guint64 sequence = sweepRingSequence( pRing );
+        tSlotHeader *pSlot;
+
+        if( sequence == 0 )
+            return NULL;
+
+        pSlot = slotHeader( pRing, (sequence - 1) % pRing->pHeader->nSlots );
+        if( __atomic_load_n( &pSlot->sequence, __ATOMIC_ACQUIRE ) != sequence )
+            continue;   // lapped already: take the newer sweep
+
+        viewSlot( pRing, pSlot );
+        pRing->view.nPoints = MIN( pSlot->nPoints, pRing->pHeader->maxPoints );
+        pRing->viewSequence = sequence;
+        if( pSequence )
+            *pSequence = sequence;
+        if( pTimestamp )
+            *pTimestamp = pSlot->timestamp;
+
+        return &pRing->view;
+    }
+}
+
+/*!     \brief  Release the acquired sweep
+ *
+ * Release the sweep acquired by sweepRingAcquire() and check that it was
+ * not overwritten while it was in use
+ *
+ * \ingroup ring
+ *
+ * \param pRing     pointer to the ring
+ * \return          TRUE if the sweep was intact, FALSE if it should be discarded
+ */
+gboolean
+sweepRingRelease( tSweepRing *pRing ) {
+    tSlotHeader *pSlot = pRing->pViewSlot;
+
+    if( pSlot == NULL )
+        return FALSE;
+
+    pRing->pViewSlot = NULL;
+    __atomic_thread_fence( __ATOMIC_ACQUIRE );
+    return __atomic_load_n( &pSlot->sequence, __ATOMIC_RELAXED ) == pRing->viewSequence;
+}
+
+/*!     \brief  Frame clock tick of a watched ring
+ *
+ * Queue a redraw of the drawing area if a sweep has arrived since the last frame
+ *
+ * \ingroup ring
+ *
+ * \param pWidget       the drawing area
+ * \param pFrameClock   unused
+ * \param userData      pointer to the ring
+ * \return              G_SOURCE_CONTINUE
+ */
+static gboolean
+ringTick( GtkWidget *pWidget, GdkFrameClock *pFrameClock, gpointer userData ) {
+    tSweepRing *pRing = userData;
+    guint64 sequence = sweepRingSequence( pRing );
+
+    if( sequence != pRing->watched ) {
+        pRing->watched = sequence;
+        gtk_widget_queue_draw( pWidget );
+    }
+
+    return G_SOURCE_CONTINUE;
+}
+
+/*!     \brief  Redraw a chart as sweeps arrive
+ *
+ * Check the ring at each frame of the drawing area and redraw it when a new
+ * sweep has arrived (at most once per frame). Remove the watch with
+ * gtk_widget_remove_tick_callback() before freeing the ring.
+ *
+ * \ingroup ring
+ *
+ * \param pRing     pointer to the ring
+ * \param pWidget   the drawing area
+ * \return          id of the tick callback
+ */
+guint
+sweepRingWatch( tSweepRing *pRing, GtkWidget *pWidget ) {
+    return gtk_widget_add_tick_callback( pWidget, ringTick, pRing, NULL );
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHRING_H_
+#define GTKSMITHRING_H_
+
+#include "GTKsmithChart.h"
+
+typedef struct sSweepRing tSweepRing;
+
+// Sweeps held by a ring unless another number is given
+#define SWEEP_RING_SLOTS    8
+
+tSweepRing *sweepRingCreate( const gchar *, gint, gint, GError ** );
+tSweepRing *sweepRingAttach( const gchar *, GError ** );
+tSweepRing *sweepRingAttachFd( gint, GError ** );
+void sweepRingFree( tSweepRing * );
+gint sweepRingFd( tSweepRing * );
+gint sweepRingMaxPoints( tSweepRing * );
+tSmithTrace *sweepRingBeginWrite( tSweepRing * );
+guint64 sweepRingEndWrite( tSweepRing * );
+guint64 sweepRingSequence( tSweepRing * );
+const tSmithTrace *sweepRingAcquire( tSweepRing *, guint64 *, gint64 * );
+gboolean sweepRingRelease( tSweepRing * );
+guint sweepRingWatch( tSweepRing *, GtkWidget * );
+
+#endif /* GTKSMITHRING_H_ */
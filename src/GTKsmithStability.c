@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithStability.c
+ * @brief Stability circles of a two-port
+ *
+ * @author Michael G. Katzmann
+ *
+ * The load stability circle is the locus of load reflection coefficients for
+ * which |gamma in| = 1, and the source stability circle the locus of source
+ * reflection coefficients for which |gamma out| = 1. With D = S11 S22 - S12 S21
+ *
+ *      load:   center = conj(S22 - D conj(S11)) / (|S22|^2 - |D|^2)
+ *              radius = |S12 S21| / | |S22|^2 - |D|^2 |
+ *      source: center = conj(S11 - D conj(S22)) / (|S11|^2 - |D|^2)
+ *              radius = |S12 S21| / | |S11|^2 - |D|^2 |
+ *
+ * A matched load (the center of the chart) gives |gamma in| = |S11|, so the
+ * center of the chart is stable if |S11| < 1, which determines whether the
+ * stable side of the load circle is its inside or outside (and likewise |S22|
+ * for the source circle).
+ *
+ * When |S22|^2 = |D|^2 (or |S11|^2 = |D|^2 for the source circle) the circle
+ * becomes the straight line Re( C gamma ) = (1 - |S11|^2) / 2, at right angles
+ * to conj(C), where C is the numerator of the center above; the terminations
+ * with Re( C gamma ) below it are stable. The chord of the line across the
+ * chart is then drawn in place of the circle.
+ *
+ * The S-parameters are given as traces (real part in U, imaginary part in V)
+ * sharing the same frequencies. The circles at all frequencies are calculated
+ * in parallel by a loop over the arrays of the traces.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "GTKsmithStability.h"
+#include "GTKsmithParallel.h"
+
+// A boundary with a larger radius (in units of the chart radius) is treated as a straight line
+#define STABILITY_LINE_RADIUS   1e6
+
+typedef struct {
+    const gdouble    *S11r, *S11i, *S12r, *S12i, *S21r, *S21i, *S22r, *S22i;
+    tStabilityCircle *pSource, *pLoad;
+} tStabilityJob;
+
+/*!     \brief  Stability line from its parameters
+ *
+ * Straight stability boundary Re( C gamma ) = (1 - |Sjj|^2) / 2, when the
+ * denominator of the circle vanishes
+ *
+ * \ingroup stability
+ *
+ * \param Cr            real part of C
+ * \param Ci            imaginary part of C
+ * \param magSjj        |Sjj| (the other port's reflection, deciding the stable side)
+ * \return              the stability boundary
+ */
+static tStabilityCircle
+stabilityLine( gdouble Cr, gdouble Ci, gdouble magSjj ) {
+    tStabilityCircle stability = { .circle.radius = INFINITY };
+    gboolean bCenterStable = magSjj < 1.0;
+    gdouble magC = hypot( Cr, Ci ), offset, halfChord;
+    tUV normal, along;
+
+    if( magC == 0.0 ) {
+        // every termination is as stable as the center of the chart
+        stability.bUnconditional = bCenterStable;
+        return stability;
+    }
+
+    // distance of the line from the center of the chart along the unit normal conj(C) / |C|
+    offset = (1.0 - SQU( magSjj )) / (2.0 * magC);
+    normal = (tUV){ Cr / magC, -Ci / magC };
+    stability.circle.center = (tUV){ normal.U * offset, normal.V * offset };
+    stability.bUnconditional = bCenterStable && fabs( offset ) >= SMITH_RADIUS;
+    if( fabs( offset ) >= SMITH_RADIUS ) {
+        // the whole chart is on the side of its center
+        stability.line = (tLine){ stability.circle.center, stability.circle.center };
+        return stability;
+    }
+
+    // the stable side (Re( C gamma ) below the line) is on the left of this direction
+    along = (tUV){ -normal.V, normal.U };
+    halfChord = sqrt( SQU( SMITH_RADIUS ) - SQU( offset ) );
+    stability.line.A = (tUV){ stability.circle.center.U - halfChord * along.U,
+                              stability.circle.center.V - halfChord * along.V };
+    stability.line.B = (tUV){ stability.circle.center.U + halfChord * along.U,
+                              stability.circle.center.V + halfChord * along.V };
+
+    return stability;
+}
+
+/*!     \brief  Stability circle from its parameters
+ *
+ * Stability circle center = conj(C) / denominator, radius = |S12 S21| / |denominator|
+ * (or the straight line of stabilityLine() if the radius is unbounded)
+ *
+ * \ingroup stability
+ *
+ * \param Cr            real part of C
+ * \param Ci            imaginary part of C
+ * \param denominator   |Sii|^2 - |D|^2
+ * \param magS12S21     |S12 S21|
+ * \param magSjj        |Sjj| (the other port's reflection, deciding the stable side)
+ * \return              the stability circle
+ */
+static inline tStabilityCircle
+stabilityCircle( gdouble Cr, gdouble Ci, gdouble denominator, gdouble magS12S21, gdouble magSjj ) {
+    tStabilityCircle stability = { 0 };
+    gdouble distance;
+    gboolean bCenterStable = magSjj < 1.0, bCenterInside;
+
+    if( magS12S21 >= STABILITY_LINE_RADIUS * fabs( denominator ) )
+        return stabilityLine( Cr, Ci, magSjj );
+
+    stability.circle.center = (tUV){ Cr / denominator, -Ci / denominator };
+    stability.circle.radius = magS12S21 / fabs( denominator );
+
+    distance = hypot( stability.circle.center.U, stability.circle.center.V );
+    bCenterInside = distance < stability.circle.radius;
+    stability.bStableInside = ( bCenterInside == bCenterStable );
+    // the whole chart is on the stable side
+    stability.bUnconditional = bCenterStable
+            && ( stability.bStableInside ? stability.circle.radius - distance >= 1.0
+                                         : distance - stability.circle.radius >= 1.0 );
+
+    return stability;
+}
+
+static void
+stabilityRange( gint from, gint to, gpointer userData ) {
+    tStabilityJob *pJob = userData;
+
+    for( gint i = from; i < to; i++ ) {
+        gdouble S11r = pJob->S11r[i], S11i = pJob->S11i[i];
+        gdouble S22r = pJob->S22r[i], S22i = pJob->S22i[i];
+        // S12 S21
+        gdouble Pr = pJob->S12r[i] * pJob->S21r[i] - pJob->S12i[i] * pJob->S21i[i];
+        gdouble Pi = pJob->S12r[i] * pJob->S21i[i] + pJob->S12i[i] * pJob->S21r[i];
+        // D = S11 S22 - S12 S21
+        gdouble Dr = S11r * S22r - S11i * S22i - Pr;
+        gdouble Di = S11r * S22i + S11i * S22r - Pi;
+        gdouble magSquD = SQU(Dr) + SQU(Di);
+        gdouble magSquS11 = SQU(S11r) + SQU(S11i);
+        gdouble magSquS22 = SQU(S22r) + SQU(S22i);
+        gdouble magP = hypot( Pr, Pi );
+
+        // C = S22 - D conj(S11) (load) and S11 - D conj(S22) (source)
+        pJob->pLoad[i] = stabilityCircle( S22r - (Dr * S11r + Di * S11i), S22i - (Di * S11r - Dr * S11i),
+                magSquS22 - magSquD, magP, sqrt( magSquS11 ) );
+        pJob->pSource[i] = stabilityCircle( S11r - (Dr * S22r + Di * S22i), S11i - (Di * S22r - Dr * S22i),
+                magSquS11 - magSquD, magP, sqrt( magSquS22 ) );
+    }
+}
+
+/*!     \brief  Stability circles of a two-port over frequency
+ *
+ * Source and load stability circles at every frequency of a two-port.
+ * The traces must have the same number of points (the shortest sets the number).
+ *
+ * \ingroup stability
+ *
+ * \param pS11      pointer to the S11 trace
+ * \param pS12      pointer to the S12 trace
+ * \param pS21      pointer to the S21 trace
+ * \param pS22      pointer to the S22 trace
+ * \param source    array where the source plane circles are written
+ * \param load      array where the load plane circles are written
+ */
+void
+stabilityCircles( const tSmithTrace *pS11, const tSmithTrace *pS12, const tSmithTrace *pS21,
+        const tSmithTrace *pS22, tStabilityCircle source[], tStabilityCircle load[] ) {
+    tStabilityJob job = { pS11->pU, pS11->pV, pS12->pU, pS12->pV, pS21->pU, pS21->pV,
+                          pS22->pU, pS22->pV, source, load };
+    gint nPoints = MIN( MIN( pS11->nPoints, pS12->nPoints ), MIN( pS21->nPoints, pS22->nPoints ) );
+
+    smithParallelFor( nPoints, PARALLEL_GRAIN * 4, stabilityRange, &job );
+}
+
+/*!     \brief  Draw a stability circle
+ *
+ * Shade the unstable region of the chart (in the region color) and draw the
+ * stability circle, or the chord of a straight boundary (in the line color)
+ *
+ * \ingroup stability
+ *
+ * \param cr            pointer to the cairo context
+ * \param pStability    pointer to the stability circle
+ * \param pOptions      pointer to options settings
+ */
+void
+drawStabilityOnSmithChart( cairo_t *cr, const tStabilityCircle *pStability, tSmithOptions *pOptions ) {
+    const tCircle *pCircle = &pStability->circle;
+    const tLine *pLine = &pStability->line;
+
+    if( pStability->bUnconditional || !isfinite( pCircle->center.U ) || !isfinite( pCircle->center.V ) )
+        return;
+
+    if( isfinite( pCircle->radius ) ) {
+        fillCircleOnSmithChart( cr, pCircle, pStability->bStableInside, pOptions );
+        drawCircleArrayOnSmithChart( cr, pCircle, 1, pOptions );
+    } else if( pLine->A.U == pLine->B.U && pLine->A.V == pLine->B.V ) {
+        // the whole chart is unstable
+        fillCircleOnSmithChart( cr, &(tCircle){ { 0.0, 0.0 }, SMITH_RADIUS }, FALSE, pOptions );
+    } else {
+        // the unstable side is on the right of A to B
+        fillHalfPlaneOnSmithChart( cr, &(tLine){ pLine->B, pLine->A }, pOptions );
+        drawLineArrayOnSmithChart( cr, (tUV []){ pLine->A, pLine->B }, 2, pOptions );
+    }
+}
+
+/*!     \brief  Clip to the stable side of a stability circle
+ *
+ * Restrict further drawing to the stable side of a stability circle (or of a
+ * straight boundary). Use between cairo_save() and cairo_restore().
+ *
+ * \ingroup stability
+ *
+ * \param cr            pointer to the cairo context
+ * \param pStability    pointer to the stability circle
+ * \param pOptions      pointer to options settings
+ */
+void
+clipStableOnSmithChart( cairo_t *cr, const tStabilityCircle *pStability, tSmithOptions *pOptions ) {
+    const tLine *pLine = &pStability->line;
+
+    if( pStability->bUnconditional )
+        return;
+
+    if( isfinite( pStability->circle.radius ) )
+        clipCircleOnSmithChart( cr, &pStability->circle, !pStability->bStableInside, pOptions );
+    else if( pLine->A.U == pLine->B.U && pLine->A.V == pLine->B.V )
+        // nothing is stable
+        clipCircleOnSmithChart( cr, &(tCircle){ { 0.0, 0.0 }, 0.0 }, FALSE, pOptions );
+    else
+        clipHalfPlaneOnSmithChart( cr, pLine, pOptions );
+}
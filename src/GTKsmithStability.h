@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHSTABILITY_H_
+#define GTKSMITHSTABILITY_H_
+
+#include "GTKsmithChart.h"
+
+typedef struct {
+    tCircle  circle;            // |gamma in| = 1 (load plane) or |gamma out| = 1 (source plane)
+                                // (radius INFINITY when the boundary is a straight line)
+    tLine    line;              // chord of a straight boundary across the chart, stable side on the left
+                                // of A to B (A == B if the line misses the chart)
+    gboolean bStableInside;     // the stable terminations are inside the circle
+    gboolean bUnconditional;    // no passive termination in this plane is unstable
+} tStabilityCircle;
+
+void stabilityCircles( const tSmithTrace *, const tSmithTrace *, const tSmithTrace *, const tSmithTrace *,
+        tStabilityCircle [], tStabilityCircle [] );
+void drawStabilityOnSmithChart( cairo_t *, const tStabilityCircle *, tSmithOptions * );
+void clipStableOnSmithChart( cairo_t *, const tStabilityCircle *, tSmithOptions * );
+
+#endif /* GTKSMITHSTABILITY_H_ */
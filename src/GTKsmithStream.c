@@ -0,0 +1,470 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithStream.c
+ * @brief Streaming sweeps from another process
+ *
+ * @author Michael G. Katzmann
+ *
+ * Sweeps are read from a file descriptor (e.g. stdin), a FIFO or a Unix domain
+ * socket by a background thread, as text lines or binary frames, and parsed
+ * into the traces of a small ring. The thread fills one trace while the latest
+ * complete sweep is kept for the chart and another may be being drawn.
+ *
+ * When a sweep completes, the drawing area is invalidated from the main loop,
+ * but only if the previous sweep has been acquired since the last invalidation,
+ * so the chart is redrawn at most once per frame however fast sweeps arrive.
+ *
+ * A FIFO is reopened when its writer closes it, so the producer may be
+ * restarted. A stream from stdin or a socket ends when the writer closes it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <glib-unix.h>
+#include "GTKsmithStream.h"
+#include "GTKsmithTrace.h"
+#include "GTKsmithParse.h"
+
+#define STREAM_READ_SIZE    (1 << 16)
+
+struct sSweepStream {
+    tStreamFormat format;
+    gint          fd;
+    gchar        *sFifo;            // path of a FIFO to reopen (or NULL)
+    gboolean      bCloseFd;
+    gint          stopPipe[2];
+    GThread      *pThread;
+    GtkWidget    *pWidget;
+    gint          bRedrawPending;   // (atomic)
+    gint          bOpen;            // (atomic)
+
+    GMutex        mutex;            // protects the slot indices and the sequence
+    tSmithTrace  *pSlots[ STREAM_SLOTS ];
+    gint          writing, latest, reading;
+    guint64       sequence;         // sweeps completed
+
+    GByteArray   *pBuffer;          // bytes read but not yet parsed
+};
+
+/*!     \brief  Invalidate the drawing area
+ *
+ * Queue a redraw of the drawing area (run in the main loop)
+ *
+ * \ingroup stream
+ *
+ * \param userData  the widget (a reference is released)
+ * \return          G_SOURCE_REMOVE
+ */
+static gboolean
+queueRedraw( gpointer userData ) {
+    GtkWidget *pWidget = userData;
+
+    gtk_widget_queue_draw( pWidget );
+    g_object_unref( pWidget );
+
+    return G_SOURCE_REMOVE;
+}
+
+/*!     \brief  Publish the sweep being written
+ *
+ * Make the sweep being written the latest, start writing another slot
+ * and invalidate the chart if it has drawn the previous sweep
+ *
+ * \ingroup stream
+ *
+ * \param pStream   pointer to the stream
+ */
+static void
+publishSweep( tSweepStream *pStream ) {
+    g_mutex_lock( &pStream->mutex );
+    pStream->latest = pStream->writing;
+    for( gint i = 0; i < STREAM_SLOTS; i++ ) {
+        if( i != pStream->latest && i != pStream->reading ) {
+            pStream->writing = i;
+            break;
+        }
+    }
+    pStream->sequence++;
+    g_mutex_unlock( &pStream->mutex );
+
+    pStream->pSlots[ pStream->writing ]->nPoints = 0;
+    if( pStream->pWidget && g_atomic_int_compare_and_exchange( &pStream->bRedrawPending, FALSE, TRUE ) )
+        g_idle_add( queueRedraw, g_object_ref( pStream->pWidget ) );
+}
+
+/*!     \brief  Parse text lines
+ *
+ * Parse the complete lines in the buffer into the sweep being written
+ *
+ * \ingroup stream
+ *
+ * \param pStream   pointer to the stream
+ */
+static void
+parseText( tSweepStream *pStream ) {
+    const gchar *pStart = (const gchar *)pStream->pBuffer->data;
+    const gchar *pEnd = pStart + pStream->pBuffer->len, *p = pStart;
+
+    for( const gchar *pNewline; (pNewline = memchr( p, '\n', pEnd - p )) != NULL; p = pNewline + 1 ) {
+        gdouble values[3];
+        gint n = 0;
+        const gchar *q = p;
+
+        while( n < 3 ) {
+            while( q < pNewline && (*q == ' ' || *q == '\t' || *q == '\r' || *q == ',') )
+                q++;
+            if( q == pNewline || (q = smithParseNumber( q, pNewline, &values[ n ] )) == NULL )
+                break;
+            n++;
+        }
+
+        if( n == 0 ) {
+            // a blank line ends the sweep (comments and other text are ignored)
+            if( q != NULL && pStream->pSlots[ pStream->writing ]->nPoints > 0 )
+                publishSweep( pStream );
+        } else if( n >= 2 ) {
+            tSmithTrace *pTrace = pStream->pSlots[ pStream->writing ];
+
+            if( n == 3 )
+                smithTraceAppend( pTrace, (tUV){ values[1], values[2] }, values[0] );
+            else
+                smithTraceAppend( pTrace, (tUV){ values[0], values[1] }, pTrace->nPoints );
+        }
+    }
+    g_byte_array_remove_range( pStream->pBuffer, 0, p - pStart );
+}
+
+/*!     \brief  Parse binary frames
+ *
+ * Copy the complete frames in the buffer into sweeps
+ *
+ * \ingroup stream
+ *
+ * \param pStream   pointer to the stream
+ * \return          FALSE if the data is not a stream of frames
+ */
+static gboolean
+parseFrames( tSweepStream *pStream ) {
+    gsize used = 0;
+
+    while( pStream->pBuffer->len - used >= sizeof( tStreamFrameHeader ) ) {
+        tStreamFrameHeader header;
+        gsize arrays, frameBytes;
+        const gdouble *pArrays;
+        tSmithTrace *pTrace = pStream->pSlots[ pStream->writing ];
+
+        memcpy( &header, pStream->pBuffer->data + used, sizeof( header ) );
+        if( header.magic != STREAM_FRAME_MAGIC || header.nPoints > G_MAXINT / 2 )
+            return FALSE;
+        arrays = ( header.flags & STREAM_FRAME_FREQUENCY ) ? 3 : 2;
+        frameBytes = sizeof( header ) + arrays * header.nPoints * sizeof( gdouble );
+        if( pStream->pBuffer->len - used < frameBytes )
+            break;
+
+        // the arrays may not be aligned in the buffer
+        pArrays = (const gdouble *)(pStream->pBuffer->data + used + sizeof( header ));
+        smithTraceReserve( pTrace, header.nPoints );
+        if( header.flags & STREAM_FRAME_FREQUENCY ) {
+            memcpy( pTrace->pFreq, pArrays, header.nPoints * sizeof( gdouble ) );
+            pArrays += header.nPoints;
+        } else {
+            for( guint i = 0; i < header.nPoints; i++ )
+                pTrace->pFreq[i] = i;
+        }
+        memcpy( pTrace->pU, pArrays, header.nPoints * sizeof( gdouble ) );
+        memcpy( pTrace->pV, pArrays + header.nPoints, header.nPoints * sizeof( gdouble ) );
+        pTrace->nPoints = header.nPoints;
+        publishSweep( pStream );
+        used += frameBytes;
+    }
+    g_byte_array_remove_range( pStream->pBuffer, 0, used );
+
+    return TRUE;
+}
+
+/*!     \brief  Open a FIFO for reading
+ *
+ * Open a FIFO for reading without waiting for a writer
+ *
+ * \ingroup stream
+ *
+ * \param sPath     path of the FIFO
+ * \return          file descriptor (or -1)
+ */
+static gint
+openFifo( const gchar *sPath ) {
+    return open( sPath, O_RDONLY | O_NONBLOCK | O_CLOEXEC );
+}
+
+/*!     \brief  Thread reading the stream
+ *
+ * Read and parse the stream until it ends or the stream is freed
+ *
+ * \ingroup stream
+ *
+ * \param userData  pointer to the stream
+ * \return          NULL
+ */
+static gpointer
+streamThread( gpointer userData ) {
+    tSweepStream *pStream = userData;
+    guint8 *pRead = g_malloc( STREAM_READ_SIZE );
+
+    for( ;; ) {
+        GPollFD fds[2] = { { pStream->fd, G_IO_IN | G_IO_HUP | G_IO_ERR, 0 },
+                           { pStream->stopPipe[0], G_IO_IN, 0 } };
+        gssize n;
+
+        if( g_poll( fds, 2, -1 ) < 0 && errno != EINTR )
+            break;
+        if( fds[1].revents )
+            break;
+        if( fds[0].revents == 0 )
+            continue;
+
+        n = read( pStream->fd, pRead, STREAM_READ_SIZE );
+        if( n < 0 && (errno == EAGAIN || errno == EINTR) )
+            continue;
+        if( n <= 0 ) {
+            // the writer has gone; wait for another on a FIFO
+            if( n == 0 && pStream->sFifo ) {
+                close( pStream->fd );
+                if( (pStream->fd = openFifo( pStream->sFifo )) >= 0 )
+                    continue;
+            }
+            break;
+        }
+
+        g_byte_array_append( pStream->pBuffer, pRead, n );
+        if( pStream->format == eStreamText )
+            parseText( pStream );
+        else if( !parseFrames( pStream ) )
+            break;
+    }
+
+    g_atomic_int_set( &pStream->bOpen, FALSE );
+    g_free( pRead );
+    return NULL;
+}
+
+/*!     \brief  Start a stream
+ *
+ * Create the stream and start its thread
+ *
+ * \ingroup stream
+ *
+ * \param fd        file descriptor to read
+ * \param format    text or binary
+ * \param pWidget   drawing area to invalidate when a sweep arrives (or NULL)
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the stream, or NULL on error
+ */
+static tSweepStream *
+streamStart( gint fd, tStreamFormat format, GtkWidget *pWidget, GError **ppError ) {
+    tSweepStream *pStream = g_new0( tSweepStream, 1 );
+
+    if( !g_unix_open_pipe( pStream->stopPipe, FD_CLOEXEC, ppError ) ) {
+        g_free( pStream );
+        return NULL;
+    }
+    // (the descriptor is left blocking, as it may be shared, e.g. stdin: it is only read when g_poll() finds data)
+
+    pStream->format = format;
+    pStream->fd = fd;
+    pStream->pWidget = pWidget ? g_object_ref( pWidget ) : NULL;
+    pStream->bOpen = TRUE;
+    g_mutex_init( &pStream->mutex );
+    for( gint i = 0; i < STREAM_SLOTS; i++ )
+        pStream->pSlots[i] = smithTraceNew( 1024, TRUE );
+    pStream->writing = 0;
+    pStream->latest = pStream->reading = -1;
+    pStream->pBuffer = g_byte_array_sized_new( STREAM_READ_SIZE );
+    pStream->pThread = g_thread_new( "sweep stream", streamThread, pStream );
+
+    return pStream;
+}
+
+/*!     \brief  Stream sweeps from a file descriptor
+ *
+ * Read sweeps from a file descriptor (e.g. 0 for stdin) in a background thread.
+ * The descriptor is not closed by sweepStreamFree().
+ *
+ * \ingroup stream
+ *
+ * \param fd        file descriptor
+ * \param format    text or binary
+ * \param pWidget   drawing area to invalidate when a sweep arrives (or NULL)
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the stream (free with sweepStreamFree), or NULL on error
+ */
+tSweepStream *
+sweepStreamOpenFd( gint fd, tStreamFormat format, GtkWidget *pWidget, GError **ppError ) {
+    return streamStart( fd, format, pWidget, ppError );
+}
+
+/*!     \brief  Stream sweeps from a FIFO or Unix domain socket
+ *
+ * Read sweeps from a FIFO (reopened whenever its writer closes it) or by
+ * connecting to a Unix domain socket, in a background thread
+ *
+ * \ingroup stream
+ *
+ * \param sPath     path of the FIFO or socket
+ * \param format    text or binary
+ * \param pWidget   drawing area to invalidate when a sweep arrives (or NULL)
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the stream (free with sweepStreamFree), or NULL on error
+ */
+tSweepStream *
+sweepStreamOpenPath( const gchar *sPath, tStreamFormat format, GtkWidget *pWidget, GError **ppError ) {
+    struct stat status;
+    tSweepStream *pStream;
+    gint fd;
+
+    if( stat( sPath, &status ) != 0 ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ), "%s: %s", sPath, g_strerror( errno ) );
+        return NULL;
+    }
+
+    if( S_ISSOCK( status.st_mode ) ) {
+        struct sockaddr_un address = { .sun_family = AF_UNIX };
+
+        if( strlen( sPath ) >= sizeof( address.sun_path ) ) {
+            g_set_error( ppError, G_FILE_ERROR, G_FILE_ERROR_NAMETOOLONG, "%s: path too long", sPath );
+            return NULL;
+        }
+        strcpy( address.sun_path, sPath );
+        fd = socket( AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0 );
+        if( fd >= 0 && connect( fd, (struct sockaddr *)&address, sizeof( address ) ) != 0 ) {
+            close( fd );
+            fd = -1;
+        }
+    } else {
+        fd = S_ISFIFO( status.st_mode ) ? openFifo( sPath ) : open( sPath, O_RDONLY | O_CLOEXEC );
+    }
+    if( fd < 0 ) {
+        g_set_error( ppError, G_FILE_ERROR, g_file_error_from_errno( errno ), "%s: %s", sPath, g_strerror( errno ) );
+        return NULL;
+    }
+
+    if( (pStream = streamStart( fd, format, pWidget, ppError )) == NULL ) {
+        close( fd );
+        return NULL;
+    }
+    pStream->bCloseFd = TRUE;
+    if( S_ISFIFO( status.st_mode ) )
+        pStream->sFifo = g_strdup( sPath );
+
+    return pStream;
+}
+
+/*!     \brief  Stop and free a stream
+ *
+ * Stop the thread of a stream and free it
+ *
+ * \ingroup stream
+ *
+ * \param pStream   pointer to the stream
+ */
+void
+sweepStreamFree( tSweepStream *pStream ) {
+    if( pStream == NULL )
+        return;
+
+    while( write( pStream->stopPipe[1], "x", 1 ) < 0 && errno == EINTR )
+        ;
+    g_thread_join( pStream->pThread );
+
+    if( pStream->bCloseFd && pStream->fd >= 0 )
+        close( pStream->fd );
+    close( pStream->stopPipe[0] );
+    close( pStream->stopPipe[1] );
+    for( gint i = 0; i < STREAM_SLOTS; i++ )
+        smithTraceFree( pStream->pSlots[i] );
+    g_byte_array_unref( pStream->pBuffer );
+    g_mutex_clear( &pStream->mutex );
+    g_clear_object( &pStream->pWidget );
+    g_free( pStream->sFifo );
+    g_free( pStream );
+}
+
+/*!     \brief  Acquire the latest sweep
+ *
+ * Acquire the latest complete sweep for drawing. It is not changed until
+ * sweepStreamRelease() is called (call it before acquiring again).
+ *
+ * \ingroup stream
+ *
+ * \param pStream       pointer to the stream
+ * \param pSequence     where the number of the sweep is written (or NULL)
+ * \return              the latest sweep (or NULL if none has arrived)
+ */
+const tSmithTrace *
+sweepStreamAcquire( tSweepStream *pStream, guint64 *pSequence ) {
+    const tSmithTrace *pTrace = NULL;
+
+    // the next sweep may invalidate the chart again
+    g_atomic_int_set( &pStream->bRedrawPending, FALSE );
+
+    g_mutex_lock( &pStream->mutex );
+    pStream->reading = pStream->latest;
+    if( pStream->reading >= 0 )
+        pTrace = pStream->pSlots[ pStream->reading ];
+    if( pSequence )
+        *pSequence = pStream->sequence;
+    g_mutex_unlock( &pStream->mutex );
+
+    return pTrace;
+}
+
+/*!     \brief  Release the acquired sweep
+ *
+ * Release the sweep acquired by sweepStreamAcquire()
+ *
+ * \ingroup stream
+ *
+ * \param pStream   pointer to the stream
+ */
+void
+sweepStreamRelease( tSweepStream *pStream ) {
+    g_mutex_lock( &pStream->mutex );
+    pStream->reading = -1;
+    g_mutex_unlock( &pStream->mutex );
+}
+
+/*!     \brief  Is the stream still open
+ *
+ * Is the stream still being read (FALSE when the writer has closed stdin or
+ * the socket, or the data was not valid)
+ *
+ * \ingroup stream
+ *
+ * \param pStream   pointer to the stream
+ * \return          TRUE if sweeps may still arrive
+ */
+gboolean
+sweepStreamIsOpen( tSweepStream *pStream ) {
+    return g_atomic_int_get( &pStream->bOpen );
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHSTREAM_H_
+#define GTKSMITHSTREAM_H_
+
+#include "GTKsmithChart.h"
+
+typedef enum {
+    eStreamText,        // a point per line "frequency real imaginary" (or "real imaginary"), a blank line ends a sweep
+    eStreamBinary       // frames of a tStreamFrameHeader followed by the arrays
+} tStreamFormat;
+
+// Header of a binary frame, followed by nPoints doubles of frequency (if STREAM_FRAME_FREQUENCY),
+// of the real parts and of the imaginary parts (in the byte order of the machine)
+typedef struct {
+    guint32 magic;          // STREAM_FRAME_MAGIC
+    guint32 nPoints;
+    guint32 flags;
+    guint32 reserved;
+} tStreamFrameHeader;
+
+#define STREAM_FRAME_MAGIC      0x31505753      // "SWP1"
+#define STREAM_FRAME_FREQUENCY  0x1
+// Sweeps held by the stream (the one being read, the latest and the one being drawn)
+#define STREAM_SLOTS            3
+
+typedef struct sSweepStream tSweepStream;
+
+tSweepStream *sweepStreamOpenFd( gint, tStreamFormat, GtkWidget *, GError ** );
+tSweepStream *sweepStreamOpenPath( const gchar *, tStreamFormat, GtkWidget *, GError ** );
+void sweepStreamFree( tSweepStream * );
+const tSmithTrace *sweepStreamAcquire( tSweepStream *, guint64 * );
+void sweepStreamRelease( tSweepStream * );
+gboolean sweepStreamIsOpen( tSweepStream * );
+
+#endif /* GTKSMITHSTREAM_H_ */
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithStub.c
+ * @brief Stub tuners
+ *
+ * @author Michael G. Katzmann
+ *
+ * Moving toward the generator along a line rotates gamma clockwise around the
+ * constant |gamma| circle. A single stub tuner is placed where the circle of
+ * the load meets the G=1 circle (shunt stub) or R=1 circle (series stub),
+ * and the stub cancels the susceptance (or reactance) there.
+ *
+ * With |gamma| = p, the G=1 circle is where U = -p^2 and the R=1 circle where
+ * U = p^2, so the stub positions are at the angles whose cosine is -p (or p).
+ *
+ * A double stub tuner has shunt stubs a fixed distance apart. The first stub
+ * moves the admittance along its G circle to the G=1 circle rotated toward
+ * the load by that distance, so that the line between the stubs brings it to
+ * the G=1 circle where the second stub cancels the remaining susceptance.
+ *
+ * The "wavelengths toward generator" scale of drawWavelengthRing() reads
+ * 0 at angle pi and increases clockwise by 0.5 per turn.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "GTKsmithStub.h"
+#include "GTKsmithMatch.h"
+#include "GTKsmithParallel.h"
+
+/*!     \brief  Length of a stub whose immittance is j tan(beta l)
+ *
+ * Length of a stub (shunt open or series short) giving a normalized immittance
+ *
+ * \ingroup stub
+ *
+ * \param immittance    normalized susceptance or reactance
+ * \return              length in wavelengths (0 to 0.5)
+ */
+static gdouble
+tanStubLength( gdouble immittance ) {
+    gdouble betaL = atan( immittance );
+
+    return ( betaL < 0.0 ? betaL + M_PI : betaL ) / (2.0 * M_PI);
+}
+
+/*!     \brief  Length of a stub whose immittance is -j cot(beta l)
+ *
+ * Length of a stub (shunt short or series open) giving a normalized immittance
+ *
+ * \ingroup stub
+ *
+ * \param immittance    normalized susceptance or reactance
+ * \return              length in wavelengths (0 to 0.5)
+ */
+static gdouble
+cotStubLength( gdouble immittance ) {
+    return atan2( 1.0, -immittance ) / (2.0 * M_PI);
+}
+
+/*!     \brief  Reading of a point on the wavelength ring
+ *
+ * The "wavelengths toward generator" reading of the radial through a point
+ *
+ * \ingroup stub
+ *
+ * \param uv        point in gamma space
+ * \return          the reading and its position on the ring
+ */
+tRingReadout
+wavelengthRingReadout( tUV uv ) {
+    gdouble angle = atan2( uv.V, uv.U );
+    gdouble wavelengths = fmod( (M_PI - angle) / (4.0 * M_PI), 0.5 );
+
+    return (tRingReadout){ wavelengths < 0.0 ? wavelengths + 0.5 : wavelengths,
+                           { WAVE_RING_RADIUS * cos( angle ), WAVE_RING_RADIUS * sin( angle ) } };
+}
+
+/*!     \brief  Rotate gamma along a line
+ *
+ * Move gamma along a line toward the generator
+ *
+ * \ingroup stub
+ *
+ * \param uv            gamma
+ * \param wavelengths   length of the line
+ * \return              gamma at the other end
+ */
+static tUV
+rotateGamma( tUV uv, gdouble wavelengths ) {
+    gdouble c = cos( 4.0 * M_PI * wavelengths ), s = sin( 4.0 * M_PI * wavelengths );
+
+    return (tUV){ uv.U * c + uv.V * s, uv.V * c - uv.U * s };
+}
+
+/*!     \brief  Solve a single stub tuner
+ *
+ * Find the (up to two) positions and lengths of a single stub matching a load
+ *
+ * \ingroup stub
+ *
+ * \param gammaLoad     reflection coefficient of the load
+ * \param connection    shunt or series stub
+ * \param pStub         where the solutions are written
+ * \return              TRUE if there is a solution
+ */
+gboolean
+solveSingleStub( tUV gammaLoad, tStubConnection connection, tSingleStub *pStub ) {
+    gdouble magnitude = hypot( gammaLoad.U, gammaLoad.V );
+    gdouble angleLoad = atan2( gammaLoad.V, gammaLoad.U );
+    gdouble sign = ( connection == eStubShunt ) ? -1.0 : 1.0;
+
+    pStub->nSolutions = 0;
+    pStub->swrCircle = (tCircle){ { 0.0, 0.0 }, magnitude };
+    pStub->matchCircle = (tCircle){ { sign * 0.5, 0.0 }, 0.5 };
+    pStub->ringLoad = wavelengthRingReadout( gammaLoad );
+    if( !(magnitude < 1.0) )
+        return FALSE;
+
+    for( gint i = 0; i < 2; i++ ) {
+        tStubSolution *pSolution = &pStub->solution[ pStub->nSolutions ];
+        gdouble angle = ( i == 0 ? 1.0 : -1.0 ) * acos( sign * magnitude );
+        gdouble distance = fmod( (angleLoad - angle) / (4.0 * M_PI), 0.5 );
+        tRX rx;
+
+        // a matched load needs no stub and has one solution
+        if( magnitude == 0.0 && i > 0 )
+            break;
+
+        pSolution->distance = distance < 0.0 ? distance + 0.5 : distance;
+        pSolution->uvStub = rotateGamma( gammaLoad, pSolution->distance );
+        pSolution->ringStub = wavelengthRingReadout( pSolution->uvStub );
+        pSolution->path[0] = lineArc( gammaLoad, pSolution->distance );
+
+        rx = UVtoRX( pSolution->uvStub );
+        if( connection == eStubShunt ) {
+            gdouble b = -rx.X / (SQU(rx.R) + SQU(rx.X));
+
+            pSolution->immittance = -b;
+            pSolution->lengthShort = cotStubLength( -b );
+            pSolution->lengthOpen = tanStubLength( -b );
+            pSolution->path[1] = constantGarc( 1.0, b, 0.0 );
+        } else {
+            pSolution->immittance = -rx.X;
+            pSolution->lengthShort = tanStubLength( -rx.X );
+            pSolution->lengthOpen = cotStubLength( -rx.X );
+            pSolution->path[1] = constantRarc( 1.0, rx.X, 0.0 );
+        }
+        pStub->nSolutions++;
+    }
+
+    return pStub->nSolutions > 0;
+}
+
+/*!     \brief  Solve a double stub tuner
+ *
+ * Find the (up to two) pairs of shunt stub susceptances and lengths of
+ * a double stub tuner matching a load
+ *
+ * \ingroup stub
+ *
+ * \param gammaLoad     reflection coefficient of the load
+ * \param distance      wavelengths from the load to the first stub
+ * \param spacing       wavelengths between the stubs (not a multiple of 0.25)
+ * \param pStub         where the solutions are written
+ * \return              TRUE if there is a solution (the admittance at the first
+ *                      stub is not in the region the tuner cannot match)
+ */
+gboolean
+solveDoubleStub( tUV gammaLoad, gdouble distance, gdouble spacing, tDoubleStub *pStub ) {
+    tUV uvFirst = rotateGamma( gammaLoad, distance );
+    tRX z = UVtoRX( uvFirst );
+    gdouble magSqu = SQU(z.R) + SQU(z.X);
+    gdouble g = z.R / magSqu, b = -z.X / magSqu;
+    gdouble t = tan( 2.0 * M_PI * spacing );
+    gdouble radicand = (1.0 + SQU(t)) * g - SQU(g * t);
+    gdouble rotation = 4.0 * M_PI * spacing;
+
+    pStub->nSolutions = 0;
+    pStub->rotatedCircle = (tCircle){ { -0.5 * cos( rotation ), -0.5 * sin( rotation ) }, 0.5 };
+    pStub->ringLoad = wavelengthRingReadout( gammaLoad );
+    pStub->ringStub = wavelengthRingReadout( uvFirst );
+    if( !(radicand >= 0.0) || !isfinite( t ) || fabs( t ) < 1.0e-9 || !(g > 0.0) )
+        return FALSE;
+
+    for( gint sign = 1; sign >= -1; sign -= 2 ) {
+        tDoubleStubSolution *pSolution = &pStub->solution[ pStub->nSolutions++ ];
+        gdouble root = sign * sqrt( radicand );
+        // susceptance after the first stub, and at the second stub before it
+        gdouble bAfter = (1.0 + root) / t;
+        gdouble b2 = (root + g) / (g * t);
+        tUV uvSecond = rotateGamma( RXtoUV( (tRX){ g / (SQU(g) + SQU(bAfter)), -bAfter / (SQU(g) + SQU(bAfter)) } ),
+                                    spacing );
+        tRX zSecond = UVtoRX( uvSecond );
+        gdouble bSecond = -zSecond.X / (SQU(zSecond.R) + SQU(zSecond.X));
+
+        pSolution->immittance[0] = bAfter - b;
+        pSolution->immittance[1] = b2;
+        for( gint i = 0; i < 2; i++ ) {
+            pSolution->lengthShort[i] = cotStubLength( pSolution->immittance[i] );
+            pSolution->lengthOpen[i] = tanStubLength( pSolution->immittance[i] );
+        }
+        pSolution->path[0] = lineArc( gammaLoad, distance );
+        pSolution->path[1] = constantGarc( g, b, bAfter );
+        pSolution->path[2] = lineArc( rotateGamma( uvSecond, -spacing ), spacing );
+        pSolution->path[3] = constantGarc( 1.0, bSecond, 0.0 );
+        if( root == 0.0 )
+            break;
+    }
+
+    return TRUE;
+}
+
+typedef struct {
+    const tSmithTrace *pLoad;
+    tStubConnection    connection;
+    gdouble            distance, spacing;
+    gpointer           pResults;
+} tStubSweep;
+
+static void
+singleStubRange( gint from, gint to, gpointer userData ) {
+    tStubSweep *pSweep = userData;
+    tSingleStub *pResults = pSweep->pResults;
+
+    for( gint i = from; i < to; i++ )
+        solveSingleStub( (tUV){ pSweep->pLoad->pU[i], pSweep->pLoad->pV[i] }, pSweep->connection,
+                &pResults[i] );
+}
+
+static void
+doubleStubRange( gint from, gint to, gpointer userData ) {
+    tStubSweep *pSweep = userData;
+    tDoubleStub *pResults = pSweep->pResults;
+
+    for( gint i = from; i < to; i++ )
+        solveDoubleStub( (tUV){ pSweep->pLoad->pU[i], pSweep->pLoad->pV[i] }, pSweep->distance,
+                pSweep->spacing, &pResults[i] );
+}
+
+/*!     \brief  Solve a single stub tuner for every point of a trace
+ *
+ * Solve a single stub tuner for every point of a trace (in parallel)
+ *
+ * \ingroup stub
+ *
+ * \param pLoad         pointer to the load trace
+ * \param connection    shunt or series stub
+ * \param results       array (of the points of the trace) where the solutions are written
+ */
+void
+solveSingleStubSweep( const tSmithTrace *pLoad, tStubConnection connection, tSingleStub results[] ) {
+    tStubSweep sweep = { pLoad, connection, 0.0, 0.0, results };
+
+    smithParallelFor( pLoad->nPoints, PARALLEL_GRAIN, singleStubRange, &sweep );
+}
+
+/*!     \brief  Solve a double stub tuner for every point of a trace
+ *
+ * Solve a double stub tuner for every point of a trace (in parallel)
+ *
+ * \ingroup stub
+ *
+ * \param pLoad         pointer to the load trace
+ * \param distance      wavelengths from the load to the first stub
+ * \param spacing       wavelengths between the stubs
+ * \param results       array (of the points of the trace) where the solutions are written
+ */
+void
+solveDoubleStubSweep( const tSmithTrace *pLoad, gdouble distance, gdouble spacing, tDoubleStub results[] ) {
+    tStubSweep sweep = { pLoad, eStubShunt, distance, spacing, results };
+
+    smithParallelFor( pLoad->nPoints, PARALLEL_GRAIN, doubleStubRange, &sweep );
+}
+
+/*!     \brief  Annotate a reading on the wavelength ring
+ *
+ * Mark a reading on the wavelength ring and label it with its value
+ *
+ * \ingroup stub
+ *
+ * \param cr        pointer to cairo structure
+ * \param pReadout  pointer to the reading
+ * \param pOptions  pointer to the chart options
+ */
+static void
+annotateRingReadout( cairo_t *cr, const tRingReadout *pReadout, tSmithOptions *pOptions ) {
+    gchar sLabel[ 16 ];
+
+    g_snprintf( sLabel, sizeof( sLabel ), "%.3fλ", pReadout->wavelengths );
+    drawPointOnSmithChart( cr, pReadout->uv, pOptions );
+    annotatePointOnSmithChart( cr, sLabel, pReadout->uv, pReadout->uv.U < 0.0, pOptions );
+}
+
+/*!     \brief  Draw the solutions of a single stub tuner
+ *
+ * Draw the constant |gamma| circle of the load, the G=1 (or R=1) circle and the
+ * path of each solution, and mark the load and stub positions on the wavelength ring
+ *
+ * \ingroup stub
+ *
+ * \param cr        pointer to cairo structure
+ * \param pStub     pointer to the solutions from solveSingleStub()
+ * \param pOptions  pointer to the chart options
+ */
+void
+drawSingleStubOnSmithChart( cairo_t *cr, const tSingleStub *pStub, tSmithOptions *pOptions ) {
+    tCircle circles[] = { pStub->swrCircle, pStub->matchCircle };
+
+    drawCircleArrayOnSmithChart( cr, circles, G_N_ELEMENTS( circles ), pOptions );
+    annotateRingReadout( cr, &pStub->ringLoad, pOptions );
+    for( gint i = 0; i < pStub->nSolutions; i++ ) {
+        drawArcArrayOnSmithChart( cr, pStub->solution[i].path, 2, pOptions );
+        annotateRingReadout( cr, &pStub->solution[i].ringStub, pOptions );
+    }
+}
+
+/*!     \brief  Draw the solutions of a double stub tuner
+ *
+ * Draw the rotated G=1 circle and the path of each solution,
+ * and mark the load and first stub positions on the wavelength ring
+ *
+ * \ingroup stub
+ *
+ * \param cr        pointer to cairo structure
+ * \param pStub     pointer to the solutions from solveDoubleStub()
+ * \param pOptions  pointer to the chart options
+ */
+void
+drawDoubleStubOnSmithChart( cairo_t *cr, const tDoubleStub *pStub, tSmithOptions *pOptions ) {
+    drawCircleArrayOnSmithChart( cr, &pStub->rotatedCircle, 1, pOptions );
+    annotateRingReadout( cr, &pStub->ringLoad, pOptions );
+    annotateRingReadout( cr, &pStub->ringStub, pOptions );
+    for( gint i = 0; i < pStub->nSolutions; i++ )
+        drawArcArrayOnSmithChart( cr, pStub->solution[i].path, 4, pOptions );
+}
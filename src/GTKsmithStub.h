@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHSTUB_H_
+#define GTKSMITHSTUB_H_
+
+#include "GTKsmithChart.h"
+
+typedef enum {
+    eStubShunt, eStubSeries
+} tStubConnection;
+
+// A reading on the wavelength ring ("wavelengths toward generator")
+typedef struct {
+    gdouble wavelengths;
+    tUV     uv;             // position on the ring
+} tRingReadout;
+
+typedef struct {
+    gdouble      distance;      // wavelengths from the load to the stub
+    gdouble      immittance;    // normalized susceptance (shunt) or reactance (series) of the stub
+    gdouble      lengthShort;   // wavelengths of a short circuited stub
+    gdouble      lengthOpen;    // wavelengths of an open circuited stub
+    tUV          uvStub;        // gamma (on the line) where the stub is connected
+    tRingReadout ringStub;
+    tArc         path[2];       // along the line to the stub, then by the stub to the center
+} tStubSolution;
+
+typedef struct {
+    gint          nSolutions;
+    tStubSolution solution[2];
+    tCircle       swrCircle;    // the constant |gamma| circle of the load
+    tCircle       matchCircle;  // G=1 (shunt) or R=1 (series) circle
+    tRingReadout  ringLoad;
+} tSingleStub;
+
+typedef struct {
+    gdouble      immittance[2]; // normalized susceptance of the stubs (first at the load side)
+    gdouble      lengthShort[2];
+    gdouble      lengthOpen[2];
+    tArc         path[4];       // to the first stub, by the first stub, to the second stub, by the second stub
+} tDoubleStubSolution;
+
+typedef struct {
+    gint                nSolutions;
+    tDoubleStubSolution solution[2];
+    tCircle             rotatedCircle;  // G=1 circle rotated toward the load by the stub spacing
+    tRingReadout        ringLoad, ringStub;
+} tDoubleStub;
+
+tRingReadout wavelengthRingReadout( tUV );
+gboolean solveSingleStub( tUV, tStubConnection, tSingleStub * );
+gboolean solveDoubleStub( tUV, gdouble, gdouble, tDoubleStub * );
+void solveSingleStubSweep( const tSmithTrace *, tStubConnection, tSingleStub [] );
+void solveDoubleStubSweep( const tSmithTrace *, gdouble, gdouble, tDoubleStub [] );
+void drawSingleStubOnSmithChart( cairo_t *, const tSingleStub *, tSmithOptions * );
+void drawDoubleStubOnSmithChart( cairo_t *, const tDoubleStub *, tSmithOptions * );
+
+#endif /* GTKSMITHSTUB_H_ */
@@ -0,0 +1,439 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithSynthesis.c
+ * @brief Matching networks of catalogue (E series) parts
+ *
+ * @author Michael G. Katzmann
+ *
+ * Every ladder of two or three alternating series and shunt elements, each
+ * an inductor or capacitor of an E12 or E24 value, is evaluated over a band
+ * of a load trace and scored by its worst |gamma in|. Only values whose
+ * immittance at the center of the band is between SYNTHESIS_MIN_IMMITTANCE
+ * and its inverse are considered, the others having little effect or acting
+ * as a short or open.
+ *
+ * The search is split into items (a topology, the kinds of its elements and
+ * the value of the element at the load) which the workers claim dynamically.
+ * Within an item the impedance after each element is kept for every
+ * frequency so that only the elements downstream of a change are re-evaluated.
+ * Two bounds prune the search against the Nth best network found so far:
+ * before the last element, the best |gamma| it could reach at each frequency
+ * (the distance of the impedance from the R=1 or G=1 circle) is a lower bound
+ * for its whole range of values, and the evaluation of a candidate stops at
+ * the first frequency where it is worse.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <complex.h>
+#include "GTKsmithSynthesis.h"
+#include "GTKsmithParallel.h"
+
+// Smallest normalized reactance or susceptance of a part considered
+#define SYNTHESIS_MIN_IMMITTANCE    0.01
+
+static const gdouble E12[] = { 1.0, 1.2, 1.5, 1.8, 2.2, 2.7, 3.3, 3.9, 4.7, 5.6, 6.8, 8.2 };
+static const gdouble E24[] = { 1.0, 1.1, 1.2, 1.3, 1.5, 1.6, 1.8, 2.0, 2.2, 2.4, 2.7, 3.0,
+                               3.3, 3.6, 3.9, 4.3, 4.7, 5.1, 5.6, 6.2, 6.8, 7.5, 8.2, 9.1 };
+
+// The parts of one kind (e.g. series inductors) and their immittance at each frequency
+typedef struct {
+    gint     nValues;
+    gdouble *pValues;           // H or F
+    gdouble *pImmittance;       // nValues x nFrequencies
+} tPartList;
+
+typedef struct {
+    gint        nElements;
+    gboolean    bSeriesFirst;   // the element at the load is in series
+    gint        kinds;          // bit i set if element i is an inductor
+} tTopology;
+
+typedef struct {
+    tTopology topology;
+    gint      value[ MAX_LADDER_ELEMENTS ];
+    gdouble   worstGamma;
+} tCandidate;
+
+typedef struct {
+    gint             nFrequencies;
+    double complex  *pLoad;                     // normalized load impedance at each frequency
+    tPartList        parts[4];                  // indexed by tElementType
+    GArray          *pTopologies;               // of tTopology
+    GArray          *pItemStart;                // first item of each topology (of gint)
+
+    gint             nBest;
+    GMutex           mutex;
+    tCandidate      *pBest;                     // sorted best first (protected by mutex)
+    gint             nFound;
+    gdouble          threshold;                 // worst gamma of the Nth best (protected by mutex)
+} tSynthesis;
+
+/*!     \brief  Type of an element of a topology
+ *
+ * Type of an element of a topology
+ *
+ * \ingroup synthesis
+ *
+ * \param pTopology pointer to the topology
+ * \param i         position of the element (0 at the load)
+ * \return          element type
+ */
+static tElementType
+elementType( const tTopology *pTopology, gint i ) {
+    gboolean bSeries = ( (i % 2) == 0 ) == pTopology->bSeriesFirst;
+    gboolean bInductor = ( pTopology->kinds >> i ) & 1;
+
+    if( bSeries )
+        return bInductor ? eSeriesL : eSeriesC;
+    return bInductor ? eShuntL : eShuntC;
+}
+
+/*!     \brief  Normalized immittance of a part
+ *
+ * Normalized reactance (series) or susceptance (shunt) of a part
+ *
+ * \ingroup synthesis
+ *
+ * \param type      element type
+ * \param value     H or F
+ * \param omega     angular frequency
+ * \param Z0        characteristic impedance
+ * \return          normalized immittance
+ */
+static gdouble
+partImmittance( tElementType type, gdouble value, gdouble omega, gdouble Z0 ) {
+    switch( type ) {
+    case eSeriesL:  return omega * value / Z0;
+    case eSeriesC:  return -1.0 / (omega * value * Z0);
+    case eShuntL:   return -Z0 / (omega * value);
+    case eShuntC:
+    default:        return omega * value * Z0;
+    }
+}
+
+/*!     \brief  Impedance after adding an element
+ *
+ * Impedance after adding a series reactance or shunt susceptance
+ *
+ * \ingroup synthesis
+ *
+ * \param z         normalized impedance
+ * \param bSeries   series element
+ * \param immittance    normalized reactance or susceptance of the element
+ * \return          the new impedance
+ */
+static inline double complex
+addElement( double complex z, gboolean bSeries, gdouble immittance ) {
+    if( bSeries )
+        return z + I * immittance;
+    return 1.0 / (1.0 / z + I * immittance);
+}
+
+/*!     \brief  Offer a network to the best list
+ *
+ * Add a network to the list of the best if it is better than the Nth best
+ *
+ * \ingroup synthesis
+ *
+ * \param pSynthesis    pointer to the search
+ * \param pCandidate    pointer to the network
+ * \return              the (new) worst gamma of the Nth best
+ */
+static gdouble
+offerCandidate( tSynthesis *pSynthesis, const tCandidate *pCandidate ) {
+    gdouble threshold;
+
+    g_mutex_lock( &pSynthesis->mutex );
+    if( pCandidate->worstGamma < pSynthesis->threshold ) {
+        gint position = MIN( pSynthesis->nFound, pSynthesis->nBest - 1 );
+
+        for( ; position > 0 && pSynthesis->pBest[ position - 1 ].worstGamma > pCandidate->worstGamma; position-- )
+            pSynthesis->pBest[ position ] = pSynthesis->pBest[ position - 1 ];
+        pSynthesis->pBest[ position ] = *pCandidate;
+        pSynthesis->nFound = MIN( pSynthesis->nFound + 1, pSynthesis->nBest );
+        if( pSynthesis->nFound == pSynthesis->nBest )
+            pSynthesis->threshold = pSynthesis->pBest[ pSynthesis->nBest - 1 ].worstGamma;
+    }
+    threshold = pSynthesis->threshold;
+    g_mutex_unlock( &pSynthesis->mutex );
+
+    return threshold;
+}
+
+/*!     \brief  Search the values of the elements from a position on
+ *
+ * Depth first search over the values of elements 'depth' onwards
+ *
+ * \ingroup synthesis
+ *
+ * \param pSynthesis    pointer to the search
+ * \param pCandidate    pointer to the network (values up to depth - 1 set)
+ * \param depth         position of the element to vary
+ * \param pZ            impedances at each frequency for each depth (row 0 is the load)
+ * \param pThreshold    pointer to the current threshold (updated)
+ * \param pWorstFirst   pointer to the frequency to evaluate first (updated)
+ */
+static void
+searchValues( tSynthesis *pSynthesis, tCandidate *pCandidate, gint depth,
+        double complex *pZ, gdouble *pThreshold, gint *pWorstFirst ) {
+    gint nF = pSynthesis->nFrequencies;
+    tElementType type = elementType( &pCandidate->topology, depth );
+    gboolean bSeries = ( type == eSeriesL || type == eSeriesC );
+    const tPartList *pParts = &pSynthesis->parts[ type ];
+    const double complex *pIn = pZ + (gsize)depth * nF;
+    double complex *pOut = pZ + (gsize)(depth + 1) * nF;
+    gboolean bLast = ( depth == pCandidate->topology.nElements - 1 );
+
+    if( bLast ) {
+        // no value of the last element can do better than moving to the R=1 (or G=1) circle
+        gdouble bound = 0.0;
+
+        for( gint f = 0; f < nF && bound < *pThreshold; f++ ) {
+            double complex w = bSeries ? pIn[f] : 1.0 / pIn[f];
+            bound = MAX( bound, fabs( creal( w ) - 1.0 ) / (creal( w ) + 1.0) );
+        }
+        if( bound >= *pThreshold )
+            return;
+    }
+
+    for( gint v = 0; v < pParts->nValues; v++ ) {
+        const gdouble *pImmittance = &pParts->pImmittance[ (gsize)v * nF ];
+
+        pCandidate->value[ depth ] = v;
+        if( !bLast ) {
+            for( gint f = 0; f < nF; f++ )
+                pOut[f] = addElement( pIn[f], bSeries, pImmittance[f] );
+            searchValues( pSynthesis, pCandidate, depth + 1, pZ, pThreshold, pWorstFirst );
+            continue;
+        }
+
+        // the worst frequency of the last rejected network is tried first
+        gdouble worst = 0.0;
+        for( gint i = 0; i < nF && worst < *pThreshold; i++ ) {
+            gint f = ( i == 0 ) ? *pWorstFirst : ( i == *pWorstFirst ? 0 : i );
+            double complex z = addElement( pIn[f], bSeries, pImmittance[f] );
+            gdouble gamma = cabs( (z - 1.0) / (z + 1.0) );
+
+            // (an open or short circuit on the way gives no number, and no match)
+            if( !isfinite( gamma ) )
+                gamma = INFINITY;
+            if( gamma > worst ) {
+                worst = gamma;
+                if( worst >= *pThreshold )
+                    *pWorstFirst = f;
+            }
+        }
+        if( worst < *pThreshold ) {
+            pCandidate->worstGamma = worst;
+            *pThreshold = offerCandidate( pSynthesis, pCandidate );
+        }
+    }
+}
+
+static void
+synthesisRange( gint from, gint to, gpointer userData ) {
+    tSynthesis *pSynthesis = userData;
+    gint nF = pSynthesis->nFrequencies;
+    double complex *pZ = g_new( double complex, (gsize)(MAX_LADDER_ELEMENTS + 1) * nF );
+    gint worstFirst = 0;
+    gdouble threshold;
+
+    memcpy( pZ, pSynthesis->pLoad, nF * sizeof( double complex ) );
+
+    for( gint item = from; item < to; item++ ) {
+        gint t = 0;
+        tCandidate candidate;
+        const gdouble *pImmittance;
+        tElementType type;
+
+        // pick up the improvements found by the other workers
+        g_mutex_lock( &pSynthesis->mutex );
+        threshold = pSynthesis->threshold;
+        g_mutex_unlock( &pSynthesis->mutex );
+
+        // the topology of the item, and the value of its first element
+        while( t + 1 < (gint)pSynthesis->pTopologies->len
+                && g_array_index( pSynthesis->pItemStart, gint, t + 1 ) <= item )
+            t++;
+        candidate.topology = g_array_index( pSynthesis->pTopologies, tTopology, t );
+        candidate.value[0] = item - g_array_index( pSynthesis->pItemStart, gint, t );
+        type = elementType( &candidate.topology, 0 );
+        pImmittance = &pSynthesis->parts[ type ].pImmittance[ (gsize)candidate.value[0] * nF ];
+
+        for( gint f = 0; f < nF; f++ )
+            pZ[ nF + f ] = addElement( pZ[f], type == eSeriesL || type == eSeriesC, pImmittance[f] );
+        searchValues( pSynthesis, &candidate, 1, pZ, &threshold, &worstFirst );
+    }
+
+    g_free( pZ );
+}
+
+/*!     \brief  Path of a network on the chart
+ *
+ * Describe the elements of a network and their arcs at a frequency
+ *
+ * \ingroup synthesis
+ *
+ * \param pSynthesis    pointer to the search
+ * \param pCandidate    pointer to the network
+ * \param f             index of the frequency
+ * \param pMatch        where the network is written
+ */
+static void
+describeCandidate( tSynthesis *pSynthesis, const tCandidate *pCandidate, gint f, tLadderMatch *pMatch ) {
+    double complex z = pSynthesis->pLoad[f];
+
+    pMatch->nElements = pCandidate->topology.nElements;
+    pMatch->worstGamma = pCandidate->worstGamma;
+    for( gint i = 0; i < pMatch->nElements; i++ ) {
+        tElementType type = elementType( &pCandidate->topology, i );
+        const tPartList *pParts = &pSynthesis->parts[ type ];
+        gdouble immittance = pParts->pImmittance[ (gsize)pCandidate->value[i] * pSynthesis->nFrequencies + f ];
+        gboolean bSeries = ( type == eSeriesL || type == eSeriesC );
+
+        pMatch->element[i] = (tElement){ type, pParts->pValues[ pCandidate->value[i] ], immittance };
+        if( bSeries ) {
+            pMatch->path[i] = constantRarc( creal( z ), cimag( z ), cimag( z ) + immittance );
+        } else {
+            double complex y = 1.0 / z;
+            pMatch->path[i] = constantGarc( creal( y ), cimag( y ), cimag( y ) + immittance );
+        }
+        z = addElement( z, bSeries, immittance );
+    }
+}
+
+/*!     \brief  Find the best ladder networks of catalogue parts
+ *
+ * Search all ladders of alternating series and shunt inductors and capacitors
+ * (of two up to maxElements elements) of E series values for those with the
+ * smallest worst |gamma in| over a band of a load.
+ *
+ * \ingroup synthesis
+ *
+ * \param pLoad         pointer to the load trace (with a frequency axis)
+ * \param fLow          lowest frequency of the band (Hz)
+ * \param fHigh         highest frequency of the band (Hz)
+ * \param Z0            characteristic impedance
+ * \param series        E series of the part values
+ * \param maxElements   largest number of elements (2 or 3)
+ * \param nBest         number of networks sought
+ * \param best          array of nBest networks (best first)
+ * \return              number of networks found (0 if the load is not finite in the band)
+ */
+gint
+synthesizeLadders( const tSmithTrace *pLoad, gdouble fLow, gdouble fHigh, gdouble Z0,
+        tESeries series, gint maxElements, gint nBest, tLadderMatch best[] ) {
+    tSynthesis synthesis = { 0 };
+    const gdouble *pMantissas = ( series == eE12 ) ? E12 : E24;
+    gint nMantissas = ( series == eE12 ) ? G_N_ELEMENTS( E12 ) : G_N_ELEMENTS( E24 );
+    gint first = -1, last = -1, nItems = 0;
+    gdouble *pOmega, omegaCenter;
+    gint center;
+
+    if( pLoad->pFreq == NULL || nBest <= 0 )
+        return 0;
+    for( gint i = 0; i < pLoad->nPoints; i++ )
+        if( pLoad->pFreq[i] >= fLow && pLoad->pFreq[i] <= fHigh ) {
+            if( first < 0 )
+                first = i;
+            last = i;
+        }
+    if( first < 0 )
+        return 0;
+
+    // the band, decimated to at most SYNTHESIS_POINTS (including its ends)
+    synthesis.nFrequencies = MIN( last - first + 1, SYNTHESIS_POINTS );
+    synthesis.pLoad = g_new( double complex, synthesis.nFrequencies );
+    pOmega = g_new( gdouble, synthesis.nFrequencies );
+    for( gint f = 0; f < synthesis.nFrequencies; f++ ) {
+        gint i = first + ( synthesis.nFrequencies > 1 ?
+                (gint)((gint64)f * (last - first) / (synthesis.nFrequencies - 1)) : 0 );
+        tRX z = UVtoRX( (tUV){ pLoad->pU[i], pLoad->pV[i] } );
+
+        synthesis.pLoad[f] = z.R + I * z.X;
+        pOmega[f] = 2.0 * M_PI * pLoad->pFreq[i];
+        // e.g. an open circuit (|gamma| = 1 on the real axis) cannot be matched
+        if( !isfinite( z.R ) || !isfinite( z.X ) ) {
+            g_free( synthesis.pLoad );
+            g_free( pOmega );
+            return 0;
+        }
+    }
+    center = synthesis.nFrequencies / 2;
+    omegaCenter = pOmega[ center ];
+
+    // the usable values of each kind of part
+    for( gint type = eSeriesL; type <= eShuntC; type++ ) {
+        tPartList *pParts = &synthesis.parts[ type ];
+        GArray *pValues = g_array_new( FALSE, FALSE, sizeof( gdouble ) );
+
+        for( gint decade = -15; decade <= 0; decade++ )
+            for( gint m = 0; m < nMantissas; m++ ) {
+                gdouble value = pMantissas[m] * pow( 10.0, decade );
+                gdouble magnitude = fabs( partImmittance( type, value, omegaCenter, Z0 ) );
+
+                if( magnitude >= SYNTHESIS_MIN_IMMITTANCE && magnitude <= 1.0 / SYNTHESIS_MIN_IMMITTANCE )
+                    g_array_append_val( pValues, value );
+            }
+        pParts->nValues = pValues->len;
+        pParts->pValues = (gdouble *)g_array_free( pValues, FALSE );
+        pParts->pImmittance = g_new( gdouble, (gsize)MAX( pParts->nValues, 1 ) * synthesis.nFrequencies );
+        for( gint v = 0; v < pParts->nValues; v++ )
+            for( gint f = 0; f < synthesis.nFrequencies; f++ )
+                pParts->pImmittance[ (gsize)v * synthesis.nFrequencies + f ] =
+                        partImmittance( type, pParts->pValues[v], pOmega[f], Z0 );
+    }
+
+    // every topology, each element an inductor or capacitor
+    synthesis.pTopologies = g_array_new( FALSE, FALSE, sizeof( tTopology ) );
+    synthesis.pItemStart = g_array_new( FALSE, FALSE, sizeof( gint ) );
+    for( gint nElements = 2; nElements <= CLAMP( maxElements, 2, MAX_LADDER_ELEMENTS ); nElements++ )
+        for( gint bSeriesFirst = 0; bSeriesFirst <= 1; bSeriesFirst++ )
+            for( gint kinds = 0; kinds < (1 << nElements); kinds++ ) {
+                tTopology topology = { nElements, bSeriesFirst, kinds };
+
+                g_array_append_val( synthesis.pTopologies, topology );
+                g_array_append_val( synthesis.pItemStart, nItems );
+                nItems += synthesis.parts[ elementType( &topology, 0 ) ].nValues;
+            }
+
+    synthesis.nBest = nBest;
+    synthesis.pBest = g_new( tCandidate, nBest );
+    synthesis.threshold = G_MAXDOUBLE;
+    g_mutex_init( &synthesis.mutex );
+
+    smithParallelFor( nItems, 1, synthesisRange, &synthesis );
+
+    for( gint i = 0; i < synthesis.nFound; i++ )
+        describeCandidate( &synthesis, &synthesis.pBest[i], center, &best[i] );
+
+    g_mutex_clear( &synthesis.mutex );
+    for( gint type = eSeriesL; type <= eShuntC; type++ ) {
+        g_free( synthesis.parts[ type ].pValues );
+        g_free( synthesis.parts[ type ].pImmittance );
+    }
+    g_array_free( synthesis.pTopologies, TRUE );
+    g_array_free( synthesis.pItemStart, TRUE );
+    g_free( synthesis.pBest );
+    g_free( synthesis.pLoad );
+    g_free( pOmega );
+
+    return synthesis.nFound;
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHSYNTHESIS_H_
+#define GTKSMITHSYNTHESIS_H_
+
+#include "GTKsmithChart.h"
+#include "GTKsmithMatch.h"
+
+typedef enum {
+    eE12 = 12, eE24 = 24
+} tESeries;
+
+#define MAX_LADDER_ELEMENTS 3
+
+// A ladder network of catalogue parts. The first element is connected to the load.
+typedef struct {
+    gint     nElements;
+    tElement element[ MAX_LADDER_ELEMENTS ];    // immittance at the center of the band
+    gdouble  worstGamma;                        // largest |gamma in| over the band
+    tArc     path[ MAX_LADDER_ELEMENTS ];       // load -> ... -> input, at the center of the band
+} tLadderMatch;
+
+// Most frequencies of the band at which the networks are evaluated
+#define SYNTHESIS_POINTS    64
+
+gint synthesizeLadders( const tSmithTrace *, gdouble, gdouble, gdouble, tESeries, gint, gint, tLadderMatch [] );
+
+#endif /* GTKSMITHSYNTHESIS_H_ */
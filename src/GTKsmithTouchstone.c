@@ -0,0 +1,623 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithTouchstone.c
+ * @brief Touchstone (.snp) file loader
+ *
+ * @author Michael G. Katzmann
+ *
+ * Touchstone files (versions 1 and 2) are loaded into a tSmithNetwork.
+ *
+ * The header (comments, option line "# <unit> <parameter> <format> R <Z0>"
+ * and version 2 keywords) is read first. The network data is then just a
+ * stream of numbers: for each frequency, the frequency and 2 n^2 numbers
+ * (for a two-port in the order 11 21 12 22, otherwise row by row). The
+ * memory mapped data is a table of the parallel table parser of
+ * GTKsmithParse.c, with a column for the frequency and for each part of
+ * each parameter, stored directly into the traces. A parallel pass then
+ * scales the frequencies and converts magnitude / angle and dB / angle
+ * pairs into real and imaginary parts.
+ *
+ * touchstoneLoadSelected() parses only the frequencies and the numbers of
+ * the parameters asked for; the other numbers are only stepped over. The
+ * network keeps the mapped file and the table of its numbers, and a
+ * parameter not parsed is parsed (alone) the first time it is asked for
+ * with smithNetworkParameter().
+ *
+ * The network data ends at a version 2 keyword ([Noise Data] or [End]) or,
+ * in a version 1 two-port file, at the first line of five numbers
+ * (frequency, NFmin in dB, |gamma opt|, angle of gamma opt and Rn normalized
+ * to Z0), which begins the noise parameters.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "GTKsmithTouchstone.h"
+#include "GTKsmithTrace.h"
+#include "GTKsmithParse.h"
+#include "GTKsmithParallel.h"
+
+typedef enum {
+    eFormatMA, eFormatDB, eFormatRI
+} tNumberFormat;
+
+typedef struct {
+    tParseTable      *pTable;           // the network data
+    gboolean          bNoiseLines;      // a line of five numbers begins the noise data
+    gint              nPerPoint;        // numbers for each frequency
+    gdouble           frequencyUnit;
+    tNumberFormat     format;
+    gint             *pMap;             // parameter of each pair of numbers of a frequency
+    gboolean          bFrequency;       // parse the frequencies
+    tSmithTrace     **pTargets;         // trace of each parameter to parse (NULL to step over its numbers)
+    tSmithNetwork    *pNetwork;
+} tTouchstoneLoad;
+
+// The source of the parameters of a network not yet parsed
+typedef struct {
+    tTouchstoneLoad load;
+    GMappedFile    *pMapped;
+    GMutex          mutex;
+    gint            nPending;           // parameters not yet parsed
+} tLazyParameters;
+
+/*!     \brief  Number of ports from a file name
+ *
+ * Number of ports from the extension of a Touchstone file name (e.g. 2 for .s2p)
+ *
+ * \ingroup touchstone
+ *
+ * \param sName     file name
+ * \return          number of ports (0 if the extension is not .snp)
+ */
+gint
+touchstonePortsFromName( const gchar *sName ) {
+    const gchar *sExtension = strrchr( sName, '.' );
+    gchar *pEnd;
+    gint64 nPorts;
+
+    if( sExtension == NULL || g_ascii_tolower( sExtension[1] ) != 's' || !g_ascii_isdigit( sExtension[2] ) )
+        return 0;
+    nPorts = g_ascii_strtoll( sExtension + 2, &pEnd, 10 );
+
+    return ( g_ascii_tolower( *pEnd ) == 'p' && pEnd[1] == 0 && nPorts > 0 && nPorts < 100 ) ? (gint)nPorts : 0;
+}
+
+/*!     \brief  Does a line end the network data
+ *
+ * A keyword, or in a version 1 two-port file a line of five numbers (the
+ * first of the noise parameters), ends the network data (see smithParseTableNewUntil())
+ *
+ * \ingroup touchstone
+ *
+ * \param pLine     first character of the line
+ * \param nNumbers  numbers (words) on the line
+ * \param userData  pointer to the tTouchstoneLoad
+ * \return          TRUE if the line ends the network data
+ */
+static gboolean
+endsNetworkData( const gchar *pLine, gint nNumbers, gpointer userData ) {
+    const tTouchstoneLoad *pLoad = userData;
+
+    return *pLine == '[' || (pLoad->bNoiseLines && nNumbers == 5);
+}
+
+/*!     \brief  Parse the numbers of the targets
+ *
+ * Parse the frequencies (if asked for) and the numbers of the target traces
+ * from the network data; the other numbers are only stepped over
+ *
+ * \ingroup touchstone
+ *
+ * \param pLoad     pointer to the load
+ * \return          NULL, or the first text that is not a number
+ */
+static const gchar *
+parseTargets( tTouchstoneLoad *pLoad ) {
+    gdouble **ppColumns = g_new0( gdouble *, pLoad->nPerPoint );
+    const gchar *pInvalid;
+
+    if( pLoad->bFrequency )
+        ppColumns[0] = pLoad->pNetwork->pFreq;
+    for( gint j = 0; 1 + 2 * j < pLoad->nPerPoint; j++ ) {
+        tSmithTrace *pTrace = pLoad->pTargets[ pLoad->pMap[j] ];
+
+        if( pTrace ) {
+            ppColumns[ 1 + 2 * j ] = pTrace->pU;
+            ppColumns[ 2 + 2 * j ] = pTrace->pV;
+        }
+    }
+    pInvalid = smithParseTableStore( pLoad->pTable, pLoad->nPerPoint, ppColumns, pLoad->pNetwork->nPoints );
+    g_free( ppColumns );
+
+    return pInvalid;
+}
+
+/*!     \brief  Convert the parameters to real and imaginary parts
+ *
+ * Scale the frequencies (if parsed) to Hz, and convert magnitude / angle or
+ * dB / angle pairs of the target traces to real and imaginary parts
+ * (a parallel loop function over the points)
+ *
+ * \ingroup touchstone
+ *
+ * \param from      first point
+ * \param to        last point (exclusive)
+ * \param userData  pointer to the tTouchstoneLoad
+ */
+static void
+convertPoints( gint from, gint to, gpointer userData ) {
+    tTouchstoneLoad *pLoad = userData;
+    tSmithNetwork *pNetwork = pLoad->pNetwork;
+
+    for( gint i = from; pLoad->bFrequency && i < to; i++ )
+        pNetwork->pFreq[i] *= pLoad->frequencyUnit;
+
+    for( gint t = 0; t < pNetwork->nPorts * pNetwork->nPorts; t++ ) {
+        gdouble *restrict pU, *restrict pV;
+
+        if( pLoad->format == eFormatRI || pLoad->pTargets[t] == NULL )
+            continue;
+        pU = pLoad->pTargets[t]->pU;
+        pV = pLoad->pTargets[t]->pV;
+
+        for( gint i = from; i < to; i++ ) {
+            gdouble magnitude = ( pLoad->format == eFormatDB ) ? pow( 10.0, pU[i] / 20.0 ) : pU[i];
+            gdouble angle = pV[i] * (M_PI / 180.0);
+
+            pU[i] = magnitude * cos( angle );
+            pV[i] = magnitude * sin( angle );
+        }
+    }
+}
+
+/*!     \brief  Parse the option line
+ *
+ * Parse the option line ("# GHz S MA R 50"), whose items are optional and in any order
+ *
+ * \ingroup touchstone
+ *
+ * \param p         start of the line (after the '#')
+ * \param pEnd      end of the text
+ * \param pLoad     pointer to the load (frequency unit and format)
+ * \param pNetwork  pointer to a network (type and Z0)
+ */
+static void
+parseOptionLine( const gchar *p, const gchar *pEnd, tTouchstoneLoad *pLoad, tSmithNetwork *pNetwork ) {
+    static const struct {
+        const gchar *sName;
+        gint         kind;          // 0 unit, 1 parameter, 2 format
+        gdouble      value;
+    } options[] = {
+        { "HZ", 0, 1.0 }, { "KHZ", 0, 1.0e3 }, { "MHZ", 0, 1.0e6 }, { "GHZ", 0, 1.0e9 },
+        { "S", 1, eParameterS }, { "Y", 1, eParameterY }, { "Z", 1, eParameterZ },
+        { "H", 1, eParameterH }, { "G", 1, eParameterG },
+        { "MA", 2, eFormatMA }, { "DB", 2, eFormatDB }, { "RI", 2, eFormatRI }
+    };
+
+    for( ;; ) {
+        const gchar *pToken;
+        gsize length;
+
+        p = smithParseSkipSeparators( p, pEnd );
+        if( p == pEnd || *p == '\n' || *p == '!' )
+            break;
+        pToken = p;
+        p = smithParseSkipWord( p, pEnd, '!' );
+        length = p - pToken;
+
+        if( length == 1 && g_ascii_toupper( *pToken ) == 'R' ) {
+            gdouble Z0;
+            const gchar *q = smithParseNumber( smithParseSkipSeparators( p, pEnd ), pEnd, &Z0 );
+
+            if( q ) {
+                pNetwork->Z0 = Z0;
+                p = q;
+            }
+            continue;
+        }
+        for( gint i = 0; i < (gint)G_N_ELEMENTS( options ); i++ ) {
+            if( strlen( options[i].sName ) == length
+                    && g_ascii_strncasecmp( pToken, options[i].sName, length ) == 0 ) {
+                if( options[i].kind == 0 )
+                    pLoad->frequencyUnit = options[i].value;
+                else if( options[i].kind == 1 )
+                    pNetwork->type = (tParameterType)options[i].value;
+                else
+                    pLoad->format = (tNumberFormat)options[i].value;
+            }
+        }
+    }
+}
+
+/*!     \brief  Does a line start with a keyword
+ *
+ * Compare the keyword at the start of a line, ignoring case
+ *
+ * \ingroup touchstone
+ *
+ * \param p         start of the keyword ('[')
+ * \param pEnd      end of the text
+ * \param sKeyword  keyword (with its brackets)
+ * \return          the text after the keyword, or NULL if it is not the keyword
+ */
+static const gchar *
+matchKeyword( const gchar *p, const gchar *pEnd, const gchar *sKeyword ) {
+    gsize length = strlen( sKeyword );
+
+    if( (gsize)(pEnd - p) < length || g_ascii_strncasecmp( p, sKeyword, length ) != 0 )
+        return NULL;
+    return p + length;
+}
+
+/*!     \brief  Parse the noise parameters
+ *
+ * Parse the lines of five numbers of the noise parameters
+ *
+ * \ingroup touchstone
+ *
+ * \param p         start of the noise data
+ * \param pEnd      end of the text
+ * \param pLoad     pointer to the load (frequency unit)
+ * \param pNetwork  pointer to the network
+ */
+static void
+parseNoise( const gchar *p, const gchar *pEnd, tTouchstoneLoad *pLoad, tSmithNetwork *pNetwork ) {
+    GArray *pNoise = g_array_new( FALSE, FALSE, sizeof( tNoiseParameters ) );
+    gdouble values[5];
+    gint n = 0;
+
+    while( p < pEnd ) {
+        const gchar *q;
+
+        p = smithParseSkipSeparators( p, pEnd );
+        if( p == pEnd || *p == '[' )
+            break;
+        if( *p == '\n' || *p == '!' ) {
+            p = smithParseNextLine( p, pEnd );
+            continue;
+        }
+        if( (q = smithParseNumber( p, pEnd, &values[ n ] )) == NULL )
+            break;
+        p = q;
+        if( ++n == 5 ) {
+            tNoiseParameters noise = {
+                values[0] * pLoad->frequencyUnit, values[1],
+                { values[2] * cos( values[3] * (M_PI / 180.0) ), values[2] * sin( values[3] * (M_PI / 180.0) ) },
+                values[4] * pNetwork->Z0
+            };
+
+            g_array_append_val( pNoise, noise );
+            n = 0;
+        }
+    }
+
+    pNetwork->nNoise = pNoise->len;
+    pNetwork->pNoise = (tNoiseParameters *)g_array_free( pNoise, pNoise->len == 0 );
+}
+
+/*!     \brief  Free the table and map of a load
+ *
+ * Free the network data table and the arrays of a load
+ *
+ * \ingroup touchstone
+ *
+ * \param pLoad     pointer to the load
+ */
+static void
+loadClear( tTouchstoneLoad *pLoad ) {
+    g_free( pLoad->pMap );
+    smithParseTableFree( pLoad->pTable );
+    g_free( pLoad->pTargets );
+    pLoad->pMap = NULL;
+    pLoad->pTable = NULL;
+    pLoad->pTargets = NULL;
+}
+
+/*!     \brief  Parse a Touchstone file in memory
+ *
+ * Parse the text of a Touchstone file into a network, with the frequencies
+ * and the selected parameters. On success the load keeps the table of the
+ * network data (for parameters parsed later); free it with loadClear().
+ *
+ * \ingroup touchstone
+ *
+ * \param pText         text of the file (need not be NUL terminated)
+ * \param length        length of the text
+ * \param nPorts        number of ports (see touchstoneParse())
+ * \param selection     the row and column (1 to nPorts) of each parameter to parse (or NULL for all)
+ * \param nSelection    number of parameters selected
+ * \param pLoad         pointer to the load (zeroed)
+ * \param ppError       where an error is reported (or NULL)
+ * \return              pointer to the network, or NULL on error
+ */
+static tSmithNetwork *
+parseNetwork( const gchar *pText, gsize length, gint nPorts, const gint selection[][2], gint nSelection,
+              tTouchstoneLoad *pLoad, GError **ppError ) {
+    const gchar *p = pText, *pEnd = pText + length, *pData = NULL, *pStop, *pInvalid;
+    tSmithNetwork header = { .type = eParameterS, .Z0 = 50.0 };
+    gboolean bVersion2 = FALSE, bOrder12 = FALSE, *pSelected = NULL;
+    gint nPoints;
+    gint64 nNumbers;
+
+    pLoad->frequencyUnit = 1.0e9;
+    pLoad->format = eFormatMA;
+
+    // the header (up to the first line of data)
+    while( p < pEnd && pData == NULL ) {
+        const gchar *pNext = smithParseNextLine( p, pEnd ), *q;
+
+        p = smithParseSkipSeparators( p, pEnd );
+        if( p < pEnd && *p == '#' ) {
+            parseOptionLine( p + 1, pNext, pLoad, &header );
+        } else if( p < pEnd && *p == '[' ) {
+            if( matchKeyword( p, pNext, "[Version]" ) ) {
+                bVersion2 = TRUE;
+            } else if( (q = matchKeyword( p, pNext, "[Number of Ports]" )) ) {
+                nPorts = (gint)g_ascii_strtoll( smithParseSkipSeparators( q, pNext ), NULL, 10 );
+            } else if( (q = matchKeyword( p, pNext, "[Two-Port Data Order]" )) ) {
+                bOrder12 = ( matchKeyword( smithParseSkipSeparators( q, pNext ), pNext, "12_21" ) != NULL );
+            } else if( (q = matchKeyword( p, pNext, "[Reference]" )) ) {
+                // the reference of port 1 (on this line or the next)
+                q = smithParseSkipSeparators( q, pNext );
+                if( q == pNext || *q == '\n' || *q == '!' )
+                    q = smithParseSkipSeparators( pNext, pEnd );
+                smithParseNumber( q, pEnd, &header.Z0 );
+            } else if( (q = matchKeyword( p, pNext, "[Matrix Format]" )) ) {
+                if( !matchKeyword( smithParseSkipSeparators( q, pNext ), pNext, "Full" ) ) {
+                    g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorFormat,
+                                 "Only the full matrix format is supported" );
+                    return NULL;
+                }
+            } else if( matchKeyword( p, pNext, "[Network Data]" ) ) {
+                pData = pNext;
+            }
+        } else if( p < pEnd && *p != '\n' && *p != '!' ) {
+            pData = p;
+        }
+        p = pNext;
+    }
+
+    if( nPorts < 1 || nPorts > 99 ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorFormat,
+                     "The number of ports is not known (the file is not .snp)" );
+        return NULL;
+    }
+    if( pData == NULL ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData, "There is no network data" );
+        return NULL;
+    }
+
+    // the parameter trace of each pair of numbers
+    pLoad->nPerPoint = 1 + 2 * nPorts * nPorts;
+    pLoad->pMap = g_new( gint, nPorts * nPorts );
+    for( gint i = 0; i < nPorts * nPorts; i++ )
+        pLoad->pMap[i] = ( nPorts == 2 && !bOrder12 ) ? (i % 2) * 2 + i / 2 : i;
+    pLoad->bNoiseLines = ( nPorts == 2 && !bVersion2 );
+
+    // count the numbers up to the end of the network data
+    pLoad->pTable = smithParseTableNewUntil( pData, pEnd, '!', endsNetworkData, pLoad );
+    nNumbers = smithParseTableCount( pLoad->pTable );
+    pStop = smithParseTableStop( pLoad->pTable );
+
+    if( nNumbers == 0 || nNumbers % pLoad->nPerPoint != 0 || nNumbers / pLoad->nPerPoint > G_MAXINT ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData,
+                     "The network data has %" G_GINT64_FORMAT " numbers, not a multiple of %d for a %d port",
+                     nNumbers, pLoad->nPerPoint, nPorts );
+        loadClear( pLoad );
+        return NULL;
+    }
+    nPoints = (gint)(nNumbers / pLoad->nPerPoint);
+
+    // the selected parameters (those out of range are ignored)
+    if( selection ) {
+        pSelected = g_new0( gboolean, nPorts * nPorts );
+        for( gint s = 0; s < nSelection; s++ ) {
+            if( selection[s][0] >= 1 && selection[s][0] <= nPorts && selection[s][1] >= 1 && selection[s][1] <= nPorts )
+                pSelected[ (selection[s][0] - 1) * nPorts + selection[s][1] - 1 ] = TRUE;
+        }
+    }
+
+    // parse the numbers directly into the network
+    pLoad->pNetwork = smithNetworkNewSelected( nPorts, nPoints, pSelected );
+    pLoad->pNetwork->type = header.type;
+    pLoad->pNetwork->Z0 = header.Z0;
+    pLoad->pTargets = g_memdup2( pLoad->pNetwork->pParameters, nPorts * nPorts * sizeof( tSmithTrace * ) );
+    pLoad->bFrequency = TRUE;
+    pInvalid = parseTargets( pLoad );
+    g_free( pSelected );
+
+    if( pInvalid ) {
+        g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorNumber, "Invalid number on line %d",
+                     smithParseLineNumber( pText, pInvalid ) );
+        smithNetworkFree( pLoad->pNetwork );
+        loadClear( pLoad );
+        return pLoad->pNetwork = NULL;
+    }
+
+    smithParallelFor( nPoints, PARALLEL_GRAIN, convertPoints, pLoad );
+
+    // noise parameters follow the network data of a two-port
+    if( pStop && nPorts == 2 ) {
+        if( !bVersion2 )
+            parseNoise( pStop, pEnd, pLoad, pLoad->pNetwork );
+        else if( matchKeyword( smithParseSkipSeparators( pStop, pEnd ), pEnd, "[Noise Data]" ) )
+            parseNoise( smithParseNextLine( pStop, pEnd ), pEnd, pLoad, pLoad->pNetwork );
+    }
+
+    return pLoad->pNetwork;
+}
+
+/*!     \brief  Parse a Touchstone file in memory
+ *
+ * Parse the text of a Touchstone file (version 1 or 2) into a network
+ *
+ * \ingroup touchstone
+ *
+ * \param pText     text of the file (need not be NUL terminated)
+ * \param length    length of the text
+ * \param nPorts    number of ports (from the file name, see touchstonePortsFromName())
+ *                  or 0 if it is given in the file ([Number of Ports])
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the network (free with smithNetworkFree), or NULL on error
+ */
+tSmithNetwork *
+touchstoneParse( const gchar *pText, gsize length, gint nPorts, GError **ppError ) {
+    tTouchstoneLoad load = { 0 };
+    tSmithNetwork *pNetwork = parseNetwork( pText, length, nPorts, NULL, 0, &load, ppError );
+
+    loadClear( &load );
+    return pNetwork;
+}
+
+/*!     \brief  Parse a parameter on first access
+ *
+ * Parse a parameter not selected when the network was loaded
+ * (the decoder of the network, see smithNetworkParameter())
+ *
+ * \ingroup touchstone
+ *
+ * \param pData     pointer to the tLazyParameters
+ * \param index     parameter (row major)
+ * \return          the trace, or NULL if it cannot be parsed
+ */
+static tSmithTrace *
+parseLazyParameter( gpointer pData, gint index ) {
+    tLazyParameters *pLazy = pData;
+    tTouchstoneLoad *pLoad = &pLazy->load;
+    tSmithNetwork *pNetwork = pLoad->pNetwork;
+    tSmithTrace *pTrace;
+
+    g_mutex_lock( &pLazy->mutex );
+    if( (pTrace = pNetwork->pParameters[ index ]) == NULL ) {
+        pTrace = smithNetworkTraceNew( pNetwork );
+        pLoad->pTargets[ index ] = pTrace;
+        if( parseTargets( pLoad ) ) {
+            smithTraceFree( pTrace );
+            pTrace = NULL;
+        } else {
+            if( pLoad->format != eFormatRI )
+                smithParallelFor( pNetwork->nPoints, PARALLEL_GRAIN, convertPoints, pLoad );
+            g_atomic_pointer_set( &pNetwork->pParameters[ index ], pTrace );
+
+            // the file is no longer needed once every parameter is parsed
+            if( --pLazy->nPending == 0 ) {
+                g_mapped_file_unref( pLazy->pMapped );
+                pLazy->pMapped = NULL;
+                loadClear( pLoad );
+            }
+        }
+        if( pLoad->pTargets )
+            pLoad->pTargets[ index ] = NULL;
+    }
+    g_mutex_unlock( &pLazy->mutex );
+
+    return pTrace;
+}
+
+/*!     \brief  Free the source of the parameters not yet parsed
+ *
+ * Free the source of the parameters not yet parsed (with the network)
+ *
+ * \ingroup touchstone
+ *
+ * \param pData     pointer to the tLazyParameters
+ */
+static void
+freeLazyParameters( gpointer pData ) {
+    tLazyParameters *pLazy = pData;
+
+    if( pLazy->pMapped )
+        g_mapped_file_unref( pLazy->pMapped );
+    loadClear( &pLazy->load );
+    g_mutex_clear( &pLazy->mutex );
+    g_free( pLazy );
+}
+
+/*!     \brief  Load a Touchstone file
+ *
+ * Load a Touchstone file (memory mapped and parsed in parallel)
+ *
+ * \ingroup touchstone
+ *
+ * \param sPath     path of the file (.snp, or any name for version 2)
+ * \param ppError   where an error is reported (or NULL)
+ * \return          pointer to the network (free with smithNetworkFree), or NULL on error
+ */
+tSmithNetwork *
+touchstoneLoad( const gchar *sPath, GError **ppError ) {
+    return touchstoneLoadSelected( sPath, NULL, 0, ppError );
+}
+
+/*!     \brief  Load some of the parameters of a Touchstone file
+ *
+ * Load a Touchstone file, parsing only the frequencies and the selected
+ * parameters (e.g. { { 1, 1 } } for S11). The other parameters are parsed
+ * the first time they are asked for with smithNetworkParameter(); until then
+ * the network keeps the file mapped.
+ *
+ * \ingroup touchstone
+ *
+ * \param sPath         path of the file (.snp, or any name for version 2)
+ * \param selection     the row and column (1 to nPorts) of each parameter to parse (or NULL for all)
+ * \param nSelection    number of parameters selected
+ * \param ppError       where an error is reported (or NULL)
+ * \return              pointer to the network (free with smithNetworkFree), or NULL on error
+ */
+tSmithNetwork *
+touchstoneLoadSelected( const gchar *sPath, const gint selection[][2], gint nSelection, GError **ppError ) {
+    GMappedFile *pMapped = g_mapped_file_new( sPath, FALSE, ppError );
+    tTouchstoneLoad load = { 0 };
+    tSmithNetwork *pNetwork;
+    tLazyParameters *pLazy;
+    gint nPending = 0;
+
+    if( pMapped == NULL )
+        return NULL;
+
+    pNetwork = parseNetwork( g_mapped_file_get_contents( pMapped ), g_mapped_file_get_length( pMapped ),
+                             touchstonePortsFromName( sPath ), selection, nSelection, &load, ppError );
+    if( pNetwork == NULL ) {
+        if( ppError && *ppError )
+            g_prefix_error( ppError, "%s: ", sPath );
+        g_mapped_file_unref( pMapped );
+        return NULL;
+    }
+
+    for( gint i = 0; i < pNetwork->nPorts * pNetwork->nPorts; i++ )
+        nPending += ( pNetwork->pParameters[i] == NULL );
+    if( nPending == 0 ) {
+        loadClear( &load );
+        g_mapped_file_unref( pMapped );
+        return pNetwork;
+    }
+
+    // the rest are parsed from the mapped file when asked for
+    pLazy = g_new0( tLazyParameters, 1 );
+    pLazy->load = load;
+    pLazy->load.bFrequency = FALSE;
+    memset( pLazy->load.pTargets, 0, pNetwork->nPorts * pNetwork->nPorts * sizeof( tSmithTrace * ) );
+    pLazy->pMapped = pMapped;
+    pLazy->nPending = nPending;
+    g_mutex_init( &pLazy->mutex );
+    pNetwork->decodeParameter = parseLazyParameter;
+    pNetwork->pDecoder = pLazy;
+    pNetwork->freeDecoder = freeLazyParameters;
+
+    return pNetwork;
+}
@@ -0,0 +1,307 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file GTKsmithTrace.c
+ * @brief Trace container
+ *
+ * @author Michael G. Katzmann
+ *
+ * A trace holds the U and V (gamma) coordinates of its points in separate
+ * arrays (a structure of arrays rather than an array of tUV) so that
+ * operations over whole traces can be vectorized by the compiler.
+ * The arrays are aligned to TRACE_ALIGNMENT bytes.
+ *
+ * If the trace has a frequency axis, it must be monotonically increasing;
+ * points at a given frequency are then found by bisection.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "GTKsmithTrace.h"
+
+/*!     \brief  Create a trace
+ *
+ * Create an empty trace with room for nAllocated points
+ *
+ * \ingroup trace
+ *
+ * \param nAllocated    initial capacity of the trace
+ * \param bFrequency    allocate a frequency axis
+ * \return              pointer to the trace (free with smithTraceFree)
+ */
+tSmithTrace *
+smithTraceNew( gint nAllocated, gboolean bFrequency ) {
+    tSmithTrace *pTrace = g_new0( tSmithTrace, 1 );
+
+    nAllocated = MAX( nAllocated, 1 );
+    pTrace->nAllocated = nAllocated;
+    pTrace->pU = g_aligned_alloc( nAllocated, sizeof( gdouble ), TRACE_ALIGNMENT );
+    pTrace->pV = g_aligned_alloc( nAllocated, sizeof( gdouble ), TRACE_ALIGNMENT );
+    if( bFrequency )
+        pTrace->pFreq = g_aligned_alloc( nAllocated, sizeof( gdouble ), TRACE_ALIGNMENT );
+
+    return pTrace;
+}
+
+/*!     \brief  Create a trace from an array of points
+ *
+ * Create a trace from an array of points in gamma space
+ *
+ * \ingroup trace
+ *
+ * \param uvPoints      array of points in gamma space
+ * \param frequency     array of the frequencies of the points (or NULL)
+ * \param length        number of points
+ * \return              pointer to the trace (free with smithTraceFree)
+ */
+tSmithTrace *
+smithTraceNewFromUV( const tUV uvPoints[], const gdouble frequency[], gint length ) {
+    tSmithTrace *pTrace = smithTraceNew( length, frequency != NULL );
+
+    for( gint i = 0; i < length; i++ ) {
+        pTrace->pU[i] = uvPoints[i].U;
+        pTrace->pV[i] = uvPoints[i].V;
+    }
+    if( frequency )
+        memcpy( pTrace->pFreq, frequency, length * sizeof( gdouble ) );
+    pTrace->nPoints = length;
+
+    return pTrace;
+}
+
+/*!     \brief  Free a trace
+ *
+ * Free a trace (and the arrays it owns)
+ *
+ * \ingroup trace
+ *
+ * \param pTrace        pointer to the trace
+ */
+void
+smithTraceFree( tSmithTrace *pTrace ) {
+    if( pTrace == NULL )
+        return;
+
+    if( !pTrace->flags.bBorrowed ) {
+        g_aligned_free( pTrace->pU );
+        g_aligned_free( pTrace->pV );
+        if( !pTrace->flags.bSharedFreq )
+            g_aligned_free( pTrace->pFreq );
+    }
+    g_free( pTrace );
+}
+
+/*!     \brief  Reallocate an aligned array
+ *
+ * Reallocate an aligned array, preserving its contents
+ *
+ * \ingroup trace
+ *
+ * \param pArray        array to reallocate
+ * \param nOld          number of values to preserve
+ * \param nNew          new size of the array
+ * \return              the new array
+ */
+static gdouble *
+reallocAligned( gdouble *pArray, gint nOld, gint nNew ) {
+    gdouble *pNew = g_aligned_alloc( nNew, sizeof( gdouble ), TRACE_ALIGNMENT );
+
+    if( pArray ) {
+        memcpy( pNew, pArray, MIN( nOld, nNew ) * sizeof( gdouble ) );
+        g_aligned_free( pArray );
+    }
+    return pNew;
+}
+
+/*!     \brief  Ensure the trace has room for a number of points
+ *
+ * Grow the arrays of the trace so that they hold at least nAllocated points
+ *
+ * \ingroup trace
+ *
+ * \param pTrace        pointer to the trace
+ * \param nAllocated    number of points required
+ * \return              FALSE if the trace cannot grow (its arrays are borrowed)
+ */
+gboolean
+smithTraceReserve( tSmithTrace *pTrace, gint nAllocated ) {
+    if( nAllocated <= pTrace->nAllocated )
+        return TRUE;
+    if( pTrace->flags.bBorrowed || (pTrace->pFreq && pTrace->flags.bSharedFreq) )
+        return FALSE;
+
+    pTrace->pU = reallocAligned( pTrace->pU, pTrace->nPoints, nAllocated );
+    pTrace->pV = reallocAligned( pTrace->pV, pTrace->nPoints, nAllocated );
+    if( pTrace->pFreq )
+        pTrace->pFreq = reallocAligned( pTrace->pFreq, pTrace->nPoints, nAllocated );
+    pTrace->nAllocated = nAllocated;
+
+    return TRUE;
+}
+
+/*!     \brief  Append a point to the trace
+ *
+ * Append a point to the trace, growing it if necessary
+ *
+ * \ingroup trace
+ *
+ * \param pTrace        pointer to the trace
+ * \param uv            point in gamma space
+ * \param frequency     frequency of the point (ignored if the trace has no frequency axis)
+ * \return              FALSE if the trace is full and cannot grow (see smithTraceReserve())
+ */
+gboolean
+smithTraceAppend( tSmithTrace *pTrace, tUV uv, gdouble frequency ) {
+    if( pTrace->nPoints == pTrace->nAllocated
+            && !smithTraceReserve( pTrace, MAX( pTrace->nAllocated * 2, 1 ) ) )
+        return FALSE;
+
+    pTrace->pU[ pTrace->nPoints ] = uv.U;
+    pTrace->pV[ pTrace->nPoints ] = uv.V;
+    if( pTrace->pFreq )
+        pTrace->pFreq[ pTrace->nPoints ] = frequency;
+    pTrace->nPoints++;
+    return TRUE;
+}
+
+/*!     \brief  Point at a fractional position along the trace
+ *
+ * Linearly interpolate between point 'index' and the next point
+ *
+ * \ingroup trace
+ *
+ * \param pTrace        pointer to the trace
+ * \param index         index of the point
+ * \param fraction      fraction (0 to 1) of the way to the next point
+ * \return              point in gamma space
+ */
+tUV
+smithTracePointAt( const tSmithTrace *pTrace, gint index, gdouble fraction ) {
+    gint next;
+
+    index = CLAMP( index, 0, pTrace->nPoints - 1 );
+    next = MIN( index + 1, pTrace->nPoints - 1 );
+
+    return (tUV){ pTrace->pU[ index ] + fraction * (pTrace->pU[ next ] - pTrace->pU[ index ]),
+                  pTrace->pV[ index ] + fraction * (pTrace->pV[ next ] - pTrace->pV[ index ]) };
+}
+
+/*!     \brief  Locate a frequency on the frequency axis
+ *
+ * Find the point at or below the frequency (by bisection of the frequency axis)
+ * and the fractional distance to the next point.
+ *
+ * \ingroup trace
+ *
+ * \param pTrace        pointer to the trace
+ * \param frequency     frequency in Hz
+ * \param pIndex        pointer to where the index of the point is written
+ * \param pFraction     pointer to where the fraction (0 to 1) is written
+ * \return              FALSE if the trace has no frequency axis or the frequency is outside it
+ */
+gboolean
+smithTraceFindFrequency( const tSmithTrace *pTrace, gdouble frequency, gint *pIndex, gdouble *pFraction ) {
+    const gdouble *pFreq = pTrace->pFreq;
+    gint low = 0, high = pTrace->nPoints - 1;
+
+    if( pFreq == NULL || pTrace->nPoints == 0
+            || !(frequency >= pFreq[ low ] && frequency <= pFreq[ high ]) )
+        return FALSE;
+
+    if( high == 0 ) {
+        *pIndex = 0;
+        *pFraction = 0.0;
+        return TRUE;
+    }
+
+    // invariant: pFreq[ low ] <= frequency <= pFreq[ high ]
+    while( high - low > 1 ) {
+        gint middle = low + (high - low) / 2;
+
+        if( pFreq[ middle ] <= frequency )
+            low = middle;
+        else
+            high = middle;
+    }
+
+    *pIndex = low;
+    *pFraction = ( pFreq[ high ] > pFreq[ low ] ) ?
+            (frequency - pFreq[ low ]) / (pFreq[ high ] - pFreq[ low ]) : 0.0;
+    return TRUE;
+}
+
+/*!     \brief  Frequency at a fractional position along the trace
+ *
+ * Linearly interpolate the frequency between point 'index' and the next point
+ *
+ * \ingroup trace
+ *
+ * \param pTrace        pointer to the trace
+ * \param index         index of the point
+ * \param fraction      fraction (0 to 1) of the way to the next point
+ * \return              frequency (NAN if the trace has no frequency axis)
+ */
+gdouble
+smithTraceFrequencyAt( const tSmithTrace *pTrace, gint index, gdouble fraction ) {
+    gint next;
+
+    if( pTrace->pFreq == NULL || pTrace->nPoints == 0 )
+        return NAN;
+
+    index = CLAMP( index, 0, pTrace->nPoints - 1 );
+    next = MIN( index + 1, pTrace->nPoints - 1 );
+
+    return pTrace->pFreq[ index ] + fraction * (pTrace->pFreq[ next ] - pTrace->pFreq[ index ]);
+}
+
+/*!     \brief  Gamma at a frequency
+ *
+ * Interpolate gamma at a frequency between the points of the trace, either
+ * linearly in gamma or linearly in impedance (which follows the constant
+ * resistance and reactance circles of the chart).
+ *
+ * \ingroup trace
+ *
+ * \param pTrace        pointer to the trace
+ * \param frequency     frequency in Hz
+ * \param interpolation interpolate in gamma or impedance
+ * \param pUV           pointer to where gamma is written
+ * \return              FALSE if the trace has no frequency axis or the frequency is outside it
+ */
+gboolean
+smithTraceGammaAtFrequency( const tSmithTrace *pTrace, gdouble frequency,
+        tInterpolation interpolation, tUV *pUV ) {
+    gint index, next;
+    gdouble fraction;
+
+    if( !smithTraceFindFrequency( pTrace, frequency, &index, &fraction ) )
+        return FALSE;
+
+    *pUV = smithTracePointAt( pTrace, index, fraction );
+
+    next = MIN( index + 1, pTrace->nPoints - 1 );
+    if( interpolation == eInterpolateZ && fraction != 0.0 && next != index ) {
+        tRX z0 = UVtoRX( (tUV){ pTrace->pU[ index ], pTrace->pV[ index ] } );
+        tRX z1 = UVtoRX( (tUV){ pTrace->pU[ next ], pTrace->pV[ next ] } );
+
+        // gamma interpolation is kept near the open circuit point where Z is unbounded
+        if( isfinite( z0.R ) && isfinite( z0.X ) && isfinite( z1.R ) && isfinite( z1.X ) )
+            *pUV = RXtoUV( (tRX){ z0.R + fraction * (z1.R - z0.R), z0.X + fraction * (z1.X - z0.X) } );
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+#ifndef GTKSMITHTRACE_H_
+#define GTKSMITHTRACE_H_
+
+#include "GTKsmithChart.h"
+
+typedef enum {
+    eInterpolateGamma,      // linearly in gamma
+    eInterpolateZ           // linearly in impedance
+} tInterpolation;
+
+// Alignment (bytes) of the trace arrays so that they can be processed with vector instructions
+#define TRACE_ALIGNMENT 64
+
+tSmithTrace *smithTraceNew( gint, gboolean );
+tSmithTrace *smithTraceNewFromUV( const tUV [], const gdouble [], gint );
+void smithTraceFree( tSmithTrace * );
+gboolean smithTraceReserve( tSmithTrace *, gint );
+gboolean smithTraceAppend( tSmithTrace *, tUV, gdouble );
+tUV smithTracePointAt( const tSmithTrace *, gint, gdouble );
+gboolean smithTraceFindFrequency( const tSmithTrace *, gdouble, gint *, gdouble * );
+gdouble smithTraceFrequencyAt( const tSmithTrace *, gint, gdouble );
+gboolean smithTraceGammaAtFrequency( const tSmithTrace *, gdouble, tInterpolation, tUV * );
+
+#endif /* GTKSMITHTRACE_H_ */
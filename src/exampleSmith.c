@@ -21,7 +21,7 @@
  * @author Michael G. Katzmann
  *
  * compile with:
- * $ gcc -o smith `pkg-config --cflags --libs gtk4` -lm GTKsmithChart.c exampleSmith.c
+ * $ gcc -o smith `pkg-config --cflags --libs gtk4` -lm GTKsmith*.c exampleSmith.c
  */
 
 #include <stdio.h>
@@ -73,7 +73,8 @@ CB_drawingArea_SmithS11 (GtkDrawingArea *wDrawingArea, cairo_t *cr, gint width,
             .colorGBtext     =  { 0.0, 0.5, 0.5, 1.0 },     // dark cyan on GB grid
             .colorRing       =  { 0.0, 0.0, 0.0, 1.0 },     // outer ring in black
             .colorLine       =  { 0.0, 0.0, 0.5, 1.0 },     // curves, lines and points in dark blue
-            .colorAnnotation =  { 0.0, 0.5, 0.0, 1.0 }      // annotations in dark green
+            .colorAnnotation =  { 0.0, 0.5, 0.0, 1.0 },     // annotations in dark green
+            .colorRegion     =  { 0.0, 0.0, 0.5, 0.25 }     // filled regions in translucent blue
     };
 
     // Pass the pointer to the options of this Smith chart to the drawing routines
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file archiveBenchmark.c
+ * @brief Compression and decoding speed of a sweep archive
+ *
+ * @author Michael G. Katzmann
+ *
+ * Sweeps of a resonant load drifting slowly, with noise, are written to an
+ * archive (GTKsmithArchive.c) and read back. Reported are the size of the
+ * archive against the sweeps as doubles and as floats, the rates of coding
+ * and decoding (in sweeps and in megabytes of doubles per second) and the
+ * largest error of the decoded values, which must not exceed half the
+ * resolution. First the limits of the archive are checked: a resolution finer
+ * than ARCHIVE_MIN_RESOLUTION, or a value too large for the resolution, must
+ * be refused, and gamma of magnitude 2 must be kept at the finest resolution.
+ *
+ *   $ gcc -O2 -o archiveBenchmark `pkg-config --cflags --libs gtk4` archiveBenchmark.c ../src/GTKsmithArchive.c \
+ *         ../src/GTKsmithTrace.c ../src/GTKsmithParse.c ../src/GTKsmithChart.c ../src/GTKsmithParallel.c -lm
+ *   $ ./archiveBenchmark --points 1601 --sweeps 2000 --noise 1e-4 --resolution 1e-6
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+#include <glib/gstdio.h>
+#include "../src/GTKsmithArchive.h"
+#include "../src/GTKsmithTrace.h"
+
+/*!     \brief  Fill a sweep
+ *
+ * Gamma of a series RLC load whose resonance drifts from sweep to sweep, with noise
+ *
+ * \param pTrace    the sweep (nPoints set)
+ * \param sweep     sweep number
+ * \param noise     amplitude of the noise in gamma
+ * \param pRandom   random number generator
+ */
+static void
+fillSweep( tSmithTrace *pTrace, gint sweep, gdouble noise, GRand *pRandom ) {
+    gdouble f0 = 100e6 * (1.0 + 0.01 * sin( sweep * 0.01 ));
+
+    for( gint i = 0; i < pTrace->nPoints; i++ ) {
+        gdouble x = 2.0 * (pTrace->pFreq[i] / f0 - f0 / pTrace->pFreq[i]);
+        tUV uv = RXtoUV( (tRX){ 0.6, x } );
+
+        pTrace->pU[i] = uv.U + noise * g_rand_double_range( pRandom, -1.0, 1.0 );
+        pTrace->pV[i] = uv.V + noise * g_rand_double_range( pRandom, -1.0, 1.0 );
+    }
+}
+
+/*!     \brief  Check the limits of the archive
+ *
+ * A resolution finer than ARCHIVE_MIN_RESOLUTION must be refused, as must a
+ * sweep with a value too large for the resolution; gamma of magnitude 2 must
+ * be read back at the finest resolution
+ *
+ * \param sPath     path of a scratch archive
+ * \return          TRUE if the archive behaves as it should
+ */
+static gboolean
+checkLimits( const gchar *sPath ) {
+    tSmithTrace *pTrace = smithTraceNew( 2, FALSE );
+    tArchiveWriter *pWriter;
+    tArchiveReader *pReader;
+    const tSmithTrace *pDecoded = NULL;
+    GError *pError = NULL;
+    gboolean bRefused, bTooLarge = FALSE;
+
+    pWriter = sweepArchiveCreate( sPath, ARCHIVE_MIN_RESOLUTION / 2.0, NULL, 0, &pError );
+    bRefused = ( pWriter == NULL );
+    g_clear_error( &pError );
+    sweepArchiveClose( pWriter, NULL );
+
+    pTrace->nPoints = 2;
+    pTrace->pU[0] = 2.0;
+    pTrace->pV[0] = -2.0;
+    pTrace->pU[1] = -2.0;
+    pTrace->pV[1] = 2.0;
+    if( (pWriter = sweepArchiveCreate( sPath, ARCHIVE_MIN_RESOLUTION, NULL, 0, NULL )) != NULL ) {
+        if( sweepArchiveAppend( pWriter, pTrace, 0, NULL ) ) {
+            pTrace->pU[1] = 2.5;
+            bTooLarge = !sweepArchiveAppend( pWriter, pTrace, 1, &pError );
+            g_clear_error( &pError );
+        }
+        sweepArchiveClose( pWriter, NULL );
+    }
+
+    if( (pReader = sweepArchiveOpen( sPath, NULL )) != NULL ) {
+        pDecoded = sweepArchiveNext( pReader, NULL, NULL );
+        if( pDecoded && (pDecoded->nPoints != 2 || fabs( pDecoded->pU[0] - 2.0 ) > ARCHIVE_MIN_RESOLUTION
+                         || fabs( pDecoded->pV[1] - 2.0 ) > ARCHIVE_MIN_RESOLUTION
+                         || sweepArchiveNext( pReader, NULL, NULL ) != NULL) )
+            pDecoded = NULL;
+        sweepArchiveReaderFree( pReader );
+    }
+
+    printf( "limits: resolution %g refused %s, value too large refused %s, |Γ| 2 kept %s\n",
+            ARCHIVE_MIN_RESOLUTION / 2.0, bRefused ? "yes" : "NO", bTooLarge ? "yes" : "NO", pDecoded ? "yes" : "NO" );
+
+    g_unlink( sPath );
+    smithTraceFree( pTrace );
+    return bRefused && bTooLarge && pDecoded != NULL;
+}
+
+int
+main( int argc, char *argv[] ) {
+    static const struct option options[] = {
+        { "points",     required_argument, NULL, 'p' },
+        { "sweeps",     required_argument, NULL, 'n' },
+        { "noise",      required_argument, NULL, 'e' },
+        { "resolution", required_argument, NULL, 'r' },
+        { NULL, 0, NULL, 0 }
+    };
+    gint nPoints = 1601, nSweeps = 2000, option;
+    gdouble noise = 1e-4, resolution = ARCHIVE_RESOLUTION, maxError = 0.0;
+    gchar *sPath = g_build_filename( g_get_tmp_dir(), "archiveBenchmark.sma", NULL );
+    GRand *pRandom = g_rand_new_with_seed( 1 );
+    tSmithTrace *pTrace;
+    tArchiveWriter *pWriter;
+    tArchiveReader *pReader;
+    const tSmithTrace *pDecoded;
+    GError *pError = NULL;
+    GStatBuf status;
+    gint64 start, encodeTime, decodeTime;
+    gdouble rawBytes, megabytes;
+    gint nDecoded = 0;
+
+    while( (option = getopt_long( argc, argv, "p:n:e:r:", options, NULL )) != -1 ) {
+        switch( option ) {
+        case 'p': nPoints = MAX( atoi( optarg ), 2 ); break;
+        case 'n': nSweeps = MAX( atoi( optarg ), 1 ); break;
+        case 'e': noise = fabs( atof( optarg ) ); break;
+        case 'r': resolution = atof( optarg ) > 0.0 ? atof( optarg ) : ARCHIVE_RESOLUTION; break;
+        default:
+            fprintf( stderr, "usage: %s [--points N] [--sweeps N] [--noise Γ] [--resolution Γ]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    pTrace = smithTraceNew( nPoints, TRUE );
+    pTrace->nPoints = nPoints;
+    for( gint i = 0; i < nPoints; i++ )
+        pTrace->pFreq[i] = 50e6 + 100e6 * i / (nPoints - 1);
+
+    if( !checkLimits( sPath ) )
+        return EXIT_FAILURE;
+
+    printf( "%d sweeps of %d points, noise %g, resolution %g\n", nSweeps, nPoints, noise, resolution );
+
+    // coding (the sweeps are generated again when decoding to check the error)
+    if( (pWriter = sweepArchiveCreate( sPath, resolution, pTrace->pFreq, nPoints, &pError )) == NULL ) {
+        fprintf( stderr, "%s\n", pError->message );
+        return EXIT_FAILURE;
+    }
+    encodeTime = 0;
+    for( gint sweep = 0; sweep < nSweeps; sweep++ ) {
+        fillSweep( pTrace, sweep, noise, pRandom );
+        start = g_get_monotonic_time();
+        if( !sweepArchiveAppend( pWriter, pTrace, sweep, &pError ) ) {
+            fprintf( stderr, "%s\n", pError->message );
+            return EXIT_FAILURE;
+        }
+        encodeTime += g_get_monotonic_time() - start;
+    }
+    if( !sweepArchiveClose( pWriter, &pError ) ) {
+        fprintf( stderr, "%s\n", pError->message );
+        return EXIT_FAILURE;
+    }
+
+    // decoding
+    if( (pReader = sweepArchiveOpen( sPath, &pError )) == NULL ) {
+        fprintf( stderr, "%s\n", pError->message );
+        return EXIT_FAILURE;
+    }
+    g_rand_set_seed( pRandom, 1 );
+    decodeTime = 0;
+    for( ;; ) {
+        start = g_get_monotonic_time();
+        pDecoded = sweepArchiveNext( pReader, NULL, &pError );
+        decodeTime += g_get_monotonic_time() - start;
+        if( pDecoded == NULL )
+            break;
+
+        fillSweep( pTrace, nDecoded++, noise, pRandom );
+        for( gint i = 0; i < nPoints; i++ )
+            maxError = MAX( maxError, MAX( fabs( pDecoded->pU[i] - pTrace->pU[i] ),
+                                           fabs( pDecoded->pV[i] - pTrace->pV[i] ) ) );
+    }
+    sweepArchiveReaderFree( pReader );
+    if( pError ) {
+        fprintf( stderr, "%s\n", pError->message );
+        return EXIT_FAILURE;
+    }
+
+    g_stat( sPath, &status );
+    rawBytes = (gdouble)nSweeps * nPoints * 2 * sizeof( gdouble );
+    megabytes = rawBytes / 1e6;
+    printf( "archive %.2f MB: %.1f:1 against doubles, %.1f:1 against floats (%.2f bits per value)\n",
+            status.st_size / 1e6, rawBytes / status.st_size, rawBytes / 2 / status.st_size,
+            status.st_size * 8.0 / ((gdouble)nSweeps * nPoints * 2) );
+    printf( "coding   %9.0f sweeps/s %8.1f MB/s\n",
+            nSweeps / (encodeTime * 1e-6), megabytes / (encodeTime * 1e-6) );
+    printf( "decoding %9.0f sweeps/s %8.1f MB/s\n",
+            nDecoded / (decodeTime * 1e-6), megabytes / (decodeTime * 1e-6) );
+    printf( "%d sweeps read back, largest error %.3g (%s)\n", nDecoded, maxError,
+            nDecoded == nSweeps && maxError <= resolution * 0.5000001 ? "correct" : "WRONG" );
+
+    g_unlink( sPath );
+    g_free( sPath );
+    smithTraceFree( pTrace );
+    g_rand_free( pRandom );
+
+    return nDecoded == nSweeps && maxError <= resolution * 0.5000001 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file exportBenchmark.c
+ * @brief Size and time of PDF and SVG exports of the chart
+ *
+ * @author Michael G. Katzmann
+ *
+ * The chart is drawn with each of a set of option presets on PDF and SVG
+ * surfaces, as drawn for the screen and with flags.bCompact (merged grid
+ * paths, no clearing; on SVG also flags.bReuseGlyphs, glyphs drawn once). Reported for each are the size of
+ * the file and the best time (over the repeats) to draw and write it, and
+ * the ratios of the compact export to the normal one. The files are counted
+ * as they are written, not kept, unless a directory is given with --keep.
+ *
+ *   $ gcc -O2 -o exportBenchmark `pkg-config --cflags --libs gtk4` exportBenchmark.c ../src/GTKsmithChart.c \
+ *         ../src/GTKsmithParallel.c -lm
+ *   $ ./exportBenchmark --size 600 --repeat 10
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <cairo-pdf.h>
+#include <cairo-svg.h>
+#include "../src/GTKsmithChart.h"
+
+#define SIZE_PCT        98
+
+typedef struct {
+    const gchar *sName;
+    gboolean    bShowRX, bShowGB, bSparceGB, bShowLabels, bDrawRing;
+} tPreset;
+
+static const tPreset presets[] = {
+    // name              RX     GB     sparse labels ring
+    { "Z",               TRUE,  FALSE, FALSE, TRUE,  TRUE  },
+    { "Y",               FALSE, TRUE,  FALSE, TRUE,  TRUE  },
+    { "ZY",              TRUE,  TRUE,  TRUE,  TRUE,  TRUE  },
+    { "Z no ring",       TRUE,  FALSE, FALSE, TRUE,  FALSE },
+    { "Z grid only",     TRUE,  FALSE, FALSE, FALSE, FALSE }
+};
+
+typedef struct {
+    gsize   bytes;
+    FILE    *pFile;             // copy of the output (or NULL)
+} tByteCount;
+
+/*!     \brief  Count the bytes written by a surface
+ *
+ * cairo write function counting (and optionally keeping) the output
+ *
+ * \param closure   pointer to the tByteCount
+ * \param data      data written
+ * \param length    length of the data
+ * \return          CAIRO_STATUS_SUCCESS (or CAIRO_STATUS_WRITE_ERROR if the copy fails)
+ */
+static cairo_status_t
+countBytes( void *closure, const unsigned char *data, unsigned int length ) {
+    tByteCount *pCount = closure;
+
+    pCount->bytes += length;
+    if( pCount->pFile && fwrite( data, 1, length, pCount->pFile ) != length )
+        return CAIRO_STATUS_WRITE_ERROR;
+    return CAIRO_STATUS_SUCCESS;
+}
+
+/*!     \brief  Export the chart once
+ *
+ * Draw the chart on a PDF or SVG surface and finish the surface
+ *
+ * \param pOptions  pointer to the options of the chart
+ * \param bSVG      SVG (TRUE) or PDF
+ * \param size      width and height of the chart (points)
+ * \param sKeep     path to keep the output in (or NULL)
+ * \param pBytes    where the size of the output is written
+ * \return          time taken (s), or a negative value on error
+ */
+static gdouble
+exportChart( tSmithOptions *pOptions, gboolean bSVG, gint size, const gchar *sKeep, gsize *pBytes ) {
+    tByteCount count = { 0 };
+    cairo_surface_t *pSurface;
+    cairo_status_t status;
+    gint64 start;
+    cairo_t *cr;
+
+    if( sKeep && (count.pFile = fopen( sKeep, "w" )) == NULL ) {
+        perror( sKeep );
+        return -1.0;
+    }
+
+    start = g_get_monotonic_time();
+    pSurface = bSVG ? cairo_svg_surface_create_for_stream( countBytes, &count, size, size )
+                    : cairo_pdf_surface_create_for_stream( countBytes, &count, size, size );
+    cr = cairo_create( pSurface );
+    drawSmithChart( cr, size / 2.0, size / 2.0, size / 2.0 * (SIZE_PCT / 100.0), pOptions );
+    cairo_destroy( cr );
+    cairo_surface_finish( pSurface );
+    status = cairo_surface_status( pSurface );
+    cairo_surface_destroy( pSurface );
+
+    if( count.pFile )
+        fclose( count.pFile );
+    if( status != CAIRO_STATUS_SUCCESS ) {
+        fprintf( stderr, "%s\n", cairo_status_to_string( status ) );
+        return -1.0;
+    }
+
+    *pBytes = count.bytes;
+    return (g_get_monotonic_time() - start) * 1e-6;
+}
+
+/*!     \brief  Benchmark an export
+ *
+ * Export the chart a number of times
+ *
+ * \param pOptions  pointer to the options of the chart
+ * \param bSVG      SVG (TRUE) or PDF
+ * \param size      width and height of the chart (points)
+ * \param nRepeat   number of exports
+ * \param sKeep     path to keep the output in (or NULL)
+ * \param pBytes    where the size of the output is written
+ * \return          best time (s), or a negative value on error
+ */
+static gdouble
+benchmarkExport( tSmithOptions *pOptions, gboolean bSVG, gint size, gint nRepeat, const gchar *sKeep, gsize *pBytes ) {
+    gdouble best = G_MAXDOUBLE;
+
+    for( gint r = 0; r < nRepeat; r++ ) {
+        // (the output is kept once)
+        gdouble seconds = exportChart( pOptions, bSVG, size, r == 0 ? sKeep : NULL, pBytes );
+
+        if( seconds < 0.0 )
+            return seconds;
+        best = MIN( best, seconds );
+    }
+    return best;
+}
+
+int
+main( int argc, char *argv[] ) {
+    static const struct option longOptions[] = {
+        { "size",   required_argument, NULL, 's' },
+        { "repeat", required_argument, NULL, 'r' },
+        { "keep",   required_argument, NULL, 'k' },
+        { NULL, 0, NULL, 0 }
+    };
+    tSmithOptions options = {
+            .flags.bShowStrings = TRUE,
+
+            .lineWidth  = 0.25,
+            .pointWidth = 0.6,
+                            // red/green/blue/alpha
+            .colorRXgrid     = { 0.7, 0.0, 0.0, 1.0 },
+            .colorGBgrid     = { 0.0, 0.5, 0.5, 1.0 },
+            .colorRXtext     = { 0.5, 0.0, 0.0, 1.0 },
+            .colorGBtext     = { 0.0, 0.5, 0.5, 1.0 },
+            .colorRing       = { 0.0, 0.0, 0.0, 1.0 },
+            .colorLine       = { 0.0, 0.0, 0.5, 1.0 },
+            .colorAnnotation = { 0.0, 0.5, 0.0, 1.0 },
+            .colorRegion     = { 0.0, 0.0, 0.5, 0.25 },
+
+            .annotationFontSize = 0.4
+    };
+    gint size = 600, nRepeat = 5, option;
+    const gchar *sKeepDir = NULL;
+
+    while( (option = getopt_long( argc, argv, "s:r:k:", longOptions, NULL )) != -1 ) {
+        switch( option ) {
+        case 's': size = MAX( atoi( optarg ), 16 ); break;
+        case 'r': nRepeat = MAX( atoi( optarg ), 1 ); break;
+        case 'k': sKeepDir = optarg; break;
+        default:
+            fprintf( stderr, "usage: %s [--size points] [--repeat N] [--keep directory]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf( "%d x %d points, best of %d\n", size, size, nRepeat );
+    printf( "%-12s %-4s %12s %10s %12s %10s %8s %8s\n",
+            "preset", "", "bytes", "ms", "compact", "ms", "size", "time" );
+
+    for( guint p = 0; p < G_N_ELEMENTS( presets ); p++ ) {
+        const tPreset *pPreset = &presets[p];
+
+        options.flags.bShowRX = pPreset->bShowRX;
+        options.flags.bShowGB = pPreset->bShowGB;
+        options.flags.bSparceGB = pPreset->bSparceGB;
+        options.flags.bShowLabels = pPreset->bShowLabels;
+        options.flags.bDrawRing = pPreset->bDrawRing;
+
+        for( gint svg = 0; svg < 2; svg++ ) {
+            gsize bytes[2] = { 0 };
+            gdouble seconds[2];
+
+            for( gint compact = 0; compact < 2; compact++ ) {
+                gchar *sKeep = NULL;
+
+                if( sKeepDir ) {
+                    gchar *sName = g_strdup_printf( "%s%s.%s", pPreset->sName, compact ? " compact" : "", svg ? "svg" : "pdf" );
+
+                    g_strdelimit( sName, " ", '_' );
+                    sKeep = g_build_filename( sKeepDir, sName, NULL );
+                    g_free( sName );
+                }
+                options.flags.bCompact = compact;
+                options.flags.bReuseGlyphs = compact && svg;
+                seconds[ compact ] = benchmarkExport( &options, svg, size, nRepeat, sKeep, &bytes[ compact ] );
+                g_free( sKeep );
+                if( seconds[ compact ] < 0.0 )
+                    return EXIT_FAILURE;
+            }
+
+            printf( "%-12s %-4s %12" G_GSIZE_FORMAT " %10.2f %12" G_GSIZE_FORMAT " %10.2f %7.2fx %7.2fx\n",
+                    pPreset->sName, svg ? "SVG" : "PDF",
+                    bytes[0], seconds[0] * 1e3, bytes[1], seconds[1] * 1e3,
+                    (gdouble)bytes[0] / MAX( bytes[1], 1 ), seconds[0] / MAX( seconds[1], 1e-9 ) );
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
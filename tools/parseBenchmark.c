@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file parseBenchmark.c
+ * @brief Loading speed of Touchstone, CITIfile and MDIF files
+ *
+ * @author Michael G. Katzmann
+ *
+ * The same network is written as a Touchstone file, a CITIfile and an MDIF
+ * file (an ACDATA block), and each is loaded several times. Reported are the
+ * size of each file, the best load time and rate, and the largest difference
+ * of the loaded parameters from those of the Touchstone file. MDIF blocks
+ * with a complex column are checked first.
+ *
+ *   $ gcc -O2 -o parseBenchmark `pkg-config --cflags --libs gtk4` parseBenchmark.c ../src/GTKsmithTouchstone.c \
+ *         ../src/GTKsmithCiti.c ../src/GTKsmithMdif.c ../src/GTKsmithNetwork.c ../src/GTKsmithTrace.c \
+ *         ../src/GTKsmithParse.c ../src/GTKsmithChart.c ../src/GTKsmithParallel.c -lm
+ *   $ ./parseBenchmark --ports 2 --points 200000 --repeat 5
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+#include <glib/gstdio.h>
+#include "../src/GTKsmithTouchstone.h"
+#include "../src/GTKsmithCiti.h"
+#include "../src/GTKsmithMdif.h"
+#include "../src/GTKsmithTrace.h"
+
+/*!     \brief  A parameter of the test network
+ *
+ * Real and imaginary parts of a parameter at a point
+ *
+ * \param parameter row major index of the parameter
+ * \param point     point number
+ * \param pU        where the real part is written
+ * \param pV        where the imaginary part is written
+ */
+static void
+parameterValue( gint parameter, gint point, gdouble *pU, gdouble *pV ) {
+    gdouble magnitude = 0.9 / (1 + parameter), angle = point * 1e-3 + parameter;
+
+    *pU = magnitude * cos( angle );
+    *pV = magnitude * sin( angle );
+}
+
+/*!     \brief  Write the test files
+ *
+ * Write the network as a Touchstone file, a CITIfile and an MDIF file
+ *
+ * \param sPaths    paths of the three files
+ * \param nPorts    number of ports
+ * \param nPoints   number of frequencies
+ * \return          FALSE if a file cannot be written
+ */
+static gboolean
+writeFiles( gchar *sPaths[3], gint nPorts, gint nPoints ) {
+    FILE *pFiles[3];
+    gint nParameters = nPorts * nPorts;
+    gdouble u, v;
+
+    for( gint f = 0; f < 3; f++ ) {
+        if( (pFiles[f] = g_fopen( sPaths[f], "w" )) == NULL ) {
+            perror( sPaths[f] );
+            return FALSE;
+        }
+    }
+
+    // Touchstone (version 1, two-port data in the order 11 21 12 22)
+    fprintf( pFiles[0], "! benchmark network\n# Hz S RI R 50\n" );
+    for( gint i = 0; i < nPoints; i++ ) {
+        fprintf( pFiles[0], "%.9e", 1e9 + i * 1e3 );
+        for( gint k = 0; k < nParameters; k++ ) {
+            gint parameter = nPorts == 2 ? (k % 2) * 2 + k / 2 : k;
+
+            parameterValue( parameter, i, &u, &v );
+            fprintf( pFiles[0], " %.9e %.9e%s", u, v, (k % 4 == 3 && k + 1 < nParameters) ? "\n" : "" );
+        }
+        fputc( '\n', pFiles[0] );
+    }
+
+    // CITIfile (a block for each parameter)
+    fprintf( pFiles[1], "CITIFILE A.01.00\nNAME BENCHMARK\nVAR FREQ MAG %d\n", nPoints );
+    for( gint k = 0; k < nParameters; k++ )
+        fprintf( pFiles[1], "DATA S[%d,%d] RI\n", k / nPorts + 1, k % nPorts + 1 );
+    fprintf( pFiles[1], "VAR_LIST_BEGIN\n" );
+    for( gint i = 0; i < nPoints; i++ )
+        fprintf( pFiles[1], "%.9e\n", 1e9 + i * 1e3 );
+    fprintf( pFiles[1], "VAR_LIST_END\n" );
+    for( gint k = 0; k < nParameters; k++ ) {
+        fprintf( pFiles[1], "BEGIN\n" );
+        for( gint i = 0; i < nPoints; i++ ) {
+            parameterValue( k, i, &u, &v );
+            fprintf( pFiles[1], "%.9e,%.9e\n", u, v );
+        }
+        fprintf( pFiles[1], "END\n" );
+    }
+
+    // MDIF (one ACDATA block, row major)
+    fprintf( pFiles[2], "! benchmark network\nBEGIN ACDATA\n# Hz S RI R 50\n%% F" );
+    for( gint k = 0; k < nParameters; k++ )
+        fprintf( pFiles[2], " n%d%dx n%d%dy", k / nPorts + 1, k % nPorts + 1, k / nPorts + 1, k % nPorts + 1 );
+    fputc( '\n', pFiles[2] );
+    for( gint i = 0; i < nPoints; i++ ) {
+        fprintf( pFiles[2], "%.9e", 1e9 + i * 1e3 );
+        for( gint k = 0; k < nParameters; k++ ) {
+            parameterValue( k, i, &u, &v );
+            fprintf( pFiles[2], " %.9e %.9e", u, v );
+        }
+        fputc( '\n', pFiles[2] );
+    }
+    fprintf( pFiles[2], "END\n" );
+
+    for( gint f = 0; f < 3; f++ )
+        fclose( pFiles[f] );
+    return TRUE;
+}
+
+/*!     \brief  Largest error of a parameter
+ *
+ * Largest difference of a trace from the test parameter
+ *
+ * \param pTrace    the trace (or NULL)
+ * \param parameter row major index of the parameter
+ * \return          largest difference (INFINITY if there is no trace)
+ */
+static gdouble
+traceError( const tSmithTrace *pTrace, gint parameter ) {
+    gdouble error = 0.0, u, v;
+
+    if( pTrace == NULL )
+        return INFINITY;
+    for( gint i = 0; i < pTrace->nPoints; i++ ) {
+        parameterValue( parameter, i, &u, &v );
+        error = MAX( error, MAX( fabs( pTrace->pU[i] - u ), fabs( pTrace->pV[i] - v ) ) );
+        error = MAX( error, fabs( pTrace->pFreq[i] - (1e9 + i * 1e3) ) * 1e-9 );
+    }
+    return error;
+}
+
+/*!     \brief  Check the columns of a complex MDIF column
+ *
+ * Parse blocks with a complex column (two numbers in each row) of two and
+ * three rows, whose numbers must be in the columns they belong to
+ *
+ * \return          TRUE if the blocks are parsed as they should be
+ */
+static gboolean
+checkComplexColumns( void ) {
+    static const gchar *sBlocks[] = {
+        "BEGIN LP\n% freq(real) gammaL(complex) Pout(real)\n1 0.1 0.2 10\n2 0.3 0.4 20\nEND\n",
+        "BEGIN LP\n% freq(real) gammaL(complex) Pout(real)\n1 0.1 0.2 10\n2 0.3 0.4 20\n3 0.5 0.6 30\nEND\n"
+    };
+    gboolean bCorrect = TRUE;
+
+    for( gint b = 0; b < (gint)G_N_ELEMENTS( sBlocks ); b++ ) {
+        tMdifFile *pMdif = mdifParse( sBlocks[b], strlen( sBlocks[b] ), NULL );
+        tMdifBlock *pBlock = pMdif ? &pMdif->pBlocks[0] : NULL;
+        gint re, im, power;
+
+        if( pBlock == NULL || pBlock->nRows != b + 2 || pBlock->nColumns != 4
+                || (re = mdifBlockColumn( pBlock, "gammaL_re" )) < 0 || (im = mdifBlockColumn( pBlock, "gammaL_im" )) < 0
+                || (power = mdifBlockColumn( pBlock, "Pout" )) < 0 ) {
+            bCorrect = FALSE;
+        } else {
+            for( gint r = 0; r < pBlock->nRows; r++ )
+                bCorrect = bCorrect && fabs( pBlock->pColumns[re][r] - (0.1 + 0.2 * r) ) < 1e-12
+                           && fabs( pBlock->pColumns[im][r] - (0.2 + 0.2 * r) ) < 1e-12
+                           && pBlock->pColumns[power][r] == 10.0 * (r + 1);
+        }
+        mdifFree( pMdif );
+    }
+
+    printf( "MDIF complex columns %s\n", bCorrect ? "correct" : "WRONG" );
+    return bCorrect;
+}
+
+int
+main( int argc, char *argv[] ) {
+    static const struct option options[] = {
+        { "ports",  required_argument, NULL, 'n' },
+        { "points", required_argument, NULL, 'p' },
+        { "repeat", required_argument, NULL, 'r' },
+        { NULL, 0, NULL, 0 }
+    };
+    static const gchar *sFormats[] = { "Touchstone", "CITIfile", "MDIF" };
+    gint nPorts = 2, nPoints = 200000, nRepeat = 5, option;
+    gchar *sPaths[3];
+    gboolean bCorrect = TRUE;
+
+    while( (option = getopt_long( argc, argv, "n:p:r:", options, NULL )) != -1 ) {
+        switch( option ) {
+        case 'n': nPorts = CLAMP( atoi( optarg ), 1, 9 ); break;
+        case 'p': nPoints = MAX( atoi( optarg ), 1 ); break;
+        case 'r': nRepeat = MAX( atoi( optarg ), 1 ); break;
+        default:
+            fprintf( stderr, "usage: %s [--ports N] [--points N] [--repeat N]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    sPaths[0] = g_strdup_printf( "%s/parseBenchmark.s%dp", g_get_tmp_dir(), nPorts );
+    sPaths[1] = g_strdup_printf( "%s/parseBenchmark.cti", g_get_tmp_dir() );
+    sPaths[2] = g_strdup_printf( "%s/parseBenchmark.mdf", g_get_tmp_dir() );
+    if( !writeFiles( sPaths, nPorts, nPoints ) )
+        return EXIT_FAILURE;
+
+    if( !checkComplexColumns() )
+        return EXIT_FAILURE;
+
+    printf( "%d-port, %d points, best of %d loads\n", nPorts, nPoints, nRepeat );
+    for( gint f = 0; f < 3; f++ ) {
+        gint64 best = G_MAXINT64;
+        gdouble error = 0.0;
+        GStatBuf status;
+
+        g_stat( sPaths[f], &status );
+        for( gint r = 0; r < nRepeat; r++ ) {
+            gint64 start = g_get_monotonic_time();
+            GError *pError = NULL;
+            tSmithNetwork *pNetwork = NULL;
+            tMdifFile *pMdif = NULL;
+
+            if( f == 0 )
+                pNetwork = touchstoneLoad( sPaths[f], &pError );
+            else if( f == 1 )
+                pNetwork = citifileLoad( sPaths[f], &pError );
+            else
+                pMdif = mdifLoad( sPaths[f], &pError );
+            best = MIN( best, g_get_monotonic_time() - start );
+
+            if( pError ) {
+                fprintf( stderr, "%s\n", pError->message );
+                return EXIT_FAILURE;
+            }
+            if( r > 0 ) {
+                // (checked once)
+            } else if( pNetwork ) {
+                for( gint k = 0; k < nPorts * nPorts; k++ )
+                    error = MAX( error, traceError( smithNetworkParameter( pNetwork, k / nPorts + 1, k % nPorts + 1 ), k ) );
+            } else {
+                for( gint k = 0; k < nPorts * nPorts; k++ ) {
+                    tSmithTrace *pTrace = mdifBlockTrace( &pMdif->pBlocks[0], 1 + 2 * k, 2 + 2 * k, 0 );
+
+                    error = MAX( error, traceError( pTrace, k ) );
+                    smithTraceFree( pTrace );
+                }
+            }
+            smithNetworkFree( pNetwork );
+            mdifFree( pMdif );
+        }
+
+        printf( "%-10s %8.1f MB %8.1f ms %8.1f MB/s   largest error %.3g\n", sFormats[f], status.st_size / 1e6,
+                best * 1e-3, status.st_size / (gdouble)best, error );
+        bCorrect = bCorrect && error < 1e-8;
+        g_unlink( sPaths[f] );
+        g_free( sPaths[f] );
+    }
+
+    return bCorrect ? EXIT_SUCCESS : EXIT_FAILURE;
+}
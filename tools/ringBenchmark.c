@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file ringBenchmark.c
+ * @brief Latency and throughput of a shared memory sweep ring
+ *
+ * @author Michael G. Katzmann
+ *
+ * A child process writes sweeps as fast as it can into an unnamed ring
+ * (GTKsmithRing.c) inherited from the parent, while the parent reads each
+ * latest sweep in place, as a chart would. The same sweeps are then sent
+ * as binary frames (GTKsmithStream.h) through a pipe and copied out, for
+ * comparison. Reported are the sweeps written per second, the sweeps the
+ * reader saw, the latency from completion to reading and the torn reads
+ * (sweeps overwritten while being read, with --draw to simulate drawing).
+ *
+ *   $ gcc -O2 -o ringBenchmark `pkg-config --cflags --libs gtk4` ringBenchmark.c ../src/GTKsmithRing.c \
+ *         ../src/GTKsmithTrace.c ../src/GTKsmithChart.c ../src/GTKsmithParallel.c -lm
+ *   $ ./ringBenchmark --points 4001 --sweeps 20000 --draw 2000
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../src/GTKsmithRing.h"
+#include "../src/GTKsmithStream.h"
+#include "../src/GTKsmithTrace.h"
+
+typedef struct {
+    guint64 seen, torn;
+    gint64  start, end;         // start of writing and completion of the last sweep read (µs)
+    GArray *latency;            // µs
+    gdouble sum;                // of the data read, so that it is really read
+} tBenchResult;
+
+/*!     \brief  Fill a sweep
+ *
+ * Fill the arrays of a sweep with values that change with each sweep
+ *
+ * \param sweep     sweep number
+ * \param nPoints   points in the sweep
+ * \param pFreq     frequencies
+ * \param pU        real part of gamma
+ * \param pV        imaginary part of gamma
+ */
+static void
+fillSweep( guint64 sweep, gint nPoints, gdouble *pFreq, gdouble *pU, gdouble *pV ) {
+    for( gint i = 0; i < nPoints; i++ ) {
+        pFreq[i] = 1e6 * (i + 1);
+        pU[i] = (gdouble)((sweep + i) % 1000) * 1e-3;
+        pV[i] = -pU[i];
+    }
+}
+
+/*!     \brief  Read a sweep as a chart would
+ *
+ * Read the points of a sweep, and spin for the time taken to draw it
+ *
+ * \param pTrace    the sweep
+ * \param drawTime  time to spend (µs)
+ * \return          sum of the points
+ */
+static gdouble
+useSweep( const tSmithTrace *pTrace, gint drawTime ) {
+    gdouble sum = 0.0;
+    gint64 until = g_get_monotonic_time() + drawTime;
+
+    for( gint i = 0; i < pTrace->nPoints; i++ )
+        sum += pTrace->pU[i] + pTrace->pV[i];
+    while( g_get_monotonic_time() < until )
+        ;
+
+    return sum;
+}
+
+/*!     \brief  Compare latencies
+ *
+ * Comparison of two latencies for qsort()
+ */
+static gint
+compareLatency( gconstpointer a, gconstpointer b ) {
+    gint64 x = *(const gint64 *)a, y = *(const gint64 *)b;
+
+    return (x > y) - (x < y);
+}
+
+/*!     \brief  Report the results
+ *
+ * Print the results of a benchmark
+ *
+ * \param sName     name of the transport
+ * \param pResult   the results
+ * \param nSweeps   sweeps written
+ * \param nPoints   points in each sweep
+ */
+static void
+report( const gchar *sName, tBenchResult *pResult, gint nSweeps, gint nPoints ) {
+    gdouble seconds = MAX( pResult->end - pResult->start, 1 ) * 1e-6;
+    gint64 *pLatency = (gint64 *)pResult->latency->data;
+    guint n = pResult->latency->len;
+
+    qsort( pLatency, n, sizeof( gint64 ), compareLatency );
+    printf( "%-6s %9.0f sweeps/s %7.2f GB/s   seen %6" G_GUINT64_FORMAT " of %d   torn %4" G_GUINT64_FORMAT
+            "   latency µs median %5" G_GINT64_FORMAT " 99%% %6" G_GINT64_FORMAT " max %6" G_GINT64_FORMAT "\n",
+            sName, nSweeps / seconds, nSweeps * 3.0 * nPoints * sizeof( gdouble ) / seconds * 1e-9,
+            pResult->seen, nSweeps, pResult->torn,
+            n ? pLatency[ n / 2 ] : 0, n ? pLatency[ n * 99 / 100 ] : 0, n ? pLatency[ n - 1 ] : 0 );
+}
+
+/*!     \brief  Benchmark the shared memory ring
+ *
+ * \param nPoints   points in each sweep
+ * \param nSweeps   sweeps to write
+ * \param nSlots    slots in the ring
+ * \param drawTime  simulated drawing time (µs)
+ * \param pResult   where the results are written
+ * \return          FALSE on error
+ */
+static gboolean
+benchmarkRing( gint nPoints, gint nSweeps, gint nSlots, gint drawTime, tBenchResult *pResult ) {
+    GError *pError = NULL;
+    tSweepRing *pProducer = sweepRingCreate( NULL, nSlots, nPoints, &pError ), *pReader;
+    guint64 last = 0;
+    pid_t child;
+
+    if( pProducer == NULL ) {
+        fprintf( stderr, "%s\n", pError->message );
+        return FALSE;
+    }
+
+    pResult->start = g_get_monotonic_time();
+    if( (child = fork()) == 0 ) {
+        for( gint sweep = 0; sweep < nSweeps; sweep++ ) {
+            tSmithTrace *pTrace = sweepRingBeginWrite( pProducer );
+
+            fillSweep( sweep, nPoints, pTrace->pFreq, pTrace->pU, pTrace->pV );
+            pTrace->nPoints = nPoints;
+            sweepRingEndWrite( pProducer );
+        }
+        _exit( 0 );
+    }
+
+    // read through a mapping of our own, as another process would
+    pReader = sweepRingAttachFd( dup( sweepRingFd( pProducer ) ), &pError );
+    sweepRingFree( pProducer );
+    if( pReader == NULL ) {
+        fprintf( stderr, "%s\n", pError->message );
+        return FALSE;
+    }
+
+    while( last < (guint64)nSweeps ) {
+        const tSmithTrace *pTrace;
+        guint64 sequence;
+        gint64 timestamp, latency;
+
+        if( sweepRingSequence( pReader ) == last )
+            continue;
+        if( (pTrace = sweepRingAcquire( pReader, &sequence, &timestamp )) == NULL )
+            continue;
+        latency = g_get_monotonic_time() - timestamp;
+        pResult->sum += useSweep( pTrace, drawTime );
+        if( sweepRingRelease( pReader ) ) {
+            g_array_append_val( pResult->latency, latency );
+            pResult->seen++;
+        } else {
+            pResult->torn++;
+        }
+        pResult->end = timestamp;
+        last = sequence;
+    }
+
+    waitpid( child, NULL, 0 );
+    sweepRingFree( pReader );
+    return TRUE;
+}
+
+/*!     \brief  Read all of a buffer
+ *
+ * Read all of a buffer from a file descriptor
+ *
+ * \return          FALSE at the end of the data
+ */
+static gboolean
+readAll( gint fd, void *pData, gsize length ) {
+    guint8 *p = pData;
+
+    while( length > 0 ) {
+        gssize n = read( fd, p, length );
+
+        if( n < 0 && errno == EINTR )
+            continue;
+        if( n <= 0 )
+            return FALSE;
+        p += n;
+        length -= n;
+    }
+    return TRUE;
+}
+
+/*!     \brief  Benchmark a pipe
+ *
+ * The same sweeps as binary frames through a pipe, each copied into a trace.
+ * The completion time is sent in the reserved field of the frame header.
+ *
+ * \param nPoints   points in each sweep
+ * \param nSweeps   sweeps to write
+ * \param drawTime  simulated drawing time (µs)
+ * \param pResult   where the results are written
+ * \return          FALSE on error
+ */
+static gboolean
+benchmarkPipe( gint nPoints, gint nSweeps, gint drawTime, tBenchResult *pResult ) {
+    gsize arrayBytes = nPoints * sizeof( gdouble );
+    gdouble *pArrays = g_new( gdouble, 3 * nPoints );
+    tSmithTrace *pTrace = smithTraceNew( nPoints, TRUE );
+    tStreamFrameHeader header;
+    gint fds[2];
+    pid_t child;
+
+    if( pipe( fds ) != 0 ) {
+        perror( "pipe" );
+        return FALSE;
+    }
+
+    pResult->start = g_get_monotonic_time();
+    if( (child = fork()) == 0 ) {
+        close( fds[0] );
+        for( gint sweep = 0; sweep < nSweeps; sweep++ ) {
+            fillSweep( sweep, nPoints, pArrays, pArrays + nPoints, pArrays + 2 * nPoints );
+            header = (tStreamFrameHeader){ STREAM_FRAME_MAGIC, nPoints, STREAM_FRAME_FREQUENCY,
+                                           (guint32)g_get_monotonic_time() };
+            if( write( fds[1], &header, sizeof( header ) ) != sizeof( header )
+                    || write( fds[1], pArrays, 3 * arrayBytes ) != (gssize)(3 * arrayBytes) )
+                break;
+        }
+        _exit( 0 );
+    }
+    close( fds[1] );
+
+    while( readAll( fds[0], &header, sizeof( header ) ) && readAll( fds[0], pArrays, 3 * arrayBytes ) ) {
+        // the microsecond clock truncated to 32 bits is enough for a difference
+        gint64 now = g_get_monotonic_time(), latency = (guint32)((guint32)now - header.reserved);
+
+        memcpy( pTrace->pFreq, pArrays, arrayBytes );
+        memcpy( pTrace->pU, pArrays + nPoints, arrayBytes );
+        memcpy( pTrace->pV, pArrays + 2 * nPoints, arrayBytes );
+        pTrace->nPoints = nPoints;
+        pResult->sum += useSweep( pTrace, drawTime );
+        g_array_append_val( pResult->latency, latency );
+        pResult->seen++;
+        pResult->end = now;
+    }
+
+    close( fds[0] );
+    waitpid( child, NULL, 0 );
+    smithTraceFree( pTrace );
+    g_free( pArrays );
+    return TRUE;
+}
+
+int
+main( int argc, char *argv[] ) {
+    static const struct option options[] = {
+        { "points", required_argument, NULL, 'p' },
+        { "sweeps", required_argument, NULL, 'n' },
+        { "slots",  required_argument, NULL, 's' },
+        { "draw",   required_argument, NULL, 'd' },
+        { NULL, 0, NULL, 0 }
+    };
+    gint nPoints = 4001, nSweeps = 20000, nSlots = SWEEP_RING_SLOTS, drawTime = 0, option;
+    tBenchResult ringResult = { 0 }, pipeResult = { 0 };
+
+    while( (option = getopt_long( argc, argv, "p:n:s:d:", options, NULL )) != -1 ) {
+        switch( option ) {
+        case 'p': nPoints = MAX( atoi( optarg ), 1 ); break;
+        case 'n': nSweeps = MAX( atoi( optarg ), 1 ); break;
+        case 's': nSlots = MAX( atoi( optarg ), 1 ); break;
+        case 'd': drawTime = MAX( atoi( optarg ), 0 ); break;
+        default:
+            fprintf( stderr, "usage: %s [--points N] [--sweeps N] [--slots N] [--draw µs]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf( "%d sweeps of %d points, %d slots, %d µs to draw\n", nSweeps, nPoints, nSlots, drawTime );
+    ringResult.latency = g_array_new( FALSE, FALSE, sizeof( gint64 ) );
+    pipeResult.latency = g_array_new( FALSE, FALSE, sizeof( gint64 ) );
+    if( !benchmarkRing( nPoints, nSweeps, nSlots, drawTime, &ringResult )
+            || !benchmarkPipe( nPoints, nSweeps, drawTime, &pipeResult ) )
+        return EXIT_FAILURE;
+
+    report( "ring", &ringResult, nSweeps, nPoints );
+    report( "pipe", &pipeResult, nSweeps, nPoints );
+    g_array_free( ringResult.latency, TRUE );
+    g_array_free( pipeResult.latency, TRUE );
+
+    return EXIT_SUCCESS;
+}
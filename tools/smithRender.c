@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file smithRender.c
+ * @brief Render Smith charts of data files without a display
+ *
+ * @author Michael G. Katzmann
+ *
+ * Each line of the job list names a data file (Touchstone, CITIfile or MDIF),
+ * the chart to write (.png, .pdf or .svg) and optionally the size of the chart
+ * (pixels or points) and the parameter to plot:
+ *
+ *   # input              output            size  parameter
+ *   lot/dut0001.s2p      out/dut0001.png   800   S21
+ *   sweep.cti            out/sweep.pdf
+ *   loadpull.mdf         out/loadpull.svg  600   gammaL_re,gammaL_im
+ *
+ * The parameter of a network is Sij (default S11); that of an MDIF file is the
+ * pair of columns holding the real and imaginary parts of gamma (default the
+ * second and third columns), drawn for each block of the file.
+ *
+ * The charts are drawn directly on cairo image, PDF and SVG surfaces with
+ * drawSmithChart() and the overlay functions, so neither a display nor a
+ * GtkApplication is needed. The jobs are rendered in parallel; each thread
+ * claims the next job as it finishes the last, so a large file does not hold
+ * up the others. The grid depends only on the options, the kind of output
+ * and the size, so each thread draws it once for each and paints it beneath
+ * the traces of every chart of that kind and size it renders (a cairo surface
+ * is not to be used by several threads at once, so the grids are not shared).
+ * PDF and SVG charts are drawn with flags.bCompact, for smaller files (and
+ * SVG charts with flags.bReuseGlyphs).
+ *
+ *   $ gcc -O2 -o smithRender `pkg-config --cflags --libs gtk4` smithRender.c ../src/GTKsmithChart.c \
+ *         ../src/GTKsmithTouchstone.c ../src/GTKsmithCiti.c ../src/GTKsmithMdif.c ../src/GTKsmithNetwork.c \
+ *         ../src/GTKsmithTrace.c ../src/GTKsmithParse.c ../src/GTKsmithMarker.c ../src/GTKsmithParallel.c -lm
+ *   $ ./smithRender --grid zy --marker jobs.txt
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <getopt.h>
+#include <cairo-pdf.h>
+#include <cairo-svg.h>
+#include "../src/GTKsmithChart.h"
+#include "../src/GTKsmithTrace.h"
+#include "../src/GTKsmithMarker.h"
+#include "../src/GTKsmithNetwork.h"
+#include "../src/GTKsmithTouchstone.h"
+#include "../src/GTKsmithCiti.h"
+#include "../src/GTKsmithMdif.h"
+#include "../src/GTKsmithParse.h"
+#include "../src/GTKsmithParallel.h"
+
+#define DEFAULT_SIZE    800
+#define SIZE_PCT        98
+
+typedef enum {
+    eOutputPNG, eOutputPDF, eOutputSVG
+} tOutputKind;
+
+typedef struct {
+    gchar       *sInput, *sOutput;
+    tOutputKind kind;
+    gint        size;
+    gchar       *sParameter;    // Sij or two MDIF column names (or NULL for the default)
+    gint        line;           // line of the job list
+} tRenderJob;
+
+// A grid drawn once by a thread and painted beneath the traces of each chart of the same kind and size
+typedef struct {
+    cairo_surface_t *pGrid;     // image surface (PNG) or recording surface (PDF and SVG)
+    cairo_matrix_t  matrix;     // transformation to gamma space left by drawSmithChart()
+} tGridCacheEntry;
+
+typedef struct {
+    tRenderJob    *pJobs;
+    tSmithOptions *pOptions;    // template; each job draws with its own copy
+    gboolean      bMarker;
+
+    GMutex        mutex;        // protects pGridCaches
+    GPtrArray     *pGridCaches; // the grid cache of each thread, freed at the end
+    gint          nFailed;      // (atomic)
+} tRender;
+
+// The grid cache of this thread: "kind:size" -> tGridCacheEntry
+static GPrivate gridCache = G_PRIVATE_INIT( NULL );
+
+/*!     \brief  Kind of output from the name of the file
+ *
+ * Kind of output from the extension of the file name
+ *
+ * \param sPath     path of the output
+ * \param pKind     where the kind is written
+ * \return          FALSE if the extension is not .png, .pdf or .svg
+ */
+static gboolean
+outputKind( const gchar *sPath, tOutputKind *pKind ) {
+    const gchar *sExtension = strrchr( sPath, '.' );
+
+    if( sExtension == NULL )
+        return FALSE;
+    if( g_ascii_strcasecmp( sExtension, ".png" ) == 0 )
+        *pKind = eOutputPNG;
+    else if( g_ascii_strcasecmp( sExtension, ".pdf" ) == 0 )
+        *pKind = eOutputPDF;
+    else if( g_ascii_strcasecmp( sExtension, ".svg" ) == 0 )
+        *pKind = eOutputSVG;
+    else
+        return FALSE;
+    return TRUE;
+}
+
+/*!     \brief  Read the job list
+ *
+ * Read the jobs from a file ("-" for stdin). Blank lines and lines starting
+ * with '#' are ignored.
+ *
+ * \param sPath         path of the job list
+ * \param defaultSize   size of the charts that do not give one
+ * \return              array of tRenderJob (or NULL if the list cannot be read)
+ */
+static GArray *
+readJobs( const gchar *sPath, gint defaultSize ) {
+    FILE *pFile = strcmp( sPath, "-" ) == 0 ? stdin : fopen( sPath, "r" );
+    GArray *pJobs;
+    gchar sLine[ 4096 ];
+    gint line = 0;
+
+    if( pFile == NULL ) {
+        perror( sPath );
+        return NULL;
+    }
+
+    pJobs = g_array_new( FALSE, TRUE, sizeof( tRenderJob ) );
+    while( fgets( sLine, sizeof( sLine ), pFile ) ) {
+        gchar **sFields = g_strsplit_set( g_strstrip( sLine ), " \t", -1 );
+        gchar *sField[4] = { NULL };
+        tRenderJob job = { .size = defaultSize, .line = ++line };
+        gint n = 0;
+
+        // (consecutive separators give empty fields)
+        for( gint i = 0; sFields[i] && n < 4; i++ )
+            if( *sFields[i] )
+                sField[ n++ ] = sFields[i];
+
+        if( n == 0 || *sField[0] == '#' ) {
+            g_strfreev( sFields );
+            continue;
+        }
+        if( n < 2 || !outputKind( sField[1], &job.kind )
+                || (n > 2 && (job.size = atoi( sField[2] )) <= 0) ) {
+            fprintf( stderr, "%s:%d: expected: input output.(png|pdf|svg) [size] [parameter]\n", sPath, line );
+            g_strfreev( sFields );
+            continue;
+        }
+
+        job.sInput = g_strdup( sField[0] );
+        job.sOutput = g_strdup( sField[1] );
+        job.sParameter = g_strdup( sField[3] );
+        g_array_append_val( pJobs, job );
+        g_strfreev( sFields );
+    }
+
+    if( pFile != stdin )
+        fclose( pFile );
+    return pJobs;
+}
+
+/*!     \brief  Free a grid cache entry
+ *
+ * Free a grid cache entry
+ *
+ * \param data      pointer to the tGridCacheEntry
+ */
+static void
+gridCacheEntryFree( gpointer data ) {
+    tGridCacheEntry *pEntry = data;
+
+    cairo_surface_destroy( pEntry->pGrid );
+    g_free( pEntry );
+}
+
+/*!     \brief  Grid of a kind and size of chart
+ *
+ * Find the grid for the kind and size of chart in the cache of this thread,
+ * drawing it the first time. The grid is drawn on a transparent surface, as
+ * the labels clear the grid lines behind them.
+ *
+ * \param pRender   pointer to the render state
+ * \param kind      kind of output
+ * \param size      width and height of the chart
+ * \return          the cache entry (used only by this thread, valid until the caches are destroyed)
+ */
+static tGridCacheEntry *
+gridCacheLookup( tRender *pRender, tOutputKind kind, gint size ) {
+    // (an SVG grid reuses its glyphs, a PDF grid does not)
+    gchar *sKey = g_strdup_printf( "%d:%d", kind, size );
+    GHashTable *pCache = g_private_get( &gridCache );
+    tGridCacheEntry *pEntry;
+
+    if( pCache == NULL ) {
+        pCache = g_hash_table_new_full( g_str_hash, g_str_equal, g_free, gridCacheEntryFree );
+        g_private_set( &gridCache, pCache );
+        g_mutex_lock( &pRender->mutex );
+        g_ptr_array_add( pRender->pGridCaches, pCache );
+        g_mutex_unlock( &pRender->mutex );
+    }
+
+    if( (pEntry = g_hash_table_lookup( pCache, sKey )) == NULL ) {
+        tSmithOptions options = *pRender->pOptions;
+        cairo_t *cr;
+
+        options.flags.bCompact = kind != eOutputPNG;
+        options.flags.bReuseGlyphs = kind == eOutputSVG;
+        pEntry = g_new0( tGridCacheEntry, 1 );
+        if( kind == eOutputPNG ) {
+            pEntry->pGrid = cairo_image_surface_create( CAIRO_FORMAT_ARGB32, size, size );
+        } else {
+            cairo_rectangle_t extents = { 0, 0, size, size };
+            pEntry->pGrid = cairo_recording_surface_create( CAIRO_CONTENT_COLOR_ALPHA, &extents );
+        }
+
+        cr = cairo_create( pEntry->pGrid );
+        drawSmithChart( cr, size / 2.0, size / 2.0, size / 2.0 * (SIZE_PCT / 100.0), &options );
+        cairo_destroy( cr );
+        cairo_surface_flush( pEntry->pGrid );
+        pEntry->matrix = options.matrix;
+
+        g_hash_table_insert( pCache, sKey, pEntry );
+        sKey = NULL;
+    }
+
+    g_free( sKey );
+    return pEntry;
+}
+
+/*!     \brief  Load the traces to be drawn by a job
+ *
+ * Load the data file of a job and make the traces of its parameter
+ *
+ * \param pJob      pointer to the job
+ * \param ppNetwork where the network is written (owns the traces, or NULL for an MDIF file)
+ * \param ppMdif    where the MDIF file is written (or NULL for a network)
+ * \param ppError   where an error is reported
+ * \return          array of tSmithTrace * to be drawn (or NULL on error)
+ */
+static GPtrArray *
+loadTraces( const tRenderJob *pJob, tSmithNetwork **ppNetwork, tMdifFile **ppMdif, GError **ppError ) {
+    const gchar *sExtension = strrchr( pJob->sInput, '.' );
+    GPtrArray *pTraces = g_ptr_array_new();
+
+    if( sExtension && (g_ascii_strcasecmp( sExtension, ".mdf" ) == 0 || g_ascii_strcasecmp( sExtension, ".mdif" ) == 0) ) {
+        gchar **sColumns = pJob->sParameter ? g_strsplit( pJob->sParameter, ",", 2 ) : NULL;
+
+        if( sColumns && g_strv_length( sColumns ) != 2 ) {
+            g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorFormat,
+                    "%s: %s: parameter must be two columns (real,imaginary)", pJob->sInput, pJob->sParameter );
+        } else if( (*ppMdif = mdifLoad( pJob->sInput, ppError )) ) {
+            g_ptr_array_set_free_func( pTraces, (GDestroyNotify)smithTraceFree );
+            for( gint b = 0; b < (*ppMdif)->nBlocks; b++ ) {
+                const tMdifBlock *pBlock = &(*ppMdif)->pBlocks[b];
+                gint u = sColumns ? mdifBlockColumn( pBlock, sColumns[0] ) : 1;
+                gint v = sColumns ? mdifBlockColumn( pBlock, sColumns[1] ) : 2;
+
+                if( u >= 0 && v >= 0 && u < pBlock->nColumns && v < pBlock->nColumns )
+                    g_ptr_array_add( pTraces, mdifBlockTrace( pBlock, u, v, -1 ) );
+            }
+            if( pTraces->len == 0 )
+                g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData,
+                        "%s: no block has the columns %s", pJob->sInput, pJob->sParameter ? pJob->sParameter : "1,2" );
+        }
+        g_strfreev( sColumns );
+    } else {
+        gint selection[1][2] = { { 1, 1 } };
+        const gchar *sParameter = pJob->sParameter;
+
+        if( sParameter && g_ascii_toupper( *sParameter ) == 'S' )
+            sParameter++;
+        if( sParameter && !(strlen( sParameter ) == 2 && g_ascii_isdigit( sParameter[0] ) && g_ascii_isdigit( sParameter[1] )) ) {
+            g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorFormat,
+                    "%s: %s: parameter must be Sij", pJob->sInput, pJob->sParameter );
+        } else {
+            if( sParameter ) {
+                selection[0][0] = sParameter[0] - '0';
+                selection[0][1] = sParameter[1] - '0';
+            }
+            if( sExtension && (g_ascii_strcasecmp( sExtension, ".cti" ) == 0 || g_ascii_strcasecmp( sExtension, ".citi" ) == 0) )
+                *ppNetwork = citifileLoad( pJob->sInput, ppError );
+            else
+                *ppNetwork = touchstoneLoadSelected( pJob->sInput, (const gint (*)[2])selection, 1, ppError );
+
+            if( *ppNetwork ) {
+                tSmithTrace *pTrace = NULL;
+
+                if( selection[0][0] >= 1 && selection[0][0] <= (*ppNetwork)->nPorts
+                        && selection[0][1] >= 1 && selection[0][1] <= (*ppNetwork)->nPorts )
+                    pTrace = smithNetworkParameter( *ppNetwork, selection[0][0], selection[0][1] );
+                if( pTrace )
+                    g_ptr_array_add( pTraces, pTrace );
+                else
+                    g_set_error( ppError, SMITH_PARSE_ERROR, eParseErrorData,
+                            "%s: S%d%d is not in the file", pJob->sInput, selection[0][0], selection[0][1] );
+            }
+        }
+    }
+
+    if( ppError && *ppError ) {
+        g_ptr_array_free( pTraces, TRUE );
+        return NULL;
+    }
+    return pTraces;
+}
+
+/*!     \brief  Mark the best match of a trace
+ *
+ * Draw a point at the minimum |gamma| of the trace, labeled with its frequency
+ * (or |gamma| if the trace has no frequency axis)
+ *
+ * \param cr        pointer to the cairo context
+ * \param pTrace    pointer to the trace
+ * \param pOptions  pointer to the options of the chart
+ */
+static void
+markBestMatch( cairo_t *cr, const tSmithTrace *pTrace, tSmithOptions *pOptions ) {
+    tMarkerPosition position;
+    gchar *sLabel;
+    tUV uv;
+
+    if( !markerMinGamma( pTrace, &position ) )
+        return;
+
+    uv = smithTracePointAt( pTrace, position.index, position.fraction );
+    if( pTrace->pFreq )
+        sLabel = g_strdup_printf( "%.6g MHz", smithTraceFrequencyAt( pTrace, position.index, position.fraction ) / 1e6 );
+    else
+        sLabel = g_strdup_printf( "|Γ| %.3f", position.value );
+
+    drawPointOnSmithChart( cr, uv, pOptions );
+    annotatePointOnSmithChart( cr, sLabel, uv, uv.U < 0.5, pOptions );
+    g_free( sLabel );
+}
+
+/*!     \brief  Render a job
+ *
+ * Load the data of a job and draw its chart
+ *
+ * \param pRender   pointer to the render state
+ * \param pJob      pointer to the job
+ * \param ppError   where an error is reported
+ * \return          FALSE on error
+ */
+static gboolean
+renderJob( tRender *pRender, const tRenderJob *pJob, GError **ppError ) {
+    tSmithNetwork *pNetwork = NULL;
+    tMdifFile *pMdif = NULL;
+    GPtrArray *pTraces = loadTraces( pJob, &pNetwork, &pMdif, ppError );
+    tSmithOptions options = *pRender->pOptions;
+    tGridCacheEntry *pGrid;
+    cairo_surface_t *pSurface;
+    cairo_status_t status;
+    cairo_t *cr;
+
+    if( pTraces == NULL ) {
+        smithNetworkFree( pNetwork );
+        mdifFree( pMdif );
+        return FALSE;
+    }
+
+    pGrid = gridCacheLookup( pRender, pJob->kind, pJob->size );
+    if( pJob->kind == eOutputPNG )
+        pSurface = cairo_image_surface_create( CAIRO_FORMAT_ARGB32, pJob->size, pJob->size );
+    else if( pJob->kind == eOutputPDF )
+        pSurface = cairo_pdf_surface_create( pJob->sOutput, pJob->size, pJob->size );
+    else
+        pSurface = cairo_svg_surface_create( pJob->sOutput, pJob->size, pJob->size );
+
+    cr = cairo_create( pSurface );
+    cairo_set_source_surface( cr, pGrid->pGrid, 0, 0 );
+    cairo_paint( cr );
+    options.matrix = pGrid->matrix;
+    options.flags.bCompact = pJob->kind != eOutputPNG;
+    options.flags.bReuseGlyphs = pJob->kind == eOutputSVG;
+
+    for( guint t = 0; t < pTraces->len; t++ ) {
+        drawTraceOnSmithChart( cr, g_ptr_array_index( pTraces, t ), &options );
+        if( pRender->bMarker )
+            markBestMatch( cr, g_ptr_array_index( pTraces, t ), &options );
+    }
+
+    if( pJob->kind == eOutputPNG ) {
+        // an opaque background beneath the chart
+        cairo_set_operator( cr, CAIRO_OPERATOR_DEST_OVER );
+        cairo_set_source_rgb( cr, 1.0, 1.0, 1.0 );
+        cairo_paint( cr );
+    }
+    cairo_destroy( cr );
+
+    if( pJob->kind == eOutputPNG )
+        status = cairo_surface_write_to_png( pSurface, pJob->sOutput );
+    else {
+        cairo_surface_finish( pSurface );
+        status = cairo_surface_status( pSurface );
+    }
+    cairo_surface_destroy( pSurface );
+
+    g_ptr_array_free( pTraces, TRUE );
+    smithNetworkFree( pNetwork );
+    mdifFree( pMdif );
+
+    if( status != CAIRO_STATUS_SUCCESS ) {
+        g_set_error( ppError, G_FILE_ERROR, G_FILE_ERROR_FAILED, "%s: %s",
+                pJob->sOutput, cairo_status_to_string( status ) );
+        return FALSE;
+    }
+    return TRUE;
+}
+
+/*!     \brief  Render a range of jobs
+ *
+ * Render a range of jobs (a parallel loop function)
+ *
+ * \param from      first job
+ * \param to        last job (exclusive)
+ * \param userData  pointer to the tRender
+ */
+static void
+renderJobs( gint from, gint to, gpointer userData ) {
+    tRender *pRender = userData;
+
+    for( gint j = from; j < to; j++ ) {
+        GError *pError = NULL;
+
+        if( !renderJob( pRender, &pRender->pJobs[j], &pError ) ) {
+            fprintf( stderr, "line %d: %s\n", pRender->pJobs[j].line, pError->message );
+            g_error_free( pError );
+            g_atomic_int_inc( &pRender->nFailed );
+        }
+    }
+}
+
+int
+main( int argc, char *argv[] ) {
+    static const struct option longOptions[] = {
+        { "size",    required_argument, NULL, 's' },
+        { "grid",    required_argument, NULL, 'g' },
+        { "no-ring", no_argument,       NULL, 'n' },
+        { "marker",  no_argument,       NULL, 'm' },
+        { NULL, 0, NULL, 0 }
+    };
+    tSmithOptions options = {
+            .flags.bShowRX      = TRUE,
+            .flags.bShowGB      = FALSE,
+            .flags.bShowLabels  = TRUE,
+            .flags.bShowStrings = TRUE,
+            .flags.bDrawRing    = TRUE,
+            .flags.bSparceGB    = TRUE,
+
+            .lineWidth  = 0.25,
+            .pointWidth = 0.6,
+                            // red/green/blue/alpha
+            .colorRXgrid     = { 0.7, 0.0, 0.0, 1.0 },
+            .colorGBgrid     = { 0.0, 0.5, 0.5, 1.0 },
+            .colorRXtext     = { 0.5, 0.0, 0.0, 1.0 },
+            .colorGBtext     = { 0.0, 0.5, 0.5, 1.0 },
+            .colorRing       = { 0.0, 0.0, 0.0, 1.0 },
+            .colorLine       = { 0.0, 0.0, 0.5, 1.0 },
+            .colorAnnotation = { 0.0, 0.5, 0.0, 1.0 },
+            .colorRegion     = { 0.0, 0.0, 0.5, 0.25 },
+
+            .annotationFontSize = 0.4
+    };
+    tRender render = { .pOptions = &options };
+    gint size = DEFAULT_SIZE, option;
+    GArray *pJobs;
+    gint64 start;
+    gdouble seconds;
+
+    while( (option = getopt_long( argc, argv, "s:g:nm", longOptions, NULL )) != -1 ) {
+        switch( option ) {
+        case 's': size = MAX( atoi( optarg ), 16 ); break;
+        case 'g':
+            // z: impedance, y: admittance, zy: both (sparse admittance grid)
+            options.flags.bShowRX = strchr( optarg, 'z' ) != NULL;
+            options.flags.bShowGB = strchr( optarg, 'y' ) != NULL;
+            options.flags.bSparceGB = options.flags.bShowRX;
+            break;
+        case 'n': options.flags.bDrawRing = FALSE; break;
+        case 'm': render.bMarker = TRUE; break;
+        default:
+            optind = argc;
+            break;
+        }
+    }
+    if( optind != argc - 1 ) {
+        fprintf( stderr, "usage: %s [--size N] [--grid z|y|zy] [--no-ring] [--marker] JOBLIST|-\n", argv[0] );
+        return EXIT_FAILURE;
+    }
+
+    if( (pJobs = readJobs( argv[ optind ], size )) == NULL )
+        return EXIT_FAILURE;
+
+    render.pJobs = (tRenderJob *)pJobs->data;
+    render.pGridCaches = g_ptr_array_new_with_free_func( (GDestroyNotify)g_hash_table_destroy );
+    g_mutex_init( &render.mutex );
+
+    start = g_get_monotonic_time();
+    smithParallelFor( pJobs->len, 1, renderJobs, &render );
+    seconds = (g_get_monotonic_time() - start) * 1e-6;
+
+    printf( "%u charts (%d failed) in %.2f s on %d threads, %.0f charts per minute\n", pJobs->len, render.nFailed,
+            seconds, smithParallelThreads(), seconds > 0 ? pJobs->len * 60.0 / seconds : 0.0 );
+
+    for( guint j = 0; j < pJobs->len; j++ ) {
+        g_free( render.pJobs[j].sInput );
+        g_free( render.pJobs[j].sOutput );
+        g_free( render.pJobs[j].sParameter );
+    }
+    g_array_free( pJobs, TRUE );
+    g_ptr_array_free( render.pGridCaches, TRUE );
+    g_mutex_clear( &render.mutex );
+
+    return render.nFailed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,236 @@
+/*
+ * Copyright (c) 2026 Michael G. Katzmann
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/**
+ * @file sweepProducer.c
+ * @brief Stand-in for an instrument streaming sweeps
+ *
+ * @author Michael G. Katzmann
+ *
+ * Writes sweeps of a drifting resonant load, as text lines or binary frames
+ * (see GTKsmithStream.h), to stdout or to a client of a Unix domain socket,
+ * for trying sweepStreamOpenFd() and sweepStreamOpenPath() without an instrument.
+ * With --ring it is the reference producer of a shared memory ring (GTKsmithRing.c),
+ * writing each sweep in place for sweepRingAttach().
+ *
+ *   $ gcc -O2 -o sweepProducer `pkg-config --cflags --libs gtk4` sweepProducer.c ../src/GTKsmithRing.c -lm
+ *   $ ./sweepProducer --points 1001 --rate 50 | ./smith
+ *   $ mkfifo /tmp/sweeps; ./sweepProducer --binary > /tmp/sweeps
+ *   $ ./sweepProducer --binary --socket /tmp/sweeps.sock
+ *   $ ./sweepProducer --ring /vna-sweeps --points 4001 --rate 500
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include <complex.h>
+#include <getopt.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "../src/GTKsmithStream.h"
+#include "../src/GTKsmithRing.h"
+
+#define Z0  50.0
+
+/*!     \brief  Write all of a buffer
+ *
+ * Write all of a buffer to a file descriptor
+ *
+ * \param fd        file descriptor
+ * \param pData     data to write
+ * \param length    number of bytes
+ * \return          FALSE if the reader has gone
+ */
+static gboolean
+writeAll( gint fd, const void *pData, gsize length ) {
+    const guint8 *p = pData;
+
+    while( length > 0 ) {
+        gssize n = write( fd, p, length );
+
+        if( n < 0 && errno == EINTR )
+            continue;
+        if( n <= 0 )
+            return FALSE;
+        p += n;
+        length -= n;
+    }
+    return TRUE;
+}
+
+/*!     \brief  Calculate a sweep
+ *
+ * Reflection coefficient of a series RLC load whose resonance drifts
+ * slowly with the sweep number
+ *
+ * \param sweep     sweep number
+ * \param nPoints   points in the sweep
+ * \param pFreq     frequencies (Hz)
+ * \param pU        real part of gamma
+ * \param pV        imaginary part of gamma
+ */
+static void
+calculateSweep( guint64 sweep, gint nPoints, gdouble *pFreq, gdouble *pU, gdouble *pV ) {
+    gdouble fResonance = 100e6 * (1.0 + 0.05 * sin( sweep * 0.02 ));
+    gdouble L = 200e-9, C = 1.0 / (SQU( 2.0 * G_PI * fResonance ) * L), R = 30.0 + 10.0 * cos( sweep * 0.013 );
+
+    for( gint i = 0; i < nPoints; i++ ) {
+        gdouble w = 2.0 * G_PI * (50e6 + 100e6 * i / MAX( nPoints - 1, 1 ));
+        complex double Z = R + I * (w * L - 1.0 / (w * C));
+        complex double gamma = (Z - Z0) / (Z + Z0);
+
+        pFreq[i] = w / (2.0 * G_PI);
+        pU[i] = creal( gamma );
+        pV[i] = cimag( gamma );
+    }
+}
+
+/*!     \brief  Accept a client on a Unix domain socket
+ *
+ * Create a Unix domain socket and wait for a client to connect
+ *
+ * \param sPath     path of the socket
+ * \return          connected file descriptor (or -1)
+ */
+static gint
+acceptClient( const gchar *sPath ) {
+    struct sockaddr_un address = { .sun_family = AF_UNIX };
+    gint listener, fd;
+
+    if( strlen( sPath ) >= sizeof( address.sun_path ) )
+        return -1;
+    strcpy( address.sun_path, sPath );
+    unlink( sPath );
+    if( (listener = socket( AF_UNIX, SOCK_STREAM, 0 )) < 0
+            || bind( listener, (struct sockaddr *)&address, sizeof( address ) ) != 0
+            || listen( listener, 1 ) != 0 )
+        return -1;
+
+    fprintf( stderr, "waiting for a client on %s\n", sPath );
+    fd = accept( listener, NULL, NULL );
+    close( listener );
+    unlink( sPath );
+
+    return fd;
+}
+
+int
+main( int argc, char *argv[] ) {
+    static const struct option options[] = {
+        { "binary", no_argument,       NULL, 'b' },
+        { "points", required_argument, NULL, 'p' },
+        { "rate",   required_argument, NULL, 'r' },
+        { "count",  required_argument, NULL, 'n' },
+        { "socket", required_argument, NULL, 's' },
+        { "ring",   required_argument, NULL, 'R' },
+        { NULL, 0, NULL, 0 }
+    };
+    gboolean bBinary = FALSE;
+    gint nPoints = 401, option, fd = STDOUT_FILENO;
+    gdouble rate = 30.0;
+    guint64 count = 0;
+    const gchar *sSocket = NULL, *sRing = NULL;
+    tSweepRing *pRing = NULL;
+    GError *pError = NULL;
+    gdouble *pFreq, *pU, *pV;
+    GString *pText = g_string_new( NULL );
+    struct timespec next;
+
+    while( (option = getopt_long( argc, argv, "bp:r:n:s:R:", options, NULL )) != -1 ) {
+        switch( option ) {
+        case 'b': bBinary = TRUE; break;
+        case 'p': nPoints = MAX( atoi( optarg ), 1 ); break;
+        case 'r': rate = atof( optarg ); break;
+        case 'n': count = strtoull( optarg, NULL, 10 ); break;
+        case 's': sSocket = optarg; break;
+        case 'R': sRing = optarg; break;
+        default:
+            fprintf( stderr, "usage: %s [--binary] [--points N] [--rate sweeps/s (0 for flat out)]"
+                             " [--count sweeps] [--socket path | --ring name]\n", argv[0] );
+            return EXIT_FAILURE;
+        }
+    }
+
+    signal( SIGPIPE, SIG_IGN );
+    if( sRing && (pRing = sweepRingCreate( sRing, 0, nPoints, &pError )) == NULL ) {
+        fprintf( stderr, "%s\n", pError->message );
+        return EXIT_FAILURE;
+    }
+    if( sSocket && (fd = acceptClient( sSocket )) < 0 ) {
+        fprintf( stderr, "%s: %s\n", sSocket, strerror( errno ) );
+        return EXIT_FAILURE;
+    }
+
+    pFreq = g_new( gdouble, nPoints );
+    pU = g_new( gdouble, nPoints );
+    pV = g_new( gdouble, nPoints );
+    clock_gettime( CLOCK_MONOTONIC, &next );
+
+    for( guint64 sweep = 0; count == 0 || sweep < count; sweep++ ) {
+        gboolean bWritten;
+
+        if( pRing ) {
+            // calculated in place in the shared memory
+            tSmithTrace *pTrace = sweepRingBeginWrite( pRing );
+
+            calculateSweep( sweep, nPoints, pTrace->pFreq, pTrace->pU, pTrace->pV );
+            pTrace->nPoints = nPoints;
+            sweepRingEndWrite( pRing );
+            bWritten = TRUE;
+        } else {
+            calculateSweep( sweep, nPoints, pFreq, pU, pV );
+            if( bBinary ) {
+                tStreamFrameHeader header = { STREAM_FRAME_MAGIC, nPoints, STREAM_FRAME_FREQUENCY, 0 };
+
+                bWritten = writeAll( fd, &header, sizeof( header ) )
+                        && writeAll( fd, pFreq, nPoints * sizeof( gdouble ) )
+                        && writeAll( fd, pU, nPoints * sizeof( gdouble ) )
+                        && writeAll( fd, pV, nPoints * sizeof( gdouble ) );
+            } else {
+                g_string_truncate( pText, 0 );
+                for( gint i = 0; i < nPoints; i++ )
+                    g_string_append_printf( pText, "%.9g %.9g %.9g\n", pFreq[i], pU[i], pV[i] );
+                g_string_append_c( pText, '\n' );
+                bWritten = writeAll( fd, pText->str, pText->len );
+            }
+        }
+        if( !bWritten )
+            break;
+
+        if( rate > 0.0 ) {
+            gint64 period = (gint64)(1e9 / rate);
+
+            next.tv_nsec += period % 1000000000;
+            next.tv_sec += period / 1000000000 + next.tv_nsec / 1000000000;
+            next.tv_nsec %= 1000000000;
+            clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL );
+        }
+    }
+
+    g_free( pFreq );
+    g_free( pU );
+    g_free( pV );
+    g_string_free( pText, TRUE );
+    sweepRingFree( pRing );
+    close( fd );
+
+    return EXIT_SUCCESS;
+}